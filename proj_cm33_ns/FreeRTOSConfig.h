@@ -110,10 +110,18 @@ when application makefile has VFP_SELECT configured as softfloat */
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* The run time counter of the task statistics is provided by the power
+ * profiler in microseconds, derived from the tick count and SysTick.
+ */
+extern uint64_t power_profiler_run_time_us( void );
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        power_profiler_run_time_us()
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -202,9 +210,12 @@ standard names - or at least those used in the unmodified vector table. */
  * The Low Power Assistant library provides additional portable configuration layer
  * for low-power features supported by the PSoC 6 devices:
  * https://github.com/Infineon/lpa
+ * power_profiler_sleep() wraps it to account the time spent in each
+ * power mode.
  */
 extern void vApplicationSleep( uint32_t xExpectedIdleTime );
-#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) vApplicationSleep( xIdleTime )
+extern void power_profiler_sleep( uint32_t expected_idle_ticks );
+#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) power_profiler_sleep( xIdleTime )
 #define configUSE_TICKLESS_IDLE                 2
 
 #else
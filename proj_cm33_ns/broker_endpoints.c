@@ -0,0 +1,425 @@
+/******************************************************************************
+* File Name:   broker_endpoints.c
+*
+* Description: This file contains the list of MQTT broker endpoints. The
+*              TCP connect latency of every endpoint is probed, the
+*              endpoints are ranked by latency and connection failures, and
+*              the endpoints are re-probed periodically within a time budget.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "broker_endpoints.h"
+
+#include "mqtt_client_config.h"
+
+#include "cy_secure_sockets.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Ranking penalty of each consecutive failed MQTT connection, so that an
+ * endpoint that accepts TCP but fails the TLS handshake or MQTT is quickly
+ * passed over.
+ */
+#define BROKER_FAILURE_PENALTY_MS           (1000U)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Compile-time endpoint. */
+typedef struct
+{
+    const char *hostname;
+    uint16_t port;
+} broker_endpoint_config_t;
+
+/* Endpoints after the primary one; the last entry terminates the list. */
+static const broker_endpoint_config_t broker_fallback_endpoints[] =
+{
+    MQTT_BROKER_FALLBACK_ENDPOINTS
+    { NULL, 0U }
+};
+
+static broker_endpoint_t broker_endpoints[MQTT_BROKER_MAX_ENDPOINTS];
+static uint32_t broker_endpoint_count;
+static TickType_t broker_last_probe;
+
+/******************************************************************************
+ * Function Name: broker_endpoints_init
+ ******************************************************************************
+ * Summary:
+ *  Builds the endpoint list: the broker of the configuration store
+ *  (MQTT_BROKER_ADDRESS and MQTT_PORT by default) followed by
+ *  MQTT_BROKER_FALLBACK_ENDPOINTS, up to MQTT_BROKER_MAX_ENDPOINTS.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void broker_endpoints_init(void)
+{
+    const broker_endpoint_config_t *config;
+    broker_endpoint_t *endpoint;
+
+    memset(broker_endpoints, 0, sizeof(broker_endpoints));
+    config_store_get_string(CONFIG_KEY_MQTT_BROKER, broker_endpoints[0].hostname,
+                            sizeof(broker_endpoints[0].hostname), MQTT_BROKER_ADDRESS);
+    broker_endpoints[0].port = (uint16_t)config_store_get_uint(CONFIG_KEY_MQTT_PORT, MQTT_PORT);
+    broker_endpoint_count = 1U;
+
+    for (config = broker_fallback_endpoints;
+         (NULL != config->hostname) && (broker_endpoint_count < MQTT_BROKER_MAX_ENDPOINTS); config++)
+    {
+        endpoint = &broker_endpoints[broker_endpoint_count++];
+        strncpy(endpoint->hostname, config->hostname, sizeof(endpoint->hostname) - 1U);
+        endpoint->port = config->port;
+    }
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_probe_one
+ ******************************************************************************
+ * Summary:
+ *  Measures the time of a TCP connect to an endpoint. The name is resolved
+ *  before the timing starts.
+ *
+ * Parameters:
+ *  broker_endpoint_t *endpoint : Endpoint; its probe result is updated
+ *  uint32_t timeout_ms : Time after which the endpoint counts as unreachable
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void broker_endpoints_probe_one(broker_endpoint_t *endpoint, uint32_t timeout_ms)
+{
+    cy_socket_t handle;
+    cy_socket_sockaddr_t address;
+    TickType_t start;
+    cy_rslt_t result;
+
+    endpoint->reachable = false;
+
+    memset(&address, 0, sizeof(address));
+    if (CY_RSLT_SUCCESS != cy_socket_gethostbyname(endpoint->hostname, CY_SOCKET_IP_VER_V4,
+                                                   &address.ip_address))
+    {
+        printf("Broker '%s': name resolution failed.\n", endpoint->hostname);
+        return;
+    }
+    address.port = endpoint->port;
+
+    result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_STREAM,
+                              CY_SOCKET_IPPROTO_TCP, &handle);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return;
+    }
+
+    (void) cy_socket_setsockopt(handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                                &timeout_ms, sizeof(timeout_ms));
+    (void) cy_socket_setsockopt(handle, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_SNDTIMEO,
+                                &timeout_ms, sizeof(timeout_ms));
+
+    start = xTaskGetTickCount();
+    result = cy_socket_connect(handle, &address, sizeof(address));
+    if (CY_RSLT_SUCCESS == result)
+    {
+        endpoint->reachable = true;
+        endpoint->latency_ms = (uint32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+        printf("Broker '%s:%u': TCP connect latency %lu ms\n", endpoint->hostname,
+               (unsigned int)endpoint->port, (unsigned long)endpoint->latency_ms);
+        (void) cy_socket_disconnect(handle, 0U);
+    }
+    else
+    {
+        printf("Broker '%s:%u': unreachable (0x%0X)\n", endpoint->hostname,
+               (unsigned int)endpoint->port, (int)result);
+    }
+
+    (void) cy_socket_delete(handle);
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_probe_all
+ ******************************************************************************
+ * Summary:
+ *  Probes every endpoint the same way, so that their latencies compare.
+ *
+ * Parameters:
+ *  uint32_t timeout_ms : Probe timeout of each endpoint
+ *
+ * Return:
+ *  uint32_t : Number of reachable endpoints
+ *
+ ******************************************************************************/
+static uint32_t broker_endpoints_probe_all(uint32_t timeout_ms)
+{
+    uint32_t reachable = 0U;
+
+    for (uint32_t i = 0U; i < broker_endpoint_count; i++)
+    {
+        broker_endpoints_probe_one(&broker_endpoints[i], timeout_ms);
+        if (broker_endpoints[i].reachable)
+        {
+            reachable++;
+        }
+    }
+    broker_last_probe = xTaskGetTickCount();
+
+    return reachable;
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_probe
+ ******************************************************************************
+ * Summary:
+ *  Probes every endpoint before the first MQTT connection. The MQTT library
+ *  must be initialized.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Number of reachable endpoints
+ *
+ ******************************************************************************/
+uint32_t broker_endpoints_probe(void)
+{
+    return broker_endpoints_probe_all(MQTT_BROKER_PROBE_TIMEOUT_MS);
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_cost
+ ******************************************************************************
+ * Summary:
+ *  Cost of a reachable endpoint: its connect latency, raised by recent
+ *  MQTT connection failures.
+ *
+ * Parameters:
+ *  const broker_endpoint_t *endpoint : Endpoint
+ *
+ * Return:
+ *  uint32_t : Cost in milliseconds; lower is better
+ *
+ ******************************************************************************/
+static uint32_t broker_endpoints_cost(const broker_endpoint_t *endpoint)
+{
+    return endpoint->latency_ms + (endpoint->consecutive_failures * BROKER_FAILURE_PENALTY_MS);
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_rank
+ ******************************************************************************
+ * Summary:
+ *  Orders the endpoints for connection: endpoints reachable in the last
+ *  probe by ascending cost, then the others in list order. Depends only on
+ *  its arguments, so it can be fed simulated probe results.
+ *
+ * Parameters:
+ *  const broker_endpoint_t *endpoints : Endpoints
+ *  uint32_t count : Number of endpoints
+ *  uint8_t *order : Indices of the endpoints in connection order; set
+ *
+ * Return:
+ *  uint32_t : Number of entries written to 'order'
+ *
+ ******************************************************************************/
+uint32_t broker_endpoints_rank(const broker_endpoint_t *endpoints, uint32_t count, uint8_t *order)
+{
+    uint32_t reachable_count = 0U;
+    uint32_t n;
+    uint32_t j;
+    uint8_t index;
+
+    /* Insertion sort of the reachable endpoints; the list is short. */
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (!endpoints[i].reachable)
+        {
+            continue;
+        }
+
+        for (j = reachable_count; (j > 0U) &&
+             (broker_endpoints_cost(&endpoints[order[j - 1U]]) > broker_endpoints_cost(&endpoints[i])); j--)
+        {
+            order[j] = order[j - 1U];
+        }
+        order[j] = (uint8_t)i;
+        reachable_count++;
+    }
+
+    n = reachable_count;
+    for (index = 0U; index < count; index++)
+    {
+        if (!endpoints[index].reachable)
+        {
+            order[n++] = index;
+        }
+    }
+
+    return n;
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_order
+ ******************************************************************************
+ * Summary:
+ *  Ranks the configured endpoints with broker_endpoints_rank().
+ *
+ * Parameters:
+ *  uint8_t *order : At least MQTT_BROKER_MAX_ENDPOINTS entries; set
+ *
+ * Return:
+ *  uint32_t : Number of entries written to 'order'
+ *
+ ******************************************************************************/
+uint32_t broker_endpoints_order(uint8_t *order)
+{
+    return broker_endpoints_rank(broker_endpoints, broker_endpoint_count, order);
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_get
+ ******************************************************************************
+ * Summary:
+ *  Returns an endpoint of the list.
+ *
+ * Parameters:
+ *  uint32_t index : Index of the endpoint
+ *
+ * Return:
+ *  const broker_endpoint_t * : Endpoint, or NULL if the index is invalid
+ *
+ ******************************************************************************/
+const broker_endpoint_t *broker_endpoints_get(uint32_t index)
+{
+    return (index < broker_endpoint_count) ? &broker_endpoints[index] : NULL;
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_record
+ ******************************************************************************
+ * Summary:
+ *  Records the result of an MQTT connection to an endpoint.
+ *
+ * Parameters:
+ *  uint32_t index : Index of the endpoint
+ *  bool connected : true if the MQTT connection succeeded
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void broker_endpoints_record(uint32_t index, bool connected)
+{
+    if (index >= broker_endpoint_count)
+    {
+        return;
+    }
+
+    if (connected)
+    {
+        broker_endpoints[index].consecutive_failures = 0U;
+    }
+    else
+    {
+        broker_endpoints[index].consecutive_failures++;
+    }
+}
+
+/******************************************************************************
+ * Function Name: broker_endpoints_reprobe
+ ******************************************************************************
+ * Summary:
+ *  Re-probes the endpoints once every MQTT_BROKER_REPROBE_INTERVAL_MS and
+ *  checks whether the best ranked endpoint is worth moving to: it must be
+ *  at least MQTT_BROKER_SWITCH_HYSTERESIS_MS faster than the current one,
+ *  or the current one must have become unreachable.
+ *
+ *  The re-probe runs on the MQTT task while it is connected, so the whole
+ *  pass is bounded by MQTT_BROKER_REPROBE_BUDGET_MS, shared evenly by the
+ *  endpoints. An endpoint that does not answer within its share counts as
+ *  unreachable for this pass.
+ *
+ * Parameters:
+ *  uint32_t current : Index of the endpoint in use
+ *
+ * Return:
+ *  bool : true if the client should reconnect to the best ranked endpoint
+ *
+ ******************************************************************************/
+bool broker_endpoints_reprobe(uint32_t current)
+{
+    uint8_t order[MQTT_BROKER_MAX_ENDPOINTS];
+    const broker_endpoint_t *best;
+
+    if ((broker_endpoint_count < 2U) || (current >= broker_endpoint_count) ||
+        ((xTaskGetTickCount() - broker_last_probe) < pdMS_TO_TICKS(MQTT_BROKER_REPROBE_INTERVAL_MS)))
+    {
+        return false;
+    }
+
+    if (0U == broker_endpoints_probe_all(MQTT_BROKER_REPROBE_BUDGET_MS / broker_endpoint_count))
+    {
+        return false;
+    }
+
+    (void) broker_endpoints_order(order);
+    best = &broker_endpoints[order[0]];
+    if ((order[0] == current) ||
+        (broker_endpoints[current].reachable &&
+         ((broker_endpoints_cost(best) + MQTT_BROKER_SWITCH_HYSTERESIS_MS) >
+          broker_endpoints_cost(&broker_endpoints[current]))))
+    {
+        return false;
+    }
+
+    printf("\nBroker '%s' is preferred over '%s'.\n", best->hostname, broker_endpoints[current].hostname);
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name:   broker_endpoints.h
+*
+* Description: This file is the public interface of broker_endpoints.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef BROKER_ENDPOINTS_H_
+#define BROKER_ENDPOINTS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config_store.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* MQTT broker endpoint with its last probe result and connection history. */
+typedef struct
+{
+    char hostname[CONFIG_STORE_MAX_VALUE_LEN + 1];
+    uint16_t port;
+
+    bool reachable;
+    uint32_t latency_ms;
+    uint32_t consecutive_failures;
+} broker_endpoint_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void broker_endpoints_init(void);
+uint32_t broker_endpoints_probe(void);
+uint32_t broker_endpoints_rank(const broker_endpoint_t *endpoints, uint32_t count, uint8_t *order);
+uint32_t broker_endpoints_order(uint8_t *order);
+const broker_endpoint_t *broker_endpoints_get(uint32_t index);
+void broker_endpoints_record(uint32_t index, bool connected);
+bool broker_endpoints_reprobe(uint32_t current);
+
+#endif /* BROKER_ENDPOINTS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,508 @@
+/******************************************************************************
+* File Name:   cert_pinning.c
+*
+* Description: This file contains the server certificate pinning cache. After
+*              a full chain validation, it keeps the SHA-256 of the server
+*              chain and of the trusted CAs it was validated against, so that
+*              a reconnect to the same endpoint presenting the same chain is
+*              accepted with a hash compare. The TLS layer reaches it through
+*              link-time wrappers of the mbedTLS chain verification, enabled
+*              with CERT_PIN_ENABLE in the Makefile.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mbedtls/ecp.h"
+#include "mbedtls/sha256.h"
+
+#include "cert_pinning.h"
+
+#if defined(CERT_PIN_TLS_HOOK)
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* The non-secure link wraps the chain verification of mbedTLS (-Wl,--wrap in
+ * the Makefile). TLS 1.2 verifies the server chain with the restartable
+ * function, TLS 1.3 with the profile one.
+ */
+int __wrap_mbedtls_x509_crt_verify_restartable(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                               mbedtls_x509_crl *ca_crl,
+                                               const mbedtls_x509_crt_profile *profile, const char *cn,
+                                               uint32_t *flags,
+                                               int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                               void *p_vrfy, mbedtls_x509_crt_restart_ctx *rs_ctx);
+int __real_mbedtls_x509_crt_verify_restartable(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                               mbedtls_x509_crl *ca_crl,
+                                               const mbedtls_x509_crt_profile *profile, const char *cn,
+                                               uint32_t *flags,
+                                               int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                               void *p_vrfy, mbedtls_x509_crt_restart_ctx *rs_ctx);
+int __wrap_mbedtls_x509_crt_verify_with_profile(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                                mbedtls_x509_crl *ca_crl,
+                                                const mbedtls_x509_crt_profile *profile, const char *cn,
+                                                uint32_t *flags,
+                                                int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                                void *p_vrfy);
+int __real_mbedtls_x509_crt_verify_with_profile(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                                mbedtls_x509_crl *ca_crl,
+                                                const mbedtls_x509_crt_profile *profile, const char *cn,
+                                                uint32_t *flags,
+                                                int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                                void *p_vrfy);
+#endif /* CERT_PIN_TLS_HOOK */
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Pinned server chain. A match stands in for a full validation only when
+ * that validation is bound to give the same result: the same endpoint, the
+ * same certificates byte for byte (so every signature of the chain has been
+ * checked), the same trusted CAs and profile, no CRL, and a time inside the
+ * validity window of every certificate involved.
+ */
+typedef struct
+{
+    bool valid;
+    char server_name[CERT_PIN_MAX_SERVER_NAME_LEN + 1];
+    uint16_t port;
+    uint8_t chain_hash[CERT_PIN_HASH_SIZE];
+    uint8_t trust_ca_hash[CERT_PIN_HASH_SIZE];
+    const mbedtls_x509_crt_profile *profile;
+    mbedtls_x509_time valid_from;
+    mbedtls_x509_time valid_to;
+} cert_pin_t;
+
+static cert_pin_t cert_pin;
+
+/* Endpoint of the connection in progress, see cert_pin_set_endpoint(). */
+static char cert_pin_endpoint_name[CERT_PIN_MAX_SERVER_NAME_LEN + 1];
+static uint16_t cert_pin_endpoint_port;
+
+/******************************************************************************
+ * Function Name: cert_pin_time_compare
+ ******************************************************************************
+ * Summary:
+ *  Compares two certificate times.
+ *
+ * Parameters:
+ *  const mbedtls_x509_time *a : First time
+ *  const mbedtls_x509_time *b : Second time
+ *
+ * Return:
+ *  int : Negative, zero or positive if 'a' is before, equal to or after 'b'
+ *
+ ******************************************************************************/
+static int cert_pin_time_compare(const mbedtls_x509_time *a, const mbedtls_x509_time *b)
+{
+    const int fields_a[] = { a->year, a->mon, a->day, a->hour, a->min, a->sec };
+    const int fields_b[] = { b->year, b->mon, b->day, b->hour, b->min, b->sec };
+
+    for (size_t i = 0U; i < (sizeof(fields_a) / sizeof(fields_a[0])); i++)
+    {
+        if (fields_a[i] != fields_b[i])
+        {
+            return fields_a[i] - fields_b[i];
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_in_window
+ ******************************************************************************
+ * Summary:
+ *  Checks the current time of the C library clock (the RTC) against a
+ *  validity window. A clock before the start of the window is taken as not
+ *  set, so the pin is not used until the clock is set.
+ *
+ * Parameters:
+ *  const cert_pin_t *pin : Pin holding the window
+ *
+ * Return:
+ *  bool : true if the current time is inside the window, else false
+ *
+ ******************************************************************************/
+static bool cert_pin_in_window(const cert_pin_t *pin)
+{
+    time_t seconds = time(NULL);
+    struct tm calendar;
+    mbedtls_x509_time now;
+
+    if (NULL == gmtime_r(&seconds, &calendar))
+    {
+        return false;
+    }
+
+    now.year = calendar.tm_year + 1900;
+    now.mon = calendar.tm_mon + 1;
+    now.day = calendar.tm_mday;
+    now.hour = calendar.tm_hour;
+    now.min = calendar.tm_min;
+    now.sec = calendar.tm_sec;
+
+    return (cert_pin_time_compare(&now, &pin->valid_from) >= 0) &&
+           (cert_pin_time_compare(&now, &pin->valid_to) <= 0);
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_hash_list
+ ******************************************************************************
+ * Summary:
+ *  Computes the SHA-256 over the DER of every certificate of a list, with
+ *  the length of each certificate in front of it, and narrows a validity
+ *  window to the windows of the certificates.
+ *
+ * Parameters:
+ *  const mbedtls_x509_crt *list : Certificates, may be NULL
+ *  uint8_t *hash : CERT_PIN_HASH_SIZE bytes; set
+ *  cert_pin_t *pin : Pin whose window is narrowed
+ *
+ * Return:
+ *  bool : true on success, false if the digest failed
+ *
+ ******************************************************************************/
+static bool cert_pin_hash_list(const mbedtls_x509_crt *list, uint8_t *hash, cert_pin_t *pin)
+{
+    mbedtls_sha256_context sha256;
+    uint8_t length[4];
+    int ret;
+
+    mbedtls_sha256_init(&sha256);
+    ret = mbedtls_sha256_starts(&sha256, 0);
+    for (; (0 == ret) && (NULL != list) && (NULL != list->raw.p); list = list->next)
+    {
+        length[0] = (uint8_t)(list->raw.len >> 24);
+        length[1] = (uint8_t)(list->raw.len >> 16);
+        length[2] = (uint8_t)(list->raw.len >> 8);
+        length[3] = (uint8_t)list->raw.len;
+        ret = mbedtls_sha256_update(&sha256, length, sizeof(length));
+        if (0 == ret)
+        {
+            ret = mbedtls_sha256_update(&sha256, list->raw.p, list->raw.len);
+        }
+
+        if (cert_pin_time_compare(&list->valid_from, &pin->valid_from) > 0)
+        {
+            pin->valid_from = list->valid_from;
+        }
+        if (cert_pin_time_compare(&list->valid_to, &pin->valid_to) < 0)
+        {
+            pin->valid_to = list->valid_to;
+        }
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_sha256_finish(&sha256, hash);
+    }
+    mbedtls_sha256_free(&sha256);
+
+    return (0 == ret);
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_compute
+ ******************************************************************************
+ * Summary:
+ *  Computes the pin of a verification: its endpoint, the digests of the
+ *  server chain and of the trusted CAs, the profile and the intersection of
+ *  the validity windows of all those certificates.
+ *
+ * Parameters:
+ *  cert_pin_t *pin : Pin; set
+ *  const mbedtls_x509_crt *chain : Chain sent by the server, leaf first
+ *  const mbedtls_x509_crt *trust_ca : Trusted CAs of the verification
+ *  const mbedtls_x509_crt_profile *profile : Profile of the verification
+ *  const char *server_name : Server name of the connection
+ *
+ * Return:
+ *  bool : true on success, else false
+ *
+ ******************************************************************************/
+static bool cert_pin_compute(cert_pin_t *pin, const mbedtls_x509_crt *chain, const mbedtls_x509_crt *trust_ca,
+                             const mbedtls_x509_crt_profile *profile, const char *server_name)
+{
+    memset(pin, 0, sizeof(*pin));
+
+    if ((NULL == chain) || (NULL == server_name) || (strlen(server_name) >= sizeof(pin->server_name)))
+    {
+        return false;
+    }
+
+    strcpy(pin->server_name, server_name);
+    pin->port = cert_pin_endpoint_port;
+    pin->profile = profile;
+    pin->valid_from = chain->valid_from;
+    pin->valid_to = chain->valid_to;
+
+    return cert_pin_hash_list(chain, pin->chain_hash, pin) &&
+           cert_pin_hash_list(trust_ca, pin->trust_ca_hash, pin);
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_clear
+ ******************************************************************************
+ * Summary:
+ *  Drops the pin, so that the next handshake runs a full chain validation.
+ *  Called whenever the trust anchors or the broker endpoint change.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void cert_pin_clear(void)
+{
+    taskENTER_CRITICAL();
+    memset(&cert_pin, 0, sizeof(cert_pin));
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_set_endpoint
+ ******************************************************************************
+ * Summary:
+ *  Sets the broker endpoint of the next connections. A pin recorded for
+ *  another host or port is dropped.
+ *
+ * Parameters:
+ *  const char *hostname : Host name of the broker
+ *  uint16_t port : Port of the broker
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void cert_pin_set_endpoint(const char *hostname, uint16_t port)
+{
+    taskENTER_CRITICAL();
+    (void) snprintf(cert_pin_endpoint_name, sizeof(cert_pin_endpoint_name), "%s", hostname);
+    cert_pin_endpoint_port = port;
+    if ((port != cert_pin.port) || (0 != strcmp(hostname, cert_pin.server_name)))
+    {
+        memset(&cert_pin, 0, sizeof(cert_pin));
+    }
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_record
+ ******************************************************************************
+ * Summary:
+ *  Pins the chain of a server. The caller must have validated the chain in
+ *  full against 'trust_ca' with 'profile', including the server name. The
+ *  pin replaces any previous one.
+ *
+ * Parameters:
+ *  const mbedtls_x509_crt *chain : Validated chain, leaf first
+ *  const mbedtls_x509_crt *trust_ca : Trusted CAs it was validated against
+ *  const mbedtls_x509_crt_profile *profile : Profile of the validation
+ *  const char *server_name : Server name the chain was validated for
+ *
+ * Return:
+ *  bool : true if the chain was pinned, else false
+ *
+ ******************************************************************************/
+bool cert_pin_record(const mbedtls_x509_crt *chain, const mbedtls_x509_crt *trust_ca,
+                     const mbedtls_x509_crt_profile *profile, const char *server_name)
+{
+    cert_pin_t pin;
+
+    if (!cert_pin_compute(&pin, chain, trust_ca, profile, server_name))
+    {
+        cert_pin_clear();
+        return false;
+    }
+    pin.valid = true;
+
+    taskENTER_CRITICAL();
+    cert_pin = pin;
+    taskEXIT_CRITICAL();
+
+    printf("Server chain of '%s:%u' pinned until %04d-%02d-%02d.\n", server_name, (unsigned int)pin.port,
+           pin.valid_to.year, pin.valid_to.mon, pin.valid_to.day);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: cert_pin_match
+ ******************************************************************************
+ * Summary:
+ *  Fast path of a reconnect: checks a verification against the pin. It
+ *  matches if the endpoint, the server chain, the trusted CAs and the
+ *  profile are those of the pinned validation, no CRL is given and the
+ *  clock is inside the validity window of all the certificates. The
+ *  handshake itself proves that the server holds the private key of the
+ *  leaf. The digests are always computed, so the cost of a check does not
+ *  depend on its result.
+ *
+ * Parameters:
+ *  const mbedtls_x509_crt *chain : Chain sent by the server, leaf first
+ *  const mbedtls_x509_crt *trust_ca : Trusted CAs of the verification
+ *  const mbedtls_x509_crl *ca_crl : CRLs of the verification, may be NULL
+ *  const mbedtls_x509_crt_profile *profile : Profile of the verification
+ *  const char *server_name : Server name of the connection
+ *
+ * Return:
+ *  bool : true if the verification matches the pin, else false
+ *
+ ******************************************************************************/
+bool cert_pin_match(const mbedtls_x509_crt *chain, const mbedtls_x509_crt *trust_ca,
+                    const mbedtls_x509_crl *ca_crl, const mbedtls_x509_crt_profile *profile,
+                    const char *server_name)
+{
+    cert_pin_t pin;
+    cert_pin_t current;
+
+    if (!cert_pin_compute(&current, chain, trust_ca, profile, server_name))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    pin = cert_pin;
+    taskEXIT_CRITICAL();
+
+    return pin.valid && (NULL == ca_crl) && (current.port == pin.port) &&
+           (0 == strcmp(current.server_name, pin.server_name)) &&
+           (0 == memcmp(current.chain_hash, pin.chain_hash, sizeof(pin.chain_hash))) &&
+           (0 == memcmp(current.trust_ca_hash, pin.trust_ca_hash, sizeof(pin.trust_ca_hash))) &&
+           (current.profile == pin.profile) && cert_pin_in_window(&pin);
+}
+
+#if defined(CERT_PIN_TLS_HOOK)
+/******************************************************************************
+ * Function Name: __wrap_mbedtls_x509_crt_verify_restartable
+ ******************************************************************************
+ * Summary:
+ *  Replaces mbedtls_x509_crt_verify_restartable() at link time. A chain
+ *  that matches the pin (see cert_pin_match()) is accepted without checking
+ *  its signatures again; any other chain is validated in full. A successful
+ *  full validation pins the chain, a failed one drops the pin. Verifications
+ *  with a verify callback always run in full, since the callback could
+ *  reject a chain the pin would accept.
+ *
+ * Parameters:
+ *  As mbedtls_x509_crt_verify_restartable(); 'crt' is the chain sent by the
+ *  server, leaf first, and 'cn' the server name of the connection
+ *
+ * Return:
+ *  int : 0 if the chain is accepted, else the mbedTLS error
+ *
+ ******************************************************************************/
+int __wrap_mbedtls_x509_crt_verify_restartable(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                               mbedtls_x509_crl *ca_crl,
+                                               const mbedtls_x509_crt_profile *profile, const char *cn,
+                                               uint32_t *flags,
+                                               int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                               void *p_vrfy, mbedtls_x509_crt_restart_ctx *rs_ctx)
+{
+    int ret;
+
+    if ((NULL == f_vrfy) && cert_pin_match(crt, trust_ca, ca_crl, profile, cn))
+    {
+        *flags = 0U;
+        return 0;
+    }
+
+    ret = __real_mbedtls_x509_crt_verify_restartable(crt, trust_ca, ca_crl, profile, cn, flags,
+                                                     f_vrfy, p_vrfy, rs_ctx);
+    if ((0 == ret) && (NULL == f_vrfy) && (NULL == ca_crl))
+    {
+        (void) cert_pin_record(crt, trust_ca, profile, cn);
+    }
+    else if (MBEDTLS_ERR_ECP_IN_PROGRESS != ret)
+    {
+        cert_pin_clear();
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+ * Function Name: __wrap_mbedtls_x509_crt_verify_with_profile
+ ******************************************************************************
+ * Summary:
+ *  Replaces mbedtls_x509_crt_verify_with_profile() at link time, with the
+ *  pin handled as in __wrap_mbedtls_x509_crt_verify_restartable().
+ *
+ * Parameters:
+ *  As mbedtls_x509_crt_verify_with_profile()
+ *
+ * Return:
+ *  int : 0 if the chain is accepted, else the mbedTLS error
+ *
+ ******************************************************************************/
+int __wrap_mbedtls_x509_crt_verify_with_profile(mbedtls_x509_crt *crt, mbedtls_x509_crt *trust_ca,
+                                                mbedtls_x509_crl *ca_crl,
+                                                const mbedtls_x509_crt_profile *profile, const char *cn,
+                                                uint32_t *flags,
+                                                int (*f_vrfy)(void *, mbedtls_x509_crt *, int, uint32_t *),
+                                                void *p_vrfy)
+{
+    int ret;
+
+    if ((NULL == f_vrfy) && cert_pin_match(crt, trust_ca, ca_crl, profile, cn))
+    {
+        *flags = 0U;
+        return 0;
+    }
+
+    ret = __real_mbedtls_x509_crt_verify_with_profile(crt, trust_ca, ca_crl, profile, cn, flags,
+                                                      f_vrfy, p_vrfy);
+    if ((0 == ret) && (NULL == f_vrfy) && (NULL == ca_crl))
+    {
+        (void) cert_pin_record(crt, trust_ca, profile, cn);
+    }
+    else
+    {
+        cert_pin_clear();
+    }
+
+    return ret;
+}
+#endif /* CERT_PIN_TLS_HOOK */
+
+/* [] END OF FILE */
@@ -0,0 +1,72 @@
+/******************************************************************************
+* File Name:   cert_pinning.h
+*
+* Description: This file is the public interface of cert_pinning.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CERT_PINNING_H_
+#define CERT_PINNING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mbedtls/x509_crt.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the pinned SHA-256 digest of the SubjectPublicKeyInfo. */
+#define CERT_PIN_HASH_SIZE                  (32U)
+
+/* Longest server name that can be pinned: a full DNS name. */
+#define CERT_PIN_MAX_SERVER_NAME_LEN        (253U)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void cert_pin_clear(void);
+void cert_pin_set_endpoint(const char *hostname, uint16_t port);
+bool cert_pin_record(const mbedtls_x509_crt *chain, const mbedtls_x509_crt *trust_ca,
+                     const mbedtls_x509_crt_profile *profile, const char *server_name);
+bool cert_pin_match(const mbedtls_x509_crt *chain, const mbedtls_x509_crt *trust_ca,
+                    const mbedtls_x509_crl *ca_crl, const mbedtls_x509_crt_profile *profile,
+                    const char *server_name);
+
+#endif /* CERT_PINNING_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,548 @@
+/******************************************************************************
+* File Name:   config_command.c
+*
+* Description: This file contains the handler of the
+*              MQTT_SUB_TOPIC_COMMAND_CONFIG topic. The JSON payload is
+*              parsed in place and every known top-level key is bound to a
+*              typed setter. Updates are applied only if the whole payload is
+*              valid.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "cybsp.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+#include "config_command.h"
+#include "config_store.h"
+#include "json_parser.h"
+#include "publisher_task.h"
+#include "subscriber_task.h"
+#include "sampling_scheduler.h"
+#include "mqtt_client_config.h"
+#include "cert_pinning.h"
+#include "cy_wcm.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Limits of the vital signs sampling period. */
+#define CONFIG_SAMPLE_PERIOD_MIN_MS         (1000U)
+#define CONFIG_SAMPLE_PERIOD_MAX_MS         (3600000U)
+
+/* Limits of the connection settings. */
+#define CONFIG_CONN_RETRIES_MAX             (1000U)
+#define CONFIG_KEEP_ALIVE_MIN_SEC           (10U)
+#define CONFIG_KEEP_ALIVE_MAX_SEC           (3600U)
+
+/* Size of the buffer staging the string values of one payload. */
+#define CONFIG_STRING_STAGING_SIZE          (256U)
+
+/* Size of the acknowledgement published on MQTT_PUB_TOPIC_COMMAND_ACK. */
+#define CONFIG_ACK_PAYLOAD_SIZE             (96U)
+
+#if (CONFIG_ACK_PAYLOAD_SIZE > PUBLISHER_COPY_PAYLOAD_SIZE)
+    #error "CONFIG_ACK_PAYLOAD_SIZE exceeds what the publisher can copy!"
+#endif
+
+#if (JSON_TOKEN_BUFFER_SIZE < CONFIG_STORE_MAX_VALUE_LEN)
+    #error "JSON_TOKEN_BUFFER_SIZE cannot hold the longest configuration value split across chunks!"
+#endif
+
+/* Number of entries in the binding table. */
+#define CONFIG_BINDING_COUNT                (sizeof(config_bindings) / sizeof(config_bindings[0]))
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool config_set_sample_period(uint32_t value);
+static bool config_set_log_level(uint32_t value);
+static bool config_set_led(uint32_t value);
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+volatile uint32_t tesaiot_debug_level = TESAIOT_DEBUG_LEVEL;
+
+/* Keys accepted on the configuration topic. */
+static const config_binding_t config_bindings[] =
+{
+    { CONFIG_KEY_SAMPLE_PERIOD, CONFIG_TYPE_UINT, CONFIG_SAMPLE_PERIOD_MIN_MS,
+      CONFIG_SAMPLE_PERIOD_MAX_MS, true, config_set_sample_period },
+    { "log_level", CONFIG_TYPE_UINT, TESAIOT_DEBUG_LEVEL_NONE,
+      TESAIOT_DEBUG_LEVEL_VERBOSE, false, config_set_log_level },
+    { "led", CONFIG_TYPE_BOOL, 0U, 1U, false, config_set_led },
+
+    /* Connection settings, used from the next (re)connection on. */
+    { CONFIG_KEY_WIFI_RETRIES, CONFIG_TYPE_UINT, 1U, CONFIG_CONN_RETRIES_MAX, true, NULL },
+    { CONFIG_KEY_MQTT_RETRIES, CONFIG_TYPE_UINT, 1U, CONFIG_CONN_RETRIES_MAX, true, NULL },
+    { CONFIG_KEY_MQTT_KEEP_ALIVE, CONFIG_TYPE_UINT, CONFIG_KEEP_ALIVE_MIN_SEC,
+      CONFIG_KEEP_ALIVE_MAX_SEC, true, NULL },
+
+#if CONFIG_COMMAND_REMOTE_CONNECTION_KEYS
+    /* Network, broker and credentials; see CONFIG_COMMAND_REMOTE_CONNECTION_KEYS. */
+    { CONFIG_KEY_WIFI_SSID, CONFIG_TYPE_STRING, 1U, CY_WCM_MAX_SSID_LEN, true, NULL },
+    { CONFIG_KEY_WIFI_PASSWORD, CONFIG_TYPE_STRING, 0U, CY_WCM_MAX_PASSPHRASE_LEN, true, NULL },
+    { CONFIG_KEY_MQTT_BROKER, CONFIG_TYPE_STRING, 1U, CONFIG_STORE_MAX_VALUE_LEN, true, NULL },
+    { CONFIG_KEY_MQTT_PORT, CONFIG_TYPE_UINT, 1U, UINT16_MAX, true, NULL },
+    { CONFIG_KEY_MQTT_USERNAME, CONFIG_TYPE_STRING, 0U, CONFIG_STORE_MAX_VALUE_LEN, true, NULL },
+    { CONFIG_KEY_MQTT_PASSWORD, CONFIG_TYPE_STRING, 0U, CONFIG_STORE_MAX_VALUE_LEN, true, NULL }
+#endif /* CONFIG_COMMAND_REMOTE_CONNECTION_KEYS */
+};
+
+/* Values collected while parsing, applied once the payload is complete. For
+ * strings the value is the offset of the string in 'strings'.
+ */
+typedef struct
+{
+    int32_t binding;
+    uint32_t staged_mask;
+    uint32_t values[CONFIG_BINDING_COUNT];
+    uint16_t lengths[CONFIG_BINDING_COUNT];
+    char strings[CONFIG_STRING_STAGING_SIZE];
+    uint32_t strings_used;
+} config_update_t;
+
+
+/******************************************************************************
+ * Function Name: config_set_sample_period
+ ******************************************************************************
+ * Summary:
+ *  Setter of 'sample_period_ms': sampling period of the vital signs.
+ *
+ * Parameters:
+ *  uint32_t value : Period in milliseconds
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_set_sample_period(uint32_t value)
+{
+    return sampling_scheduler_set_period("vitals", value);
+}
+
+/******************************************************************************
+ * Function Name: config_set_log_level
+ ******************************************************************************
+ * Summary:
+ *  Setter of 'log_level': verbosity of the debug UART output.
+ *
+ * Parameters:
+ *  uint32_t value : One of TESAIOT_DEBUG_LEVEL_*
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_set_log_level(uint32_t value)
+{
+    tesaiot_debug_level = value;
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_set_led
+ ******************************************************************************
+ * Summary:
+ *  Setter of 'led': state of the user LED, as with the "TURN ON" and
+ *  "TURN OFF" messages.
+ *
+ * Parameters:
+ *  uint32_t value : 1 to turn the LED on, 0 to turn it off
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_set_led(uint32_t value)
+{
+    subscriber_data_t subscriber_q_data =
+    {
+        .cmd = UPDATE_DEVICE_STATE,
+        .data = (0U != value) ? DEVICE_ON_STATE : DEVICE_OFF_STATE
+    };
+
+    return (pdPASS == xQueueSend(subscriber_task_q, &subscriber_q_data, portMAX_DELAY));
+}
+
+/******************************************************************************
+ * Function Name: config_parse_uint
+ ******************************************************************************
+ * Summary:
+ *  Converts a JSON number token to an unsigned integer.
+ *
+ * Parameters:
+ *  const char *text : Number token
+ *  size_t length : Length of the token
+ *  uint32_t *value : Converted value; set
+ *
+ * Return:
+ *  bool : false if the token is not a non-negative integer or overflows
+ *
+ ******************************************************************************/
+static bool config_parse_uint(const char *text, size_t length, uint32_t *value)
+{
+    uint32_t result = 0U;
+    uint32_t digit;
+
+    if (0U == length)
+    {
+        return false;
+    }
+
+    for (size_t i = 0U; i < length; i++)
+    {
+        if ((text[i] < '0') || (text[i] > '9'))
+        {
+            return false;
+        }
+
+        digit = (uint32_t)(text[i] - '0');
+        if (result > ((UINT32_MAX - digit) / 10U))
+        {
+            return false;
+        }
+        result = (result * 10U) + digit;
+    }
+
+    *value = result;
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_find_binding
+ ******************************************************************************
+ * Summary:
+ *  Looks up the binding of a key.
+ *
+ * Parameters:
+ *  const char *key : Key token, not NUL-terminated
+ *  size_t length : Length of the key
+ *
+ * Return:
+ *  int32_t : Index into config_bindings, or -1 for an unknown key
+ *
+ ******************************************************************************/
+static int32_t config_find_binding(const char *key, size_t length)
+{
+    for (uint32_t i = 0U; i < CONFIG_BINDING_COUNT; i++)
+    {
+        if ((strlen(config_bindings[i].key) == length) &&
+            (0 == memcmp(config_bindings[i].key, key, length)))
+        {
+            return (int32_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/******************************************************************************
+ * Function Name: config_parser_callback
+ ******************************************************************************
+ * Summary:
+ *  JSON parser callback. Stages the value of every bound top-level key.
+ *  Unknown keys are skipped; a value of the wrong type or out of range
+ *  rejects the whole payload. Strings with escape sequences are rejected.
+ *
+ * Parameters:
+ *  void *context : Update being collected (config_update_t)
+ *  json_event_t event : Parser event
+ *  uint32_t depth : Nesting depth of the event
+ *  const char *text : Token text
+ *  size_t length : Token length
+ *
+ * Return:
+ *  bool : false to abort the parse
+ *
+ ******************************************************************************/
+static bool config_parser_callback(void *context, json_event_t event, uint32_t depth,
+                                   const char *text, size_t length)
+{
+    config_update_t *update = (config_update_t *)context;
+    const config_binding_t *binding;
+    uint32_t value;
+
+    if (0U == depth)
+    {
+        /* The payload must be a single object. */
+        return ((JSON_EVENT_OBJECT_START == event) || (JSON_EVENT_OBJECT_END == event));
+    }
+
+    if (1U != depth)
+    {
+        return true;
+    }
+
+    if (JSON_EVENT_KEY == event)
+    {
+        update->binding = config_find_binding(text, length);
+        if (update->binding < 0)
+        {
+            printf("  Config: Unknown key '%.*s' ignored\n", (int)length, text);
+        }
+        return true;
+    }
+
+    if (update->binding < 0)
+    {
+        return true;
+    }
+
+    binding = &config_bindings[update->binding];
+    switch (event)
+    {
+        case JSON_EVENT_NUMBER:
+            if ((CONFIG_TYPE_UINT != binding->type) || !config_parse_uint(text, length, &value))
+            {
+                return false;
+            }
+            break;
+
+        case JSON_EVENT_TRUE:
+        case JSON_EVENT_FALSE:
+            if (CONFIG_TYPE_BOOL != binding->type)
+            {
+                return false;
+            }
+            value = (JSON_EVENT_TRUE == event) ? 1U : 0U;
+            break;
+
+        case JSON_EVENT_STRING:
+            if ((CONFIG_TYPE_STRING != binding->type) || (NULL != memchr(text, '\\', length)) ||
+                (length > (CONFIG_STRING_STAGING_SIZE - update->strings_used)))
+            {
+                return false;
+            }
+            memcpy(&update->strings[update->strings_used], text, length);
+            update->values[update->binding] = update->strings_used;
+            update->lengths[update->binding] = (uint16_t)length;
+            update->strings_used += length;
+            value = (uint32_t)length;
+            break;
+
+        default:
+            return false;
+    }
+
+    if ((value < binding->min) || (value > binding->max))
+    {
+        printf("  Config: '%s' out of range [%lu, %lu]\n", binding->key,
+               (unsigned long)binding->min, (unsigned long)binding->max);
+        return false;
+    }
+
+    if (CONFIG_TYPE_STRING != binding->type)
+    {
+        update->values[update->binding] = value;
+    }
+    update->staged_mask |= (1UL << update->binding);
+    update->binding = -1;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_update_persist
+ ******************************************************************************
+ * Summary:
+ *  Writes all staged values of persisted keys to the configuration store in
+ *  a single transaction. Unsigned and boolean values are stored as 4 bytes
+ *  little endian.
+ *
+ * Parameters:
+ *  const config_update_t *update : Staged values
+ *
+ * Return:
+ *  bool : true if there was nothing to persist or the transaction committed
+ *
+ ******************************************************************************/
+static bool config_update_persist(const config_update_t *update)
+{
+    const config_binding_t *binding;
+    uint8_t number[sizeof(uint32_t)];
+    bool staged = false;
+    bool result;
+
+    for (uint32_t i = 0U; (i < CONFIG_BINDING_COUNT) && !staged; i++)
+    {
+        staged = config_bindings[i].persist && (0U != (update->staged_mask & (1UL << i)));
+    }
+    if (!staged)
+    {
+        return true;
+    }
+
+    result = config_store_begin();
+    for (uint32_t i = 0U; result && (i < CONFIG_BINDING_COUNT); i++)
+    {
+        binding = &config_bindings[i];
+        if (!binding->persist || (0U == (update->staged_mask & (1UL << i))))
+        {
+            continue;
+        }
+
+        if (CONFIG_TYPE_STRING == binding->type)
+        {
+            result = config_store_set(binding->key, &update->strings[update->values[i]],
+                                      update->lengths[i]);
+        }
+        else
+        {
+            number[0] = (uint8_t)(update->values[i]);
+            number[1] = (uint8_t)(update->values[i] >> 8);
+            number[2] = (uint8_t)(update->values[i] >> 16);
+            number[3] = (uint8_t)(update->values[i] >> 24);
+            result = config_store_set(binding->key, number, sizeof(number));
+        }
+    }
+
+    if (result)
+    {
+        return config_store_commit();
+    }
+
+    config_store_abort();
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: config_command_handle
+ ******************************************************************************
+ * Summary:
+ *  Handles a payload received on the configuration topic, e.g.
+ *  {"sample_period_ms":30000,"log_level":2}. The payload is parsed in place.
+ *  Once it has been validated, the persisted keys are committed to the
+ *  configuration store together and the setters of the staged keys are
+ *  called. The result is acknowledged on MQTT_PUB_TOPIC_COMMAND_ACK.
+ *
+ * Parameters:
+ *  const char *payload : Received payload, not NUL-terminated
+ *  size_t length : Length of the payload
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void config_command_handle(const char *payload, size_t length)
+{
+    json_parser_t parser;
+    json_status_t status;
+    /* Kept off the stack of the MQTT receive thread. */
+    static config_update_t update;
+    char ack_payload[CONFIG_ACK_PAYLOAD_SIZE];
+    uint32_t applied = 0U;
+#if CONFIG_COMMAND_LOG_PARSE_CYCLES
+    uint32_t cycles;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    cycles = DWT->CYCCNT;
+#endif /* CONFIG_COMMAND_LOG_PARSE_CYCLES */
+
+    memset(&update, 0, sizeof(update));
+    update.binding = -1;
+
+    json_parser_init(&parser, config_parser_callback, &update);
+    status = json_parser_feed(&parser, payload, length);
+    if (JSON_STATUS_INCOMPLETE == status)
+    {
+        status = json_parser_finish(&parser);
+    }
+
+#if CONFIG_COMMAND_LOG_PARSE_CYCLES
+    cycles = DWT->CYCCNT - cycles;
+    printf("  Config: Parsed %u bytes in %lu cycles (%lu bytes per 1000 cycles)\n",
+           (unsigned int)length, (unsigned long)cycles,
+           (unsigned long)((0U == cycles) ? 0U : (((uint64_t)length * 1000U) / cycles)));
+#endif /* CONFIG_COMMAND_LOG_PARSE_CYCLES */
+
+    if (JSON_STATUS_DONE != status)
+    {
+        printf("  Config: Invalid payload, nothing applied\n");
+        snprintf(ack_payload, sizeof(ack_payload), "{\"config\":\"rejected\"}");
+    }
+    else if (!config_update_persist(&update))
+    {
+        printf("  Config: Failed to store the configuration, nothing applied\n");
+        snprintf(ack_payload, sizeof(ack_payload), "{\"config\":\"store_failed\"}");
+    }
+    else
+    {
+        for (uint32_t i = 0U; i < CONFIG_BINDING_COUNT; i++)
+        {
+            if (0U == (update.staged_mask & (1UL << i)))
+            {
+                continue;
+            }
+
+#if CONFIG_COMMAND_REMOTE_CONNECTION_KEYS
+            /* A pinned server chain must not outlive a change of the broker. */
+            if ((0 == strcmp(config_bindings[i].key, CONFIG_KEY_MQTT_BROKER)) ||
+                (0 == strcmp(config_bindings[i].key, CONFIG_KEY_MQTT_PORT)))
+            {
+                cert_pin_clear();
+            }
+#endif /* CONFIG_COMMAND_REMOTE_CONNECTION_KEYS */
+
+            if (CONFIG_TYPE_STRING == config_bindings[i].type)
+            {
+                printf("  Config: '%s' stored\n", config_bindings[i].key);
+                applied++;
+            }
+            else if ((NULL == config_bindings[i].set) || config_bindings[i].set(update.values[i]))
+            {
+                printf("  Config: '%s' set to %lu\n", config_bindings[i].key,
+                       (unsigned long)update.values[i]);
+                applied++;
+            }
+            else
+            {
+                printf("  Config: Failed to set '%s'\n", config_bindings[i].key);
+            }
+        }
+        snprintf(ack_payload, sizeof(ack_payload),
+                 "{\"config\":\"applied\",\"keys\":%lu}", (unsigned long)applied);
+    }
+
+    (void) publisher_enqueue_copy(PUBLISHER_LANE_URGENT, MQTT_PUB_TOPIC_COMMAND_ACK, ack_payload);
+}
+
+/* [] END OF FILE */
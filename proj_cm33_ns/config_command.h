@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   config_command.h
+*
+* Description: This file is the public interface of config_command.c, which
+*              applies runtime configuration updates received on the
+*              MQTT_SUB_TOPIC_COMMAND_CONFIG topic.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CONFIG_COMMAND_H_
+#define CONFIG_COMMAND_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set to 1 to log the cycle count of every parsed configuration payload. */
+#define CONFIG_COMMAND_LOG_PARSE_CYCLES     (0)
+
+/* Set to 1 to accept the Wi-Fi and broker settings and credentials on the
+ * configuration topic. Anyone allowed to publish on that topic could then
+ * move the device to another network or broker, so enable it only with a
+ * broker whose ACL restricts the topic to the platform. Off by default: the
+ * keys are ignored like unknown ones.
+ */
+#define CONFIG_COMMAND_REMOTE_CONNECTION_KEYS   (0)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Value types of configuration keys. */
+typedef enum
+{
+    CONFIG_TYPE_UINT,
+    CONFIG_TYPE_BOOL,
+    CONFIG_TYPE_STRING
+} config_type_t;
+
+/* Binds a top-level key of the configuration payload to a setter and/or the
+ * configuration store. Unsigned values must lie within [min, max], string
+ * lengths within [min, max]; booleans are passed as 0 or 1. Persisted keys
+ * are written to the store under the same key in one transaction.
+ */
+typedef struct
+{
+    const char *key;
+    config_type_t type;
+    uint32_t min;
+    uint32_t max;
+    bool persist;
+    bool (*set)(uint32_t value);
+} config_binding_t;
+
+/*******************************************************************************
+* Extern Variables
+********************************************************************************/
+/* Runtime log level, one of TESAIOT_DEBUG_LEVEL_*. */
+extern volatile uint32_t tesaiot_debug_level;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void config_command_handle(const char *payload, size_t length);
+
+#endif /* CONFIG_COMMAND_H_ */
+
+/* [] END OF FILE */
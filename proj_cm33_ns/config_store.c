@@ -0,0 +1,984 @@
+/******************************************************************************
+* File Name:   config_store.c
+*
+* Description: This file contains the persistent key/value configuration
+*              store. The user_nvm region is split into two banks holding a
+*              log of transactions; a RAM hash index maps every key to its
+*              latest committed record for constant time lookups. A
+*              transaction only takes effect once its commit record with a
+*              matching CRC is written, so a power loss during a commit
+*              leaves the previous values in place.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "config_store.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Each bank starts with a header; the bank with the valid header and the
+ * highest generation is active.
+ */
+#define CONFIG_STORE_BANK_COUNT             (2U)
+#define CONFIG_STORE_BANK_MAGIC             (0x53474643UL)  /* "CFGS" */
+#define CONFIG_STORE_BANK_HEADER_SIZE       (16U)
+
+/* Record types. Erased memory reads as CONFIG_RECORD_ERASED. */
+#define CONFIG_RECORD_BEGIN                 (0xB0U)
+#define CONFIG_RECORD_VALUE                 (0x4BU)
+#define CONFIG_RECORD_COMMIT                (0xC0U)
+#define CONFIG_RECORD_ERASED                (0xFFU)
+
+/* Record header: type, key length, value length (little endian). Records
+ * are padded to CONFIG_RECORD_ALIGN bytes.
+ */
+#define CONFIG_RECORD_HEADER_SIZE           (4U)
+#define CONFIG_RECORD_ALIGN                 (4U)
+#define CONFIG_RECORD_SIZE(key_len, value_len) \
+    ((CONFIG_RECORD_HEADER_SIZE + (key_len) + (value_len) + CONFIG_RECORD_ALIGN - 1U) & \
+     ~(CONFIG_RECORD_ALIGN - 1U))
+
+/* A commit record carries the CRC-32 of the transaction from its begin
+ * record up to the commit record.
+ */
+#define CONFIG_COMMIT_VALUE_SIZE            (4U)
+
+/* Open addressing hash index; a power of two larger than the key limit. */
+#define CONFIG_STORE_INDEX_SLOTS            (64U)
+
+/* Chunk size used to erase the RRAM. */
+#define CONFIG_STORE_ERASE_CHUNK            (64U)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Entry of the hash index. An offset of 0 marks an empty slot. */
+typedef struct
+{
+    uint32_t hash;
+    uint16_t offset;
+} config_index_entry_t;
+
+/* Bank header. */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t generation;
+    uint32_t crc;
+    uint32_t reserved;
+} config_bank_header_t;
+
+static const config_store_nvm_t *config_nvm;
+static SemaphoreHandle_t config_store_mutex;
+
+static uint32_t config_active_bank;
+static uint32_t config_generation;
+static uint32_t config_write_offset;
+static bool config_needs_compaction;
+
+static config_index_entry_t config_index[CONFIG_STORE_INDEX_SLOTS];
+static uint32_t config_key_count;
+
+static uint8_t config_txn_buffer[CONFIG_STORE_TXN_BUFFER_SIZE];
+static uint32_t config_txn_length;
+static bool config_txn_open;
+
+/* Offsets of the value records of the transaction being loaded. */
+static uint16_t config_load_pending[CONFIG_STORE_MAX_KEYS];
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool config_store_rram_write(uint32_t offset, const uint8_t *data, uint32_t length);
+static bool config_store_rram_erase(uint32_t offset, uint32_t length);
+
+/* Default backend: the user_nvm region of the RRAM. */
+static const config_store_nvm_t config_store_rram =
+{
+    .base = (const uint8_t *)CYMEM_CM33_0_user_nvm_START,
+    .size = CYMEM_CM33_0_user_nvm_SIZE,
+    .write = config_store_rram_write,
+    .erase = config_store_rram_erase
+};
+
+/******************************************************************************
+ * Function Name: config_store_rram_write
+ ******************************************************************************
+ * Summary:
+ *  Writes to the user_nvm region of the RRAM.
+ *
+ * Parameters:
+ *  uint32_t offset : Offset in the region
+ *  const uint8_t *data : Data to be written
+ *  uint32_t length : Number of bytes
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_store_rram_write(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    return (CY_RRAM_SUCCESS == Cy_RRAM_NvmWriteByteArray(RRAMC0,
+                                                         CYMEM_CM33_0_user_nvm_START + offset,
+                                                         data, length));
+}
+
+/******************************************************************************
+ * Function Name: config_store_rram_erase
+ ******************************************************************************
+ * Summary:
+ *  Fills part of the user_nvm region with 0xFF. The RRAM needs no erase
+ *  before writing, this only resets the region to the erased pattern.
+ *
+ * Parameters:
+ *  uint32_t offset : Offset in the region
+ *  uint32_t length : Number of bytes
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_store_rram_erase(uint32_t offset, uint32_t length)
+{
+    uint8_t erased[CONFIG_STORE_ERASE_CHUNK];
+    uint32_t chunk;
+
+    memset(erased, CONFIG_RECORD_ERASED, sizeof(erased));
+    while (length > 0U)
+    {
+        chunk = (length < sizeof(erased)) ? length : sizeof(erased);
+        if (!config_store_rram_write(offset, erased, chunk))
+        {
+            return false;
+        }
+        offset += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_crc32
+ ******************************************************************************
+ * Summary:
+ *  Computes the CRC-32 (IEEE 802.3) of a buffer.
+ *
+ * Parameters:
+ *  const uint8_t *data : Buffer
+ *  uint32_t length : Length of the buffer
+ *
+ * Return:
+ *  uint32_t : CRC-32
+ *
+ ******************************************************************************/
+static uint32_t config_store_crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint32_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
+
+/******************************************************************************
+ * Function Name: config_store_hash
+ ******************************************************************************
+ * Summary:
+ *  Computes the FNV-1a hash of a key.
+ *
+ * Parameters:
+ *  const char *key : Key
+ *  uint32_t length : Length of the key
+ *
+ * Return:
+ *  uint32_t : Hash
+ *
+ ******************************************************************************/
+static uint32_t config_store_hash(const char *key, uint32_t length)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/******************************************************************************
+ * Function Name: config_store_bank
+ ******************************************************************************
+ * Summary:
+ *  Returns the memory-mapped view of a bank.
+ *
+ * Parameters:
+ *  uint32_t bank : Bank number
+ *
+ * Return:
+ *  const uint8_t * : Start of the bank
+ *
+ ******************************************************************************/
+static const uint8_t *config_store_bank(uint32_t bank)
+{
+    return config_nvm->base + (bank * (config_nvm->size / CONFIG_STORE_BANK_COUNT));
+}
+
+/******************************************************************************
+ * Function Name: config_store_bank_size
+ ******************************************************************************
+ * Summary:
+ *  Returns the size of a bank.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Size of a bank in bytes
+ *
+ ******************************************************************************/
+static uint32_t config_store_bank_size(void)
+{
+    return config_nvm->size / CONFIG_STORE_BANK_COUNT;
+}
+
+/******************************************************************************
+ * Function Name: config_store_index_find
+ ******************************************************************************
+ * Summary:
+ *  Finds the index slot of a key, or the empty slot where it would go.
+ *
+ * Parameters:
+ *  const char *key : Key
+ *  uint32_t key_len : Length of the key
+ *  uint32_t hash : Hash of the key
+ *
+ * Return:
+ *  config_index_entry_t * : Slot of the key, or an empty slot
+ *
+ ******************************************************************************/
+static config_index_entry_t *config_store_index_find(const char *key, uint32_t key_len, uint32_t hash)
+{
+    const uint8_t *bank = config_store_bank(config_active_bank);
+    config_index_entry_t *entry;
+    const uint8_t *record;
+
+    for (uint32_t probe = 0U; probe < CONFIG_STORE_INDEX_SLOTS; probe++)
+    {
+        entry = &config_index[(hash + probe) & (CONFIG_STORE_INDEX_SLOTS - 1U)];
+        if (0U == entry->offset)
+        {
+            return entry;
+        }
+
+        record = &bank[entry->offset];
+        if ((entry->hash == hash) && (record[1] == key_len) &&
+            (0 == memcmp(&record[CONFIG_RECORD_HEADER_SIZE], key, key_len)))
+        {
+            return entry;
+        }
+    }
+
+    /* Not reached: the index is never more than half full. */
+    return NULL;
+}
+
+/******************************************************************************
+ * Function Name: config_store_index_add
+ ******************************************************************************
+ * Summary:
+ *  Points the index entry of the key of a value record at that record.
+ *
+ * Parameters:
+ *  uint16_t offset : Offset of the value record in the active bank
+ *
+ * Return:
+ *  bool : false if the key limit is reached
+ *
+ ******************************************************************************/
+static bool config_store_index_add(uint16_t offset)
+{
+    const uint8_t *record = &config_store_bank(config_active_bank)[offset];
+    const char *key = (const char *)&record[CONFIG_RECORD_HEADER_SIZE];
+    uint32_t hash = config_store_hash(key, record[1]);
+    config_index_entry_t *entry = config_store_index_find(key, record[1], hash);
+
+    if (0U == entry->offset)
+    {
+        if (CONFIG_STORE_MAX_KEYS <= config_key_count)
+        {
+            return false;
+        }
+        config_key_count++;
+    }
+
+    entry->hash = hash;
+    entry->offset = offset;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_load_bank
+ ******************************************************************************
+ * Summary:
+ *  Rebuilds the index from the log of the active bank. Value records are
+ *  indexed only when the commit record of their transaction is intact; a
+ *  torn or uncommitted tail is ignored and marks the bank for compaction.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void config_store_load_bank(void)
+{
+    const uint8_t *bank = config_store_bank(config_active_bank);
+    uint32_t bank_size = config_store_bank_size();
+    uint32_t offset = CONFIG_STORE_BANK_HEADER_SIZE;
+    uint32_t txn_start = 0U;
+    uint32_t pending_count = 0U;
+    uint32_t record_size;
+    uint32_t crc;
+    uint16_t value_len;
+    uint8_t type;
+
+    memset(config_index, 0, sizeof(config_index));
+    config_key_count = 0U;
+    config_needs_compaction = false;
+
+    while ((offset + CONFIG_RECORD_HEADER_SIZE) <= bank_size)
+    {
+        type = bank[offset];
+        if (CONFIG_RECORD_ERASED == type)
+        {
+            break;
+        }
+
+        value_len = (uint16_t)(bank[offset + 2U] | (bank[offset + 3U] << 8));
+        record_size = CONFIG_RECORD_SIZE(bank[offset + 1U], value_len);
+        if ((offset + record_size) > bank_size)
+        {
+            config_needs_compaction = true;
+            break;
+        }
+
+        if (CONFIG_RECORD_BEGIN == type)
+        {
+            txn_start = offset;
+            pending_count = 0U;
+        }
+        else if ((CONFIG_RECORD_VALUE == type) && (0U != txn_start) &&
+                 (CONFIG_STORE_MAX_KEYS > pending_count))
+        {
+            config_load_pending[pending_count++] = (uint16_t)offset;
+        }
+        else if ((CONFIG_RECORD_COMMIT == type) && (0U != txn_start) &&
+                 (CONFIG_COMMIT_VALUE_SIZE == value_len))
+        {
+            memcpy(&crc, &bank[offset + CONFIG_RECORD_HEADER_SIZE], sizeof(crc));
+            if (crc != config_store_crc32(&bank[txn_start], offset - txn_start))
+            {
+                config_needs_compaction = true;
+                break;
+            }
+
+            for (uint32_t i = 0U; i < pending_count; i++)
+            {
+                (void) config_store_index_add(config_load_pending[i]);
+            }
+            txn_start = 0U;
+        }
+        else
+        {
+            config_needs_compaction = true;
+            break;
+        }
+
+        offset += record_size;
+    }
+
+    /* A transaction without its commit record was interrupted. */
+    if (0U != txn_start)
+    {
+        config_needs_compaction = true;
+    }
+    config_write_offset = offset;
+}
+
+/******************************************************************************
+ * Function Name: config_store_encode
+ ******************************************************************************
+ * Summary:
+ *  Encodes a record into a buffer.
+ *
+ * Parameters:
+ *  uint8_t *buffer : Output buffer, CONFIG_RECORD_SIZE() bytes
+ *  uint8_t type : Record type
+ *  const char *key : Key, NULL for none
+ *  uint8_t key_len : Length of the key
+ *  const void *value : Value
+ *  uint16_t value_len : Length of the value
+ *
+ * Return:
+ *  uint32_t : Size of the record
+ *
+ ******************************************************************************/
+static uint32_t config_store_encode(uint8_t *buffer, uint8_t type, const char *key, uint8_t key_len,
+                                    const void *value, uint16_t value_len)
+{
+    uint32_t size = CONFIG_RECORD_SIZE(key_len, value_len);
+
+    memset(buffer, 0, size);
+    buffer[0] = type;
+    buffer[1] = key_len;
+    buffer[2] = (uint8_t)(value_len & 0xFFU);
+    buffer[3] = (uint8_t)(value_len >> 8);
+    memcpy(&buffer[CONFIG_RECORD_HEADER_SIZE], key, key_len);
+    memcpy(&buffer[CONFIG_RECORD_HEADER_SIZE + key_len], value, value_len);
+
+    return size;
+}
+
+/******************************************************************************
+ * Function Name: config_store_write_begin
+ ******************************************************************************
+ * Summary:
+ *  Writes the begin record of a transaction.
+ *
+ * Parameters:
+ *  uint32_t bank : Bank number
+ *  uint32_t *offset : Append position in the bank; advanced
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_store_write_begin(uint32_t bank, uint32_t *offset)
+{
+    uint8_t record[CONFIG_RECORD_SIZE(0U, 0U)];
+    uint32_t record_size = config_store_encode(record, CONFIG_RECORD_BEGIN, NULL, 0U, NULL, 0U);
+
+    if (!config_nvm->write((bank * config_store_bank_size()) + *offset, record, record_size))
+    {
+        return false;
+    }
+    *offset += record_size;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_write_commit
+ ******************************************************************************
+ * Summary:
+ *  Writes the commit record of a transaction. The CRC is computed over what
+ *  was actually written, from the begin record on.
+ *
+ * Parameters:
+ *  uint32_t bank : Bank number
+ *  uint32_t txn_start : Offset of the begin record
+ *  uint32_t *offset : Append position in the bank; advanced
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_store_write_commit(uint32_t bank, uint32_t txn_start, uint32_t *offset)
+{
+    uint8_t record[CONFIG_RECORD_SIZE(0U, CONFIG_COMMIT_VALUE_SIZE)];
+    uint32_t crc = config_store_crc32(&config_store_bank(bank)[txn_start], *offset - txn_start);
+    uint32_t record_size = config_store_encode(record, CONFIG_RECORD_COMMIT, NULL, 0U,
+                                               &crc, sizeof(crc));
+
+    if (!config_nvm->write((bank * config_store_bank_size()) + *offset, record, record_size))
+    {
+        return false;
+    }
+    *offset += record_size;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_compact
+ ******************************************************************************
+ * Summary:
+ *  Copies the latest value of every key into the other bank as a single
+ *  transaction, then activates that bank by writing its header. Until the
+ *  header is written the current bank stays valid.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool config_store_compact(void)
+{
+    uint32_t target = (config_active_bank + 1U) % CONFIG_STORE_BANK_COUNT;
+    uint32_t target_base = target * config_store_bank_size();
+    const uint8_t *bank = config_store_bank(config_active_bank);
+    uint32_t offset = CONFIG_STORE_BANK_HEADER_SIZE;
+    config_bank_header_t header;
+    const uint8_t *record;
+    uint32_t record_size;
+
+    /* The header is erased first, invalidating the bank until it is done. */
+    if (!config_nvm->erase(target_base, config_store_bank_size()) ||
+        !config_store_write_begin(target, &offset))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < CONFIG_STORE_INDEX_SLOTS; i++)
+    {
+        if (0U == config_index[i].offset)
+        {
+            continue;
+        }
+
+        record = &bank[config_index[i].offset];
+        record_size = CONFIG_RECORD_SIZE(record[1], (uint16_t)(record[2] | (record[3] << 8)));
+        if (!config_nvm->write(target_base + offset, record, record_size))
+        {
+            return false;
+        }
+        offset += record_size;
+    }
+
+    if (!config_store_write_commit(target, CONFIG_STORE_BANK_HEADER_SIZE, &offset))
+    {
+        return false;
+    }
+
+    header.magic = CONFIG_STORE_BANK_MAGIC;
+    header.generation = config_generation + 1U;
+    header.crc = config_store_crc32((const uint8_t *)&header, 2U * sizeof(uint32_t));
+    header.reserved = 0xFFFFFFFFUL;
+    if (!config_nvm->write(target_base, (const uint8_t *)&header, sizeof(header)))
+    {
+        return false;
+    }
+
+    config_active_bank = target;
+    config_generation = header.generation;
+    config_store_load_bank();
+
+    printf("  Config store: Compacted into bank %lu, %lu keys, %lu bytes used\n",
+           (unsigned long)config_active_bank, (unsigned long)config_key_count,
+           (unsigned long)config_write_offset);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_txn_new_keys
+ ******************************************************************************
+ * Summary:
+ *  Counts the distinct keys of the open transaction that are not stored yet.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Number of new keys
+ *
+ ******************************************************************************/
+static uint32_t config_store_txn_new_keys(void)
+{
+    const uint8_t *record;
+    const uint8_t *earlier;
+    uint32_t new_keys = 0U;
+    uint32_t offset = 0U;
+    uint32_t other;
+    config_index_entry_t *entry;
+    bool seen;
+
+    while (offset < config_txn_length)
+    {
+        record = &config_txn_buffer[offset];
+        entry = config_store_index_find((const char *)&record[CONFIG_RECORD_HEADER_SIZE], record[1],
+                                        config_store_hash((const char *)&record[CONFIG_RECORD_HEADER_SIZE],
+                                                          record[1]));
+        seen = (0U != entry->offset);
+
+        for (other = 0U; !seen && (other < offset);
+             other += CONFIG_RECORD_SIZE(earlier[1], (uint16_t)(earlier[2] | (earlier[3] << 8))))
+        {
+            earlier = &config_txn_buffer[other];
+            seen = (earlier[1] == record[1]) &&
+                   (0 == memcmp(&earlier[CONFIG_RECORD_HEADER_SIZE],
+                                &record[CONFIG_RECORD_HEADER_SIZE], record[1]));
+        }
+
+        if (!seen)
+        {
+            new_keys++;
+        }
+        offset += CONFIG_RECORD_SIZE(record[1], (uint16_t)(record[2] | (record[3] << 8)));
+    }
+
+    return new_keys;
+}
+
+/******************************************************************************
+ * Function Name: config_store_init
+ ******************************************************************************
+ * Summary:
+ *  Selects the active bank and builds the RAM index. If no bank is valid
+ *  the store is formatted empty, so that every lookup returns its default.
+ *
+ * Parameters:
+ *  const config_store_nvm_t *nvm : Backend, NULL for the user_nvm region
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+bool config_store_init(const config_store_nvm_t *nvm)
+{
+    const config_bank_header_t *header;
+    bool found = false;
+
+    config_nvm = (NULL != nvm) ? nvm : &config_store_rram;
+    if (NULL == config_store_mutex)
+    {
+        config_store_mutex = xSemaphoreCreateMutex();
+    }
+
+    for (uint32_t bank = 0U; bank < CONFIG_STORE_BANK_COUNT; bank++)
+    {
+        header = (const config_bank_header_t *)config_store_bank(bank);
+        if ((CONFIG_STORE_BANK_MAGIC == header->magic) &&
+            (header->crc == config_store_crc32((const uint8_t *)header, 2U * sizeof(uint32_t))) &&
+            (!found || ((int32_t)(header->generation - config_generation) > 0)))
+        {
+            config_active_bank = bank;
+            config_generation = header->generation;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        /* Format: compacting an empty index writes a fresh bank. */
+        printf("  Config store: No valid bank, using defaults\n");
+        memset(config_index, 0, sizeof(config_index));
+        config_key_count = 0U;
+        config_active_bank = CONFIG_STORE_BANK_COUNT - 1U;
+        config_generation = 0U;
+        return config_store_compact();
+    }
+
+    config_store_load_bank();
+    printf("  Config store: Bank %lu, %lu keys, %lu bytes used\n",
+           (unsigned long)config_active_bank, (unsigned long)config_key_count,
+           (unsigned long)config_write_offset);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_begin
+ ******************************************************************************
+ * Summary:
+ *  Starts a transaction. Values set until config_store_commit() take effect
+ *  together or not at all. Other tasks reading the store block until the
+ *  transaction is committed or aborted.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : false if the store is not initialized
+ *
+ ******************************************************************************/
+bool config_store_begin(void)
+{
+    if ((NULL == config_store_mutex) ||
+        (pdTRUE != xSemaphoreTake(config_store_mutex, portMAX_DELAY)))
+    {
+        return false;
+    }
+
+    config_txn_length = 0U;
+    config_txn_open = true;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_set
+ ******************************************************************************
+ * Summary:
+ *  Stages a value in the open transaction.
+ *
+ * Parameters:
+ *  const char *key : Key, at most CONFIG_STORE_MAX_KEY_LEN characters
+ *  const void *value : Value
+ *  uint16_t length : Length of the value, at most CONFIG_STORE_MAX_VALUE_LEN
+ *
+ * Return:
+ *  bool : false if no transaction is open or the value does not fit
+ *
+ ******************************************************************************/
+bool config_store_set(const char *key, const void *value, uint16_t length)
+{
+    size_t key_len = strlen(key);
+    uint32_t record_size = CONFIG_RECORD_SIZE(key_len, length);
+
+    if (!config_txn_open || (0U == key_len) || (CONFIG_STORE_MAX_KEY_LEN < key_len) ||
+        (CONFIG_STORE_MAX_VALUE_LEN < length) ||
+        ((config_txn_length + record_size) > CONFIG_STORE_TXN_BUFFER_SIZE))
+    {
+        return false;
+    }
+
+    config_txn_length += config_store_encode(&config_txn_buffer[config_txn_length],
+                                             CONFIG_RECORD_VALUE, key, (uint8_t)key_len,
+                                             value, length);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: config_store_commit
+ ******************************************************************************
+ * Summary:
+ *  Writes the open transaction to the log and updates the index. The bank
+ *  is compacted first if the transaction does not fit.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if all staged values were stored
+ *
+ ******************************************************************************/
+bool config_store_commit(void)
+{
+    uint32_t needed = CONFIG_RECORD_SIZE(0U, 0U) + config_txn_length +
+                      CONFIG_RECORD_SIZE(0U, CONFIG_COMMIT_VALUE_SIZE);
+    uint32_t offset;
+    bool result = false;
+
+    if (!config_txn_open)
+    {
+        return false;
+    }
+    config_txn_open = false;
+
+    if ((config_key_count + config_store_txn_new_keys()) > CONFIG_STORE_MAX_KEYS)
+    {
+        printf("  Config store: Key limit reached\n");
+    }
+    else if ((config_needs_compaction ||
+              ((config_write_offset + needed) > config_store_bank_size())) &&
+             !config_store_compact())
+    {
+        printf("  Config store: Compaction failed\n");
+    }
+    else if ((config_write_offset + needed) > config_store_bank_size())
+    {
+        printf("  Config store: Full\n");
+    }
+    else
+    {
+        offset = config_write_offset;
+        result = config_store_write_begin(config_active_bank, &offset) &&
+                 config_nvm->write((config_active_bank * config_store_bank_size()) + offset,
+                                   config_txn_buffer, config_txn_length);
+        offset += config_txn_length;
+        result = result && config_store_write_commit(config_active_bank, config_write_offset, &offset);
+
+        /* Re-read the log so the index only reflects what was committed. */
+        config_store_load_bank();
+    }
+
+    xSemaphoreGive(config_store_mutex);
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: config_store_abort
+ ******************************************************************************
+ * Summary:
+ *  Discards the open transaction.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void config_store_abort(void)
+{
+    if (config_txn_open)
+    {
+        config_txn_open = false;
+        xSemaphoreGive(config_store_mutex);
+    }
+}
+
+/******************************************************************************
+ * Function Name: config_store_get
+ ******************************************************************************
+ * Summary:
+ *  Copies the committed value of a key.
+ *
+ * Parameters:
+ *  const char *key : Key
+ *  void *value : Output buffer
+ *  uint16_t size : Size of the output buffer
+ *  uint16_t *length : Length of the value; set if the key exists
+ *
+ * Return:
+ *  bool : false if the key does not exist or the value does not fit
+ *
+ ******************************************************************************/
+bool config_store_get(const char *key, void *value, uint16_t size, uint16_t *length)
+{
+    size_t key_len = strlen(key);
+    config_index_entry_t *entry;
+    const uint8_t *record;
+    uint16_t value_len;
+    bool found = false;
+
+    if ((NULL == config_store_mutex) || (CONFIG_STORE_MAX_KEY_LEN < key_len) ||
+        (pdTRUE != xSemaphoreTake(config_store_mutex, portMAX_DELAY)))
+    {
+        return false;
+    }
+
+    entry = config_store_index_find(key, key_len, config_store_hash(key, key_len));
+    if ((NULL != entry) && (0U != entry->offset))
+    {
+        record = &config_store_bank(config_active_bank)[entry->offset];
+        value_len = (uint16_t)(record[2] | (record[3] << 8));
+        if (value_len <= size)
+        {
+            memcpy(value, &record[CONFIG_RECORD_HEADER_SIZE + key_len], value_len);
+            *length = value_len;
+            found = true;
+        }
+    }
+
+    xSemaphoreGive(config_store_mutex);
+
+    return found;
+}
+
+/******************************************************************************
+ * Function Name: config_store_get_uint
+ ******************************************************************************
+ * Summary:
+ *  Returns an unsigned value stored as 4 bytes little endian.
+ *
+ * Parameters:
+ *  const char *key : Key
+ *  uint32_t default_value : Returned if the key is not stored
+ *
+ * Return:
+ *  uint32_t : Stored or default value
+ *
+ ******************************************************************************/
+uint32_t config_store_get_uint(const char *key, uint32_t default_value)
+{
+    uint8_t value[sizeof(uint32_t)];
+    uint16_t length;
+
+    if (!config_store_get(key, value, sizeof(value), &length) || (sizeof(value) != length))
+    {
+        return default_value;
+    }
+
+    return ((uint32_t)value[0]) | ((uint32_t)value[1] << 8) |
+           ((uint32_t)value[2] << 16) | ((uint32_t)value[3] << 24);
+}
+
+/******************************************************************************
+ * Function Name: config_store_get_string
+ ******************************************************************************
+ * Summary:
+ *  Copies a string value, NUL-terminated.
+ *
+ * Parameters:
+ *  const char *key : Key
+ *  char *buffer : Output buffer
+ *  size_t size : Size of the output buffer
+ *  const char *default_value : Copied if the key is not stored or too long
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void config_store_get_string(const char *key, char *buffer, size_t size, const char *default_value)
+{
+    uint16_t length;
+
+    if (config_store_get(key, buffer, (uint16_t)(size - 1U), &length))
+    {
+        buffer[length] = '\0';
+    }
+    else
+    {
+        strncpy(buffer, default_value, size - 1U);
+        buffer[size - 1U] = '\0';
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name:   config_store.h
+*
+* Description: This file is the public interface of config_store.c, the
+*              persistent key/value configuration store kept in the user_nvm
+*              region.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Limits of the store. */
+#define CONFIG_STORE_MAX_KEYS               (32U)
+#define CONFIG_STORE_MAX_KEY_LEN            (32U)
+#define CONFIG_STORE_MAX_VALUE_LEN          (128U)
+
+/* Size of the RAM buffer staging the records of one transaction. */
+#define CONFIG_STORE_TXN_BUFFER_SIZE        (768U)
+
+/* Keys of the persistent settings, see the defaults in wifi_config.h and
+ * mqtt_client_config.h.
+ */
+#define CONFIG_KEY_WIFI_SSID                "wifi.ssid"
+#define CONFIG_KEY_WIFI_PASSWORD            "wifi.password"
+#define CONFIG_KEY_WIFI_RETRIES             "wifi.retries"
+#define CONFIG_KEY_MQTT_BROKER              "mqtt.broker"
+#define CONFIG_KEY_MQTT_PORT                "mqtt.port"
+#define CONFIG_KEY_MQTT_USERNAME            "mqtt.username"
+#define CONFIG_KEY_MQTT_PASSWORD            "mqtt.password"
+#define CONFIG_KEY_MQTT_RETRIES             "mqtt.retries"
+#define CONFIG_KEY_MQTT_KEEP_ALIVE          "mqtt.keep_alive"
+#define CONFIG_KEY_SAMPLE_PERIOD            "sample_period_ms"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Non-volatile memory backend of the store. 'base' is a memory-mapped view
+ * of the region; offsets are relative to it. Writes must not need a prior
+ * erase of programmed bytes; erase sets bytes to 0xFF.
+ */
+typedef struct
+{
+    const uint8_t *base;
+    uint32_t size;
+    bool (*write)(uint32_t offset, const uint8_t *data, uint32_t length);
+    bool (*erase)(uint32_t offset, uint32_t length);
+} config_store_nvm_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+bool config_store_init(const config_store_nvm_t *nvm);
+bool config_store_begin(void);
+bool config_store_set(const char *key, const void *value, uint16_t length);
+bool config_store_commit(void);
+void config_store_abort(void);
+bool config_store_get(const char *key, void *value, uint16_t size, uint16_t *length);
+uint32_t config_store_get_uint(const char *key, uint32_t default_value);
+void config_store_get_string(const char *key, char *buffer, size_t size, const char *default_value);
+
+#endif /* CONFIG_STORE_H_ */
+
+/* [] END OF FILE */
@@ -42,6 +42,8 @@
 #ifndef CORE_MQTT_CONFIG_H_
 #define CORE_MQTT_CONFIG_H_
 
+#include <stdint.h>
+
 /**
  * @brief Determines the maximum number of MQTT PUBLISH messages, pending
  * acknowledgement at a time, that are supported for incoming and outgoing
@@ -76,7 +78,13 @@
  *
  * If a ping response is not received before this timeout,
  * #MQTT_ProcessLoop will return #MQTTKeepAliveTimeout.
+ *
+ * The library does not report the time of its PINGREQ/PINGRESP exchanges,
+ * so keepalive_tuner.c derives the timeout from the QoS 1 PUBLISH/PUBACK
+ * round-trip time instead, between 1 s and 5 s, so that a dead link is
+ * detected sooner.
  */
-#define MQTT_PINGRESP_TIMEOUT_MS                ( 5000U )
+extern uint32_t keepalive_tuner_puback_timeout_ms( void );
+#define MQTT_PINGRESP_TIMEOUT_MS                ( keepalive_tuner_puback_timeout_ms() )
 
 #endif /* ifndef CORE_MQTT_CONFIG_H_ */
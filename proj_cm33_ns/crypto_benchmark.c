@@ -0,0 +1,724 @@
+/******************************************************************************
+* File Name:   crypto_benchmark.c
+*
+* Description: This file contains the micro-benchmark of the mbedTLS
+*              primitives used by the TLS handshake of the MQTT connection.
+*              It runs against cy-mbedtls-acceleration (default) or the
+*              software mbedTLS implementation (DISABLE_MBEDTLS_ACCELERATION).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+
+/* The root CA signature and its digest algorithm are private fields of the
+ * parsed certificate.
+ */
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/error.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/md.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/sha512.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+#include "psa/crypto.h"
+
+#include "cert_pinning.h"
+#include "crypto_benchmark.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Timestamps are core clock cycles. */
+#if defined(DISABLE_MBEDTLS_ACCELERATION)
+#define BENCH_IMPLEMENTATION                "software mbedTLS"
+#define BENCH_UNIT                          "cycles"
+#define BENCH_UNITS_PER_SECOND              ((uint64_t)SystemCoreClock)
+#else
+#define BENCH_IMPLEMENTATION                "cy-mbedtls-acceleration"
+#define BENCH_UNIT                          "cycles"
+#define BENCH_UNITS_PER_SECOND              ((uint64_t)SystemCoreClock)
+#endif /* DISABLE_MBEDTLS_ACCELERATION */
+
+/* Name of the TLS_PROFILE selected in mbedtls_user_config.h. */
+#ifndef TLS_PROFILE_NAME
+#define TLS_PROFILE_NAME                    "library default"
+#endif /* TLS_PROFILE_NAME */
+
+/* Sizes of the GCM nonce, additional data and tag of one TLS record. */
+#define BENCH_GCM_IV_SIZE                   (12U)
+#define BENCH_GCM_AAD_SIZE                  (13U)
+#define BENCH_GCM_TAG_SIZE                  (16U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Keys, inputs and outputs of the benchmarked primitives. Kept off the task
+ * stack; the big-number work itself allocates from the mbedTLS heap.
+ */
+typedef struct
+{
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_gcm_context gcm128;
+    mbedtls_gcm_context gcm256;
+    mbedtls_ecp_group group;
+    mbedtls_mpi ecdh_secret;
+    mbedtls_ecp_point ecdh_public;
+    mbedtls_ecp_point ecdh_peer;
+    mbedtls_mpi ecdh_shared;
+    mbedtls_ecdsa_context ecdsa;
+    unsigned char ecdsa_sig[MBEDTLS_ECDSA_MAX_LEN];
+    size_t ecdsa_sig_len;
+    mbedtls_x509_crt chain;
+    mbedtls_ssl_config tls_config;
+    mbedtls_ssl_context tls;
+    const mbedtls_x509_crt *root;
+    const char *server_name;
+    unsigned char root_hash[MBEDTLS_MD_MAX_SIZE];
+    unsigned char hash[MBEDTLS_MD_MAX_SIZE];
+    unsigned char tag[BENCH_GCM_TAG_SIZE];
+    unsigned char input[CRYPTO_BENCHMARK_BUFFER_SIZE];
+    unsigned char output[CRYPTO_BENCHMARK_BUFFER_SIZE];
+} bench_state_t;
+
+/* One benchmarked primitive; returns 0 on success like mbedTLS. */
+typedef int (*bench_op_t)(bench_state_t *state);
+
+static bench_state_t bench_state;
+
+static const unsigned char bench_key[32] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static const unsigned char bench_iv[BENCH_GCM_IV_SIZE] = { 0 };
+static const unsigned char bench_aad[BENCH_GCM_AAD_SIZE] = { 0 };
+
+/* Upper 32 bits of the extended cycle counter and the last value read. */
+static uint32_t bench_cycles_high;
+static uint32_t bench_cycles_last;
+
+/******************************************************************************
+* Function Name: bench_now
+******************************************************************************
+* Summary:
+*  Reads the time base of the benchmark. The 32-bit DWT cycle counter is
+*  extended to 64 bits; it wraps after about 20 s, so it must be
+*  read at least that often, which every single operation satisfies.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t : Core clock cycles
+*
+******************************************************************************/
+static uint64_t bench_now(void)
+{
+    uint32_t cycles = DWT->CYCCNT;
+
+    if (cycles < bench_cycles_last)
+    {
+        bench_cycles_high++;
+    }
+    bench_cycles_last = cycles;
+
+    return ((uint64_t)bench_cycles_high << 32) | cycles;
+}
+
+/******************************************************************************
+* Function Name: bench_measure
+******************************************************************************
+* Summary:
+*  Runs one primitive for at least CRYPTO_BENCHMARK_MIN_TIME_MS and
+*  CRYPTO_BENCHMARK_MIN_ITERATIONS, and prints its rate and cost per call.
+*
+* Parameters:
+*  const char *name : Name printed in the result table
+*  bench_op_t op : Primitive to run
+*  bench_state_t *state : Keys and buffers of the primitive
+*  size_t bytes : Bytes processed per call, 0 for public-key operations
+*  uint64_t *cost : Time per call in BENCH_UNIT; set, may be NULL
+*
+* Return:
+*  int : 0 on success, else the mbedTLS error of the primitive
+*
+******************************************************************************/
+static int bench_measure(const char *name, bench_op_t op, bench_state_t *state, size_t bytes,
+                         uint64_t *cost)
+{
+    uint64_t min_units = (BENCH_UNITS_PER_SECOND * CRYPTO_BENCHMARK_MIN_TIME_MS) / 1000U;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t ops_x10;
+    uint32_t iterations = 0;
+    int ret;
+
+    start = bench_now();
+    do
+    {
+        ret = op(state);
+        if (0 != ret)
+        {
+            printf("  %-26s failed: -0x%04x\n", name, (unsigned int)-ret);
+            return ret;
+        }
+        iterations++;
+        elapsed = bench_now() - start;
+    } while ((elapsed < min_units) || (iterations < CRYPTO_BENCHMARK_MIN_ITERATIONS));
+
+    ops_x10 = ((uint64_t)iterations * BENCH_UNITS_PER_SECOND * 10U) / elapsed;
+    printf("  %-26s %8lu.%lu %12llu", name, (unsigned long)(ops_x10 / 10U),
+           (unsigned long)(ops_x10 % 10U), (unsigned long long)(elapsed / iterations));
+    if (0U != bytes)
+    {
+        printf(" %10lu", (unsigned long)((ops_x10 * bytes) / 10240U));
+    }
+    printf("\n");
+
+    if (NULL != cost)
+    {
+        *cost = elapsed / iterations;
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+* Benchmarked primitives, one call of the handshake or record layer each.
+******************************************************************************/
+static int bench_aes128_gcm(bench_state_t *state)
+{
+    return mbedtls_gcm_crypt_and_tag(&state->gcm128, MBEDTLS_GCM_ENCRYPT, sizeof(state->input),
+                                     bench_iv, sizeof(bench_iv), bench_aad, sizeof(bench_aad),
+                                     state->input, state->output, sizeof(state->tag), state->tag);
+}
+
+static int bench_aes256_gcm(bench_state_t *state)
+{
+    return mbedtls_gcm_crypt_and_tag(&state->gcm256, MBEDTLS_GCM_ENCRYPT, sizeof(state->input),
+                                     bench_iv, sizeof(bench_iv), bench_aad, sizeof(bench_aad),
+                                     state->input, state->output, sizeof(state->tag), state->tag);
+}
+
+static int bench_sha256(bench_state_t *state)
+{
+    return mbedtls_sha256(state->input, sizeof(state->input), state->hash, 0);
+}
+
+#if defined(MBEDTLS_SHA384_C)
+static int bench_sha384(bench_state_t *state)
+{
+    return mbedtls_sha512(state->input, sizeof(state->input), state->hash, 1);
+}
+#endif /* MBEDTLS_SHA384_C */
+
+/* Ephemeral key generation plus shared secret, as in one ECDHE key share. */
+static int bench_ecdhe_p256(bench_state_t *state)
+{
+    int ret = mbedtls_ecdh_gen_public(&state->group, &state->ecdh_secret, &state->ecdh_public,
+                                      mbedtls_ctr_drbg_random, &state->drbg);
+
+    if (0 == ret)
+    {
+        ret = mbedtls_ecdh_compute_shared(&state->group, &state->ecdh_shared, &state->ecdh_peer,
+                                          &state->ecdh_secret, mbedtls_ctr_drbg_random, &state->drbg);
+    }
+
+    return ret;
+}
+
+static int bench_ecdsa_p256_verify(bench_state_t *state)
+{
+    return mbedtls_ecdsa_read_signature(&state->ecdsa, state->hash, 32U,
+                                        state->ecdsa_sig, state->ecdsa_sig_len);
+}
+
+/* Self-signature of the root CA, i.e. the public-key operation of checking
+ * a certificate signed by it.
+ */
+static int bench_root_ca_verify(bench_state_t *state)
+{
+    const mbedtls_x509_crt *root = state->root;
+
+    return mbedtls_pk_verify((mbedtls_pk_context *)&root->pk, root->sig_md, state->root_hash,
+                             mbedtls_md_get_size(mbedtls_md_info_from_type(root->sig_md)),
+                             root->sig.p, root->sig.len);
+}
+
+/* Fast path of a pinned reconnect: the check of cert_pin_match(), here with
+ * the CA chain standing in for both the server chain and the trusted CAs.
+ * Only its cost is measured; a mismatch, e.g. with the clock not set, costs
+ * the same.
+ */
+static int bench_pin_check(bench_state_t *state)
+{
+    (void) cert_pin_match(&state->chain, &state->chain, NULL, &mbedtls_x509_crt_profile_default,
+                          state->server_name);
+
+    return 0;
+}
+
+/******************************************************************************
+* Function Name: bench_pinned_reconnect
+******************************************************************************
+* Summary:
+*  Measures the certificate check of a reconnect with a pinned server
+*  certificate and prints the time it saves against a full chain
+*  validation, which checks at least one signature made by the root CA key.
+*  The pin is cleared again, so the benchmark leaves no pin behind.
+*
+* Parameters:
+*  bench_state_t *state : State with the parsed root CA
+*  const char *server_name : Server name of the pin
+*  uint64_t verify_cost : Time of one root CA signature check in BENCH_UNIT
+*
+* Return:
+*  int : 0 on success, else the mbedTLS error
+*
+******************************************************************************/
+static int bench_pinned_reconnect(bench_state_t *state, const char *server_name, uint64_t verify_cost)
+{
+    uint64_t pin_cost = 0U;
+    int ret = MBEDTLS_ERR_ERROR_GENERIC_ERROR;
+
+    state->server_name = server_name;
+    if (cert_pin_record(&state->chain, &state->chain, &mbedtls_x509_crt_profile_default, server_name))
+    {
+        ret = bench_measure("Chain pin check", bench_pin_check, state, 0U, &pin_cost);
+    }
+    cert_pin_clear();
+
+    if (0 == ret)
+    {
+        printf("  Pinned reconnect saves at least %llu %s per handshake (%llu x faster)\n",
+               (unsigned long long)((verify_cost > pin_cost) ? (verify_cost - pin_cost) : 0U), BENCH_UNIT,
+               (unsigned long long)(verify_cost / ((0U != pin_cost) ? pin_cost : 1U)));
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+* Function Name: bench_heap_in_use
+******************************************************************************
+* Summary:
+*  Returns the bytes currently allocated from the C library heap, which
+*  serves both mbedTLS and FreeRTOS (heap_3).
+*
+* Parameters:
+*  void
+*
+* Return:
+*  size_t : Allocated bytes
+*
+******************************************************************************/
+static size_t bench_heap_in_use(void)
+{
+    return (size_t)mallinfo().uordblks;
+}
+
+/******************************************************************************
+* Function Name: bench_heap_high_water
+******************************************************************************
+* Summary:
+*  Returns the size of the heap arena obtained from the system. The C library
+*  does not hand it back, so it is the high-water mark of the heap.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  size_t : Arena size in bytes
+*
+******************************************************************************/
+static size_t bench_heap_high_water(void)
+{
+    return (size_t)mallinfo().arena;
+}
+
+/* Transport of the ClientHello measurement: counts what is sent and never
+ * delivers a reply, so the handshake stops after the first flight.
+ */
+static int bench_tls_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    (void) buf;
+    *(size_t *)ctx += len;
+    return (int)len;
+}
+
+static int bench_tls_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    (void) ctx;
+    (void) buf;
+    (void) len;
+    return MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+/******************************************************************************
+* Function Name: bench_client_hello
+******************************************************************************
+* Summary:
+*  Builds the ClientHello of the selected TLS_PROFILE, including its key
+*  share, and prints its size on the wire, the time taken and the heap held
+*  by the TLS context at that point of the handshake.
+*
+* Parameters:
+*  bench_state_t *state : State holding the seeded DRBG
+*  const char *server_name : Server name sent in the SNI extension
+*
+* Return:
+*  int : 0 on success, else the mbedTLS error
+*
+******************************************************************************/
+static int bench_client_hello(bench_state_t *state, const char *server_name)
+{
+    size_t heap_before = bench_heap_in_use();
+    size_t heap_used;
+    size_t sent = 0;
+    uint64_t elapsed = 0;
+    int ret;
+
+    mbedtls_ssl_config_init(&state->tls_config);
+    mbedtls_ssl_init(&state->tls);
+
+    ret = mbedtls_ssl_config_defaults(&state->tls_config, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (0 == ret)
+    {
+        mbedtls_ssl_conf_rng(&state->tls_config, mbedtls_ctr_drbg_random, &state->drbg);
+        mbedtls_ssl_conf_authmode(&state->tls_config, MBEDTLS_SSL_VERIFY_NONE);
+        ret = mbedtls_ssl_setup(&state->tls, &state->tls_config);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_ssl_set_hostname(&state->tls, server_name);
+    }
+    if (0 == ret)
+    {
+        mbedtls_ssl_set_bio(&state->tls, &sent, bench_tls_send, bench_tls_recv, NULL);
+        elapsed = bench_now();
+        ret = mbedtls_ssl_handshake(&state->tls);
+        elapsed = bench_now() - elapsed;
+        ret = ((MBEDTLS_ERR_SSL_WANT_READ == ret) && (0U != sent)) ? 0 : ret;
+    }
+
+    heap_used = bench_heap_in_use() - heap_before;
+    if (0 == ret)
+    {
+        printf("  ClientHello: %u bytes, built in %llu " BENCH_UNIT ", TLS context %u bytes of heap\n",
+               (unsigned int)sent, (unsigned long long)elapsed, (unsigned int)heap_used);
+    }
+    else
+    {
+        printf("  ClientHello failed: -0x%04x\n", (unsigned int)-ret);
+    }
+
+    mbedtls_ssl_free(&state->tls);
+    mbedtls_ssl_config_free(&state->tls_config);
+
+    return ret;
+}
+
+/* Primitives measured on every run; bulk ones also report KB/s. */
+static const struct
+{
+    const char *name;
+    bench_op_t op;
+    bool bulk;
+} bench_primitives[] =
+{
+    { "AES-128-GCM encrypt",   bench_aes128_gcm,        true  },
+    { "AES-256-GCM encrypt",   bench_aes256_gcm,        true  },
+    { "SHA-256",               bench_sha256,            true  },
+#if defined(MBEDTLS_SHA384_C)
+    { "SHA-384",               bench_sha384,            true  },
+#endif /* MBEDTLS_SHA384_C */
+    { "ECDHE P-256 key share", bench_ecdhe_p256,        false },
+    { "ECDSA P-256 verify",    bench_ecdsa_p256_verify, false }
+};
+
+/******************************************************************************
+* Function Name: bench_setup
+******************************************************************************
+* Summary:
+*  Seeds the DRBG, loads the symmetric keys, generates the P-256 peer and
+*  signing keys and locates the self-signed root of the CA chain.
+*
+* Parameters:
+*  bench_state_t *state : State to set up
+*  const unsigned char *root_ca_pem : NUL-terminated PEM chain, or NULL
+*  size_t root_ca_pem_len : Length of the chain including the NUL
+*
+* Return:
+*  int : 0 on success, else the first mbedTLS error
+*
+******************************************************************************/
+static int bench_setup(bench_state_t *state, const unsigned char *root_ca_pem, size_t root_ca_pem_len)
+{
+    static const char personalization[] = "crypto_benchmark";
+    mbedtls_mpi peer_secret;
+    const mbedtls_x509_crt *crt;
+    int ret;
+
+    memset(state->input, 0xa5, sizeof(state->input));
+    state->root = NULL;
+
+    /* TLS 1.3 runs its handshake crypto through PSA. */
+    ret = (PSA_SUCCESS == psa_crypto_init()) ? 0 : MBEDTLS_ERR_ERROR_GENERIC_ERROR;
+    if (0 == ret)
+    {
+        ret = mbedtls_ctr_drbg_seed(&state->drbg, mbedtls_entropy_func, &state->entropy,
+                                    (const unsigned char *)personalization, sizeof(personalization) - 1U);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_gcm_setkey(&state->gcm128, MBEDTLS_CIPHER_ID_AES, bench_key, 128U);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_gcm_setkey(&state->gcm256, MBEDTLS_CIPHER_ID_AES, bench_key, 256U);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_ecp_group_load(&state->group, MBEDTLS_ECP_DP_SECP256R1);
+    }
+    if (0 == ret)
+    {
+        mbedtls_mpi_init(&peer_secret);
+        ret = mbedtls_ecdh_gen_public(&state->group, &peer_secret, &state->ecdh_peer,
+                                      mbedtls_ctr_drbg_random, &state->drbg);
+        mbedtls_mpi_free(&peer_secret);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_ecdsa_genkey(&state->ecdsa, MBEDTLS_ECP_DP_SECP256R1,
+                                   mbedtls_ctr_drbg_random, &state->drbg);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_sha256(state->input, sizeof(state->input), state->hash, 0);
+    }
+    if (0 == ret)
+    {
+        ret = mbedtls_ecdsa_write_signature(&state->ecdsa, MBEDTLS_MD_SHA256, state->hash, 32U,
+                                            state->ecdsa_sig, sizeof(state->ecdsa_sig),
+                                            &state->ecdsa_sig_len, mbedtls_ctr_drbg_random,
+                                            &state->drbg);
+    }
+    if ((0 == ret) && (NULL != root_ca_pem))
+    {
+        /* A positive result counts the certificates of the chain that failed
+         * to parse; the remaining ones are still usable.
+         */
+        ret = mbedtls_x509_crt_parse(&state->chain, root_ca_pem, root_ca_pem_len);
+        ret = (ret > 0) ? 0 : ret;
+        for (crt = &state->chain; (0 == ret) && (NULL != crt) && (NULL != crt->raw.p); crt = crt->next)
+        {
+            if ((crt->issuer_raw.len == crt->subject_raw.len) &&
+                (0 == memcmp(crt->issuer_raw.p, crt->subject_raw.p, crt->subject_raw.len)))
+            {
+                ret = mbedtls_md(mbedtls_md_info_from_type(crt->sig_md), crt->tbs.p, crt->tbs.len,
+                                 state->root_hash);
+                state->root = crt;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+* Function Name: crypto_benchmark_run
+******************************************************************************
+* Summary:
+*  Measures the primitives of a TLS 1.3 handshake with the MQTT broker and of
+*  its record layer, and prints ops/s and time per call for each, followed by
+*  the ClientHello of the selected TLS_PROFILE. The root CA signature and the
+*  pinned reconnect fast path are only measured when a chain with a
+*  self-signed root is given.
+*
+* Parameters:
+*  const unsigned char *root_ca_pem : NUL-terminated PEM chain, or NULL
+*  size_t root_ca_pem_len : Length of the chain including the NUL
+*  const char *server_name : Server name of the ClientHello
+*
+* Return:
+*  int : 0 if every primitive ran, else the first mbedTLS error
+*
+******************************************************************************/
+int crypto_benchmark_run(const unsigned char *root_ca_pem, size_t root_ca_pem_len,
+                         const char *server_name)
+{
+    bench_state_t *state = &bench_state;
+    char name[32];
+    uint64_t verify_cost = 0U;
+    size_t i;
+    int result;
+    int ret;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    bench_cycles_high = 0;
+    bench_cycles_last = DWT->CYCCNT;
+
+    mbedtls_entropy_init(&state->entropy);
+    mbedtls_ctr_drbg_init(&state->drbg);
+    mbedtls_gcm_init(&state->gcm128);
+    mbedtls_gcm_init(&state->gcm256);
+    mbedtls_ecp_group_init(&state->group);
+    mbedtls_mpi_init(&state->ecdh_secret);
+    mbedtls_ecp_point_init(&state->ecdh_public);
+    mbedtls_ecp_point_init(&state->ecdh_peer);
+    mbedtls_mpi_init(&state->ecdh_shared);
+    mbedtls_ecdsa_init(&state->ecdsa);
+    mbedtls_x509_crt_init(&state->chain);
+
+    printf("\nCrypto benchmark (%s, %s TLS profile, %u-byte records)\n", BENCH_IMPLEMENTATION,
+           TLS_PROFILE_NAME, (unsigned int)CRYPTO_BENCHMARK_BUFFER_SIZE);
+
+    ret = bench_setup(state, root_ca_pem, root_ca_pem_len);
+    if (0 != ret)
+    {
+        printf("  Setup failed: -0x%04x\n", (unsigned int)-ret);
+    }
+    else
+    {
+        printf("  %-26s %10s %12s %10s\n", "Primitive", "ops/s", BENCH_UNIT "/op", "KB/s");
+
+        for (i = 0; i < (sizeof(bench_primitives) / sizeof(bench_primitives[0])); i++)
+        {
+            result = bench_measure(bench_primitives[i].name, bench_primitives[i].op, state,
+                                   bench_primitives[i].bulk ? sizeof(state->input) : 0U, NULL);
+            ret = (0 == ret) ? result : ret;
+        }
+
+        if (NULL != state->root)
+        {
+            (void) snprintf(name, sizeof(name), "%s-%u verify (root CA)",
+                            mbedtls_pk_get_name(&state->root->pk),
+                            (unsigned int)mbedtls_pk_get_bitlen(&state->root->pk));
+            result = bench_measure(name, bench_root_ca_verify, state, 0U, &verify_cost);
+            ret = (0 == ret) ? result : ret;
+
+            result = bench_pinned_reconnect(state, server_name, verify_cost);
+            ret = (0 == ret) ? result : ret;
+        }
+        else
+        {
+            printf("  %-26s skipped, no self-signed root in the CA chain\n", "Root CA verify");
+        }
+
+        result = bench_client_hello(state, server_name);
+        ret = (0 == ret) ? result : ret;
+    }
+
+    mbedtls_x509_crt_free(&state->chain);
+    mbedtls_ecdsa_free(&state->ecdsa);
+    mbedtls_mpi_free(&state->ecdh_shared);
+    mbedtls_ecp_point_free(&state->ecdh_peer);
+    mbedtls_ecp_point_free(&state->ecdh_public);
+    mbedtls_mpi_free(&state->ecdh_secret);
+    mbedtls_ecp_group_free(&state->group);
+    mbedtls_gcm_free(&state->gcm256);
+    mbedtls_gcm_free(&state->gcm128);
+    mbedtls_ctr_drbg_free(&state->drbg);
+    mbedtls_entropy_free(&state->entropy);
+
+    return ret;
+}
+
+/******************************************************************************
+* Function Name: crypto_benchmark_heap_in_use
+******************************************************************************
+* Summary:
+*  Returns the bytes currently allocated from the heap, to be passed to
+*  crypto_benchmark_report_connect() after the connection is made.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  size_t : Allocated bytes
+*
+******************************************************************************/
+size_t crypto_benchmark_heap_in_use(void)
+{
+    return bench_heap_in_use();
+}
+
+/******************************************************************************
+* Function Name: crypto_benchmark_report_connect
+******************************************************************************
+* Summary:
+*  Prints the cost of one broker connection (TCP, TLS handshake and MQTT
+*  CONNECT) with the selected TLS_PROFILE and record buffer sizes: the time
+*  taken, the heap the connection keeps and the heap high-water mark, which
+*  covers the peak of the handshake.
+*
+* Parameters:
+*  uint32_t connect_ms : Duration of the connection attempt
+*  size_t heap_before : crypto_benchmark_heap_in_use() before the attempt
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void crypto_benchmark_report_connect(uint32_t connect_ms, size_t heap_before)
+{
+    printf("TLS profile %s, records %u in / %u out: connected in %lu ms, %ld bytes of heap held "
+           "by the connection, heap high-water %lu bytes\n",
+           TLS_PROFILE_NAME, (unsigned int)MBEDTLS_SSL_IN_CONTENT_LEN, (unsigned int)MBEDTLS_SSL_OUT_CONTENT_LEN,
+           (unsigned long)connect_ms, (long)bench_heap_in_use() - (long)heap_before,
+           (unsigned long)bench_heap_high_water());
+}
+
+/* [] END OF FILE */
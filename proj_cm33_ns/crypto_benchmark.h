@@ -0,0 +1,80 @@
+/******************************************************************************
+* File Name:   crypto_benchmark.h
+*
+* Description: This file is the public interface of crypto_benchmark.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CRYPTO_BENCHMARK_H_
+#define CRYPTO_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set to 1 to run the crypto benchmark once at start-up, before Wi-Fi is
+ * brought up, and to report the cost of every broker connection. Build once
+ * as is and once with DISABLE_MBEDTLS_ACCELERATION added to DEFINES to
+ * compare the hardware and software implementations, and once per
+ * TLS_PROFILE (mbedtls_user_config.h) to compare the handshake profiles.
+ */
+#define CRYPTO_BENCHMARK_ENABLE             (0)
+
+/* Minimum measurement time of one primitive. Every primitive runs at least
+ * CRYPTO_BENCHMARK_MIN_ITERATIONS times, even when that takes longer.
+ */
+#define CRYPTO_BENCHMARK_MIN_TIME_MS        (1000U)
+#define CRYPTO_BENCHMARK_MIN_ITERATIONS     (4U)
+
+/* Size of the record encrypted by AES-GCM and hashed by SHA-256/384. A full
+ * TLS record is 16 KB; 1 KB matches the MQTT publishes of this application.
+ */
+#define CRYPTO_BENCHMARK_BUFFER_SIZE        (1024U)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int crypto_benchmark_run(const unsigned char *root_ca_pem, size_t root_ca_pem_len,
+                         const char *server_name);
+size_t crypto_benchmark_heap_in_use(void);
+void crypto_benchmark_report_connect(uint32_t connect_ms, size_t heap_before);
+
+#endif /* CRYPTO_BENCHMARK_H_ */
+
+/* [] END OF FILE */
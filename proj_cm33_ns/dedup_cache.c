@@ -0,0 +1,264 @@
+/******************************************************************************
+* File Name:   dedup_cache.c
+*
+* Description: This file contains the duplicate suppression of incoming QoS 1
+*              messages. Recently received messages are remembered by packet
+*              identifier and content hash in a small open-addressed table,
+*              so a redelivered command is dropped in constant time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "cybsp.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "dedup_cache.h"
+#include "publish_metrics.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* FNV-1a parameters. */
+#define DEDUP_FNV_OFFSET_BASIS              (2166136261UL)
+#define DEDUP_FNV_PRIME                     (16777619UL)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Cache slot. 'stamp' orders the slots by insertion; 0 marks a free slot. */
+typedef struct
+{
+    uint32_t hash;
+    uint16_t packet_id;
+    uint16_t stamp;
+} dedup_slot_t;
+
+static dedup_slot_t dedup_slots[DEDUP_CACHE_SLOTS] __attribute__((aligned(32)));
+static uint16_t dedup_stamp;
+static uint32_t dedup_hits;
+static uint32_t dedup_checked;
+
+/******************************************************************************
+ * Function Name: dedup_cache_hash
+ ******************************************************************************
+ * Summary:
+ *  FNV-1a hash over the topic and the payload of a message.
+ *
+ * Parameters:
+ *  const char *topic : Topic
+ *  size_t topic_len : Length of the topic
+ *  const void *payload : Payload
+ *  size_t payload_len : Length of the payload
+ *
+ * Return:
+ *  uint32_t : Hash
+ *
+ ******************************************************************************/
+static uint32_t dedup_cache_hash(const char *topic, size_t topic_len, const void *payload, size_t payload_len)
+{
+    uint32_t hash = DEDUP_FNV_OFFSET_BASIS;
+    const uint8_t *data = (const uint8_t *)payload;
+
+    for (size_t i = 0U; i < topic_len; i++)
+    {
+        hash = (hash ^ (uint8_t)topic[i]) * DEDUP_FNV_PRIME;
+    }
+    for (size_t i = 0U; i < payload_len; i++)
+    {
+        hash = (hash ^ data[i]) * DEDUP_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/******************************************************************************
+ * Function Name: dedup_cache_format_json
+ ******************************************************************************
+ * Summary:
+ *  Formats the cache counters for the metrics report.
+ *
+ * Parameters:
+ *  char *buffer : Output buffer
+ *  size_t buffer_len : Size of the output buffer
+ *  size_t *used : Number of characters already in the buffer; updated
+ *
+ * Return:
+ *  bool : true if the section fit into the buffer, else false
+ *
+ ******************************************************************************/
+static bool dedup_cache_format_json(char *buffer, size_t buffer_len, size_t *used)
+{
+    return publish_metrics_append(buffer, buffer_len, used, "{\"checked\":%lu,\"dropped\":%lu}",
+                                  (unsigned long)dedup_checked, (unsigned long)dedup_hits);
+}
+
+/******************************************************************************
+ * Function Name: dedup_cache_print
+ ******************************************************************************
+ * Summary:
+ *  Prints the cache counters on the debug UART.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void dedup_cache_print(void)
+{
+    printf("Duplicate suppression: %lu QoS 1 messages checked, %lu dropped\n",
+           (unsigned long)dedup_checked, (unsigned long)dedup_hits);
+}
+
+/******************************************************************************
+ * Function Name: dedup_cache_init
+ ******************************************************************************
+ * Summary:
+ *  Adds the cache counters to the metrics report.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void dedup_cache_init(void)
+{
+    publish_metrics_register_section("dedup", dedup_cache_format_json, dedup_cache_print);
+}
+
+/******************************************************************************
+ * Function Name: dedup_cache_check
+ ******************************************************************************
+ * Summary:
+ *  Checks an incoming message against the cache and remembers it. A message
+ *  is a duplicate if it is a redelivery (DUP flag set) with the packet
+ *  identifier and content of a remembered message. Messages without a packet
+ *  identifier (QoS 0) are never redelivered and are not cached. The packet
+ *  identifier selects one set of DEDUP_CACHE_PROBE_LIMIT slots, so the
+ *  identifiers a broker assigns in sequence spread over all sets. A
+ *  remembered message with the same identifier is replaced: the broker
+ *  reuses an identifier only once the earlier message was acknowledged.
+ *  When all slots of the set are in use, the oldest of them is replaced.
+ *
+ * Parameters:
+ *  uint16_t packet_id : Packet identifier of the PUBLISH, 0 for QoS 0
+ *  bool dup : DUP flag of the PUBLISH
+ *  const char *topic : Topic
+ *  size_t topic_len : Length of the topic
+ *  const void *payload : Payload
+ *  size_t payload_len : Length of the payload
+ *
+ * Return:
+ *  bool : true if the message is a duplicate and must be dropped
+ *
+ ******************************************************************************/
+bool dedup_cache_check(uint16_t packet_id, bool dup, const char *topic, size_t topic_len,
+                       const void *payload, size_t payload_len)
+{
+    uint32_t hash;
+    uint32_t home;
+    dedup_slot_t *slot;
+    dedup_slot_t *victim = NULL;
+
+    if (0U == packet_id)
+    {
+        return false;
+    }
+
+    dedup_checked++;
+    hash = dedup_cache_hash(topic, topic_len, payload, payload_len);
+    home = ((uint32_t)packet_id * DEDUP_CACHE_PROBE_LIMIT) & (DEDUP_CACHE_SLOTS - DEDUP_CACHE_PROBE_LIMIT);
+
+    for (uint32_t i = 0U; i < DEDUP_CACHE_PROBE_LIMIT; i++)
+    {
+        slot = &dedup_slots[home + i];
+
+        if ((0U != slot->stamp) && (slot->packet_id == packet_id))
+        {
+            if (dup && (slot->hash == hash))
+            {
+                dedup_hits++;
+                printf("  Subscriber: Dropped redelivered message %u on '%.*s'\n",
+                       (unsigned int)packet_id, (int)topic_len, topic);
+                return true;
+            }
+
+            /* New message, or other content under a reused identifier. */
+            victim = slot;
+            break;
+        }
+
+        /* Prefer a free slot, else the oldest one of the window. */
+        if ((NULL == victim) || ((0U != victim->stamp) &&
+            ((0U == slot->stamp) || ((int16_t)(slot->stamp - victim->stamp) < 0))))
+        {
+            victim = slot;
+        }
+    }
+
+    if (0U == ++dedup_stamp)
+    {
+        dedup_stamp = 1U;
+    }
+    victim->hash = hash;
+    victim->packet_id = packet_id;
+    victim->stamp = dedup_stamp;
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: dedup_cache_hits
+ ******************************************************************************
+ * Summary:
+ *  Returns the number of dropped duplicates.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Number of dropped duplicates
+ *
+ ******************************************************************************/
+uint32_t dedup_cache_hits(void)
+{
+    return dedup_hits;
+}
+
+/* [] END OF FILE */
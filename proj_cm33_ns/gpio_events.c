@@ -0,0 +1,726 @@
+/******************************************************************************
+* File Name:   gpio_events.c
+*
+* Description: This file contains the GPIO event engine. The interrupt only
+*              records timestamped edges in a lock-free ring; a software
+*              timer runs the debouncer, which turns them into press, multi-
+*              press and long-press events for any number of inputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "gpio_events.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* An input level counts once it has been stable for this long. */
+#define GPIO_EVENTS_DEBOUNCE_MS             (20U)
+
+/* A press held this long is reported as a long press. */
+#define GPIO_EVENTS_LONG_PRESS_MS           (1000U)
+
+/* Presses less than this apart (release to press) form a multi-press. A
+ * single press is reported once this time has passed after its release.
+ */
+#define GPIO_EVENTS_MULTI_PRESS_GAP_MS      (300U)
+
+#define GPIO_EVENTS_RING_MASK               (GPIO_EVENTS_RING_SIZE - 1U)
+
+#if (0U != (GPIO_EVENTS_RING_SIZE & GPIO_EVENTS_RING_MASK))
+    #error "GPIO_EVENTS_RING_SIZE must be a power of two!"
+#endif
+
+#define GPIO_EVENTS_BARRIER()               __DMB()
+
+/* Priority of the GPIO interrupts. All inputs share it, so that the edge
+ * ring has a single producer at a time.
+ */
+#define GPIO_EVENTS_INTERRUPT_PRIORITY      (7U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Edge recorded by the interrupt. */
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t input;
+    bool level;
+} gpio_edge_t;
+
+/* Debouncer state of an input. 'raw' follows the edges, 'stable' the
+ * debounced level; both are true while the input is pressed.
+ */
+typedef struct
+{
+    gpio_event_input_t config;
+    bool raw;
+    uint32_t raw_ms;
+    bool stable;
+    uint32_t press_ms;
+    uint32_t release_ms;
+    uint8_t count;
+    bool long_reported;
+} gpio_input_state_t;
+
+static gpio_input_state_t inputs[GPIO_EVENTS_MAX_INPUTS];
+static uint32_t input_count;
+
+/* Single-producer, single-consumer ring: the interrupt advances the head,
+ * the debouncer the tail.
+ */
+static gpio_edge_t edge_ring[GPIO_EVENTS_RING_SIZE];
+static volatile uint32_t ring_head;
+static volatile uint32_t ring_tail;
+static volatile uint32_t ring_overflows;
+
+/* Debouncer timer; armed from the interrupt, re-armed while an input is
+ * active and left stopped when all inputs are idle.
+ */
+static TimerHandle_t debounce_timer;
+static volatile bool debounce_timer_armed;
+static volatile uint32_t debounce_timer_due_ms;
+static uint32_t overflows_handled;
+
+/* NVIC lines of the registered inputs. */
+static IRQn_Type input_irqs[GPIO_EVENTS_MAX_INPUTS];
+static uint32_t input_irq_count;
+
+/******************************************************************************
+ * Function Name: gpio_events_pop_edge
+ ******************************************************************************
+ * Summary:
+ *  Takes the oldest edge from the ring.
+ *
+ * Parameters:
+ *  gpio_edge_t *edge : Edge taken; set on success
+ *
+ * Return:
+ *  bool : false if the ring is empty
+ *
+ ******************************************************************************/
+static bool gpio_events_pop_edge(gpio_edge_t *edge)
+{
+    uint32_t tail = ring_tail;
+
+    if (tail == ring_head)
+    {
+        return false;
+    }
+
+    GPIO_EVENTS_BARRIER();
+    *edge = edge_ring[tail & GPIO_EVENTS_RING_MASK];
+    GPIO_EVENTS_BARRIER();
+    ring_tail = tail + 1U;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_emit
+ ******************************************************************************
+ * Summary:
+ *  Passes an event to the handler of its input.
+ *
+ * Parameters:
+ *  uint32_t index : Input index
+ *  gpio_event_type_t type : Event type
+ *  uint8_t count : Number of presses
+ *  uint32_t time_ms : Time of the event
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void gpio_events_emit(uint32_t index, gpio_event_type_t type, uint8_t count, uint32_t time_ms)
+{
+    gpio_event_t event =
+    {
+        .input = (uint8_t)index,
+        .type = type,
+        .count = count,
+        .time_ms = time_ms
+    };
+
+    if (NULL != inputs[index].config.handler)
+    {
+        inputs[index].config.handler(&event, inputs[index].config.context);
+    }
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_flush_presses
+ ******************************************************************************
+ * Summary:
+ *  Reports the short presses counted so far as one event.
+ *
+ * Parameters:
+ *  uint32_t index : Input index
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void gpio_events_flush_presses(uint32_t index)
+{
+    gpio_input_state_t *state = &inputs[index];
+
+    gpio_events_emit(index, (1U == state->count) ? GPIO_EVENT_PRESS : GPIO_EVENT_MULTI_PRESS,
+                     state->count, state->release_ms);
+    state->count = 0U;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_evaluate
+ ******************************************************************************
+ * Summary:
+ *  Advances the debouncer of an input to the given time: commits a level
+ *  that has been stable for GPIO_EVENTS_DEBOUNCE_MS, and reports long
+ *  presses and completed press sequences. Edges are evaluated at their own
+ *  time stamps, so a late run of the debouncer gives the same events.
+ *
+ * Parameters:
+ *  uint32_t index : Input index
+ *  uint32_t time_ms : Time to evaluate at
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void gpio_events_evaluate(uint32_t index, uint32_t time_ms)
+{
+    gpio_input_state_t *state = &inputs[index];
+
+    if ((state->raw != state->stable) && ((time_ms - state->raw_ms) >= GPIO_EVENTS_DEBOUNCE_MS))
+    {
+        state->stable = state->raw;
+        if (state->stable)
+        {
+            if ((0U != state->count) && ((state->raw_ms - state->release_ms) >= GPIO_EVENTS_MULTI_PRESS_GAP_MS))
+            {
+                gpio_events_flush_presses(index);
+            }
+            state->press_ms = state->raw_ms;
+            state->long_reported = false;
+        }
+        else if (!state->long_reported)
+        {
+            if (UINT8_MAX != state->count)
+            {
+                state->count++;
+            }
+            state->release_ms = state->raw_ms;
+        }
+    }
+
+    if (state->stable && !state->long_reported && ((time_ms - state->press_ms) >= GPIO_EVENTS_LONG_PRESS_MS))
+    {
+        if (0U != state->count)
+        {
+            gpio_events_flush_presses(index);
+        }
+        state->long_reported = true;
+        gpio_events_emit(index, GPIO_EVENT_LONG_PRESS, 1U, state->press_ms + GPIO_EVENTS_LONG_PRESS_MS);
+    }
+
+    /* Wait for a press that started within the gap to settle. */
+    if (!state->stable && (0U != state->count) &&
+        ((time_ms - state->release_ms) >= GPIO_EVENTS_MULTI_PRESS_GAP_MS) &&
+        !(state->raw && ((state->raw_ms - state->release_ms) < GPIO_EVENTS_MULTI_PRESS_GAP_MS)))
+    {
+        gpio_events_flush_presses(index);
+    }
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_remaining
+ ******************************************************************************
+ * Summary:
+ *  Returns the time from now until a deadline, 0 if it has passed.
+ *
+ * Parameters:
+ *  uint32_t deadline_ms : Deadline
+ *  uint32_t now_ms : Current time
+ *
+ * Return:
+ *  uint32_t : Milliseconds until the deadline
+ *
+ ******************************************************************************/
+static uint32_t gpio_events_remaining(uint32_t deadline_ms, uint32_t now_ms)
+{
+    return ((int32_t)(deadline_ms - now_ms) > 0) ? (deadline_ms - now_ms) : 0U;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_next_run
+ ******************************************************************************
+ * Summary:
+ *  Determines when the debouncer of an input needs to run next.
+ *
+ * Parameters:
+ *  uint32_t index : Input index
+ *  uint32_t now_ms : Current time
+ *
+ * Return:
+ *  uint32_t : Milliseconds until the next run, GPIO_EVENTS_IDLE if none
+ *
+ ******************************************************************************/
+static uint32_t gpio_events_next_run(uint32_t index, uint32_t now_ms)
+{
+    const gpio_input_state_t *state = &inputs[index];
+    uint32_t next = GPIO_EVENTS_IDLE;
+    uint32_t remaining;
+
+    if (state->raw != state->stable)
+    {
+        next = gpio_events_remaining(state->raw_ms + GPIO_EVENTS_DEBOUNCE_MS, now_ms);
+    }
+    if (state->stable && !state->long_reported)
+    {
+        remaining = gpio_events_remaining(state->press_ms + GPIO_EVENTS_LONG_PRESS_MS, now_ms);
+        next = (remaining < next) ? remaining : next;
+    }
+    if (!state->stable && (0U != state->count))
+    {
+        remaining = gpio_events_remaining(state->release_ms + GPIO_EVENTS_MULTI_PRESS_GAP_MS, now_ms);
+        next = (remaining < next) ? remaining : next;
+    }
+
+    return next;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_add_input
+ ******************************************************************************
+ * Summary:
+ *  Adds an input to the debouncer, released at time 0. Must be called
+ *  before edges of the input are pushed.
+ *
+ * Parameters:
+ *  const gpio_event_input_t *input : Input; copied
+ *
+ * Return:
+ *  int32_t : Index of the input, -1 if all GPIO_EVENTS_MAX_INPUTS are in use
+ *
+ ******************************************************************************/
+int32_t gpio_events_add_input(const gpio_event_input_t *input)
+{
+    gpio_input_state_t *state;
+
+    if (input_count >= GPIO_EVENTS_MAX_INPUTS)
+    {
+        return -1;
+    }
+
+    state = &inputs[input_count];
+    memset(state, 0, sizeof(*state));
+    state->config = *input;
+
+    return (int32_t)input_count++;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_push_edge
+ ******************************************************************************
+ * Summary:
+ *  Records an edge of an input. Called from the GPIO interrupt; all callers
+ *  must run at the same interrupt priority.
+ *
+ * Parameters:
+ *  uint8_t input : Input index
+ *  bool level : Pin level after the edge
+ *  uint32_t time_ms : Time of the edge
+ *
+ * Return:
+ *  bool : false if the ring was full and the edge was dropped
+ *
+ ******************************************************************************/
+bool gpio_events_push_edge(uint8_t input, bool level, uint32_t time_ms)
+{
+    uint32_t head = ring_head;
+    gpio_edge_t *edge;
+
+    if ((head - ring_tail) >= GPIO_EVENTS_RING_SIZE)
+    {
+        ring_overflows++;
+        return false;
+    }
+
+    edge = &edge_ring[head & GPIO_EVENTS_RING_MASK];
+    edge->time_ms = time_ms;
+    edge->input = input;
+    edge->level = level;
+    GPIO_EVENTS_BARRIER();
+    ring_head = head + 1U;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_resync
+ ******************************************************************************
+ * Summary:
+ *  Sets the level of an input read from the pin, after edges were dropped.
+ *  Called from the debouncer context.
+ *
+ * Parameters:
+ *  uint8_t input : Input index
+ *  bool level : Pin level
+ *  uint32_t time_ms : Time the level was read
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void gpio_events_resync(uint8_t input, bool level, uint32_t time_ms)
+{
+    gpio_input_state_t *state = &inputs[input];
+    bool pressed = (level != state->config.active_low);
+
+    if (pressed != state->raw)
+    {
+        gpio_events_evaluate(input, time_ms);
+        state->raw = pressed;
+        state->raw_ms = time_ms;
+    }
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_process
+ ******************************************************************************
+ * Summary:
+ *  Runs the debouncer: applies the recorded edges, reports the resulting
+ *  events to the input handlers and determines when it needs to run again.
+ *
+ * Parameters:
+ *  uint32_t now_ms : Current time
+ *
+ * Return:
+ *  uint32_t : Milliseconds until the next run, GPIO_EVENTS_IDLE if all
+ *             inputs are idle
+ *
+ ******************************************************************************/
+uint32_t gpio_events_process(uint32_t now_ms)
+{
+    gpio_edge_t edge;
+    gpio_input_state_t *state;
+    uint32_t next = GPIO_EVENTS_IDLE;
+    uint32_t remaining;
+
+    while (gpio_events_pop_edge(&edge))
+    {
+        if (edge.input >= input_count)
+        {
+            continue;
+        }
+
+        /* Settle the level before the edge, then start a new bounce. */
+        gpio_events_evaluate(edge.input, edge.time_ms);
+        state = &inputs[edge.input];
+        state->raw = (edge.level != state->config.active_low);
+        state->raw_ms = edge.time_ms;
+    }
+
+    for (uint32_t i = 0U; i < input_count; i++)
+    {
+        gpio_events_evaluate(i, now_ms);
+        remaining = gpio_events_next_run(i, now_ms);
+        next = (remaining < next) ? remaining : next;
+    }
+
+    return next;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_overflows
+ ******************************************************************************
+ * Summary:
+ *  Returns the number of edges dropped because the ring was full.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Dropped edges since boot
+ *
+ ******************************************************************************/
+uint32_t gpio_events_overflows(void)
+{
+    return ring_overflows;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_now_ms
+ ******************************************************************************
+ * Summary:
+ *  Time base of the edges. Safe to call from an ISR.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Milliseconds since the scheduler started
+ *
+ ******************************************************************************/
+static uint32_t gpio_events_now_ms(void)
+{
+    return (uint32_t)(xTaskGetTickCountFromISR() * portTICK_PERIOD_MS);
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_isr
+ ******************************************************************************
+ * Summary:
+ *  GPIO interrupt handler shared by all inputs. Records an edge for every
+ *  registered pin that has its interrupt flag set and clears only those
+ *  flags, then makes the debouncer run GPIO_EVENTS_DEBOUNCE_MS later unless
+ *  it is due by then anyway, e.g. while the rest of a bounce comes in.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void gpio_events_isr(void)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint32_t now_ms = gpio_events_now_ms();
+    const gpio_event_input_t *config;
+    bool edge_seen = false;
+
+    for (uint32_t i = 0U; i < input_count; i++)
+    {
+        config = &inputs[i].config;
+        if (0U != Cy_GPIO_GetInterruptStatus(config->port, config->pin))
+        {
+            Cy_GPIO_ClearInterrupt(config->port, config->pin);
+            NVIC_ClearPendingIRQ(config->irq);
+            (void) gpio_events_push_edge((uint8_t)i, 0U != Cy_GPIO_Read(config->port, config->pin), now_ms);
+            edge_seen = true;
+        }
+    }
+
+    if (edge_seen &&
+        (!debounce_timer_armed || ((int32_t)(debounce_timer_due_ms - now_ms) > (int32_t)GPIO_EVENTS_DEBOUNCE_MS)))
+    {
+        debounce_timer_armed = true;
+        debounce_timer_due_ms = now_ms + GPIO_EVENTS_DEBOUNCE_MS;
+        (void) xTimerChangePeriodFromISR(debounce_timer, pdMS_TO_TICKS(GPIO_EVENTS_DEBOUNCE_MS),
+                                         &higher_priority_task_woken);
+    }
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_timer_callback
+ ******************************************************************************
+ * Summary:
+ *  Runs the debouncer in the timer service task and re-arms the timer
+ *  while an input is active. After dropped edges the pin levels are read
+ *  back, so that a full ring never leaves an input stuck.
+ *
+ * Parameters:
+ *  TimerHandle_t timer : Debouncer timer
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void gpio_events_timer_callback(TimerHandle_t timer)
+{
+    uint32_t now_ms = gpio_events_now_ms();
+    uint32_t overflows = gpio_events_overflows();
+    uint32_t next;
+
+    if (overflows != overflows_handled)
+    {
+        overflows_handled = overflows;
+        (void) gpio_events_process(now_ms);
+        for (uint32_t i = 0U; i < input_count; i++)
+        {
+            gpio_events_resync((uint8_t)i, 0U != Cy_GPIO_Read(inputs[i].config.port, inputs[i].config.pin),
+                               now_ms);
+        }
+    }
+
+    next = gpio_events_process(now_ms);
+    if (GPIO_EVENTS_IDLE != next)
+    {
+        next = (0U == next) ? 1U : next;
+        debounce_timer_due_ms = now_ms + next;
+        (void) xTimerChangePeriod(timer, pdMS_TO_TICKS(next), 0U);
+        return;
+    }
+
+    /* An edge recorded after the ring was drained found the timer armed. */
+    debounce_timer_armed = false;
+    GPIO_EVENTS_BARRIER();
+    if (ring_tail != ring_head)
+    {
+        debounce_timer_armed = true;
+        debounce_timer_due_ms = now_ms + GPIO_EVENTS_DEBOUNCE_MS;
+        (void) xTimerChangePeriod(timer, pdMS_TO_TICKS(GPIO_EVENTS_DEBOUNCE_MS), 0U);
+    }
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_register
+ ******************************************************************************
+ * Summary:
+ *  Adds a GPIO input. Its pin interrupt is set to both edges and the port
+ *  interrupt is routed to the shared handler. The pin must be configured as
+ *  an input by the BSP. Call before gpio_events_enable().
+ *
+ * Parameters:
+ *  const gpio_event_input_t *input : Input; copied
+ *
+ * Return:
+ *  int32_t : Index of the input, -1 on failure
+ *
+ ******************************************************************************/
+int32_t gpio_events_register(const gpio_event_input_t *input)
+{
+    cy_stc_sysint_t intr_cfg =
+    {
+        .intrSrc = input->irq,
+        .intrPriority = GPIO_EVENTS_INTERRUPT_PRIORITY
+    };
+    uint32_t irq_index;
+    int32_t index;
+
+    if (NULL == debounce_timer)
+    {
+        debounce_timer = xTimerCreate("GPIO events", pdMS_TO_TICKS(GPIO_EVENTS_DEBOUNCE_MS), pdFALSE,
+                                      NULL, gpio_events_timer_callback);
+        if (NULL == debounce_timer)
+        {
+            return -1;
+        }
+    }
+
+    index = gpio_events_add_input(input);
+    if (index < 0)
+    {
+        return -1;
+    }
+
+    Cy_GPIO_SetInterruptEdge(input->port, input->pin, CY_GPIO_INTR_BOTH);
+    Cy_GPIO_ClearInterrupt(input->port, input->pin);
+    gpio_events_resync((uint8_t)index, 0U != Cy_GPIO_Read(input->port, input->pin), gpio_events_now_ms());
+
+    for (irq_index = 0U; irq_index < input_irq_count; irq_index++)
+    {
+        if (input_irqs[irq_index] == input->irq)
+        {
+            return index;
+        }
+    }
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&intr_cfg, gpio_events_isr))
+    {
+        input_count--;
+        return -1;
+    }
+    input_irqs[input_irq_count++] = input->irq;
+
+    return index;
+}
+
+/******************************************************************************
+ * Function Name: gpio_events_enable
+ ******************************************************************************
+ * Summary:
+ *  Enables or disables the interrupts of all inputs. On enabling, pending
+ *  interrupt flags are discarded and the debouncer starts from the pin
+ *  levels.
+ *
+ * Parameters:
+ *  bool enable : true to enable
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void gpio_events_enable(bool enable)
+{
+    const gpio_event_input_t *config;
+
+    if (enable)
+    {
+        /* The debouncer runs in the timer service task. */
+        vTaskSuspendAll();
+        for (uint32_t i = 0U; i < input_count; i++)
+        {
+            config = &inputs[i].config;
+            Cy_GPIO_ClearInterrupt(config->port, config->pin);
+            gpio_events_resync((uint8_t)i, 0U != Cy_GPIO_Read(config->port, config->pin),
+                               gpio_events_now_ms());
+        }
+        (void) xTaskResumeAll();
+
+        /* Settle the levels read back. */
+        debounce_timer_armed = true;
+        debounce_timer_due_ms = gpio_events_now_ms() + GPIO_EVENTS_DEBOUNCE_MS;
+        (void) xTimerChangePeriod(debounce_timer, pdMS_TO_TICKS(GPIO_EVENTS_DEBOUNCE_MS), 0U);
+    }
+
+    for (uint32_t i = 0U; i < input_irq_count; i++)
+    {
+        if (enable)
+        {
+            NVIC_ClearPendingIRQ(input_irqs[i]);
+            NVIC_EnableIRQ(input_irqs[i]);
+        }
+        else
+        {
+            NVIC_DisableIRQ(input_irqs[i]);
+        }
+    }
+}
+
+/* [] END OF FILE */
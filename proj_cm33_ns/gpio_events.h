@@ -0,0 +1,114 @@
+/******************************************************************************
+* File Name:   gpio_events.h
+*
+* Description: This file contains the declarations of the GPIO event engine,
+*              which turns timestamped input edges into debounced press,
+*              multi-press and long-press events.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef GPIO_EVENTS_H_
+#define GPIO_EVENTS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cybsp.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Maximum number of inputs. */
+#define GPIO_EVENTS_MAX_INPUTS              (8U)
+
+/* Number of edges the ring holds between two runs of the debouncer; a power
+ * of two.
+ */
+#define GPIO_EVENTS_RING_SIZE               (32U)
+
+/* Returned by gpio_events_process() when no input needs another run. */
+#define GPIO_EVENTS_IDLE                    (UINT32_MAX)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Debounced events of an input. */
+typedef enum
+{
+    GPIO_EVENT_PRESS,       /* A single short press */
+    GPIO_EVENT_MULTI_PRESS, /* 'count' short presses in quick succession */
+    GPIO_EVENT_LONG_PRESS   /* Held for GPIO_EVENTS_LONG_PRESS_MS */
+} gpio_event_type_t;
+
+typedef struct
+{
+    uint8_t input;          /* Index returned by gpio_events_add_input() */
+    gpio_event_type_t type;
+    uint8_t count;          /* Number of presses; 1 unless GPIO_EVENT_MULTI_PRESS */
+    uint32_t time_ms;       /* Time of the last release or the long-press threshold */
+} gpio_event_t;
+
+/* Called from the debouncer (the timer service task on the target). */
+typedef void (*gpio_event_handler_t)(const gpio_event_t *event, void *context);
+
+/* Input handled by the engine. */
+typedef struct
+{
+    const char *name;
+    GPIO_PRT_Type *port;
+    uint32_t pin;
+    IRQn_Type irq;          /* NVIC line of the port */
+    bool active_low;
+    gpio_event_handler_t handler;
+    void *context;
+} gpio_event_input_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int32_t gpio_events_add_input(const gpio_event_input_t *input);
+bool gpio_events_push_edge(uint8_t input, bool level, uint32_t time_ms);
+void gpio_events_resync(uint8_t input, bool level, uint32_t time_ms);
+uint32_t gpio_events_process(uint32_t now_ms);
+uint32_t gpio_events_overflows(void);
+
+int32_t gpio_events_register(const gpio_event_input_t *input);
+void gpio_events_enable(bool enable);
+
+#endif /* GPIO_EVENTS_H_ */
+
+/* [] END OF FILE */
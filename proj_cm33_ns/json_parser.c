@@ -0,0 +1,566 @@
+/******************************************************************************
+* File Name:   json_parser.c
+*
+* Description: This file contains an incremental SAX-style JSON parser. Input
+*              is consumed in place in chunks of any size; tokens are
+*              reported through a callback and only tokens split across two
+*              chunks are copied.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "json_parser.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Parser states. */
+#define JSON_STATE_VALUE                    (0U)    /* Expecting a value */
+#define JSON_STATE_VALUE_OR_END             (1U)    /* After '[' */
+#define JSON_STATE_KEY                      (2U)    /* After ',' in an object */
+#define JSON_STATE_KEY_OR_END               (3U)    /* After '{' */
+#define JSON_STATE_COLON                    (4U)
+#define JSON_STATE_AFTER_VALUE              (5U)
+#define JSON_STATE_STRING                   (6U)
+#define JSON_STATE_KEY_STRING               (7U)
+#define JSON_STATE_NUMBER                   (8U)
+#define JSON_STATE_LITERAL                  (9U)
+#define JSON_STATE_DONE                     (10U)
+#define JSON_STATE_ERROR                    (11U)
+
+#define JSON_IS_WHITESPACE(c)               (((c) == ' ') || ((c) == '\t') || ((c) == '\n') || ((c) == '\r'))
+
+/* Numbers are only checked lexically; the consumer converts them. */
+#define JSON_IS_NUMBER_CHAR(c)              ((((c) >= '0') && ((c) <= '9')) || ((c) == '-') || \
+                                             ((c) == '+') || ((c) == '.') || ((c) == 'e') || ((c) == 'E'))
+
+#define JSON_IS_LITERAL_CHAR(c)             (((c) >= 'a') && ((c) <= 'z'))
+
+/******************************************************************************
+ * Function Name: json_parser_init
+ ******************************************************************************
+ * Summary:
+ *  Prepares the parser for a new document.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  json_event_callback_t callback : Called for every event
+ *  void *context : Passed to the callback
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void json_parser_init(json_parser_t *parser, json_event_callback_t callback, void *context)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->state = JSON_STATE_VALUE;
+    parser->callback = callback;
+    parser->context = context;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_token
+ ******************************************************************************
+ * Summary:
+ *  Returns the text of the token that ends in the current chunk. If the
+ *  token started in an earlier chunk, the rest is appended to the token
+ *  buffer and the buffer is returned.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  const char *start : Part of the token in the current chunk
+ *  size_t length : Length of that part
+ *  const char **text : Token text; set
+ *  size_t *text_length : Token length; set
+ *
+ * Return:
+ *  bool : false if the token does not fit into the token buffer
+ *
+ ******************************************************************************/
+static bool json_parser_token(json_parser_t *parser, const char *start, size_t length,
+                              const char **text, size_t *text_length)
+{
+    if (0U == parser->token_length)
+    {
+        *text = start;
+        *text_length = length;
+        return true;
+    }
+
+    if (length > (JSON_TOKEN_BUFFER_SIZE - parser->token_length))
+    {
+        return false;
+    }
+
+    memcpy(&parser->token[parser->token_length], start, length);
+    *text = parser->token;
+    *text_length = parser->token_length + length;
+    parser->token_length = 0U;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_emit
+ ******************************************************************************
+ * Summary:
+ *  Reports an event to the callback and enters the error state if the
+ *  callback aborts the parse.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  json_event_t event : Event
+ *  const char *text : Token text, NULL for structural events
+ *  size_t length : Token length
+ *
+ * Return:
+ *  bool : false if the parse was aborted
+ *
+ ******************************************************************************/
+static bool json_parser_emit(json_parser_t *parser, json_event_t event,
+                             const char *text, size_t length)
+{
+    if (!parser->callback(parser->context, event, parser->depth, text, length))
+    {
+        parser->state = JSON_STATE_ERROR;
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_value_done
+ ******************************************************************************
+ * Summary:
+ *  Advances the state after a complete value.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void json_parser_value_done(json_parser_t *parser)
+{
+    parser->state = (0U == parser->depth) ? JSON_STATE_DONE : JSON_STATE_AFTER_VALUE;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_push
+ ******************************************************************************
+ * Summary:
+ *  Opens an object or array.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  bool is_object : true for an object, false for an array
+ *
+ * Return:
+ *  bool : false if JSON_MAX_DEPTH is exceeded or the parse was aborted
+ *
+ ******************************************************************************/
+static bool json_parser_push(json_parser_t *parser, bool is_object)
+{
+    if (JSON_MAX_DEPTH <= parser->depth)
+    {
+        parser->state = JSON_STATE_ERROR;
+        return false;
+    }
+
+    if (!json_parser_emit(parser, is_object ? JSON_EVENT_OBJECT_START : JSON_EVENT_ARRAY_START,
+                          NULL, 0U))
+    {
+        return false;
+    }
+
+    if (is_object)
+    {
+        parser->object_stack |= (1UL << parser->depth);
+    }
+    else
+    {
+        parser->object_stack &= ~(1UL << parser->depth);
+    }
+    parser->depth++;
+    parser->state = is_object ? JSON_STATE_KEY_OR_END : JSON_STATE_VALUE_OR_END;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_pop
+ ******************************************************************************
+ * Summary:
+ *  Closes the innermost object or array if it matches the closing bracket.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  bool is_object : true for '}', false for ']'
+ *
+ * Return:
+ *  bool : false on a mismatched bracket or if the parse was aborted
+ *
+ ******************************************************************************/
+static bool json_parser_pop(json_parser_t *parser, bool is_object)
+{
+    bool top_is_object = (0U != (parser->object_stack & (1UL << (parser->depth - 1U))));
+
+    if (top_is_object != is_object)
+    {
+        parser->state = JSON_STATE_ERROR;
+        return false;
+    }
+
+    parser->depth--;
+    if (!json_parser_emit(parser, is_object ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END,
+                          NULL, 0U))
+    {
+        return false;
+    }
+    json_parser_value_done(parser);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_begin_value
+ ******************************************************************************
+ * Summary:
+ *  Handles the first character of a value.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  char c : First character of the value
+ *
+ * Return:
+ *  bool : false on a syntax error or if the parse was aborted
+ *
+ ******************************************************************************/
+static bool json_parser_begin_value(json_parser_t *parser, char c)
+{
+    if ('{' == c)
+    {
+        return json_parser_push(parser, true);
+    }
+    if ('[' == c)
+    {
+        return json_parser_push(parser, false);
+    }
+    if ('"' == c)
+    {
+        parser->state = JSON_STATE_STRING;
+        return true;
+    }
+    if (JSON_IS_NUMBER_CHAR(c))
+    {
+        parser->state = JSON_STATE_NUMBER;
+        return true;
+    }
+    if (JSON_IS_LITERAL_CHAR(c))
+    {
+        parser->state = JSON_STATE_LITERAL;
+        return true;
+    }
+
+    parser->state = JSON_STATE_ERROR;
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_end_scalar
+ ******************************************************************************
+ * Summary:
+ *  Reports a completed number or literal.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  const char *start : Part of the token in the current chunk
+ *  size_t length : Length of that part
+ *
+ * Return:
+ *  bool : false on an unknown literal, an overlong token or if the parse
+ *         was aborted
+ *
+ ******************************************************************************/
+static bool json_parser_end_scalar(json_parser_t *parser, const char *start, size_t length)
+{
+    const char *text;
+    size_t text_length;
+    json_event_t event = JSON_EVENT_NUMBER;
+
+    if (!json_parser_token(parser, start, length, &text, &text_length))
+    {
+        parser->state = JSON_STATE_ERROR;
+        return false;
+    }
+
+    if (JSON_STATE_LITERAL == parser->state)
+    {
+        if ((4U == text_length) && (0 == memcmp(text, "true", 4U)))
+        {
+            event = JSON_EVENT_TRUE;
+        }
+        else if ((5U == text_length) && (0 == memcmp(text, "false", 5U)))
+        {
+            event = JSON_EVENT_FALSE;
+        }
+        else if ((4U == text_length) && (0 == memcmp(text, "null", 4U)))
+        {
+            event = JSON_EVENT_NULL;
+        }
+        else
+        {
+            parser->state = JSON_STATE_ERROR;
+            return false;
+        }
+    }
+
+    if (!json_parser_emit(parser, event, text, text_length))
+    {
+        return false;
+    }
+    json_parser_value_done(parser);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_feed
+ ******************************************************************************
+ * Summary:
+ *  Parses the next chunk of the document. The chunk is read in place and
+ *  may end anywhere, including in the middle of a token.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *  const char *data : Next chunk of the document
+ *  size_t length : Length of the chunk
+ *
+ * Return:
+ *  json_status_t : JSON_STATUS_DONE once the top-level value is complete,
+ *                  JSON_STATUS_INCOMPLETE if more input is needed, or
+ *                  JSON_STATUS_ERROR
+ *
+ ******************************************************************************/
+json_status_t json_parser_feed(json_parser_t *parser, const char *data, size_t length)
+{
+    size_t i = 0U;
+    size_t token_start = 0U;
+    const char *text;
+    size_t text_length;
+    char c;
+
+    while ((i < length) && (JSON_STATE_ERROR != parser->state))
+    {
+        c = data[i];
+
+        switch (parser->state)
+        {
+            case JSON_STATE_STRING:
+            case JSON_STATE_KEY_STRING:
+            {
+                if (parser->escape)
+                {
+                    parser->escape = false;
+                }
+                else if ('\\' == c)
+                {
+                    parser->escape = true;
+                }
+                else if ('"' == c)
+                {
+                    if (!json_parser_token(parser, &data[token_start], i - token_start,
+                                           &text, &text_length))
+                    {
+                        parser->state = JSON_STATE_ERROR;
+                        break;
+                    }
+
+                    if (JSON_STATE_KEY_STRING == parser->state)
+                    {
+                        if (json_parser_emit(parser, JSON_EVENT_KEY, text, text_length))
+                        {
+                            parser->state = JSON_STATE_COLON;
+                        }
+                    }
+                    else if (json_parser_emit(parser, JSON_EVENT_STRING, text, text_length))
+                    {
+                        json_parser_value_done(parser);
+                    }
+                }
+                else if ((unsigned char)c < 0x20U)
+                {
+                    parser->state = JSON_STATE_ERROR;
+                }
+                i++;
+                break;
+            }
+
+            case JSON_STATE_NUMBER:
+            case JSON_STATE_LITERAL:
+            {
+                if ((JSON_STATE_NUMBER == parser->state) ? JSON_IS_NUMBER_CHAR(c) : JSON_IS_LITERAL_CHAR(c))
+                {
+                    i++;
+                }
+                else
+                {
+                    /* The terminating character is handled in the next state. */
+                    (void) json_parser_end_scalar(parser, &data[token_start], i - token_start);
+                }
+                break;
+            }
+
+            default:
+            {
+                i++;
+                if (JSON_IS_WHITESPACE(c))
+                {
+                    break;
+                }
+
+                switch (parser->state)
+                {
+                    case JSON_STATE_VALUE_OR_END:
+                        if (']' == c)
+                        {
+                            (void) json_parser_pop(parser, false);
+                            break;
+                        }
+                        /* Fall through */
+                    case JSON_STATE_VALUE:
+                        (void) json_parser_begin_value(parser, c);
+                        /* A number or literal starts with this character. */
+                        token_start = i - 1U;
+                        if ('"' == c)
+                        {
+                            token_start = i;
+                        }
+                        break;
+
+                    case JSON_STATE_KEY_OR_END:
+                        if ('}' == c)
+                        {
+                            (void) json_parser_pop(parser, true);
+                            break;
+                        }
+                        /* Fall through */
+                    case JSON_STATE_KEY:
+                        parser->state = ('"' == c) ? JSON_STATE_KEY_STRING : JSON_STATE_ERROR;
+                        token_start = i;
+                        break;
+
+                    case JSON_STATE_COLON:
+                        parser->state = (':' == c) ? JSON_STATE_VALUE : JSON_STATE_ERROR;
+                        break;
+
+                    case JSON_STATE_AFTER_VALUE:
+                        if (',' == c)
+                        {
+                            parser->state = (0U != (parser->object_stack & (1UL << (parser->depth - 1U)))) ?
+                                            JSON_STATE_KEY : JSON_STATE_VALUE;
+                        }
+                        else if (('}' == c) || (']' == c))
+                        {
+                            (void) json_parser_pop(parser, ('}' == c));
+                        }
+                        else
+                        {
+                            parser->state = JSON_STATE_ERROR;
+                        }
+                        break;
+
+                    default:
+                        /* Only whitespace may follow the top-level value. */
+                        parser->state = JSON_STATE_ERROR;
+                        break;
+                }
+                break;
+            }
+        }
+    }
+
+    if (JSON_STATE_ERROR == parser->state)
+    {
+        return JSON_STATUS_ERROR;
+    }
+
+    /* Keep the part of an unfinished token for the next chunk. */
+    if ((JSON_STATE_STRING == parser->state) || (JSON_STATE_KEY_STRING == parser->state) ||
+        (JSON_STATE_NUMBER == parser->state) || (JSON_STATE_LITERAL == parser->state))
+    {
+        if ((length - token_start) > (JSON_TOKEN_BUFFER_SIZE - parser->token_length))
+        {
+            parser->state = JSON_STATE_ERROR;
+            return JSON_STATUS_ERROR;
+        }
+        memcpy(&parser->token[parser->token_length], &data[token_start], length - token_start);
+        parser->token_length += length - token_start;
+    }
+
+    return (JSON_STATE_DONE == parser->state) ? JSON_STATUS_DONE : JSON_STATUS_INCOMPLETE;
+}
+
+/******************************************************************************
+ * Function Name: json_parser_finish
+ ******************************************************************************
+ * Summary:
+ *  Signals the end of the input. Completes a top-level number, which has no
+ *  terminating character.
+ *
+ * Parameters:
+ *  json_parser_t *parser : Parser state
+ *
+ * Return:
+ *  json_status_t : JSON_STATUS_DONE if the document was complete, else
+ *                  JSON_STATUS_ERROR
+ *
+ ******************************************************************************/
+json_status_t json_parser_finish(json_parser_t *parser)
+{
+    if ((JSON_STATE_NUMBER == parser->state) || (JSON_STATE_LITERAL == parser->state))
+    {
+        (void) json_parser_end_scalar(parser, parser->token, 0U);
+    }
+
+    return (JSON_STATE_DONE == parser->state) ? JSON_STATUS_DONE : JSON_STATUS_ERROR;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name:   json_parser.h
+*
+* Description: This file is the public interface of json_parser.c, an
+*              incremental SAX-style JSON parser that works in place on the
+*              input and does not allocate memory.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef JSON_PARSER_H_
+#define JSON_PARSER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Maximum nesting depth of objects and arrays. */
+#define JSON_MAX_DEPTH                      (16U)
+
+/* Size of the buffer holding a token that spans two input chunks. Tokens
+ * contained in a single chunk are reported in place and have no length limit.
+ * The configuration handler needs room for its longest value,
+ * CONFIG_STORE_MAX_VALUE_LEN.
+ */
+#define JSON_TOKEN_BUFFER_SIZE              (128U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Events reported by the parser. */
+typedef enum
+{
+    JSON_EVENT_OBJECT_START,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_KEY,
+    JSON_EVENT_STRING,
+    JSON_EVENT_NUMBER,
+    JSON_EVENT_TRUE,
+    JSON_EVENT_FALSE,
+    JSON_EVENT_NULL
+} json_event_t;
+
+/* Result of feeding input to the parser. */
+typedef enum
+{
+    JSON_STATUS_INCOMPLETE,
+    JSON_STATUS_DONE,
+    JSON_STATUS_ERROR
+} json_status_t;
+
+/* Called for every event. For keys, strings and numbers 'text' points to the
+ * token, without quotes and with escape sequences left undecoded; it is only
+ * valid during the call. 'depth' is the nesting depth of the token, 1 for
+ * members of the top-level object. Returning false aborts the parse.
+ */
+typedef bool (*json_event_callback_t)(void *context, json_event_t event, uint32_t depth,
+                                      const char *text, size_t length);
+
+/* Parser state. Can be resumed across any number of input chunks. */
+typedef struct
+{
+    uint8_t state;
+    bool escape;
+    uint32_t depth;
+    uint32_t object_stack;
+    char token[JSON_TOKEN_BUFFER_SIZE];
+    size_t token_length;
+    json_event_callback_t callback;
+    void *context;
+} json_parser_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void json_parser_init(json_parser_t *parser, json_event_callback_t callback, void *context);
+json_status_t json_parser_feed(json_parser_t *parser, const char *data, size_t length);
+json_status_t json_parser_finish(json_parser_t *parser);
+
+#endif /* JSON_PARSER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,401 @@
+/******************************************************************************
+* File Name:   keepalive_tuner.c
+*
+* Description: This file contains the adaptive MQTT keep-alive. The MQTT
+*              library does not report its PINGREQ/PINGRESP exchanges, so
+*              both estimates come from QoS 1 publishes: the PUBLISH/PUBACK
+*              round-trip time sets the PINGRESP timeout, and the gaps
+*              between acknowledged publishes are the idle periods from
+*              which the keep-alive interval converges on the longest one
+*              the network path survives.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "cybsp.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "keepalive_tuner.h"
+#include "mqtt_client_config.h"
+#include "publish_metrics.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Bounds of the PINGRESP timeout; the upper bound is the former fixed
+ * MQTT_PINGRESP_TIMEOUT_MS.
+ */
+#define KEEPALIVE_PINGRESP_TIMEOUT_MIN_MS   (1000U)
+#define KEEPALIVE_PINGRESP_TIMEOUT_MAX_MS   (5000U)
+
+/* Smoothing of the round-trip time as in RFC 6298: gains of 1/8 for the
+ * mean and 1/4 for the deviation, timeout of mean + 4 deviations.
+ */
+#define KEEPALIVE_SRTT_GAIN_SHIFT           (3U)
+#define KEEPALIVE_RTTVAR_GAIN_SHIFT         (2U)
+#define KEEPALIVE_RTTVAR_FACTOR             (4U)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Keep-alive interval of the current connection. */
+static uint32_t keepalive_sec = MQTT_KEEP_ALIVE_SECONDS;
+
+/* Longest idle period proven to survive, and shortest idle period after
+ * which the connection was lost (0 if none yet).
+ */
+static uint32_t keepalive_survived_sec;
+static uint32_t keepalive_failed_sec;
+
+/* Smoothed PUBLISH/PUBACK round-trip time and its mean deviation. */
+static uint32_t keepalive_puback_srtt_ms;
+static uint32_t keepalive_puback_rttvar_ms;
+static bool keepalive_puback_valid;
+
+/* Time of the last PUBACK (or of the CONNACK) on the current connection. */
+static TickType_t keepalive_last_ack;
+static bool keepalive_connected;
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_idle_sec
+ ******************************************************************************
+ * Summary:
+ *  Longest time without traffic since the last PUBACK. The client sends a
+ *  PINGREQ after 'keepalive_sec' of silence, so the idle period never
+ *  exceeds it; a ping exchange is not seen here and does not restart it.
+ *
+ * Parameters:
+ *  TickType_t now : Current tick count
+ *
+ * Return:
+ *  uint32_t : Idle period in seconds
+ *
+ ******************************************************************************/
+static uint32_t keepalive_tuner_idle_sec(TickType_t now)
+{
+    uint32_t idle_sec = (uint32_t)(((now - keepalive_last_ack) * portTICK_PERIOD_MS) / 1000U);
+
+    return (idle_sec < keepalive_sec) ? idle_sec : keepalive_sec;
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_format_json
+ ******************************************************************************
+ * Summary:
+ *  Formats the keep-alive state for the metrics report.
+ *
+ * Parameters:
+ *  char *buffer : Output buffer
+ *  size_t buffer_len : Size of the output buffer
+ *  size_t *used : Number of characters already in the buffer; updated
+ *
+ * Return:
+ *  bool : true if the section fit into the buffer, else false
+ *
+ ******************************************************************************/
+static bool keepalive_tuner_format_json(char *buffer, size_t buffer_len, size_t *used)
+{
+    return publish_metrics_append(buffer, buffer_len, used,
+                                  "{\"ka\":%lu,\"survived\":%lu,\"failed\":%lu,"
+                                  "\"puback_srtt\":%lu,\"puback_rttvar\":%lu,\"ping_to\":%lu}",
+                                  (unsigned long)keepalive_sec,
+                                  (unsigned long)keepalive_survived_sec,
+                                  (unsigned long)keepalive_failed_sec,
+                                  (unsigned long)keepalive_puback_srtt_ms,
+                                  (unsigned long)keepalive_puback_rttvar_ms,
+                                  (unsigned long)keepalive_tuner_puback_timeout_ms());
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_print
+ ******************************************************************************
+ * Summary:
+ *  Prints the keep-alive state on the debug UART.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void keepalive_tuner_print(void)
+{
+    printf("Keep-alive %lu s (survived %lu s, failed %lu s), PUBACK RTT %lu +/- %lu ms, PINGRESP timeout %lu ms\n",
+           (unsigned long)keepalive_sec, (unsigned long)keepalive_survived_sec,
+           (unsigned long)keepalive_failed_sec, (unsigned long)keepalive_puback_srtt_ms,
+           (unsigned long)keepalive_puback_rttvar_ms, (unsigned long)keepalive_tuner_puback_timeout_ms());
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_init
+ ******************************************************************************
+ * Summary:
+ *  Adds the keep-alive state to the metrics report.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void keepalive_tuner_init(void)
+{
+    publish_metrics_register_section("keepalive", keepalive_tuner_format_json, keepalive_tuner_print);
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_select
+ ******************************************************************************
+ * Summary:
+ *  Chooses the keep-alive interval of the next connection. Without a failed
+ *  idle period the configured interval is used. Otherwise the interval
+ *  bisects the range between the longest surviving and the shortest failed
+ *  idle period, so each connection narrows it down.
+ *
+ * Parameters:
+ *  uint16_t configured_sec : Configured keep-alive; the upper bound
+ *
+ * Return:
+ *  uint16_t : Keep-alive interval in seconds for the CONNECT packet
+ *
+ ******************************************************************************/
+uint16_t keepalive_tuner_select(uint16_t configured_sec)
+{
+    uint32_t selected = configured_sec;
+
+#if MQTT_ADAPTIVE_KEEP_ALIVE
+    uint32_t lower;
+    uint32_t upper;
+
+    taskENTER_CRITICAL();
+    if ((0U != keepalive_failed_sec) && (configured_sec > MQTT_KEEP_ALIVE_MIN_SECONDS))
+    {
+        lower = (keepalive_survived_sec > MQTT_KEEP_ALIVE_MIN_SECONDS) ?
+                keepalive_survived_sec : MQTT_KEEP_ALIVE_MIN_SECONDS;
+        upper = keepalive_failed_sec - 1U;
+
+        selected = (upper > lower) ? (lower + ((upper - lower) / 2U)) : lower;
+        if (selected > configured_sec)
+        {
+            selected = configured_sec;
+        }
+    }
+
+    keepalive_sec = selected;
+    taskEXIT_CRITICAL();
+
+    if (selected != configured_sec)
+    {
+        printf("Keep-alive: %lu s (survived %lu s, failed %lu s)\n", (unsigned long)selected,
+               (unsigned long)keepalive_survived_sec, (unsigned long)keepalive_failed_sec);
+    }
+#else
+    keepalive_sec = selected;
+#endif /* MQTT_ADAPTIVE_KEEP_ALIVE */
+
+    return (uint16_t)selected;
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_connected
+ ******************************************************************************
+ * Summary:
+ *  Starts timing the idle periods of a new connection.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void keepalive_tuner_connected(void)
+{
+    taskENTER_CRITICAL();
+    keepalive_last_ack = xTaskGetTickCount();
+    keepalive_connected = true;
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_record_puback
+ ******************************************************************************
+ * Summary:
+ *  Records the PUBACK of a QoS 1 PUBLISH: updates the smoothed PUBLISH/
+ *  PUBACK round-trip time and, since the connection was alive, the longest
+ *  surviving idle period. Connections that only exchange pings learn
+ *  neither.
+ *
+ * Parameters:
+ *  uint32_t rtt_ms : PUBLISH/PUBACK round-trip time in milliseconds
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void keepalive_tuner_record_puback(uint32_t rtt_ms)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t idle_sec;
+    uint32_t deviation;
+
+    taskENTER_CRITICAL();
+    if (!keepalive_puback_valid)
+    {
+        keepalive_puback_srtt_ms = rtt_ms;
+        keepalive_puback_rttvar_ms = rtt_ms / 2U;
+        keepalive_puback_valid = true;
+    }
+    else
+    {
+        deviation = (rtt_ms > keepalive_puback_srtt_ms) ? (rtt_ms - keepalive_puback_srtt_ms) :
+                    (keepalive_puback_srtt_ms - rtt_ms);
+        keepalive_puback_rttvar_ms = keepalive_puback_rttvar_ms -
+                                     (keepalive_puback_rttvar_ms >> KEEPALIVE_RTTVAR_GAIN_SHIFT) +
+                                     (deviation >> KEEPALIVE_RTTVAR_GAIN_SHIFT);
+        keepalive_puback_srtt_ms = keepalive_puback_srtt_ms -
+                                   (keepalive_puback_srtt_ms >> KEEPALIVE_SRTT_GAIN_SHIFT) +
+                                   (rtt_ms >> KEEPALIVE_SRTT_GAIN_SHIFT);
+    }
+
+    if (keepalive_connected)
+    {
+        idle_sec = keepalive_tuner_idle_sec(now);
+        if (idle_sec > keepalive_survived_sec)
+        {
+            keepalive_survived_sec = idle_sec;
+
+            /* The path changed (e.g. after a roam): forget the old failure. */
+            if ((0U != keepalive_failed_sec) && (keepalive_survived_sec >= keepalive_failed_sec))
+            {
+                keepalive_failed_sec = 0U;
+            }
+        }
+        keepalive_last_ack = now;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_link_lost
+ ******************************************************************************
+ * Summary:
+ *  Records an unexpected disconnection. If the connection had been idle
+ *  longer than any idle period proven to survive, the idle period is taken
+ *  as the new failure bound. Shorter idle periods point at another cause
+ *  and are not learned.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void keepalive_tuner_link_lost(void)
+{
+    uint32_t idle_sec;
+    bool learned = false;
+
+    taskENTER_CRITICAL();
+    if (keepalive_connected)
+    {
+        keepalive_connected = false;
+        idle_sec = keepalive_tuner_idle_sec(xTaskGetTickCount());
+        if ((idle_sec > keepalive_survived_sec) &&
+            ((0U == keepalive_failed_sec) || (idle_sec < keepalive_failed_sec)))
+        {
+            keepalive_failed_sec = idle_sec;
+            learned = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (learned)
+    {
+        printf("Keep-alive: connection lost after %lu s idle.\n", (unsigned long)keepalive_failed_sec);
+    }
+}
+
+/******************************************************************************
+ * Function Name: keepalive_tuner_puback_timeout_ms
+ ******************************************************************************
+ * Summary:
+ *  PINGRESP timeout of the MQTT library (MQTT_PINGRESP_TIMEOUT_MS in
+ *  core_mqtt_config.h) derived from the PUBLISH/PUBACK round-trip time:
+ *  the smoothed value plus four deviations. The broker answers a PINGREQ
+ *  without the delivery work of a PUBLISH, so this errs on the long side.
+ *  Until a PUBACK is measured, the fixed upper bound applies.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Timeout in milliseconds
+ *
+ ******************************************************************************/
+uint32_t keepalive_tuner_puback_timeout_ms(void)
+{
+#if MQTT_ADAPTIVE_KEEP_ALIVE
+    uint32_t timeout_ms;
+
+    if (!keepalive_puback_valid)
+    {
+        return KEEPALIVE_PINGRESP_TIMEOUT_MAX_MS;
+    }
+
+    timeout_ms = keepalive_puback_srtt_ms + (KEEPALIVE_RTTVAR_FACTOR * keepalive_puback_rttvar_ms);
+    if (timeout_ms < KEEPALIVE_PINGRESP_TIMEOUT_MIN_MS)
+    {
+        timeout_ms = KEEPALIVE_PINGRESP_TIMEOUT_MIN_MS;
+    }
+    else if (timeout_ms > KEEPALIVE_PINGRESP_TIMEOUT_MAX_MS)
+    {
+        timeout_ms = KEEPALIVE_PINGRESP_TIMEOUT_MAX_MS;
+    }
+
+    return timeout_ms;
+#else
+    return KEEPALIVE_PINGRESP_TIMEOUT_MAX_MS;
+#endif /* MQTT_ADAPTIVE_KEEP_ALIVE */
+}
+
+/* [] END OF FILE */
@@ -984,6 +984,113 @@
  */
 #define FORCE_TLS_VERSION MBEDTLS_SSL_VERSION_TLS1_3
 
+/**
+ * \def TLS_PROFILE
+ *
+ * Selects the algorithms the client offers in its ClientHello. Override it
+ * from the Makefile, e.g. DEFINES+=TLS_PROFILE=TLS_PROFILE_MINIMAL_LATENCY.
+ *
+ * TLS_PROFILE_COMPATIBILITY: the full set enabled above. X25519 and P-256
+ *      key shares, every TLS 1.3 and TLS 1.2 cipher suite and RSA-PSS,
+ *      RSA PKCS#1 v1.5 and ECDSA signatures with SHA-256/384/512.
+ *
+ * TLS_PROFILE_MINIMAL_LATENCY: a single P-256 key share, AES-128-GCM with
+ *      SHA-256 and ECDSA P-256 CertificateVerify only. The broker must
+ *      present an ECDSA P-256 leaf certificate; the chain above it may still
+ *      be signed with RSA PKCS#1 v1.5 and SHA-256, as the bundled root CA is.
+ *      With X25519 gone, ECDHE also runs on cy-mbedtls-acceleration.
+ */
+#define TLS_PROFILE_COMPATIBILITY           0
+#define TLS_PROFILE_MINIMAL_LATENCY         1
+
+#ifndef TLS_PROFILE
+#define TLS_PROFILE TLS_PROFILE_COMPATIBILITY
+#endif
+
+#if (TLS_PROFILE == TLS_PROFILE_MINIMAL_LATENCY)
+#define TLS_PROFILE_NAME "minimal-latency"
+
+/* P-256 only, so the first key share is always acceptable and no
+ * HelloRetryRequest round trip is needed.
+ */
+#undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+
+/* Drops RSA-PSS and the SHA-384/512 signature algorithms from the offer,
+ * and the SHA-384 cipher suites with them.
+ */
+#undef MBEDTLS_PKCS1_V21
+#undef MBEDTLS_SHA384_C
+#undef MBEDTLS_SHA512_C
+
+#define MBEDTLS_SSL_CIPHERSUITES \
+    MBEDTLS_TLS1_3_AES_128_GCM_SHA256, \
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256
+
+/* Saves the 32-byte legacy session ID and the dummy ChangeCipherSpec. */
+#undef MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE
+
+#elif (TLS_PROFILE == TLS_PROFILE_COMPATIBILITY)
+#define TLS_PROFILE_NAME "compatibility"
+#else
+#error "Unknown TLS_PROFILE! Use TLS_PROFILE_COMPATIBILITY or TLS_PROFILE_MINIMAL_LATENCY."
+#endif /* TLS_PROFILE */
+
+/**
+ * \def MBEDTLS_SSL_OUT_CONTENT_LEN
+ *
+ * Size of the TLS output record buffer. mbedTLS splits application data
+ * into records of at most this size, so MQTT packets up to
+ * MQTT_NETWORK_BUFFER_SIZE go out in two records instead of one. Every
+ * handshake message the client sends must fit; 4 KB leaves room for a
+ * client certificate chain in addition to the ClientHello.
+ */
+#define MBEDTLS_SSL_OUT_CONTENT_LEN         4096
+
+/**
+ * \def TLS_RECORD_SIZE_LIMIT
+ *
+ * Size of the TLS input record buffer. Unless the broker agrees to a
+ * smaller size, it may send records of up to 16384 bytes, so that is the
+ * default. Lower it (minimum 512) only for brokers whose TLS 1.3 stack
+ * honours the record_size_limit extension (RFC 8449), which the client
+ * then sends. Brokers built on OpenSSL ignore it; they send full-size
+ * records and the handshake fails with a record overflow, so keep the
+ * default for them.
+ *
+ * The max_fragment_length extension (RFC 6066) stays compiled in, but it
+ * is only sent if the TLS layer of secure-sockets configures a length.
+ *
+ * Heap of one client connection, measured on a host with mbedTLS 2.28
+ * against an OpenSSL 3.0 server (TLS 1.2, ECDHE-RSA, RSA-2048 chain):
+ *
+ *   input / output buffer     before handshake   handshake peak   after
+ *   16384 / 16384                   39.1 KB           49.0 KB     39.0 KB
+ *   16384 / 4096 (default)          26.8 KB           36.8 KB     26.7 KB
+ *   4096  / 4096                    14.5 KB           24.5 KB     14.4 KB
+ *
+ * The first row is measured. Each buffer is one allocation of its content
+ * length plus 333 bytes, so the other rows are the first row minus the
+ * smaller buffers. The handshake adds about 10 KB on top of the buffers. OpenSSL accepted a 2048 or
+ * 4096 byte max_fragment_length, but it does not implement
+ * record_size_limit. A broker that batches MQTT packets into one TLS write
+ * may send full-size records even though every packet fits in
+ * MQTT_NETWORK_BUFFER_SIZE.
+ */
+#ifndef TLS_RECORD_SIZE_LIMIT
+#define TLS_RECORD_SIZE_LIMIT               16384
+#endif
+
+#if (TLS_RECORD_SIZE_LIMIT < 512) || (TLS_RECORD_SIZE_LIMIT > 16384)
+#error "TLS_RECORD_SIZE_LIMIT must lie within [512, 16384]!"
+#endif
+
+#define MBEDTLS_SSL_IN_CONTENT_LEN          TLS_RECORD_SIZE_LIMIT
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+
+#if (TLS_RECORD_SIZE_LIMIT < 16384)
+#define MBEDTLS_SSL_RECORD_SIZE_LIMIT
+#endif
+
 /**
  * \def Enable alternate crypto implementations to use the hardware
  *      acceleration. Include The hardware acceleration module's (cy-mbedtls-acceleration)
@@ -42,6 +42,7 @@
 #include <stdio.h>
 #include "mqtt_client_config.h"
 #include "cy_mqtt_api.h"
+#include "secure_sign_client.h"
 
 /******************************************************************************
 * Global Variables
@@ -67,8 +68,13 @@ static cy_awsport_ssl_credentials_t credentials =
     .client_cert_size = 0,
 #endif /* CLIENT_CERTIFICATE */
 
-    /* Configure the client private key. */
-#ifdef CLIENT_PRIVATE_KEY
+    /* Configure the client private key. A key kept in the secure world is
+     * loaded as its PEM stand-in, whose signatures are made there.
+     */
+#if (MQTT_CLIENT_KEY_IN_SECURE_WORLD)
+    .private_key = secure_sign_client_key_pem,
+    .private_key_size = sizeof(secure_sign_client_key_pem),
+#elif defined(CLIENT_PRIVATE_KEY)
     .private_key = (const char *)CLIENT_PRIVATE_KEY,
     .private_key_size = sizeof(CLIENT_PRIVATE_KEY),
 #else
@@ -142,7 +148,7 @@ cy_mqtt_connect_info_t connection_info =
     .username_len = 0,
     .password = NULL,
     .password_len = 0,
-    .clean_session = true,
+    .clean_session = (MQTT_PERSISTENT_SESSION == 0),
     .keep_alive_sec = MQTT_KEEP_ALIVE_SECONDS,
 #if ENABLE_LWT_MESSAGE
     .will_info = &will_msg_info
@@ -156,5 +162,22 @@ cy_mqtt_connect_info_t connection_info =
     #error "Invalid QoS setting! MQTT_MESSAGES_QOS must be either 0 or 1."
 #endif
 
+/* The broker identifies a persistent session by the client identifier. */
+#if (MQTT_PERSISTENT_SESSION && GENERATE_UNIQUE_CLIENT_ID)
+    #error "MQTT_PERSISTENT_SESSION requires a stable client identifier! Disable GENERATE_UNIQUE_CLIENT_ID."
+#endif
+
+/* A key kept in the secure world must not also be linked into this image. */
+#if (MQTT_CLIENT_KEY_IN_SECURE_WORLD && defined(CLIENT_PRIVATE_KEY))
+    #error "MQTT_CLIENT_KEY_IN_SECURE_WORLD is set! Provision the key in secure_sign_keys.h, not CLIENT_PRIVATE_KEY."
+#endif
+
+/* The TLS signatures reach the secure world through linker-wrapped mbedTLS
+ * functions, which the Makefile sets up for the GNU and LLVM toolchains only.
+ */
+#if (MQTT_CLIENT_KEY_IN_SECURE_WORLD && !defined(SECURE_SIGN_CLIENT_TLS_HOOK))
+    #error "MQTT_CLIENT_KEY_IN_SECURE_WORLD needs the --wrap linker flags of the Makefile (GCC_ARM or LLVM_ARM)."
+#endif
+
 
 /* [] END OF FILE */
@@ -107,6 +107,15 @@
 #define MQTT_BROKER_ADDRESS               "mqtt.tesaiot.com"
 #define MQTT_PORT                         8884  /* Server-TLS port (password-based auth) */
 
+/* Fallback MQTT brokers, used after MQTT_BROKER_ADDRESS (or the 'mqtt.broker'
+ * setting) when it is unreachable or slower. Each entry is
+ * { "hostname", port }, e.g. { "mqtt2.tesaiot.com", 8884 },
+ */
+#define MQTT_BROKER_FALLBACK_ENDPOINTS
+
+/* Maximum number of broker endpoints, including MQTT_BROKER_ADDRESS. */
+#define MQTT_BROKER_MAX_ENDPOINTS         (4u)
+
 /* Set this macro to 1 if a secure (TLS) connection to the MQTT Broker is
  * required to be established, else 0.
  */
@@ -122,6 +131,16 @@
  */
 #define MQTT_ENABLE_MUTUAL_AUTH           ( 0 )  /* Disabled for Server-TLS */
 
+/* Set to 1 to keep the client private key of mutual TLS in the secure world.
+ * The key is provisioned in proj_cm33_s/secure_sign_keys.h instead of
+ * CLIENT_PRIVATE_KEY and never enters non-secure memory. The TLS layer loads
+ * a PEM stand-in with its public key, and the CertificateVerify signature is
+ * made through the NSC veneers of the secure signing service. The service
+ * signs SHA-256 only, so in TLS 1.2 the broker must not negotiate a SHA-384
+ * cipher suite.
+ */
+#define MQTT_CLIENT_KEY_IN_SECURE_WORLD   ( 0 )
+
 /* Configure the user credentials to be sent as part of MQTT CONNECT packet
  * For Server-TLS: Username is device_id, password is set via Platform UI
  * Uses DEVICE_ID macro defined above
@@ -142,6 +161,14 @@
 #define MQTT_PUB_TOPIC                    MQTT_TELEMETRY_TOPIC_BASE
 #define MQTT_PUB_TOPIC_SENSOR             MQTT_TELEMETRY_TOPIC_BASE "/sensor"
 
+/* Topic of the publisher's urgent lane (alarms such as an abnormal SpO2). */
+#define MQTT_PUB_TOPIC_ALARM              MQTT_TELEMETRY_TOPIC_BASE "/alarm"
+
+/* Topic on which the device periodically reports its own metrics (publish
+ * latency histograms).
+ */
+#define MQTT_PUB_TOPIC_METRICS            MQTT_TELEMETRY_TOPIC_BASE "/metrics"
+
 /*
  * Default subscription topic listens for device-specific commands. If you need
  * broader coverage (for example, to capture config or firmware broadcasts),
@@ -171,6 +198,26 @@
 #define MQTT_SUB_TOPIC_COMMAND_UPLOAD_CERT_RESPONSE MQTT_COMMAND_TOPIC_BASE "/upload_certificate_response"
 #define MQTT_SUB_TOPIC_COMMAND_SYNC_CERT_RESPONSE   MQTT_COMMAND_TOPIC_BASE "/sync_certificate_response"
 
+/* Topics subscribed to, all in one SUBSCRIBE packet. The default is the
+ * command wildcard; to receive only the topics the device handles, set
+ * MQTT_SUB_TOPICS to MQTT_SUB_TOPICS_INDIVIDUAL.
+ */
+#define MQTT_SUB_TOPICS_INDIVIDUAL        MQTT_COMMAND_TOPIC_BASE, \
+                                          MQTT_SUB_TOPIC_COMMAND_CONFIG, \
+                                          MQTT_SUB_TOPIC_COMMAND_CERT, \
+                                          MQTT_SUB_TOPIC_COMMAND_FIRMWARE, \
+                                          MQTT_SUB_TOPIC_COMMAND_PROTECTED_UPDATE, \
+                                          MQTT_SUB_TOPIC_COMMAND_CHECK_CERT_RESPONSE, \
+                                          MQTT_SUB_TOPIC_COMMAND_UPLOAD_CERT_RESPONSE, \
+                                          MQTT_SUB_TOPIC_COMMAND_SYNC_CERT_RESPONSE
+
+/* Number of topics in MQTT_SUB_TOPICS_INDIVIDUAL; the subscription registry
+ * is sized from it. Update it together with the list.
+ */
+#define MQTT_SUB_TOPICS_INDIVIDUAL_COUNT  (8U)
+
+#define MQTT_SUB_TOPICS                   MQTT_SUB_TOPIC
+
 /* DEPRECATED topics (kept for reference, will be removed in future) */
 #define MQTT_SUB_TOPIC_COMMAND_MANIFEST   MQTT_COMMAND_TOPIC_BASE "/manifest"
 #define MQTT_SUB_TOPIC_COMMAND_FRAGMENT   MQTT_COMMAND_TOPIC_BASE "/fragment"
@@ -215,6 +262,34 @@
 /* The keep-alive interval in seconds used for MQTT ping request. */
 #define MQTT_KEEP_ALIVE_SECONDS           ( 180 )
 
+/* Adaptive keep-alive: MQTT_KEEP_ALIVE_SECONDS (or 'mqtt.keep_alive') is the
+ * upper bound. From the gaps between acknowledged QoS 1 publishes, the
+ * client learns the longest idle period the network path survives and the
+ * shortest one that killed the connection, and bisects between them, never
+ * going below MQTT_KEEP_ALIVE_MIN_SECONDS. The PINGRESP timeout follows the
+ * PUBLISH/PUBACK round-trip time. Set MQTT_ADAPTIVE_KEEP_ALIVE to 0 to
+ * always use the configured value.
+ */
+#define MQTT_ADAPTIVE_KEEP_ALIVE          ( 1 )
+#define MQTT_KEEP_ALIVE_MIN_SECONDS       ( 30 )
+
+/* Persistent session: connect with clean_session = false, so that the broker
+ * keeps the subscriptions and the QoS 1 messages for the client while it is
+ * offline, and the MQTT library resends unacknowledged QoS 1 publishes on
+ * reconnection. The subscribe is skipped on reconnection while the broker is
+ * expected to hold the session: same broker endpoint, the broker was not
+ * reported down, and offline for less than MQTT_SESSION_EXPIRY_MS (set it to
+ * the session expiry of the broker).
+ *
+ * Disabled by default: the MQTT library does not report the session present
+ * flag of the CONNACK, so a broker that dropped the session earlier than
+ * MQTT_SESSION_EXPIRY_MS leaves the client without subscriptions. Enable it
+ * only for a broker with a known session expiry; scripts/session_resume.py
+ * checks that broker and measures the reconnect-to-ready time of both paths.
+ */
+#define MQTT_PERSISTENT_SESSION           ( 0 )
+#define MQTT_SESSION_EXPIRY_MS            ( 3600000u )
+
 /* Every active MQTT connection must have a unique client identifier. If you
  * are using the above 'MQTT_CLIENT_IDENTIFIER' as client ID for multiple MQTT
  * connections simultaneously, set this macro to 1. The device will then
@@ -247,15 +322,46 @@
  * - Protected Update manifest: ~2500 bytes
  * - Protected Update fragment: ~1500 bytes per chunk
  * Set to 5KB to accommodate CSR workflow and Protected Update safely.
+ *
+ * The MQTT library takes this one buffer for both directions, but sends the
+ * payload of an outgoing PUBLISH directly from the caller's memory, so the
+ * buffer bounds the size of incoming packets. A larger incoming PUBLISH is
+ * rejected by the library.
  */
 #define MQTT_NETWORK_BUFFER_SIZE          ( 5120 )
 
+/* Publish rate budget enforced by the publisher in front of cy_mqtt_publish()
+ * (token buckets). The message and byte rates are sustained limits, and the
+ * burst values are the bucket capacities. A rate of 0 disables that limit.
+ * Urgent (alarm) messages are never delayed, but they consume budget.
+ */
+#define MQTT_PUBLISH_RATE_MSGS_PER_SEC    ( 5U )
+#define MQTT_PUBLISH_BURST_MSGS           ( 10U )
+#define MQTT_PUBLISH_RATE_BYTES_PER_SEC   ( 4096U )
+#define MQTT_PUBLISH_BURST_BYTES          ( 8192U )
+
 /* Maximum MQTT connection re-connection limit. */
 #define MAX_MQTT_CONN_RETRIES             (150u)
 
 /* MQTT re-connection time interval in milliseconds. */
 #define MQTT_CONN_RETRY_INTERVAL_MS       (2000)
 
+/* The TCP connect latency of every broker endpoint is probed at start-up,
+ * with a timeout of MQTT_BROKER_PROBE_TIMEOUT_MS per endpoint. While
+ * connected, the endpoints are re-probed the same way every
+ * MQTT_BROKER_REPROBE_INTERVAL_MS. The re-probe blocks the MQTT task, so the
+ * whole pass is bounded by MQTT_BROKER_REPROBE_BUDGET_MS. A TCP connect is
+ * used in both places rather than a TLS handshake, which would cost several
+ * round trips and a second TLS context on the heap (the record buffers alone
+ * are MBEDTLS_SSL_IN_CONTENT_LEN + MBEDTLS_SSL_OUT_CONTENT_LEN bytes). The
+ * client moves to a faster endpoint only if it saves at least
+ * MQTT_BROKER_SWITCH_HYSTERESIS_MS.
+ */
+#define MQTT_BROKER_PROBE_TIMEOUT_MS      (5000u)
+#define MQTT_BROKER_REPROBE_INTERVAL_MS   (300000u)
+#define MQTT_BROKER_REPROBE_BUDGET_MS     (1000u)
+#define MQTT_BROKER_SWITCH_HYSTERESIS_MS  (200u)
+
 /* Optional ALPN (for example, when tunnelling MQTT over HTTPS/port 443). */
 // #define MQTT_ALPN_PROTOCOL_NAME         "x-amzn-mqtt-ca"
 
@@ -48,11 +48,25 @@
 /* FreeRTOS header files */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
 
 /* Task header files */
 #include "mqtt_task.h"
 #include "subscriber_task.h"
 #include "publisher_task.h"
+#include "sampling_scheduler.h"
+#include "ota_receiver.h"
+#include "config_store.h"
+#include "wifi_profiles.h"
+#include "broker_endpoints.h"
+#include "keepalive_tuner.h"
+#include "dedup_cache.h"
+#include "power_profiler.h"
+#include "wifi_powersave.h"
+#include "sensor_acq.h"
+#include "crypto_benchmark.h"
+#include "secure_sign_client.h"
+#include "cert_pinning.h"
 
 /* Configuration file for Wi-Fi and MQTT client */
 #include "wifi_config.h"
@@ -134,6 +148,32 @@ uint32_t status_flag;
  * receive operations.
  */
 uint8_t *mqtt_network_buffer = NULL;
+
+/* Index of the broker endpoint the MQTT instance was created for. */
+static uint32_t mqtt_broker_index;
+
+/* true while the MQTT instance is connected. Set by this task once
+ * cy_mqtt_connect() succeeds; the publisher reads it under
+ * mqtt_client_mutex before every cy_mqtt_publish().
+ */
+static volatile bool mqtt_client_connected;
+
+/* Held by the publisher around cy_mqtt_publish(), and by this task while it
+ * marks the client offline, so that the instance is never disconnected or
+ * deleted under a publish in progress.
+ */
+static SemaphoreHandle_t mqtt_client_mutex;
+
+#if MQTT_PERSISTENT_SESSION
+/* false once the broker may have lost the persistent session: the endpoint
+ * changed, the broker went down or the subscribe failed.
+ */
+static volatile bool mqtt_session_valid;
+#endif /* MQTT_PERSISTENT_SESSION */
+
+/* Credentials read from the configuration store. */
+static char mqtt_username[CONFIG_STORE_MAX_VALUE_LEN + 1];
+static char mqtt_password[CONFIG_STORE_MAX_VALUE_LEN + 1];
 static mtb_hal_sdio_t sdio_instance;
 cy_stc_sd_host_context_t sdhc_host_context;
 static cy_wcm_config_t wcm_config;
@@ -269,10 +309,11 @@ static void cleanup(void)
  * Function Name: wifi_connect
  ******************************************************************************
  * Summary:
- *  Function that initiates connection to the Wi-Fi Access Point using the
- *  specified SSID and PASSWORD. The connection is retried a maximum of
- *  'MAX_WIFI_CONN_RETRIES' times with interval of 'WIFI_CONN_RETRY_INTERVAL_MS'
- *  milliseconds.
+ *  Function that initiates connection to a Wi-Fi Access Point. Every attempt
+ *  scans once and tries the configured network profiles in ranked order
+ *  (see wifi_profiles.c). The connection is retried a maximum of
+ *  'wifi.retries' (default 'MAX_WIFI_CONN_RETRIES') times with interval of
+ *  'WIFI_CONN_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
  *  void
@@ -285,33 +326,26 @@ static void cleanup(void)
 static cy_rslt_t wifi_connect(void)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
-    cy_wcm_connect_params_t connect_param;
     cy_wcm_ip_address_t ip_address;
+    uint32_t max_retries = config_store_get_uint(CONFIG_KEY_WIFI_RETRIES, MAX_WIFI_CONN_RETRIES);
 
     /* Check if Wi-Fi connection is already established. */
     if (!(cy_wcm_is_connected_to_ap()))
     {
-        /* Configure the connection parameters for the Wi-Fi interface. */
-        memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
-        memcpy(connect_param.ap_credentials.SSID, WIFI_SSID, sizeof(WIFI_SSID));
-        memcpy(connect_param.ap_credentials.password, WIFI_PASSWORD, sizeof(WIFI_PASSWORD));
-        connect_param.ap_credentials.security = WIFI_SECURITY;
-
-        printf("\nWi-Fi Connecting to '%s'\n", connect_param.ap_credentials.SSID);
-
         /* Connect to the Wi-Fi AP. */
-        for (uint32_t retry_count = 0; retry_count < MAX_WIFI_CONN_RETRIES; retry_count++)
+        for (uint32_t retry_count = 0; retry_count < max_retries; retry_count++)
         {
-            result = cy_wcm_connect_ap(&connect_param, &ip_address);
+            result = wifi_profiles_connect(&ip_address);
 
             if (CY_RSLT_SUCCESS == result)
             {
-                printf("\nSuccessfully connected to Wi-Fi network '%s'.\n", connect_param.ap_credentials.SSID);
+                printf("\nSuccessfully connected to Wi-Fi network.\n");
 
                 /* Set the appropriate bit in the status_flag to denote
                  * successful Wi-Fi connection, print the assigned IP address.
                  */
                 status_flag |= WIFI_CONNECTED;
+                wifi_powersave_connected();
                 if (ip_address.version == CY_WCM_IP_VER_V4)
                 {
                     printf("IPv4 Address Assigned: %s\n\n", ip4addr_ntoa((const ip4_addr_t *) &ip_address.ip.v4));
@@ -324,13 +358,13 @@ static cy_rslt_t wifi_connect(void)
             }
 
             printf("Wi-Fi Connection failed. Error code:0x%0X. Retrying in %d ms. Retries left: %d\n",
-                (int)result, WIFI_CONN_RETRY_INTERVAL_MS, (int)(MAX_WIFI_CONN_RETRIES - retry_count - 1));
+                (int)result, WIFI_CONN_RETRY_INTERVAL_MS, (int)(max_retries - retry_count - 1));
             vTaskDelay(pdMS_TO_TICKS(WIFI_CONN_RETRY_INTERVAL_MS));
         }
 
         printf("\nExceeded maximum Wi-Fi connection attempts!\n");
         printf("Wi-Fi connection failed after retrying for %d mins\n\n",
-            (int)(WIFI_CONN_RETRY_INTERVAL_MS * MAX_WIFI_CONN_RETRIES) / TIME_DIV_MS);
+            (int)(WIFI_CONN_RETRY_INTERVAL_MS * max_retries) / TIME_DIV_MS);
     }
     return result;
 }
@@ -368,14 +402,26 @@ static void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, vo
     {
         case CY_MQTT_EVENT_TYPE_DISCONNECT:
         {
-            /* Clear the status flag bit to indicate MQTT disconnection. */
+            /* Clear the status flag bit to indicate MQTT disconnection. The
+             * mutex is not taken here: a publish in progress may hold it
+             * until the library gives up on the PUBACK.
+             */
             status_flag &= ~(MQTT_CONNECTION_SUCCESS);
+            mqtt_client_connected = false;
 
             /* MQTT connection with the MQTT broker is broken as the client
              * is unable to communicate with the broker. Set the appropriate
              * command to be sent to the MQTT task.
              */
             printf("\nUnexpectedly disconnected from MQTT broker!\n");
+            keepalive_tuner_link_lost();
+#if MQTT_PERSISTENT_SESSION
+            /* A broker that went down may have restarted without the session. */
+            if (CY_MQTT_DISCONN_TYPE_BROKER_DOWN == event.data.reason)
+            {
+                mqtt_session_valid = false;
+            }
+#endif /* MQTT_PERSISTENT_SESSION */
             mqtt_task_cmd = HANDLE_DISCONNECTION;
 
             /* Send the message to the MQTT client task to handle the
@@ -395,6 +441,14 @@ static void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, vo
 
             received_msg = &(event.data.pub_msg.received_message);
 
+            /* Drop QoS 1 redeliveries of messages already handled. */
+            if (dedup_cache_check(event.data.pub_msg.packet_id, received_msg->dup,
+                                  received_msg->topic, received_msg->topic_len,
+                                  received_msg->payload, received_msg->payload_len))
+            {
+                break;
+            }
+
             mqtt_subscription_callback(received_msg);
             break;
         }
@@ -407,12 +461,144 @@ static void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, vo
     }
 }
 
+/******************************************************************************
+ * Function Name: mqtt_client_set_offline
+ ******************************************************************************
+ * Summary:
+ *  Marks the MQTT client offline once no publish is in progress. Publishes
+ *  are refused from then on, until the next successful connection.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void mqtt_client_set_offline(void)
+{
+    xSemaphoreTake(mqtt_client_mutex, portMAX_DELAY);
+    mqtt_client_connected = false;
+    xSemaphoreGive(mqtt_client_mutex);
+}
+
+/******************************************************************************
+ * Function Name: mqtt_client_is_connected
+ ******************************************************************************
+ * Summary:
+ *  Tells whether the MQTT client is connected to a broker. The publisher
+ *  holds its queued messages while this returns false.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if messages can be published
+ *
+ ******************************************************************************/
+bool mqtt_client_is_connected(void)
+{
+    return mqtt_client_connected;
+}
+
+/******************************************************************************
+ * Function Name: mqtt_client_publish
+ ******************************************************************************
+ * Summary:
+ *  Publishes a message if the MQTT client is connected. The MQTT task does
+ *  not disconnect or replace the instance while the publish is in progress.
+ *
+ * Parameters:
+ *  cy_mqtt_publish_info_t *publish_info : Message to be published
+ *  cy_rslt_t *result : Result of cy_mqtt_publish(), set only if the client
+ *                      was connected
+ *
+ * Return:
+ *  bool : false if the client is offline and nothing was sent
+ *
+ ******************************************************************************/
+bool mqtt_client_publish(cy_mqtt_publish_info_t *publish_info, cy_rslt_t *result)
+{
+    bool connected;
+
+    xSemaphoreTake(mqtt_client_mutex, portMAX_DELAY);
+    connected = mqtt_client_connected;
+    if (connected)
+    {
+        *result = cy_mqtt_publish(mqtt_connection, publish_info);
+    }
+    xSemaphoreGive(mqtt_client_mutex);
+
+    return connected;
+}
+
+/******************************************************************************
+ * Function Name: mqtt_use_broker
+ ******************************************************************************
+ * Summary:
+ *  Makes sure the MQTT client instance targets a broker endpoint. The MQTT
+ *  library binds the broker when the instance is created, so the instance
+ *  is deleted and created again when the endpoint changes. The client must
+ *  be disconnected and marked offline with mqtt_client_set_offline().
+ *
+ * Parameters:
+ *  uint32_t index : Index of the broker endpoint
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the instance targets the endpoint, else
+ *              an error code indicating the failure.
+ *
+ ******************************************************************************/
+static cy_rslt_t mqtt_use_broker(uint32_t index)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    const broker_endpoint_t *endpoint = broker_endpoints_get(index);
+
+    if (NULL == endpoint)
+    {
+        return ~CY_RSLT_SUCCESS;
+    }
+
+    if (status_flag & MQTT_INSTANCE_CREATED)
+    {
+        if (index == mqtt_broker_index)
+        {
+            return result;
+        }
+
+        cy_mqtt_delete(mqtt_connection);
+        status_flag &= ~(MQTT_INSTANCE_CREATED);
+#if MQTT_PERSISTENT_SESSION
+        mqtt_session_valid = false;
+#endif /* MQTT_PERSISTENT_SESSION */
+    }
+
+    broker_info.hostname = endpoint->hostname;
+    broker_info.hostname_len = (uint16_t)strlen(endpoint->hostname);
+    broker_info.port = endpoint->port;
+
+    /* A pinned server chain is only valid for the endpoint it came from. */
+    cert_pin_set_endpoint(endpoint->hostname, endpoint->port);
+
+    /* Create the MQTT client instance. */
+    result = cy_mqtt_create(mqtt_network_buffer, MQTT_NETWORK_BUFFER_SIZE,
+                            security_info, &broker_info,MQTT_HANDLE_DESCRIPTOR,
+                            &mqtt_connection);
+
+    CHECK_RESULT(result, MQTT_INSTANCE_CREATED, "\nMQTT instance creation failed!\n");
+    mqtt_broker_index = index;
+
+    /* Register a MQTT event callback */
+    return cy_mqtt_register_event_callback( mqtt_connection, (cy_mqtt_callback_t)mqtt_event_callback, NULL );
+}
+
 /******************************************************************************
  * Function Name: mqtt_init
  ******************************************************************************
  * Summary:
  *  Function that initializes the MQTT library and creates an instance for the
- *  MQTT client. The network buffer needed by the MQTT library for MQTT send
+ *  MQTT client, targeting the broker endpoint with the lowest connect
+ *  latency. The network buffer needed by the MQTT library for MQTT send
  *  send and receive operations is also allocated by this function.
  *
  * Parameters:
@@ -427,6 +613,7 @@ static cy_rslt_t mqtt_init(void)
 {
     /* Variable to indicate status of various operations. */
     cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint8_t order[MQTT_BROKER_MAX_ENDPOINTS];
 
     /* Initialize the MQTT library. */
     result = cy_mqtt_init();
@@ -440,20 +627,18 @@ static cy_rslt_t mqtt_init(void)
     }
     CHECK_RESULT(result, BUFFER_INITIALIZED, "Network Buffer allocation failed!\n\n");
 
-    /* Create the MQTT client instance. */
-    result = cy_mqtt_create(mqtt_network_buffer, MQTT_NETWORK_BUFFER_SIZE,
-                            security_info, &broker_info,MQTT_HANDLE_DESCRIPTOR,
-                            &mqtt_connection);
+    /* Probe the broker endpoints and create the MQTT client instance for
+     * the fastest one.
+     */
+    broker_endpoints_init();
+    printf("\nProbing the MQTT broker endpoints...\n");
+    (void) broker_endpoints_probe();
+    (void) broker_endpoints_order(order);
 
-    CHECK_RESULT(result, MQTT_INSTANCE_CREATED, "\nMQTT instance creation failed!\n");
+    result = mqtt_use_broker(order[0]);
     if(CY_RSLT_SUCCESS == result)
     {
-        /* Register a MQTT event callback */
-        result = cy_mqtt_register_event_callback( mqtt_connection, (cy_mqtt_callback_t)mqtt_event_callback, NULL );
-        if(CY_RSLT_SUCCESS == result)
-        {
-            printf("\nMQTT library initialization successful.\n");
-        }
+        printf("\nMQTT library initialization successful.\n");
     }
     return result;
 }
@@ -462,8 +647,10 @@ static cy_rslt_t mqtt_init(void)
  * Function Name: mqtt_connect
  ******************************************************************************
  * Summary:
- *  Function that initiates MQTT connect operation. The connection is retried
- *  a maximum of 'MAX_MQTT_CONN_RETRIES' times with interval of
+ *  Function that initiates MQTT connect operation. Every attempt tries the
+ *  broker endpoints in ranked order, moving to the next one immediately on
+ *  failure. The attempt is retried a maximum of 'mqtt.retries' (default
+ *  'MAX_MQTT_CONN_RETRIES') times with interval of
  *  'MQTT_CONN_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
@@ -479,18 +666,29 @@ static cy_rslt_t mqtt_connect(void)
     /* Variable to indicate status of various operations. */
     cy_rslt_t result = CY_RSLT_SUCCESS;
     bool mqtt_conn_status = false;
+    uint32_t max_retries = config_store_get_uint(CONFIG_KEY_MQTT_RETRIES, MAX_MQTT_CONN_RETRIES);
+    uint8_t order[MQTT_BROKER_MAX_ENDPOINTS];
+    uint32_t count;
+#if CRYPTO_BENCHMARK_ENABLE
+    TickType_t connect_tick;
+    size_t connect_heap;
+#endif /* CRYPTO_BENCHMARK_ENABLE */
 
     /* MQTT client identifier string. */
     char mqtt_client_identifier[(MQTT_CLIENT_IDENTIFIER_MAX_LEN + 1)] = MQTT_CLIENT_IDENTIFIER;
 
     /* Configure the user credentials as a part of MQTT Connect packet */
-    if (strlen(MQTT_USERNAME) > 0)
+    config_store_get_string(CONFIG_KEY_MQTT_USERNAME, mqtt_username, sizeof(mqtt_username), MQTT_USERNAME);
+    config_store_get_string(CONFIG_KEY_MQTT_PASSWORD, mqtt_password, sizeof(mqtt_password), MQTT_PASSWORD);
+    if (strlen(mqtt_username) > 0)
     {
-        connection_info.username = MQTT_USERNAME;
-        connection_info.password = MQTT_PASSWORD;
-        connection_info.username_len = sizeof(MQTT_USERNAME) - 1;
-        connection_info.password_len = sizeof(MQTT_PASSWORD) - 1;
+        connection_info.username = mqtt_username;
+        connection_info.password = mqtt_password;
+        connection_info.username_len = strlen(mqtt_username);
+        connection_info.password_len = strlen(mqtt_password);
     }
+    connection_info.keep_alive_sec = keepalive_tuner_select((uint16_t)config_store_get_uint(CONFIG_KEY_MQTT_KEEP_ALIVE,
+                                                                                            MQTT_KEEP_ALIVE_SECONDS));
 
     /* Generate a unique client identifier with 'MQTT_CLIENT_IDENTIFIER' string
      * as a prefix if the `GENERATE_UNIQUE_CLIENT_ID` macro is enabled.
@@ -504,13 +702,7 @@ static cy_rslt_t mqtt_connect(void)
     connection_info.client_id = mqtt_client_identifier;
     connection_info.client_id_len = strlen(mqtt_client_identifier);
 
-    printf("\n'%.*s' connecting to MQTT broker '%.*s'...\n",
-           connection_info.client_id_len,
-           connection_info.client_id,
-           broker_info.hostname_len,
-           broker_info.hostname);
-
-    for (uint32_t retry_count = 0; retry_count < MAX_MQTT_CONN_RETRIES; retry_count++)
+    for (uint32_t retry_count = 0; retry_count < max_retries; retry_count++)
     {
         if (cy_wcm_is_connected_to_ap() == 0)
         {
@@ -527,23 +719,57 @@ static cy_rslt_t mqtt_connect(void)
 
         mqtt_conn_status = false;
 
-        /* Establish the MQTT connection. */
-        result = cy_mqtt_connect(mqtt_connection, &connection_info);
-
-        if (CY_RSLT_SUCCESS == result)
+        /* Establish the MQTT connection, failing over to the next endpoint
+         * without waiting.
+         */
+        count = broker_endpoints_order(order);
+        for (uint32_t i = 0; (i < count) && !mqtt_conn_status; i++)
         {
-            printf("MQTT connection successful.\r\n");
+            result = mqtt_use_broker(order[i]);
+            if (CY_RSLT_SUCCESS != result)
+            {
+                continue;
+            }
 
-            /* Set the appropriate bit in the status_flag to denote successful
-             * MQTT connection, and return the result to the calling function.
-             */
-            status_flag |= MQTT_CONNECTION_SUCCESS;
-            mqtt_conn_status = true;
+            printf("\n'%.*s' connecting to MQTT broker '%.*s:%u'...\n",
+                   connection_info.client_id_len,
+                   connection_info.client_id,
+                   broker_info.hostname_len,
+                   broker_info.hostname,
+                   (unsigned int)broker_info.port);
+
+#if CRYPTO_BENCHMARK_ENABLE
+            connect_heap = crypto_benchmark_heap_in_use();
+            connect_tick = xTaskGetTickCount();
+#endif /* CRYPTO_BENCHMARK_ENABLE */
+            result = cy_mqtt_connect(mqtt_connection, &connection_info);
+            broker_endpoints_record(order[i], (CY_RSLT_SUCCESS == result));
+
+            if (CY_RSLT_SUCCESS == result)
+            {
+                printf("MQTT connection successful.\r\n");
+#if CRYPTO_BENCHMARK_ENABLE
+                crypto_benchmark_report_connect((uint32_t)((xTaskGetTickCount() - connect_tick) * portTICK_PERIOD_MS),
+                                                connect_heap);
+#endif /* CRYPTO_BENCHMARK_ENABLE */
+
+                /* Set the appropriate bit in the status_flag to denote successful
+                 * MQTT connection, and return the result to the calling function.
+                 */
+                status_flag |= MQTT_CONNECTION_SUCCESS;
+                mqtt_client_connected = true;
+                mqtt_conn_status = true;
+                keepalive_tuner_connected();
+            }
+        }
+
+        if (mqtt_conn_status)
+        {
             break;
         }
 
         printf("\nMQTT connection failed with error code 0x%0X. \nRetrying in %d ms. Retries left: %d\n",
-               (int)result, MQTT_CONN_RETRY_INTERVAL_MS, (int)(MAX_MQTT_CONN_RETRIES - retry_count - 1));
+               (int)result, MQTT_CONN_RETRY_INTERVAL_MS, (int)(max_retries - retry_count - 1));
         vTaskDelay(pdMS_TO_TICKS(MQTT_CONN_RETRY_INTERVAL_MS));
     }
 
@@ -551,7 +777,7 @@ static cy_rslt_t mqtt_connect(void)
     {
         printf("\nExceeded maximum MQTT connection attempts\n");
         printf("MQTT connection failed after retrying for %d mins\n\n",
-               (int)(MQTT_CONN_RETRY_INTERVAL_MS * MAX_MQTT_CONN_RETRIES) / TIME_DIV_MS);
+               (int)(MQTT_CONN_RETRY_INTERVAL_MS * max_retries) / TIME_DIV_MS);
     }
     return result;
 }
@@ -678,6 +904,14 @@ static void app_sdio_init(void)
 void terminate_tasks(void)
 {
     printf("\nTerminating Publisher and Subscriber tasks...\n");
+    if (NULL != sampling_scheduler_task_handle )
+    {
+        vTaskDelete(sampling_scheduler_task_handle);
+    }
+    if (NULL != ota_writer_task_handle )
+    {
+        vTaskDelete(ota_writer_task_handle);
+    }
     if (NULL != subscriber_task_handle )
     {
         vTaskDelete(subscriber_task_handle);
@@ -714,8 +948,8 @@ void mqtt_client_task(void *pvParameters)
      */
     mqtt_task_cmd_t mqtt_status;
     subscriber_data_t subscriber_q_data;
-    publisher_data_t publisher_q_data;
     bool mqtt_client_status = false;
+    TickType_t disconnect_tick;
 
     app_sdio_init();
 
@@ -728,6 +962,31 @@ void mqtt_client_task(void *pvParameters)
 
     /* Create a message queue to communicate with other tasks and callbacks. */
     mqtt_task_q = xQueueCreate(MQTT_TASK_QUEUE_LENGTH, sizeof(mqtt_task_cmd_t));
+    mqtt_client_mutex = xSemaphoreCreateMutex();
+
+    /* Load the runtime configuration; missing keys fall back to the macros. */
+    if (!config_store_init(NULL))
+    {
+        printf("\nConfiguration store unavailable, using the built-in defaults.\n");
+    }
+    wifi_profiles_init();
+    keepalive_tuner_init();
+    dedup_cache_init();
+    power_profiler_init();
+    wifi_powersave_init();
+
+#if (MQTT_ENABLE_MUTUAL_AUTH && MQTT_CLIENT_KEY_IN_SECURE_WORLD)
+    (void) secure_sign_client_init();
+#endif /* MQTT_ENABLE_MUTUAL_AUTH && MQTT_CLIENT_KEY_IN_SECURE_WORLD */
+
+#if CRYPTO_BENCHMARK_ENABLE
+#ifdef ROOT_CA_CERTIFICATE
+    (void) crypto_benchmark_run((const unsigned char *)ROOT_CA_CERTIFICATE, sizeof(ROOT_CA_CERTIFICATE),
+                                MQTT_BROKER_ADDRESS);
+#else
+    (void) crypto_benchmark_run(NULL, 0, MQTT_BROKER_ADDRESS);
+#endif /* ROOT_CA_CERTIFICATE */
+#endif /* CRYPTO_BENCHMARK_ENABLE */
 
     /* Initialize the Wi-Fi Connection Manager and jump to the cleanup block 
      * upon failure.
@@ -749,7 +1008,9 @@ void mqtt_client_task(void *pvParameters)
         /* Set-up the MQTT client and connect to the MQTT broker.
          * cleanup block if any of the operations fail.
          */
-        if ( (CY_RSLT_SUCCESS == mqtt_init()) && (CY_RSLT_SUCCESS == mqtt_connect()) )
+        if ( (CY_RSLT_SUCCESS == mqtt_init()) && (CY_RSLT_SUCCESS == mqtt_connect()) &&
+             (pdPASS == xTaskCreate(ota_writer_task, "OTA writer task", OTA_WRITER_TASK_STACK_SIZE,
+                                    NULL, OTA_WRITER_TASK_PRIORITY, &ota_writer_task_handle)) )
         {
             /* Create the subscriber task and cleanup if the operation fails. */
             if (pdPASS == xTaskCreate(subscriber_task, "Subscriber task", SUBSCRIBER_TASK_STACK_SIZE,
@@ -762,7 +1023,21 @@ void mqtt_client_task(void *pvParameters)
                 if (pdPASS == xTaskCreate(publisher_task, "Publisher task", PUBLISHER_TASK_STACK_SIZE,
                                           NULL, PUBLISHER_TASK_PRIORITY, &publisher_task_handle))
                 {
-                    mqtt_client_status = true;
+                    /* Create the sampling scheduler that drives the periodic
+                     * telemetry of the publisher and of the sensor stream.
+                     */
+                    publisher_register_sensors();
+                    sensor_acq_init();
+                    if (pdPASS == xTaskCreate(sampling_scheduler_task, "Sampling scheduler task",
+                                              SAMPLING_SCHEDULER_TASK_STACK_SIZE, NULL,
+                                              SAMPLING_SCHEDULER_TASK_PRIORITY,
+                                              &sampling_scheduler_task_handle))
+                    {
+                        mqtt_client_status = true;
+#if MQTT_PERSISTENT_SESSION
+                        mqtt_session_valid = true;
+#endif /* MQTT_PERSISTENT_SESSION */
+                    }
                 }
             }
         }
@@ -773,8 +1048,29 @@ void mqtt_client_task(void *pvParameters)
         mqtt_client_status = false;
         while (true)
         {
-            /* Wait for results of MQTT operations from other tasks and callbacks. */
-            if (pdTRUE == xQueueReceive(mqtt_task_q, &mqtt_status, portMAX_DELAY))
+            /* Wait for results of MQTT operations from other tasks and callbacks.
+             * While idle, check every WIFI_ROAM_CHECK_INTERVAL_MS whether a
+             * weak link should roam; a roam that breaks the MQTT connection
+             * is reported back as HANDLE_DISCONNECTION. A faster broker
+             * endpoint found by the periodic re-probe is moved to through
+             * the same reconnection path.
+             */
+            if (pdTRUE != xQueueReceive(mqtt_task_q, &mqtt_status, pdMS_TO_TICKS(WIFI_ROAM_CHECK_INTERVAL_MS)))
+            {
+                (void) wifi_profiles_check_roam();
+                if (!broker_endpoints_reprobe(mqtt_broker_index))
+                {
+                    continue;
+                }
+                mqtt_status = HANDLE_DISCONNECTION;
+            }
+            else if (HANDLE_WIFI_POWERSAVE == mqtt_status)
+            {
+                /* A producer's traffic changed the power save mode to use. */
+                wifi_powersave_apply();
+                continue;
+            }
+
             {
                 /* In this code example, the disconnection from the MQTT Broker or
                  * the Wi-Fi network is handled by the case 'HANDLE_DISCONNECTION'.
@@ -788,9 +1084,15 @@ void mqtt_client_task(void *pvParameters)
                 {
                     case HANDLE_DISCONNECTION:
                     {
-                        /* Deinit the publisher before initiating reconnections. */
-                        publisher_q_data.cmd = PUBLISHER_DEINIT;
-                        xQueueSend(publisher_task_q, &publisher_q_data, portMAX_DELAY);
+                        disconnect_tick = xTaskGetTickCount();
+
+                        /* Deinit the publisher before initiating reconnections,
+                         * and wait for a publish in progress to return before
+                         * the instance is disconnected or replaced. Queued
+                         * messages are held until the publisher is resumed.
+                         */
+                        publisher_send_command(PUBLISHER_DEINIT);
+                        mqtt_client_set_offline();
 
                         /* Although the connection with the MQTT Broker is lost,
                          * call the MQTT disconnect API for cleanup of threads and
@@ -799,31 +1101,61 @@ void mqtt_client_task(void *pvParameters)
                         cy_mqtt_disconnect(mqtt_connection);
 
                         /* Check if Wi-Fi connection is active. If not, update the
-                         * status flag and initiate Wi-Fi reconnection.
+                         * status flag and initiate Wi-Fi reconnection. The MQTT
+                         * connection is restored once Wi-Fi is up, which also
+                         * covers a broker disconnection after a roam.
                          */
                         if (cy_wcm_is_connected_to_ap() == 0)
                         {
                             status_flag &= ~(WIFI_CONNECTED);
                             printf("\nInitiating Wi-Fi Reconnection...\n");
-                            if (CY_RSLT_SUCCESS == wifi_connect())
+                            (void) wifi_connect();
+                        }
+
+                        if (cy_wcm_is_connected_to_ap() != 0)
+                        {
+                            printf("\nInitiating MQTT Reconnection...\n");
+                            if (CY_RSLT_SUCCESS == mqtt_connect())
                             {
-                                printf("\nInitiating MQTT Reconnection...\n");
-                                if (CY_RSLT_SUCCESS == mqtt_connect())
+#if MQTT_PERSISTENT_SESSION
+                                /* The broker still holds the subscriptions of
+                                 * a resumed session; skip the round trip.
+                                 */
+                                if (mqtt_session_valid &&
+                                    ((xTaskGetTickCount() - disconnect_tick) < pdMS_TO_TICKS(MQTT_SESSION_EXPIRY_MS)))
+                                {
+                                    printf("MQTT session resumed, ready %lu ms after the disconnection.\n",
+                                           (unsigned long)((xTaskGetTickCount() - disconnect_tick) * portTICK_PERIOD_MS));
+                                }
+                                else
+#endif /* MQTT_PERSISTENT_SESSION */
                                 {
                                     /* Initiate MQTT subscribe post the reconnection. */
                                     subscriber_q_data.cmd = SUBSCRIBE_TO_TOPIC;
+                                    subscriber_q_data.disconnect_tick = disconnect_tick;
                                     xQueueSend(subscriber_task_q, &subscriber_q_data, portMAX_DELAY);
-
-                                    /* Initialize Publisher post the reconnection. */
-                                    publisher_q_data.cmd = PUBLISHER_INIT;
-                                    xQueueSend(publisher_task_q, &publisher_q_data, portMAX_DELAY);
-                                    mqtt_client_status = true;
                                 }
+#if MQTT_PERSISTENT_SESSION
+                                mqtt_session_valid = true;
+#endif /* MQTT_PERSISTENT_SESSION */
+
+                                /* Initialize Publisher post the reconnection. */
+                                publisher_send_command(PUBLISHER_INIT);
+                                mqtt_client_status = true;
                             }
                         }
                         break;
                     }
 
+#if MQTT_PERSISTENT_SESSION
+                    case HANDLE_MQTT_SUBSCRIBE_FAILURE:
+                    {
+                        /* Subscribe again on the next reconnection. */
+                        mqtt_session_valid = false;
+                        break;
+                    }
+#endif /* MQTT_PERSISTENT_SESSION */
+
                     default:
                         break;
                 }
@@ -42,6 +42,7 @@
 #ifndef MQTT_TASK_H_
 #define MQTT_TASK_H_
 
+#include <stdbool.h>
 #include "FreeRTOS.h"
 #include "queue.h"
 #include "cy_mqtt_api.h"
@@ -62,7 +63,8 @@ typedef enum
 {
     HANDLE_MQTT_SUBSCRIBE_FAILURE,
     HANDLE_MQTT_PUBLISH_FAILURE,
-    HANDLE_DISCONNECTION
+    HANDLE_DISCONNECTION,
+    HANDLE_WIFI_POWERSAVE
 } mqtt_task_cmd_t;
 
 /*******************************************************************************
@@ -75,6 +77,8 @@ extern QueueHandle_t mqtt_task_q;
 * Function Prototypes
 ********************************************************************************/
 void mqtt_client_task(void *pvParameters);
+bool mqtt_client_is_connected(void);
+bool mqtt_client_publish(cy_mqtt_publish_info_t *publish_info, cy_rslt_t *result);
 
 #endif /* MQTT_TASK_H_ */
 
@@ -0,0 +1,1101 @@
+/******************************************************************************
+* File Name:   ota_receiver.c
+*
+* Description: This file contains the streaming firmware update receiver.
+*              Sequence-numbered fragments received on the
+*              MQTT_SUB_TOPIC_COMMAND_FIRMWARE topic are copied into a
+*              double-buffered pipeline and written to the MCUboot secondary
+*              slot by the OTA writer task, which also hashes the image
+*              incrementally and keeps the flash erased ahead of the incoming
+*              data.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include "publisher_task.h"
+#include "mqtt_client_config.h"
+#include "wifi_powersave.h"
+
+#include "cycfg_qspi_memslot.h"
+#include "mbedtls/sha256.h"
+
+#include "ota_receiver.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Number of pipeline buffers. One is filled by the MQTT callback while the
+ * other is written to flash by the writer task.
+ */
+#define OTA_BUFFER_COUNT                    (2U)
+
+/* Length of the writer task queue: one command per buffer plus the start and
+ * finish commands.
+ */
+#define OTA_WRITER_QUEUE_LENGTH             (OTA_BUFFER_COUNT + 2U)
+
+/* Maximum time the MQTT callback waits for the writer to free a buffer
+ * before the update is aborted.
+ */
+#define OTA_BUFFER_WAIT_MS                  (5000U)
+
+/* MCUboot image trailer magic, written at the end of the secondary slot to
+ * request a test swap on the next boot.
+ */
+#define OTA_BOOT_MAGIC_SIZE                 (16U)
+
+/* Size of the status message published on MQTT_PUB_TOPIC_COMMAND_STATUS. */
+#define OTA_STATUS_PAYLOAD_SIZE             (PUBLISHER_COPY_PAYLOAD_SIZE)
+
+/* Longest expected gap between two fragments. While fragments keep coming,
+ * the radio stays out of power save for throughput.
+ */
+#define OTA_FRAGMENT_GAP_MS                 (2000U)
+
+#define OTA_ROUND_UP(value, align)          ((((value) + (align) - 1U) / (align)) * (align))
+
+/* SMIF block and memory of the external flash, as configured in the BSP.
+ * The memory configuration is generated as initialized data, so it is in
+ * RAM and readable while XIP is off.
+ */
+#define OTA_SMIF_HW                         (CYBSP_SMIF_CORE_0_XSPI_FLASH_HW)
+#define OTA_SMIF_MEM_CONFIG                 (smifMemConfigs[0])
+
+/* Timeout of the SMIF driver for a command transfer. */
+#define OTA_SMIF_TIMEOUT_US                 (1000U)
+
+/* Erase suspend and erase resume commands of the S25FS128S. */
+#define OTA_SMIF_CMD_ERASE_SUSPEND          (0x75U)
+#define OTA_SMIF_CMD_ERASE_RESUME           (0x7AU)
+
+/* A sector erase takes up to the eraseTime of the memory configuration.
+ * It runs in slices of OTA_SMIF_ERASE_SLICE_US with interrupts disabled;
+ * between slices the erase is suspended and XIP restored for a tick, so
+ * interrupts and tasks are held off for one slice at most. The slice is
+ * well above the minimum resume-to-suspend time of the memory.
+ */
+#define OTA_SMIF_ERASE_SLICE_US             (1000U)
+#define OTA_SMIF_POLL_US                    (20U)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Commands for the OTA writer task. */
+typedef enum
+{
+    OTA_WRITER_START,
+    OTA_WRITER_WRITE,
+    OTA_WRITER_FINISH
+} ota_writer_cmd_t;
+
+/* Struct to be passed via the OTA writer task queue */
+typedef struct
+{
+    ota_writer_cmd_t cmd;
+    uint32_t index;
+    uint32_t image_size;
+    uint8_t sha256[OTA_SHA256_SIZE];
+} ota_writer_msg_t;
+
+/* Pipeline buffer. */
+typedef struct
+{
+    uint8_t data[OTA_BUFFER_SIZE];
+    uint32_t offset;
+    uint32_t length;
+} ota_buffer_t;
+
+/* Receiver side state, owned by the MQTT callback. */
+typedef struct
+{
+    uint32_t expected_sequence;
+    uint32_t image_size;
+    uint32_t received_size;
+    uint32_t fill_index;
+    bool fill_acquired;
+    uint32_t duplicates;
+    TickType_t stall_ticks;
+} ota_receiver_state_t;
+
+/* Writer side state, owned by the OTA writer task. */
+typedef struct
+{
+    bool active;
+    bool flash_error;
+    uint32_t image_size;
+    uint32_t erase_end;
+    uint32_t erased_size;
+    uint32_t written_size;
+    uint32_t erase_stalls;
+    TickType_t start_tick;
+    uint8_t expected_sha256[OTA_SHA256_SIZE];
+    mbedtls_sha256_context sha256;
+} ota_writer_state_t;
+
+/* Task handle for the OTA writer task. */
+TaskHandle_t ota_writer_task_handle;
+
+static const uint8_t ota_boot_magic[OTA_BOOT_MAGIC_SIZE] =
+{
+    0x77, 0xc2, 0x95, 0xf3, 0x60, 0xd2, 0xef, 0x7f,
+    0x35, 0x52, 0x50, 0x0f, 0x2c, 0xb6, 0x79, 0x80
+};
+
+static ota_buffer_t ota_buffers[OTA_BUFFER_COUNT];
+static QueueHandle_t ota_writer_q;
+static SemaphoreHandle_t ota_free_buffers;
+static volatile ota_state_t ota_state = OTA_STATE_IDLE;
+static ota_receiver_state_t ota_rx;
+static ota_writer_state_t ota_writer;
+
+/* Context of the SMIF driver used by the default flash backend, set up by
+ * ota_smif_init().
+ */
+static cy_stc_smif_context_t ota_smif_context;
+static bool ota_smif_ready = false;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool ota_smif_erase(uint32_t offset, uint32_t length);
+static bool ota_smif_program(uint32_t offset, const uint8_t *data, uint32_t length);
+
+/* Flash backend in use; the external SMIF flash by default. */
+static const ota_flash_ops_t ota_smif_flash_ops =
+{
+    .erase = ota_smif_erase,
+    .program = ota_smif_program
+};
+static const ota_flash_ops_t *ota_flash = &ota_smif_flash_ops;
+
+/* The SMIF functions below switch the SMIF block out of XIP mode, which
+ * the code of the CM33 NS image is executed from. They are placed in RAM,
+ * and so are the PDL SMIF and SysLib drivers they call (see the
+ * .app_code_ram section of the linker script). The data they program must
+ * be in RAM as well.
+ */
+
+/******************************************************************************
+ * Function Name: ota_smif_init
+ ******************************************************************************
+ * Summary:
+ *  Sets up the SMIF driver context with the BSP configuration of the
+ *  external flash. The block keeps running in XIP mode.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if the flash can be used by the default backend
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_init(void)
+{
+    cy_stc_smif_config_t config = CYBSP_SMIF_CORE_0_XSPI_FLASH_config;
+    cy_en_smif_status_t result;
+    uint32_t interrupt_state;
+
+    config.mode = (uint32_t)CY_SMIF_MEMORY;
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    result = Cy_SMIF_Init(OTA_SMIF_HW, &config, OTA_SMIF_TIMEOUT_US, &ota_smif_context);
+    Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_MEMORY);
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return (CY_SMIF_SUCCESS == result) &&
+           (OTA_FLASH_ERASE_SIZE == OTA_SMIF_MEM_CONFIG->deviceCfg->eraseSize) &&
+           (OTA_FLASH_PROGRAM_SIZE == OTA_SMIF_MEM_CONFIG->deviceCfg->programSize);
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_smif_command
+ ******************************************************************************
+ * Summary:
+ *  Sends a single-byte command without address or data to the external
+ *  flash. The SMIF block must be in normal mode.
+ *
+ * Parameters:
+ *  uint8_t command : Command byte
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_command(uint8_t command)
+{
+    return (CY_SMIF_SUCCESS == Cy_SMIF_TransmitCommand(OTA_SMIF_HW, command, CY_SMIF_WIDTH_SINGLE,
+                                                       NULL, CY_SMIF_CMD_WITHOUT_PARAM,
+                                                       CY_SMIF_WIDTH_SINGLE,
+                                                       OTA_SMIF_MEM_CONFIG->slaveSelect,
+                                                       CY_SMIF_TX_LAST_BYTE, &ota_smif_context));
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_smif_wait_ready
+ ******************************************************************************
+ * Summary:
+ *  Polls the busy bit of the external flash. The SMIF block must be in
+ *  normal mode.
+ *
+ * Parameters:
+ *  uint32_t timeout_us : Longest time to poll
+ *
+ * Return:
+ *  bool : true if the flash is ready, false if it is still busy
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_wait_ready(uint32_t timeout_us)
+{
+    while (Cy_SMIF_MemIsBusy(OTA_SMIF_HW, OTA_SMIF_MEM_CONFIG, &ota_smif_context))
+    {
+        if (timeout_us < OTA_SMIF_POLL_US)
+        {
+            return false;
+        }
+        Cy_SysLib_DelayUs(OTA_SMIF_POLL_US);
+        timeout_us -= OTA_SMIF_POLL_US;
+    }
+
+    return true;
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_smif_erase_sector
+ ******************************************************************************
+ * Summary:
+ *  Erases one sector of the external flash. The erase runs in slices with
+ *  interrupts disabled; after each slice it is suspended, XIP is restored
+ *  and the task sleeps for a tick before the erase is resumed. Code and
+ *  data outside the sector being erased can be read while it is suspended.
+ *
+ * Parameters:
+ *  uint32_t offset : Flash offset, aligned to OTA_FLASH_ERASE_SIZE
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_erase_sector(uint32_t offset)
+{
+    uint8_t address[CY_SMIF_FOUR_BYTES_ADDR];
+    uint32_t address_size = OTA_SMIF_MEM_CONFIG->deviceCfg->numOfAddrBytes;
+    uint32_t budget_us = OTA_SMIF_MEM_CONFIG->deviceCfg->eraseTime * 1000U;
+    uint32_t interrupt_state;
+    bool success;
+
+    for (uint32_t i = 0U; i < address_size; i++)
+    {
+        address[i] = (uint8_t)(offset >> (8U * (address_size - 1U - i)));
+    }
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_NORMAL);
+
+    success = (CY_SMIF_SUCCESS == Cy_SMIF_MemCmdWriteEnable(OTA_SMIF_HW, OTA_SMIF_MEM_CONFIG,
+                                                            &ota_smif_context)) &&
+              (CY_SMIF_SUCCESS == Cy_SMIF_MemCmdSectorErase(OTA_SMIF_HW, OTA_SMIF_MEM_CONFIG,
+                                                            address, &ota_smif_context));
+
+    while (success && !ota_smif_wait_ready(OTA_SMIF_ERASE_SLICE_US))
+    {
+        if (budget_us <= OTA_SMIF_ERASE_SLICE_US)
+        {
+            /* Past the erase time of the memory; XIP cannot be restored
+             * while it is busy, so keep waiting for it.
+             */
+            success = false;
+            while (!ota_smif_wait_ready(OTA_SMIF_ERASE_SLICE_US))
+            {
+            }
+            break;
+        }
+        budget_us -= OTA_SMIF_ERASE_SLICE_US;
+
+        success = ota_smif_command(OTA_SMIF_CMD_ERASE_SUSPEND);
+        while (!ota_smif_wait_ready(OTA_SMIF_ERASE_SLICE_US))
+        {
+        }
+        Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_MEMORY);
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+        vTaskDelay(1U);
+
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_NORMAL);
+        success = success && ota_smif_command(OTA_SMIF_CMD_ERASE_RESUME);
+    }
+
+    Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_MEMORY);
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return success;
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_smif_erase
+ ******************************************************************************
+ * Summary:
+ *  Erases sectors of the external flash, see ota_smif_erase_sector().
+ *
+ * Parameters:
+ *  uint32_t offset : Flash offset, aligned to OTA_FLASH_ERASE_SIZE
+ *  uint32_t length : Number of bytes to erase
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_erase(uint32_t offset, uint32_t length)
+{
+    bool success = ota_smif_ready;
+
+    for (uint32_t erased = 0U; success && (erased < length); erased += OTA_FLASH_ERASE_SIZE)
+    {
+        success = ota_smif_erase_sector(offset + erased);
+    }
+
+    return success;
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_smif_program
+ ******************************************************************************
+ * Summary:
+ *  Programs previously erased bytes of the external flash one page at a
+ *  time, so that interrupts are disabled for one page program at most.
+ *
+ * Parameters:
+ *  uint32_t offset : Flash offset
+ *  const uint8_t *data : Data to be programmed, in RAM
+ *  uint32_t length : Number of bytes to program
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+CY_RAMFUNC_BEGIN
+static CY_NOINLINE bool ota_smif_program(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    cy_en_smif_status_t result = CY_SMIF_SUCCESS;
+    uint32_t interrupt_state;
+    uint32_t chunk;
+
+    if (!ota_smif_ready)
+    {
+        return false;
+    }
+
+    while ((CY_SMIF_SUCCESS == result) && (length > 0U))
+    {
+        chunk = OTA_FLASH_PROGRAM_SIZE - (offset % OTA_FLASH_PROGRAM_SIZE);
+        if (chunk > length)
+        {
+            chunk = length;
+        }
+
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+        Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_NORMAL);
+        result = Cy_SMIF_MemWrite(OTA_SMIF_HW, OTA_SMIF_MEM_CONFIG, offset, data, chunk,
+                                  &ota_smif_context);
+        Cy_SMIF_SetMode(OTA_SMIF_HW, CY_SMIF_MEMORY);
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+        offset += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    return (CY_SMIF_SUCCESS == result);
+}
+CY_RAMFUNC_END
+
+/******************************************************************************
+ * Function Name: ota_read_le32
+ ******************************************************************************
+ * Summary:
+ *  Reads an unaligned little-endian 32-bit value.
+ *
+ * Parameters:
+ *  const uint8_t *bytes : First byte of the value
+ *
+ * Return:
+ *  uint32_t : Decoded value
+ *
+ ******************************************************************************/
+static uint32_t ota_read_le32(const uint8_t *bytes)
+{
+    return ((uint32_t)bytes[0]) | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/******************************************************************************
+ * Function Name: ota_report_status
+ ******************************************************************************
+ * Summary:
+ *  Prints the status of the update and publishes a copy of it on the urgent
+ *  lane of the publisher, on MQTT_PUB_TOPIC_COMMAND_STATUS.
+ *
+ * Parameters:
+ *  const char *status : Short status word
+ *  const char *detail : Human readable detail
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_report_status(const char *status, const char *detail)
+{
+    char payload[OTA_STATUS_PAYLOAD_SIZE];
+
+    printf("  OTA: %s - %s\n", status, detail);
+
+    snprintf(payload, sizeof(payload), "{\"ota\":\"%s\",\"detail\":\"%s\"}", status, detail);
+    (void) publisher_enqueue_copy(PUBLISHER_LANE_URGENT, MQTT_PUB_TOPIC_COMMAND_STATUS, payload);
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_fail
+ ******************************************************************************
+ * Summary:
+ *  Aborts the update from the receiver side. Buffers already handed to the
+ *  writer are still written and released; the fill buffer is kept for the
+ *  next update.
+ *
+ * Parameters:
+ *  const char *detail : Reason of the failure
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_receiver_fail(const char *detail)
+{
+    ota_state = OTA_STATE_FAILED;
+    ota_report_status("failed", detail);
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_acquire_buffer
+ ******************************************************************************
+ * Summary:
+ *  Takes a free pipeline buffer for filling. Blocks while both buffers are
+ *  owned by the writer; the time spent waiting is the time the network
+ *  waited for the flash.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if a buffer was acquired
+ *
+ ******************************************************************************/
+static bool ota_receiver_acquire_buffer(void)
+{
+    TickType_t wait_start;
+
+    if (ota_rx.fill_acquired)
+    {
+        return true;
+    }
+
+    wait_start = xTaskGetTickCount();
+    if (pdTRUE != xSemaphoreTake(ota_free_buffers, pdMS_TO_TICKS(OTA_BUFFER_WAIT_MS)))
+    {
+        return false;
+    }
+    ota_rx.stall_ticks += xTaskGetTickCount() - wait_start;
+
+    ota_rx.fill_acquired = true;
+    ota_buffers[ota_rx.fill_index].offset = ota_rx.received_size;
+    ota_buffers[ota_rx.fill_index].length = 0U;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_submit_buffer
+ ******************************************************************************
+ * Summary:
+ *  Hands the fill buffer to the writer task and switches to the other one.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_receiver_submit_buffer(void)
+{
+    ota_writer_msg_t msg = { .cmd = OTA_WRITER_WRITE, .index = ota_rx.fill_index };
+
+    xQueueSend(ota_writer_q, &msg, portMAX_DELAY);
+
+    ota_rx.fill_acquired = false;
+    ota_rx.fill_index = (ota_rx.fill_index + 1U) % OTA_BUFFER_COUNT;
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_start
+ ******************************************************************************
+ * Summary:
+ *  Handles the manifest fragment: validates the image size and starts a new
+ *  update, discarding any update in progress.
+ *
+ * Parameters:
+ *  const uint8_t *manifest : Manifest, see OTA_MANIFEST_SIZE
+ *  size_t length : Length of the manifest
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_receiver_start(const uint8_t *manifest, size_t length)
+{
+    ota_writer_msg_t msg = { .cmd = OTA_WRITER_START };
+    char detail[64];
+
+    if (!OTA_SECONDARY_SLOT_AVAILABLE)
+    {
+        ota_receiver_fail("no secondary slot in the memory map");
+        return;
+    }
+
+    if (length != OTA_MANIFEST_SIZE)
+    {
+        ota_receiver_fail("invalid manifest");
+        return;
+    }
+
+    msg.image_size = ota_read_le32(manifest);
+    memcpy(msg.sha256, &manifest[4], OTA_SHA256_SIZE);
+
+    if ((0U == msg.image_size) ||
+        (msg.image_size > (OTA_SECONDARY_SLOT_SIZE - OTA_FLASH_ERASE_SIZE)))
+    {
+        ota_receiver_fail("image does not fit the secondary slot");
+        return;
+    }
+
+    ota_rx.expected_sequence = 1U;
+    ota_rx.image_size = msg.image_size;
+    ota_rx.received_size = 0U;
+    ota_rx.duplicates = 0U;
+    ota_rx.stall_ticks = 0U;
+    if (ota_rx.fill_acquired)
+    {
+        ota_buffers[ota_rx.fill_index].offset = 0U;
+        ota_buffers[ota_rx.fill_index].length = 0U;
+    }
+
+    ota_state = OTA_STATE_RECEIVING;
+    xQueueSend(ota_writer_q, &msg, portMAX_DELAY);
+
+    snprintf(detail, sizeof(detail), "receiving %lu bytes", (unsigned long)msg.image_size);
+    ota_report_status("started", detail);
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_append
+ ******************************************************************************
+ * Summary:
+ *  Copies image data into the pipeline, handing each full buffer, and the
+ *  last partial one, to the writer task.
+ *
+ * Parameters:
+ *  const uint8_t *data : Image data
+ *  size_t length : Length of the image data
+ *
+ * Return:
+ *  bool : false if no buffer became free in time
+ *
+ ******************************************************************************/
+static bool ota_receiver_append(const uint8_t *data, size_t length)
+{
+    ota_buffer_t *buffer;
+    uint32_t chunk;
+
+    while (length > 0U)
+    {
+        if (!ota_receiver_acquire_buffer())
+        {
+            return false;
+        }
+
+        buffer = &ota_buffers[ota_rx.fill_index];
+        chunk = OTA_BUFFER_SIZE - buffer->length;
+        if (chunk > length)
+        {
+            chunk = length;
+        }
+
+        memcpy(&buffer->data[buffer->length], data, chunk);
+        buffer->length += chunk;
+        ota_rx.received_size += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if ((OTA_BUFFER_SIZE == buffer->length) || (ota_rx.received_size == ota_rx.image_size))
+        {
+            ota_receiver_submit_buffer();
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_handle_fragment
+ ******************************************************************************
+ * Summary:
+ *  Handles a fragment received on the firmware topic. Called from the MQTT
+ *  subscription callback; blocking here holds back the PUBACK of the
+ *  fragment and so throttles the sender to the speed of the flash.
+ *  Redelivered fragments are ignored, a missing fragment aborts the update.
+ *
+ * Parameters:
+ *  const uint8_t *fragment : Received fragment, see OTA_FRAGMENT_HEADER_SIZE
+ *  size_t length : Length of the fragment
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void ota_receiver_handle_fragment(const uint8_t *fragment, size_t length)
+{
+    uint32_t sequence;
+    const uint8_t *data;
+    size_t data_length;
+    ota_writer_msg_t msg = { .cmd = OTA_WRITER_FINISH };
+    char detail[64];
+
+    if ((NULL == ota_writer_q) || (length < OTA_FRAGMENT_HEADER_SIZE))
+    {
+        printf("  OTA: Fragment ignored\n");
+        return;
+    }
+
+    sequence = ota_read_le32(fragment);
+    data = &fragment[OTA_FRAGMENT_HEADER_SIZE];
+    data_length = length - OTA_FRAGMENT_HEADER_SIZE;
+
+    wifi_powersave_expect(WIFI_TRAFFIC_BULK, OTA_FRAGMENT_GAP_MS);
+
+    if (0U == sequence)
+    {
+        ota_receiver_start(data, data_length);
+        return;
+    }
+
+    if (OTA_STATE_RECEIVING != ota_state)
+    {
+        return;
+    }
+
+    if (sequence < ota_rx.expected_sequence)
+    {
+        /* QoS 1 redelivery of a fragment already written. */
+        ota_rx.duplicates++;
+        return;
+    }
+
+    if (sequence > ota_rx.expected_sequence)
+    {
+        snprintf(detail, sizeof(detail), "fragment %lu missing",
+                 (unsigned long)ota_rx.expected_sequence);
+        ota_receiver_fail(detail);
+        return;
+    }
+
+    if (data_length > (ota_rx.image_size - ota_rx.received_size))
+    {
+        ota_receiver_fail("image larger than the manifest");
+        return;
+    }
+
+    if (!ota_receiver_append(data, data_length))
+    {
+        ota_receiver_fail("flash writer timeout");
+        return;
+    }
+    ota_rx.expected_sequence++;
+
+    if (ota_rx.received_size == ota_rx.image_size)
+    {
+        printf("  OTA: %lu fragments received, %lu duplicates, network waited %lu ms for flash\n",
+               (unsigned long)(ota_rx.expected_sequence - 1U), (unsigned long)ota_rx.duplicates,
+               (unsigned long)(ota_rx.stall_ticks * portTICK_PERIOD_MS));
+        xQueueSend(ota_writer_q, &msg, portMAX_DELAY);
+    }
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_set_flash_ops
+ ******************************************************************************
+ * Summary:
+ *  Replaces the flash backend of the receiver, e.g. with a RAM emulator.
+ *  Must be called while no update is in progress.
+ *
+ * Parameters:
+ *  const ota_flash_ops_t *ops : Flash backend, NULL for the external flash
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void ota_receiver_set_flash_ops(const ota_flash_ops_t *ops)
+{
+    ota_flash = (NULL != ops) ? ops : &ota_smif_flash_ops;
+}
+
+/******************************************************************************
+ * Function Name: ota_receiver_get_state
+ ******************************************************************************
+ * Summary:
+ *  Returns the state of the current or last firmware update.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  ota_state_t : State of the update
+ *
+ ******************************************************************************/
+ota_state_t ota_receiver_get_state(void)
+{
+    return ota_state;
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_erase_next
+ ******************************************************************************
+ * Summary:
+ *  Erases the next sector of the image area of the secondary slot.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_writer_erase_next(void)
+{
+    if (!ota_flash->erase(OTA_SECONDARY_SLOT_OFFSET + ota_writer.erased_size,
+                          OTA_FLASH_ERASE_SIZE))
+    {
+        ota_writer.flash_error = true;
+    }
+    ota_writer.erased_size += OTA_FLASH_ERASE_SIZE;
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_erase_pending
+ ******************************************************************************
+ * Summary:
+ *  Checks if the erased area is less than OTA_ERASE_AHEAD_SIZE ahead of the
+ *  write position.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if a sector should be erased
+ *
+ ******************************************************************************/
+static bool ota_writer_erase_pending(void)
+{
+    return ota_writer.active &&
+           (ota_writer.erased_size < ota_writer.erase_end) &&
+           (ota_writer.erased_size < (ota_writer.written_size + OTA_ERASE_AHEAD_SIZE));
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_start
+ ******************************************************************************
+ * Summary:
+ *  Starts writing a new image. The last sector of the slot is erased first
+ *  so that a stale boot request of an earlier update cannot survive a failed
+ *  one.
+ *
+ * Parameters:
+ *  const ota_writer_msg_t *msg : Start command with the manifest
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_writer_start(const ota_writer_msg_t *msg)
+{
+    if (ota_writer.active)
+    {
+        mbedtls_sha256_free(&ota_writer.sha256);
+    }
+
+    ota_writer.active = true;
+    ota_writer.flash_error = false;
+    ota_writer.image_size = msg->image_size;
+    ota_writer.erase_end = OTA_ROUND_UP(msg->image_size, OTA_FLASH_ERASE_SIZE);
+    ota_writer.erased_size = 0U;
+    ota_writer.written_size = 0U;
+    ota_writer.erase_stalls = 0U;
+    ota_writer.start_tick = xTaskGetTickCount();
+    memcpy(ota_writer.expected_sha256, msg->sha256, OTA_SHA256_SIZE);
+
+    mbedtls_sha256_init(&ota_writer.sha256);
+    mbedtls_sha256_starts(&ota_writer.sha256, 0);
+
+    if (!ota_flash->erase(OTA_SECONDARY_SLOT_OFFSET + OTA_SECONDARY_SLOT_SIZE - OTA_FLASH_ERASE_SIZE,
+                          OTA_FLASH_ERASE_SIZE))
+    {
+        ota_writer.flash_error = true;
+    }
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_write
+ ******************************************************************************
+ * Summary:
+ *  Programs a filled pipeline buffer, adds it to the image hash and returns
+ *  it to the receiver. Erases inline only if the erase-ahead fell behind.
+ *
+ * Parameters:
+ *  uint32_t index : Index of the filled buffer
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_writer_write(uint32_t index)
+{
+    ota_buffer_t *buffer = &ota_buffers[index];
+
+    if (ota_writer.active && !ota_writer.flash_error)
+    {
+        if (ota_writer.erased_size < (buffer->offset + buffer->length))
+        {
+            ota_writer.erase_stalls++;
+            while (ota_writer.erased_size < (buffer->offset + buffer->length))
+            {
+                ota_writer_erase_next();
+            }
+        }
+
+        if (!ota_flash->program(OTA_SECONDARY_SLOT_OFFSET + buffer->offset,
+                                buffer->data, buffer->length))
+        {
+            ota_writer.flash_error = true;
+        }
+
+        mbedtls_sha256_update(&ota_writer.sha256, buffer->data, buffer->length);
+        ota_writer.written_size = buffer->offset + buffer->length;
+    }
+
+    xSemaphoreGive(ota_free_buffers);
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_finish
+ ******************************************************************************
+ * Summary:
+ *  Verifies the hash of the written image and, on success, marks the
+ *  secondary slot pending for MCUboot. Reports the result and the
+ *  throughput of the update.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_writer_finish(void)
+{
+    uint8_t sha256[OTA_SHA256_SIZE];
+    uint8_t boot_magic[OTA_BOOT_MAGIC_SIZE];
+    uint32_t elapsed_ms;
+    char detail[96];
+
+    if (!ota_writer.active)
+    {
+        return;
+    }
+    ota_writer.active = false;
+
+    mbedtls_sha256_finish(&ota_writer.sha256, sha256);
+    mbedtls_sha256_free(&ota_writer.sha256);
+
+    elapsed_ms = (xTaskGetTickCount() - ota_writer.start_tick) * portTICK_PERIOD_MS;
+    if (0U == elapsed_ms)
+    {
+        elapsed_ms = 1U;
+    }
+    printf("  OTA: %lu bytes written in %lu ms (%lu KB/s), %lu erase stalls\n",
+           (unsigned long)ota_writer.written_size, (unsigned long)elapsed_ms,
+           (unsigned long)(((uint64_t)ota_writer.written_size * 1000U) / (elapsed_ms * 1024U)),
+           (unsigned long)ota_writer.erase_stalls);
+
+    if (ota_writer.flash_error)
+    {
+        ota_state = OTA_STATE_FAILED;
+        ota_report_status("failed", "flash error");
+    }
+    else if (0 != memcmp(sha256, ota_writer.expected_sha256, OTA_SHA256_SIZE))
+    {
+        ota_state = OTA_STATE_FAILED;
+        ota_report_status("failed", "SHA-256 mismatch");
+    }
+    else
+    {
+        /* The magic is a constant in flash; the backend programs from RAM. */
+        memcpy(boot_magic, ota_boot_magic, OTA_BOOT_MAGIC_SIZE);
+        if (!ota_flash->program(OTA_SECONDARY_SLOT_OFFSET + OTA_SECONDARY_SLOT_SIZE - OTA_BOOT_MAGIC_SIZE,
+                                boot_magic, OTA_BOOT_MAGIC_SIZE))
+        {
+            ota_state = OTA_STATE_FAILED;
+            ota_report_status("failed", "flash error");
+            return;
+        }
+
+        ota_state = OTA_STATE_VERIFIED;
+        snprintf(detail, sizeof(detail), "%lu bytes verified, pending reboot",
+                 (unsigned long)ota_writer.written_size);
+        ota_report_status("verified", detail);
+    }
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_handle
+ ******************************************************************************
+ * Summary:
+ *  Executes a command received by the OTA writer task.
+ *
+ * Parameters:
+ *  const ota_writer_msg_t *msg : Command to be executed
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void ota_writer_handle(const ota_writer_msg_t *msg)
+{
+    switch (msg->cmd)
+    {
+        case OTA_WRITER_START:
+        {
+            ota_writer_start(msg);
+            break;
+        }
+
+        case OTA_WRITER_WRITE:
+        {
+            ota_writer_write(msg->index);
+            break;
+        }
+
+        case OTA_WRITER_FINISH:
+        {
+            ota_writer_finish();
+            break;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: ota_writer_task
+ ******************************************************************************
+ * Summary:
+ *  Task that writes the image to the secondary slot. Between buffers it keeps
+ *  up to OTA_ERASE_AHEAD_SIZE bytes erased ahead of the write position, so
+ *  that programming a buffer rarely has to wait for an erase.
+ *
+ * Parameters:
+ *  void *pvParameters : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void ota_writer_task(void *pvParameters)
+{
+    ota_writer_msg_t msg;
+    TickType_t wait_ticks;
+
+    /* To avoid compiler warnings */
+    (void) pvParameters;
+
+    ota_smif_ready = ota_smif_init();
+    if (!ota_smif_ready)
+    {
+        printf("  OTA: External flash not usable, firmware updates will fail\n");
+    }
+
+    ota_free_buffers = xSemaphoreCreateCounting(OTA_BUFFER_COUNT, OTA_BUFFER_COUNT);
+    ota_writer_q = xQueueCreate(OTA_WRITER_QUEUE_LENGTH, sizeof(ota_writer_msg_t));
+
+    while (true)
+    {
+        wait_ticks = ota_writer_erase_pending() ? 0U : portMAX_DELAY;
+
+        if (pdTRUE != xQueueReceive(ota_writer_q, &msg, wait_ticks))
+        {
+            ota_writer_erase_next();
+            continue;
+        }
+
+        ota_writer_handle(&msg);
+    }
+}
+
+/* [] END OF FILE */
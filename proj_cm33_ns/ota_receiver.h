@@ -0,0 +1,146 @@
+/******************************************************************************
+* File Name:   ota_receiver.h
+*
+* Description: This file is the public interface of ota_receiver.c, the
+*              streaming firmware update receiver for the
+*              MQTT_SUB_TOPIC_COMMAND_FIRMWARE topic.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef OTA_RECEIVER_H_
+#define OTA_RECEIVER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Task parameters for the OTA Writer Task. Runs below the MQTT tasks so that
+ * flash erase and program never delay the network.
+ */
+#define OTA_WRITER_TASK_PRIORITY            (1U)
+#define OTA_WRITER_TASK_STACK_SIZE          (1024U * 2U)
+
+/* MCUboot secondary slot of the CM33 NS image in the external flash, as an
+ * offset from the start of the flash. It is the m33_nvm_secondary region
+ * followed by the m33_trailer_secondary region of the memory map, mirroring
+ * the primary slot (m33_nvm + m33_trailer). Without these regions the
+ * memory map has no room for a second image and updates are refused.
+ */
+#if defined(CYMEM_CM33_0_m33_nvm_secondary_OFFSET) && \
+    defined(CYMEM_CM33_0_m33_trailer_secondary_OFFSET)
+#define OTA_SECONDARY_SLOT_AVAILABLE        (1)
+#define OTA_SECONDARY_SLOT_OFFSET           (CYMEM_CM33_0_m33_nvm_secondary_OFFSET)
+#define OTA_SECONDARY_SLOT_SIZE             (CYMEM_CM33_0_m33_nvm_secondary_SIZE + \
+                                             CYMEM_CM33_0_m33_trailer_secondary_SIZE)
+
+#if ((CYMEM_CM33_0_m33_nvm_secondary_OFFSET + CYMEM_CM33_0_m33_nvm_secondary_SIZE) != \
+     CYMEM_CM33_0_m33_trailer_secondary_OFFSET)
+    #error "m33_trailer_secondary must follow m33_nvm_secondary!"
+#endif
+#else
+#define OTA_SECONDARY_SLOT_AVAILABLE        (0)
+#define OTA_SECONDARY_SLOT_OFFSET           (0x00000000UL)
+#define OTA_SECONDARY_SLOT_SIZE             (0x00000000UL)
+#endif
+
+/* Erase sector and program page sizes of the external flash. */
+#define OTA_FLASH_ERASE_SIZE                (0x00010000UL)
+#define OTA_FLASH_PROGRAM_SIZE              (0x00000100UL)
+
+/* Size of each of the two pipeline buffers. Must be a multiple of
+ * OTA_FLASH_PROGRAM_SIZE.
+ */
+#define OTA_BUFFER_SIZE                     (4096U)
+
+/* Number of bytes kept erased ahead of the write position. */
+#define OTA_ERASE_AHEAD_SIZE                (2U * OTA_FLASH_ERASE_SIZE)
+
+/* Fragment layout on the firmware topic (little endian):
+ *   uint32_t sequence; uint8_t data[];
+ * Sequence 0 carries the manifest:
+ *   uint32_t image_size; uint8_t sha256[OTA_SHA256_SIZE];
+ * Sequences 1..N carry consecutive image data.
+ */
+#define OTA_FRAGMENT_HEADER_SIZE            (4U)
+#define OTA_SHA256_SIZE                     (32U)
+#define OTA_MANIFEST_SIZE                   (4U + OTA_SHA256_SIZE)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Flash backend of the receiver. Offsets are relative to the start of the
+ * external flash and the data to be programmed is always in RAM. All
+ * functions return true on success.
+ */
+typedef struct
+{
+    bool (*erase)(uint32_t offset, uint32_t length);
+    bool (*program)(uint32_t offset, const uint8_t *data, uint32_t length);
+} ota_flash_ops_t;
+
+/* State of the firmware update. */
+typedef enum
+{
+    OTA_STATE_IDLE,
+    OTA_STATE_RECEIVING,
+    OTA_STATE_VERIFIED,
+    OTA_STATE_FAILED
+} ota_state_t;
+
+/*******************************************************************************
+* Extern Variables
+********************************************************************************/
+extern TaskHandle_t ota_writer_task_handle;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void ota_receiver_set_flash_ops(const ota_flash_ops_t *ops);
+void ota_receiver_handle_fragment(const uint8_t *fragment, size_t length);
+ota_state_t ota_receiver_get_state(void);
+void ota_writer_task(void *pvParameters);
+
+#endif /* OTA_RECEIVER_H_ */
+
+/* [] END OF FILE */
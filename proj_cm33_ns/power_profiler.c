@@ -0,0 +1,599 @@
+/******************************************************************************
+* File Name:   power_profiler.c
+*
+* Description: This file contains the power profiler. It accounts the time
+*              the CM33 and the CM55 spend active, in CPU sleep and in deep
+*              sleep, the causes of the wake-ups and the active time of each
+*              task, and estimates the energy spent per published message.
+*              The figures are added to the metrics report.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "cybsp.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "power_profiler.h"
+#include "publish_metrics.h"
+#include "cm55_residency.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Current drawn in each power mode and the supply voltage, used to turn the
+ * residency into energy. These are typical values for the system domain and
+ * exclude the Wi-Fi radio; replace them with values measured on the board
+ * for absolute figures. The ratios between configurations are meaningful
+ * either way.
+ */
+#define POWER_PROFILER_SUPPLY_MV            (1800U)
+#define POWER_PROFILER_CM33_ACTIVE_UA       (9000U)
+#define POWER_PROFILER_CM33_SLEEP_UA        (3500U)
+#define POWER_PROFILER_CM55_ACTIVE_UA       (14000U)
+#define POWER_PROFILER_CM55_SLEEP_UA        (4500U)
+#define POWER_PROFILER_DEEPSLEEP_UA         (90U)
+
+/* Maximum number of tasks whose active time is reported. */
+#define POWER_PROFILER_MAX_TASKS            (16U)
+
+/* Attempts to read a consistent record from the CM55. */
+#define POWER_PROFILER_CM55_READ_RETRIES    (4U)
+
+/* Order of the SysPm callbacks; they only observe the transition. */
+#define POWER_PROFILER_SYSPM_ORDER          (255U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Interrupt that ended a sleep, found pending on the way out of it. */
+typedef enum
+{
+    POWER_WAKE_BUTTON,
+    POWER_WAKE_WIFI,
+    POWER_WAKE_TIMER,
+    POWER_WAKE_OTHER,
+    POWER_WAKE_COUNT
+} power_wake_cause_t;
+
+/* Residency of one CPU in milliseconds. */
+typedef struct
+{
+    uint32_t active_ms;
+    uint32_t sleep_ms;
+    uint32_t deepsleep_ms;
+} power_residency_t;
+
+static const char *const wake_cause_names[POWER_WAKE_COUNT] =
+{
+    "btn", "wifi", "tmr", "oth"
+};
+
+/* Updated by the idle task, with the scheduler suspended. */
+static uint32_t cm33_sleep_ms;
+static uint32_t cm33_deepsleep_ms;
+static uint32_t wake_counts[POWER_WAKE_COUNT];
+
+/* Set by the SysPm callbacks during a sleep. */
+static volatile bool sleep_entered;
+static volatile bool deepsleep_entered;
+static volatile power_wake_cause_t wake_cause;
+
+/* Messages published since boot. */
+static uint32_t messages_published;
+
+/* Last value of the run time counter, to keep it monotonic. */
+static uint64_t last_run_time_us;
+
+/* Task states for the per-task active time; used by the metrics report. */
+static TaskStatus_t task_states[POWER_PROFILER_MAX_TASKS];
+
+/******************************************************************************
+* Function Name: power_profiler_wake_cause
+******************************************************************************
+* Summary:
+*  Finds the interrupt that woke the CPU. Called with interrupts disabled on
+*  the way out of a sleep, so the interrupt is still pending.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  power_wake_cause_t : Wake-up cause
+*
+******************************************************************************/
+static power_wake_cause_t power_profiler_wake_cause(void)
+{
+    power_wake_cause_t cause = POWER_WAKE_OTHER;
+
+    if (0U != NVIC_GetPendingIRQ(CYBSP_USER_BTN_IRQ))
+    {
+        cause = POWER_WAKE_BUTTON;
+    }
+    else if ((0U != NVIC_GetPendingIRQ(CYBSP_WIFI_HOST_WAKE_IRQ)) ||
+             (0U != NVIC_GetPendingIRQ(CYBSP_WIFI_SDIO_IRQ)))
+    {
+        cause = POWER_WAKE_WIFI;
+    }
+    else if (0U != NVIC_GetPendingIRQ(CYBSP_CM33_LPTIMER_0_IRQ))
+    {
+        cause = POWER_WAKE_TIMER;
+    }
+
+    return cause;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_sleep_callback
+******************************************************************************
+* Summary:
+*  Notes a wake-up from CPU sleep and its cause.
+*
+* Parameters:
+*  cy_stc_syspm_callback_params_t *params : Callback parameters (unused)
+*  cy_en_syspm_callback_mode_t mode : Callback mode
+*
+* Return:
+*  cy_en_syspm_status_t : CY_SYSPM_SUCCESS
+*
+******************************************************************************/
+static cy_en_syspm_status_t power_profiler_sleep_callback(cy_stc_syspm_callback_params_t *params,
+                                                          cy_en_syspm_callback_mode_t mode)
+{
+    CY_UNUSED_PARAMETER(params);
+
+    if (CY_SYSPM_AFTER_TRANSITION == mode)
+    {
+        sleep_entered = true;
+        wake_cause = power_profiler_wake_cause();
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_deepsleep_callback
+******************************************************************************
+* Summary:
+*  Notes a wake-up from deep sleep and its cause.
+*
+* Parameters:
+*  cy_stc_syspm_callback_params_t *params : Callback parameters (unused)
+*  cy_en_syspm_callback_mode_t mode : Callback mode
+*
+* Return:
+*  cy_en_syspm_status_t : CY_SYSPM_SUCCESS
+*
+******************************************************************************/
+static cy_en_syspm_status_t power_profiler_deepsleep_callback(cy_stc_syspm_callback_params_t *params,
+                                                              cy_en_syspm_callback_mode_t mode)
+{
+    CY_UNUSED_PARAMETER(params);
+
+    if (CY_SYSPM_AFTER_TRANSITION == mode)
+    {
+        deepsleep_entered = true;
+        wake_cause = power_profiler_wake_cause();
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+#if configUSE_TICKLESS_IDLE
+static cy_stc_syspm_callback_params_t power_profiler_syspm_params =
+{
+    .context            = NULL,
+    .base               = NULL
+};
+
+static cy_stc_syspm_callback_t power_profiler_sleep_cb =
+{
+    .callback           = &power_profiler_sleep_callback,
+    .skipMode           = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                          CY_SYSPM_SKIP_BEFORE_TRANSITION,
+    .type               = CY_SYSPM_SLEEP,
+    .callbackParams     = &power_profiler_syspm_params,
+    .prevItm            = NULL,
+    .nextItm            = NULL,
+    .order              = POWER_PROFILER_SYSPM_ORDER
+};
+
+static cy_stc_syspm_callback_t power_profiler_deepsleep_cb =
+{
+    .callback           = &power_profiler_deepsleep_callback,
+    .skipMode           = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                          CY_SYSPM_SKIP_BEFORE_TRANSITION,
+    .type               = CY_SYSPM_DEEPSLEEP,
+    .callbackParams     = &power_profiler_syspm_params,
+    .prevItm            = NULL,
+    .nextItm            = NULL,
+    .order              = POWER_PROFILER_SYSPM_ORDER
+};
+#endif /* configUSE_TICKLESS_IDLE */
+
+/******************************************************************************
+* Function Name: power_profiler_read_cm55
+******************************************************************************
+* Summary:
+*  Reads the residency record of the CM55 from the shared memory. The CM55
+*  may update it at any time, so the read is repeated until the sequence
+*  number is even and unchanged.
+*
+* Parameters:
+*  power_residency_t *residency : Residency of the CM55
+*
+* Return:
+*  bool : true if a consistent record was read
+*
+******************************************************************************/
+static bool power_profiler_read_cm55(power_residency_t *residency)
+{
+    const volatile cm55_residency_t *record =
+        (const volatile cm55_residency_t *)CYMEM_CM33_0_m55_allocatable_shared_START;
+    uint32_t sequence;
+    uint32_t uptime_ms;
+
+    if (CM55_RESIDENCY_MAGIC != record->magic)
+    {
+        return false;
+    }
+
+    for (uint32_t attempt = 0U; attempt < POWER_PROFILER_CM55_READ_RETRIES; attempt++)
+    {
+        sequence = record->sequence;
+        __DMB();
+        uptime_ms = record->uptime_ms;
+        residency->sleep_ms = record->sleep_ms;
+        residency->deepsleep_ms = record->deepsleep_ms;
+        __DMB();
+
+        if ((0U == (sequence & 1U)) && (sequence == record->sequence))
+        {
+            residency->active_ms = uptime_ms - residency->sleep_ms - residency->deepsleep_ms;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_energy_uj
+******************************************************************************
+* Summary:
+*  Estimates the energy spent since boot from the residency of both CPUs.
+*  The deep sleep current is that of the whole system, so it is charged
+*  once, for the time the CM33 spent in deep sleep.
+*
+* Parameters:
+*  const power_residency_t *cm33 : Residency of the CM33
+*  const power_residency_t *cm55 : Residency of the CM55, NULL if unknown
+*
+* Return:
+*  uint64_t : Energy in microjoules
+*
+******************************************************************************/
+static uint64_t power_profiler_energy_uj(const power_residency_t *cm33, const power_residency_t *cm55)
+{
+    /* uA * ms = nC; nC * mV = pJ */
+    uint64_t charge_nc = ((uint64_t)cm33->active_ms * POWER_PROFILER_CM33_ACTIVE_UA) +
+                         ((uint64_t)cm33->sleep_ms * POWER_PROFILER_CM33_SLEEP_UA) +
+                         ((uint64_t)cm33->deepsleep_ms * POWER_PROFILER_DEEPSLEEP_UA);
+
+    if (NULL != cm55)
+    {
+        charge_nc += ((uint64_t)cm55->active_ms * POWER_PROFILER_CM55_ACTIVE_UA) +
+                     ((uint64_t)cm55->sleep_ms * POWER_PROFILER_CM55_SLEEP_UA);
+    }
+
+    return (charge_nc * POWER_PROFILER_SUPPLY_MV) / 1000000U;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_read_cm33
+******************************************************************************
+* Summary:
+*  Reads the residency of the CM33 and the wake-up counts.
+*
+* Parameters:
+*  power_residency_t *residency : Residency of the CM33
+*  uint32_t *wakes : Wake-up counts, POWER_WAKE_COUNT entries
+*
+* Return:
+*  uint32_t : Uptime in milliseconds
+*
+******************************************************************************/
+static uint32_t power_profiler_read_cm33(power_residency_t *residency, uint32_t *wakes)
+{
+    uint32_t uptime_ms;
+
+    taskENTER_CRITICAL();
+    uptime_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    residency->sleep_ms = cm33_sleep_ms;
+    residency->deepsleep_ms = cm33_deepsleep_ms;
+    for (uint32_t i = 0U; i < POWER_WAKE_COUNT; i++)
+    {
+        wakes[i] = wake_counts[i];
+    }
+    taskEXIT_CRITICAL();
+
+    residency->active_ms = uptime_ms - residency->sleep_ms - residency->deepsleep_ms;
+
+    return uptime_ms;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_format_json
+******************************************************************************
+* Summary:
+*  Formats the cumulative residency, wake-up counts, energy and per-task
+*  active time as a JSON object; the collector takes the differences
+*  between reports.
+*
+* Parameters:
+*  char *buffer : Output buffer
+*  size_t buffer_len : Size of the output buffer
+*  size_t *used : Number of characters already in the buffer; updated
+*
+* Return:
+*  bool : true if the object fit in the buffer
+*
+******************************************************************************/
+static bool power_profiler_format_json(char *buffer, size_t buffer_len, size_t *used)
+{
+    power_residency_t cm33;
+    power_residency_t cm55;
+    uint32_t wakes[POWER_WAKE_COUNT];
+    uint32_t uptime_ms = power_profiler_read_cm33(&cm33, wakes);
+    bool cm55_valid = power_profiler_read_cm55(&cm55);
+    UBaseType_t task_count;
+    bool fits;
+
+    fits = publish_metrics_append(buffer, buffer_len, used,
+                                  "{\"up\":%lu,\"act\":%lu,\"slp\":%lu,\"ds\":%lu,\"wake\":{",
+                                  (unsigned long)uptime_ms, (unsigned long)cm33.active_ms,
+                                  (unsigned long)cm33.sleep_ms, (unsigned long)cm33.deepsleep_ms);
+
+    for (uint32_t i = 0U; fits && (i < POWER_WAKE_COUNT); i++)
+    {
+        fits = publish_metrics_append(buffer, buffer_len, used, "%s\"%s\":%lu", (0U == i) ? "" : ",",
+                                      wake_cause_names[i], (unsigned long)wakes[i]);
+    }
+
+    fits = fits && publish_metrics_append(buffer, buffer_len, used, "}");
+
+    if (fits && cm55_valid)
+    {
+        fits = publish_metrics_append(buffer, buffer_len, used,
+                                      ",\"m55\":{\"act\":%lu,\"slp\":%lu,\"ds\":%lu}",
+                                      (unsigned long)cm55.active_ms, (unsigned long)cm55.sleep_ms,
+                                      (unsigned long)cm55.deepsleep_ms);
+    }
+
+    fits = fits && publish_metrics_append(buffer, buffer_len, used, ",\"msgs\":%lu,\"uJ\":%lu,\"tasks\":{",
+                                          (unsigned long)messages_published,
+                                          (unsigned long)power_profiler_energy_uj(&cm33,
+                                                                                  cm55_valid ? &cm55 : NULL));
+
+    task_count = uxTaskGetSystemState(task_states, POWER_PROFILER_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0U; fits && (i < task_count); i++)
+    {
+        fits = publish_metrics_append(buffer, buffer_len, used, "%s\"%s\":%lu", (0U == i) ? "" : ",",
+                                      task_states[i].pcTaskName,
+                                      (unsigned long)(task_states[i].ulRunTimeCounter / 1000U));
+    }
+
+    return fits && publish_metrics_append(buffer, buffer_len, used, "}}");
+}
+
+/******************************************************************************
+* Function Name: power_profiler_print
+******************************************************************************
+* Summary:
+*  Prints the residency and the energy per message on the debug UART.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+static void power_profiler_print(void)
+{
+    power_residency_t cm33;
+    power_residency_t cm55;
+    uint32_t wakes[POWER_WAKE_COUNT];
+    uint32_t uptime_ms = power_profiler_read_cm33(&cm33, wakes);
+    bool cm55_valid = power_profiler_read_cm55(&cm55);
+    uint64_t energy_uj = power_profiler_energy_uj(&cm33, cm55_valid ? &cm55 : NULL);
+
+    printf("Power: CM33 active %lu ms, sleep %lu ms, deep sleep %lu ms of %lu ms; wake-ups btn %lu, wifi %lu, timer %lu, other %lu\n",
+           (unsigned long)cm33.active_ms, (unsigned long)cm33.sleep_ms, (unsigned long)cm33.deepsleep_ms,
+           (unsigned long)uptime_ms, (unsigned long)wakes[POWER_WAKE_BUTTON],
+           (unsigned long)wakes[POWER_WAKE_WIFI], (unsigned long)wakes[POWER_WAKE_TIMER],
+           (unsigned long)wakes[POWER_WAKE_OTHER]);
+    if (cm55_valid)
+    {
+        printf("Power: CM55 active %lu ms, sleep %lu ms, deep sleep %lu ms\n",
+               (unsigned long)cm55.active_ms, (unsigned long)cm55.sleep_ms,
+               (unsigned long)cm55.deepsleep_ms);
+    }
+    printf("Power: %lu uJ for %lu messages, %lu uJ per message (excluding the radio)\n",
+           (unsigned long)energy_uj, (unsigned long)messages_published,
+           (unsigned long)((0U == messages_published) ? 0U : (energy_uj / messages_published)));
+}
+
+/******************************************************************************
+* Function Name: power_profiler_init
+******************************************************************************
+* Summary:
+*  Registers the SysPm callbacks that find the wake-up causes and adds the
+*  power figures to the metrics report.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void power_profiler_init(void)
+{
+#if configUSE_TICKLESS_IDLE
+    Cy_SysPm_RegisterCallback(&power_profiler_sleep_cb);
+    Cy_SysPm_RegisterCallback(&power_profiler_deepsleep_cb);
+#endif /* configUSE_TICKLESS_IDLE */
+
+    publish_metrics_register_section("power", power_profiler_format_json, power_profiler_print);
+}
+
+/******************************************************************************
+* Function Name: power_profiler_sleep
+******************************************************************************
+* Summary:
+*  Tickless idle hook (portSUPPRESS_TICKS_AND_SLEEP in FreeRTOSConfig.h),
+*  called by the idle task with the scheduler suspended. Sleeps through
+*  vApplicationSleep() of the RTOS abstraction library, which steps the tick
+*  count by the time slept, and charges that time to the power mode the
+*  SysPm callbacks saw.
+*
+* Parameters:
+*  uint32_t expected_idle_ticks : Ticks until the next task is due
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void power_profiler_sleep(uint32_t expected_idle_ticks)
+{
+#if configUSE_TICKLESS_IDLE
+    TickType_t start = xTaskGetTickCount();
+    uint32_t slept_ms;
+
+    sleep_entered = false;
+    deepsleep_entered = false;
+    vApplicationSleep(expected_idle_ticks);
+    slept_ms = (uint32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+
+    /* The sleep may be abandoned if a task became ready in the meantime. */
+    if (deepsleep_entered)
+    {
+        cm33_deepsleep_ms += slept_ms;
+    }
+    else if (sleep_entered)
+    {
+        cm33_sleep_ms += slept_ms;
+    }
+    else
+    {
+        return;
+    }
+
+    wake_counts[wake_cause]++;
+#else
+    CY_UNUSED_PARAMETER(expected_idle_ticks);
+#endif /* configUSE_TICKLESS_IDLE */
+}
+
+/******************************************************************************
+* Function Name: power_profiler_run_time_us
+******************************************************************************
+* Summary:
+*  Run time counter of the FreeRTOS task statistics, in microseconds. It
+*  extends the tick count with the elapsed part of the current SysTick
+*  period, so short bursts of work are not lost to the 1 ms tick. The time
+*  slept is stepped into the tick count and thus charged to the idle task.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t : Microseconds since the scheduler started
+*
+******************************************************************************/
+uint64_t power_profiler_run_time_us(void)
+{
+    UBaseType_t interrupt_mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t reload = SysTick->LOAD;
+    TickType_t ticks = xTaskGetTickCountFromISR();
+    uint32_t current = SysTick->VAL;
+    uint64_t run_time_us;
+
+    /* SysTick wrapped, but its interrupt has not run yet. */
+    if (0U != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        current = SysTick->VAL;
+        ticks++;
+    }
+
+    run_time_us = ((uint64_t)ticks * portTICK_PERIOD_MS * 1000U) +
+                  (((reload - current) * (portTICK_PERIOD_MS * 1000U)) / (reload + 1U));
+
+    if (run_time_us < last_run_time_us)
+    {
+        run_time_us = last_run_time_us;
+    }
+    last_run_time_us = run_time_us;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(interrupt_mask);
+
+    return run_time_us;
+}
+
+/******************************************************************************
+* Function Name: power_profiler_count_message
+******************************************************************************
+* Summary:
+*  Counts a published message, for the energy per message.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void power_profiler_count_message(void)
+{
+    taskENTER_CRITICAL();
+    messages_published++;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
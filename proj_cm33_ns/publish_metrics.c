@@ -0,0 +1,389 @@
+/******************************************************************************
+* File Name:   publish_metrics.c
+*
+* Description: This file contains the publish latency histograms. Every
+*              publish is timed from enqueue to hand-off to the MQTT library
+*              and from hand-off to PUBACK, per topic.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "publish_metrics.h"
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/* Histograms of one topic. The topic string is not copied; it must be a
+ * string literal or otherwise outlive the metrics.
+ */
+typedef struct
+{
+    const char *topic;
+    latency_histogram_t stages[PUBLISH_STAGE_COUNT];
+} topic_metrics_t;
+
+/* Additional section of the metrics report, provided by another module. */
+typedef struct
+{
+    const char *name;
+    publish_metrics_format_t format;
+    publish_metrics_print_t print;
+} metrics_section_t;
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+static topic_metrics_t topic_metrics[PUBLISH_METRICS_MAX_TOPICS];
+
+static metrics_section_t metrics_sections[PUBLISH_METRICS_MAX_SECTIONS];
+
+static const char *const stage_names[PUBLISH_STAGE_COUNT] =
+{
+    [PUBLISH_STAGE_QUEUE] = "queue",
+    [PUBLISH_STAGE_ACK] = "ack",
+    [PUBLISH_STAGE_TOTAL] = "total"
+};
+
+/******************************************************************************
+ * Function Name: latency_histogram_record
+ ******************************************************************************
+ * Summary:
+ *  Adds one latency sample to the histogram.
+ *
+ * Parameters:
+ *  latency_histogram_t *histogram : Histogram to be updated
+ *  uint32_t latency_ms : Latency in milliseconds
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void latency_histogram_record(latency_histogram_t *histogram, uint32_t latency_ms)
+{
+    uint32_t bucket = (0U == latency_ms) ? 0U : (32U - __CLZ(latency_ms));
+
+    if (bucket >= LATENCY_HISTOGRAM_BUCKETS)
+    {
+        bucket = LATENCY_HISTOGRAM_BUCKETS - 1U;
+    }
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    if (latency_ms > histogram->max_ms)
+    {
+        histogram->max_ms = latency_ms;
+    }
+}
+
+/******************************************************************************
+ * Function Name: latency_histogram_percentile
+ ******************************************************************************
+ * Summary:
+ *  Estimates a percentile as the upper bound of the bucket that contains it,
+ *  capped by the largest recorded sample.
+ *
+ * Parameters:
+ *  const latency_histogram_t *histogram : Histogram to be evaluated
+ *  uint32_t percent : Percentile to be estimated (1 - 100)
+ *
+ * Return:
+ *  uint32_t : Percentile in milliseconds, 0 if the histogram is empty
+ *
+ ******************************************************************************/
+uint32_t latency_histogram_percentile(const latency_histogram_t *histogram, uint32_t percent)
+{
+    uint32_t rank;
+    uint32_t seen = 0U;
+    uint32_t upper_ms;
+
+    if (0U == histogram->count)
+    {
+        return 0U;
+    }
+
+    /* Rank of the sample at the requested percentile, rounded up. */
+    rank = (uint32_t)(((uint64_t)histogram->count * percent + 99U) / 100U);
+
+    for (uint32_t bucket = 0U; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank)
+        {
+            upper_ms = (0U == bucket) ? 0U : ((1UL << bucket) - 1U);
+            return (upper_ms < histogram->max_ms) ? upper_ms : histogram->max_ms;
+        }
+    }
+
+    return histogram->max_ms;
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_find_topic
+ ******************************************************************************
+ * Summary:
+ *  Looks up the metrics of a topic, allocating a free slot for a new topic.
+ *
+ * Parameters:
+ *  const char *topic : Topic name
+ *
+ * Return:
+ *  topic_metrics_t * : Metrics of the topic, NULL if all slots are in use
+ *
+ ******************************************************************************/
+static topic_metrics_t *publish_metrics_find_topic(const char *topic)
+{
+    for (uint32_t i = 0U; i < PUBLISH_METRICS_MAX_TOPICS; i++)
+    {
+        if (NULL == topic_metrics[i].topic)
+        {
+            topic_metrics[i].topic = topic;
+            return &topic_metrics[i];
+        }
+
+        if ((topic_metrics[i].topic == topic) || (0 == strcmp(topic_metrics[i].topic, topic)))
+        {
+            return &topic_metrics[i];
+        }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_record
+ ******************************************************************************
+ * Summary:
+ *  Records the stage latencies of one completed publish.
+ *
+ * Parameters:
+ *  const char *topic : Topic the message was published on
+ *  uint32_t queue_ms : Time from enqueue to hand-off to the MQTT library
+ *  uint32_t ack_ms : Time from hand-off to PUBACK
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publish_metrics_record(const char *topic, uint32_t queue_ms, uint32_t ack_ms)
+{
+    topic_metrics_t *metrics = publish_metrics_find_topic(topic);
+
+    if (NULL == metrics)
+    {
+        return;
+    }
+
+    latency_histogram_record(&metrics->stages[PUBLISH_STAGE_QUEUE], queue_ms);
+    latency_histogram_record(&metrics->stages[PUBLISH_STAGE_ACK], ack_ms);
+    latency_histogram_record(&metrics->stages[PUBLISH_STAGE_TOTAL], queue_ms + ack_ms);
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_register_section
+ ******************************************************************************
+ * Summary:
+ *  Adds a section provided by another module to the metrics report. The
+ *  section is emitted as "name":<value> next to the latency histograms.
+ *
+ * Parameters:
+ *  const char *name : JSON key of the section; must outlive the metrics
+ *  publish_metrics_format_t format : Formats the JSON value of the section
+ *  publish_metrics_print_t print : Prints the section on the debug UART
+ *                                  (optional, may be NULL)
+ *
+ * Return:
+ *  bool : true if the section was registered, false if all slots are in use
+ *
+ ******************************************************************************/
+bool publish_metrics_register_section(const char *name, publish_metrics_format_t format,
+                                      publish_metrics_print_t print)
+{
+    for (uint32_t i = 0U; i < PUBLISH_METRICS_MAX_SECTIONS; i++)
+    {
+        if (NULL == metrics_sections[i].name)
+        {
+            metrics_sections[i].name = name;
+            metrics_sections[i].format = format;
+            metrics_sections[i].print = print;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_print
+ ******************************************************************************
+ * Summary:
+ *  Prints the percentiles of every tracked topic on the debug UART.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publish_metrics_print(void)
+{
+    const latency_histogram_t *histogram;
+
+    printf("\nPublish latency (ms)          count    p50    p90    p99    max\n");
+    for (uint32_t i = 0U; (i < PUBLISH_METRICS_MAX_TOPICS) && (NULL != topic_metrics[i].topic); i++)
+    {
+        printf("  %s\n", topic_metrics[i].topic);
+        for (uint32_t stage = 0U; stage < PUBLISH_STAGE_COUNT; stage++)
+        {
+            histogram = &topic_metrics[i].stages[stage];
+            printf("    %-24s %7lu %6lu %6lu %6lu %6lu\n", stage_names[stage],
+                   (unsigned long)histogram->count,
+                   (unsigned long)latency_histogram_percentile(histogram, 50U),
+                   (unsigned long)latency_histogram_percentile(histogram, 90U),
+                   (unsigned long)latency_histogram_percentile(histogram, 99U),
+                   (unsigned long)histogram->max_ms);
+        }
+    }
+
+    for (uint32_t i = 0U; (i < PUBLISH_METRICS_MAX_SECTIONS) && (NULL != metrics_sections[i].name); i++)
+    {
+        if (NULL != metrics_sections[i].print)
+        {
+            metrics_sections[i].print();
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_append
+ ******************************************************************************
+ * Summary:
+ *  Appends formatted text to a buffer, tracking the used length. Used to
+ *  build the metrics report, including the sections of other modules.
+ *
+ * Parameters:
+ *  char *buffer : Output buffer
+ *  size_t buffer_len : Size of the output buffer
+ *  size_t *used : Number of characters already in the buffer; updated
+ *  const char *format : printf-style format string
+ *
+ * Return:
+ *  bool : true if the text fit into the buffer, else false
+ *
+ ******************************************************************************/
+bool publish_metrics_append(char *buffer, size_t buffer_len, size_t *used, const char *format, ...)
+{
+    va_list args;
+    int written;
+
+    va_start(args, format);
+    written = vsnprintf(&buffer[*used], buffer_len - *used, format, args);
+    va_end(args);
+
+    if ((written < 0) || ((size_t)written >= (buffer_len - *used)))
+    {
+        return false;
+    }
+
+    *used += (size_t)written;
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: publish_metrics_format_json
+ ******************************************************************************
+ * Summary:
+ *  Formats the percentiles of every tracked topic, followed by the registered
+ *  sections, as a compact JSON document for the metrics topic, e.g.
+ *  {"latency":[{"topic":"...","queue":{"n":5,"p50":1,...},...}],"name":...}
+ *
+ * Parameters:
+ *  char *buffer : Output buffer
+ *  size_t buffer_len : Size of the output buffer
+ *
+ * Return:
+ *  size_t : Length of the JSON document, 0 if it did not fit
+ *
+ ******************************************************************************/
+size_t publish_metrics_format_json(char *buffer, size_t buffer_len)
+{
+    const latency_histogram_t *histogram;
+    size_t used = 0U;
+    bool fits;
+
+    fits = publish_metrics_append(buffer, buffer_len, &used, "{\"latency\":[");
+
+    for (uint32_t i = 0U; fits && (i < PUBLISH_METRICS_MAX_TOPICS) && (NULL != topic_metrics[i].topic); i++)
+    {
+        fits = publish_metrics_append(buffer, buffer_len, &used, "%s{\"topic\":\"%s\"",
+                              (0U == i) ? "" : ",", topic_metrics[i].topic);
+
+        for (uint32_t stage = 0U; fits && (stage < PUBLISH_STAGE_COUNT); stage++)
+        {
+            histogram = &topic_metrics[i].stages[stage];
+            fits = publish_metrics_append(buffer, buffer_len, &used,
+                                  ",\"%s\":{\"n\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}",
+                                  stage_names[stage],
+                                  (unsigned long)histogram->count,
+                                  (unsigned long)latency_histogram_percentile(histogram, 50U),
+                                  (unsigned long)latency_histogram_percentile(histogram, 90U),
+                                  (unsigned long)latency_histogram_percentile(histogram, 99U),
+                                  (unsigned long)histogram->max_ms);
+        }
+
+        fits = fits && publish_metrics_append(buffer, buffer_len, &used, "}");
+    }
+
+    fits = fits && publish_metrics_append(buffer, buffer_len, &used, "]");
+
+    for (uint32_t i = 0U; fits && (i < PUBLISH_METRICS_MAX_SECTIONS) && (NULL != metrics_sections[i].name); i++)
+    {
+        fits = publish_metrics_append(buffer, buffer_len, &used, ",\"%s\":", metrics_sections[i].name) &&
+               metrics_sections[i].format(buffer, buffer_len, &used);
+    }
+
+    fits = fits && publish_metrics_append(buffer, buffer_len, &used, "}");
+
+    return fits ? used : 0U;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,107 @@
+/******************************************************************************
+* File Name:   publish_metrics.h
+*
+* Description: This file is the public interface of publish_metrics.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PUBLISH_METRICS_H_
+#define PUBLISH_METRICS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of log2 buckets per latency histogram. Bucket 0 holds 0 ms, bucket
+ * i (i > 0) holds [2^(i-1), 2^i - 1] ms and the last bucket holds everything
+ * above, i.e. 16 buckets resolve latencies up to about 16 s.
+ */
+#define LATENCY_HISTOGRAM_BUCKETS           (16U)
+
+/* Maximum number of distinct topics that are tracked. */
+#define PUBLISH_METRICS_MAX_TOPICS          (4U)
+
+/* Maximum number of additional sections in the metrics report. */
+#define PUBLISH_METRICS_MAX_SECTIONS        (4U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Stages of a publish that are timed separately. */
+typedef enum
+{
+    PUBLISH_STAGE_QUEUE,    /* Enqueue to hand-off to cy_mqtt_publish() */
+    PUBLISH_STAGE_ACK,      /* Hand-off to PUBACK (return of cy_mqtt_publish()) */
+    PUBLISH_STAGE_TOTAL,    /* Enqueue to PUBACK */
+    PUBLISH_STAGE_COUNT
+} publish_stage_t;
+
+/* Formats the value of an additional metrics report section (the JSON
+ * value only; the key is added by the caller) using publish_metrics_append().
+ */
+typedef bool (*publish_metrics_format_t)(char *buffer, size_t buffer_len, size_t *used);
+
+/* Prints an additional metrics report section on the debug UART. */
+typedef void (*publish_metrics_print_t)(void);
+
+/* Log-bucketed latency histogram in milliseconds. */
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_ms;
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+} latency_histogram_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void latency_histogram_record(latency_histogram_t *histogram, uint32_t latency_ms);
+uint32_t latency_histogram_percentile(const latency_histogram_t *histogram, uint32_t percent);
+
+void publish_metrics_record(const char *topic, uint32_t queue_ms, uint32_t ack_ms);
+bool publish_metrics_register_section(const char *name, publish_metrics_format_t format,
+                                      publish_metrics_print_t print);
+bool publish_metrics_append(char *buffer, size_t buffer_len, size_t *used, const char *format, ...);
+void publish_metrics_print(void);
+size_t publish_metrics_format_json(char *buffer, size_t buffer_len);
+
+#endif /* PUBLISH_METRICS_H_ */
+
+/* [] END OF FILE */
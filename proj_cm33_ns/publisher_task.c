@@ -4,8 +4,8 @@
 * Description: This file contains the task that sets up the user button GPIO 
 *              for the publisher and publishes MQTT messages on the topic
 *              'MQTT_PUB_TOPIC' to control a device that is actuated by the
-*              subscriber task. The file also contains the ISR that notifies
-*              the publisher task about the new device state to be published.
+*              subscriber task. The file also contains the user button
+*              handler that queues a telemetry sample for every press.
 *
 * Related Document: See README.md
 *
@@ -57,12 +57,20 @@
 /* Middleware libraries */
 #include "cy_mqtt_api.h"
 #include "retarget_io_init.h"
+#include "rate_limiter.h"
+#include "publish_metrics.h"
+#include "sampling_scheduler.h"
+#include "config_command.h"
+#include "config_store.h"
+#include "keepalive_tuner.h"
+#include "tx_window.h"
+#include "wifi_config.h"
+#include "power_profiler.h"
+#include "wifi_powersave.h"
+#include "gpio_events.h"
 /******************************************************************************
 * Macros
 ******************************************************************************/
-/* Interrupt priority for User Button Input. */
-#define BTN1_INTERRUPT_PRIORITY         (7U)
-
 /* The maximum number of times each PUBLISH in this example will be retried. */
 #define PUBLISH_RETRY_LIMIT             (10U)
 
@@ -76,7 +84,74 @@
  */
 #define PUBLISHER_TASK_QUEUE_LENGTH     (3U)
 
-#define DEBOUNCE_TIME_MS                 (2U)
+/* Queue depth and end-to-end latency SLO (enqueue to publish completion) of
+ * the urgent lane.
+ */
+#define PUBLISHER_URGENT_QUEUE_LENGTH   (4U)
+#define PUBLISHER_URGENT_SLO_MS         (500U)
+
+/* Queue depth and latency SLO of the bulk lane. */
+#define PUBLISHER_BULK_QUEUE_LENGTH     (8U)
+
+/* Number of payload copy slots: one per entry of every lane. */
+#define PUBLISHER_COPY_SLOT_COUNT       (PUBLISHER_URGENT_QUEUE_LENGTH + PUBLISHER_BULK_QUEUE_LENGTH)
+#define PUBLISHER_BULK_SLO_MS           (10000U)
+
+/* Bulk messages are held until this many are queued or the next transmit
+ * window opens, then published back-to-back. Windows are spaced at least
+ * PUBLISHER_TX_WINDOW_INTERVAL_MS apart (see tx_window.c), and any urgent
+ * publish opens one, so that the radio wakes up once for all of them.
+ */
+#define PUBLISHER_BULK_BATCH_SIZE       (4U)
+#define PUBLISHER_TX_WINDOW_INTERVAL_MS (5000U)
+
+#if (PUBLISHER_TX_WINDOW_INTERVAL_MS >= PUBLISHER_BULK_SLO_MS)
+    #error "PUBLISHER_TX_WINDOW_INTERVAL_MS must be below the bulk lane latency SLO!"
+#endif
+
+/* Sampling period of the vital signs telemetry. */
+#define VITALS_SAMPLE_PERIOD_MS             (60000U)
+
+/* Interval at which the publish latency histograms are printed on the debug
+ * UART and published on MQTT_PUB_TOPIC_METRICS.
+ */
+#define PUBLISH_METRICS_REPORT_INTERVAL_MS  (60000U)
+
+/* Size of the buffer holding the metrics report payload; the power section
+ * lists the active time of every task.
+ */
+#define PUBLISH_METRICS_PAYLOAD_SIZE        (2048U)
+
+/* Largest value that fits in each additional byte of the MQTT "Remaining
+ * Length" variable byte integer.
+ */
+#define MQTT_REMAINING_LENGTH_1_BYTE_MAX    (127U)
+#define MQTT_REMAINING_LENGTH_2_BYTE_MAX    (16383U)
+#define MQTT_REMAINING_LENGTH_3_BYTE_MAX    (2097151U)
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/* Static configuration of a publish lane. */
+typedef struct
+{
+    const char *name;
+    const char *topic;
+    uint16_t topic_len;
+    cy_mqtt_qos_t qos;
+    UBaseType_t queue_length;
+    uint32_t latency_slo_ms;
+    uint32_t copy_slot_base;
+} publisher_lane_config_t;
+
+/* Runtime statistics of a publish lane. */
+typedef struct
+{
+    uint32_t published;
+    uint32_t dropped;
+    uint32_t slo_misses;
+    uint32_t max_latency_ms;
+} publisher_lane_stats_t;
 
 /******************************************************************************
 * Function Prototypes
@@ -88,12 +163,62 @@
 /* FreeRTOS task handle for this task. */
 TaskHandle_t publisher_task_handle;
 
-volatile bool button_debouncing = false;
-volatile uint32_t button_debounce_timestamp = 0;
-
 /* Handle of the queue holding the commands for the publisher task */
 QueueHandle_t publisher_task_q;
 
+/* Handles of the queues holding the messages of each publish lane */
+static QueueHandle_t publisher_lane_q[PUBLISHER_LANE_COUNT];
+
+static const publisher_lane_config_t publisher_lane_config[PUBLISHER_LANE_COUNT] =
+{
+    [PUBLISHER_LANE_URGENT] =
+    {
+        .name = "urgent",
+        .topic = MQTT_PUB_TOPIC_ALARM,
+        .topic_len = (sizeof(MQTT_PUB_TOPIC_ALARM) - 1),
+        .qos = CY_MQTT_QOS1,
+        .queue_length = PUBLISHER_URGENT_QUEUE_LENGTH,
+        .latency_slo_ms = PUBLISHER_URGENT_SLO_MS,
+        .copy_slot_base = 0U
+    },
+    [PUBLISHER_LANE_BULK] =
+    {
+        .name = "bulk",
+        .topic = MQTT_PUB_TOPIC,
+        .topic_len = (sizeof(MQTT_PUB_TOPIC) - 1),
+        .qos = (cy_mqtt_qos_t) MQTT_MESSAGES_QOS,
+        .queue_length = PUBLISHER_BULK_QUEUE_LENGTH,
+        .latency_slo_ms = PUBLISHER_BULK_SLO_MS,
+        .copy_slot_base = PUBLISHER_URGENT_QUEUE_LENGTH
+    }
+};
+
+static publisher_lane_stats_t publisher_lane_stats[PUBLISHER_LANE_COUNT];
+
+/* Publish rate budget shared by all lanes. */
+static rate_limiter_t publish_rate_limiter;
+
+/* Transmit windows shared by the bulk messages. */
+static tx_window_t publisher_tx_window;
+
+/* Set while bulk messages are held back because the rate budget is spent. */
+static volatile bool bulk_lane_throttled = false;
+
+/* Metrics report payload. It is reused only after the previous report has
+ * been published.
+ */
+static char metrics_payload[PUBLISH_METRICS_PAYLOAD_SIZE];
+static bool metrics_report_queued = false;
+static TickType_t metrics_report_tick;
+
+/* Payload copies of publisher_enqueue_copy(). A slot is in use from the
+ * enqueue until its message has been published. Each lane owns one slot per
+ * lane entry, starting at its copy_slot_base, so the slots of a lane run out
+ * only together with the lane.
+ */
+static char publisher_copy_slots[PUBLISHER_COPY_SLOT_COUNT][PUBLISHER_COPY_PAYLOAD_SIZE];
+static volatile bool publisher_copy_slot_used[PUBLISHER_COPY_SLOT_COUNT];
+
 /* Structure to store publish message information. */
 cy_mqtt_publish_info_t publish_info =
 {
@@ -104,138 +229,246 @@ cy_mqtt_publish_info_t publish_info =
     .dup = false
 };
 
-/* Interrupt config structure */
-cy_stc_sysint_t intrCfg =
-{
-    .intrSrc = CYBSP_USER_BTN_IRQ,
-    .intrPriority = BTN1_INTERRUPT_PRIORITY
-};
+/* Telemetry payload. Kept free of insignificant whitespace, as every byte is
+ * sent on the wire for each message.
+ */
+const char jsonPayLoad[] =
+"{"
+"\"heart_rate\":180,"
+"\"spo2\":99,"
+"\"temperature\":36.5,"
+"\"glucose\":95.3,"
+"\"systolic\":120,"
+"\"diastolic\":80,"
+"\"pulse_rate\":75,"
+"\"timestamp\":\"2026-01-13T31:45:00Z\""
+"}";
 
-const char jsonPayLoad[] = 
-"{\n"
-"  \"heart_rate\": 180,\n"
-"  \"spo2\": 99,\n"
-"  \"temperature\": 36.5,\n"
-"  \"glucose\": 95.3,\n"
-"  \"systolic\": 120,\n"
-"  \"diastolic\": 80,\n"
-"  \"pulse_rate\": 75,\n"
-"  \"timestamp\": \"2026-01-13T31:45:00Z\"\n"
-"}\n";
-
-
-/*******************************************************************************
-* Function Name: button_interrupt_handler
-********************************************************************************
-* Summary:
-*  GPIO interrupt handler.
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-*******************************************************************************/
-static void button_interrupt_handler(void)
+/* Alarm raised by a long press of the user button, published on the topic
+ * of the urgent lane.
+ */
+static const char button_alarm_payload[] = "{\"alarm\":\"button\",\"event\":\"long_press\"}";
+
+
+/******************************************************************************
+ * Function Name: mqtt_publish_wire_size
+ ******************************************************************************
+ * Summary:
+ *  Computes the size of the MQTT 3.1.1 PUBLISH packet that carries a
+ *  message: fixed header, remaining length, topic name, packet identifier
+ *  (QoS 1 and 2 only) and payload.
+ *
+ * Parameters:
+ *  cy_mqtt_qos_t qos : QoS of the message
+ *  size_t topic_len : Length of the topic name
+ *  size_t payload_len : Length of the payload
+ *
+ * Return:
+ *  size_t : Number of bytes the PUBLISH packet occupies on the wire
+ *
+ ******************************************************************************/
+static size_t mqtt_publish_wire_size(cy_mqtt_qos_t qos, size_t topic_len, size_t payload_len)
 {
-    //printf("int received\r\n");
-    if (Cy_GPIO_GetInterruptStatus(CYBSP_USER_BTN1_PORT, CYBSP_USER_BTN1_PIN))
-    {
-        Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN1_PORT, CYBSP_USER_BTN1_PIN);
-        NVIC_ClearPendingIRQ(CYBSP_USER_BTN1_IRQ);
+    size_t remaining_length = sizeof(uint16_t) + topic_len + payload_len;
+    size_t length_bytes;
 
-        if (!button_debouncing)
-        {
-            /* Set the debouncing flag */
-            button_debouncing = true;
+    if (CY_MQTT_QOS0 != qos)
+    {
+        /* Packet identifier */
+        remaining_length += sizeof(uint16_t);
+    }
 
-            /* Record the current timestamp */
-            button_debounce_timestamp = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
-        }
+    if (remaining_length <= MQTT_REMAINING_LENGTH_1_BYTE_MAX)
+    {
+        length_bytes = 1U;
+    }
+    else if (remaining_length <= MQTT_REMAINING_LENGTH_2_BYTE_MAX)
+    {
+        length_bytes = 2U;
+    }
+    else if (remaining_length <= MQTT_REMAINING_LENGTH_3_BYTE_MAX)
+    {
+        length_bytes = 3U;
+    }
+    else
+    {
+        length_bytes = 4U;
+    }
 
-        if (button_debouncing && (((xTaskGetTickCount() * portTICK_PERIOD_MS)) - button_debounce_timestamp >= DEBOUNCE_TIME_MS * portTICK_PERIOD_MS))
-        {
-            button_debouncing = false;
+    /* One byte of packet type and flags precedes the remaining length. */
+    return 1U + length_bytes + remaining_length;
+}
 
-            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-            publisher_data_t publisher_q_data;
+/******************************************************************************
+ * Function Name: publisher_count_drop
+ ******************************************************************************
+ * Summary:
+ *  Counts a message dropped on a lane. Producers drop messages from tasks
+ *  and from interrupts, so the count is updated with interrupts masked.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane the message was meant for
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_count_drop(publisher_lane_t lane)
+{
+    UBaseType_t interrupt_status = taskENTER_CRITICAL_FROM_ISR();
 
-            /* Assign the publish command to be sent to the publisher task. */
-            publisher_q_data.cmd = PUBLISH_MQTT_MSG;
+    publisher_lane_stats[lane].dropped++;
+    taskEXIT_CRITICAL_FROM_ISR(interrupt_status);
+}
 
-            /* Assign the publish message payload so that the device state toggles. */
-            if (current_device_state == DEVICE_ON_STATE)
-            {
-                publisher_q_data.data = (char *)MQTT_DEVICE_OFF_MESSAGE;
-            }
-            else
-            {
-                publisher_q_data.data = (char *)MQTT_DEVICE_ON_MESSAGE;
-            }
+/******************************************************************************
+ * Function Name: publisher_sample_vitals
+ ******************************************************************************
+ * Summary:
+ *  Sampling scheduler callback that queues a vital signs sample on the bulk
+ *  lane. The sample is dropped while the lane is over budget, and skipped
+ *  while the MQTT client is offline so that stale samples do not fill the
+ *  lane ahead of the reconnection.
+ *
+ * Parameters:
+ *  void *context : Unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_sample_vitals(void *context)
+{
+    CY_UNUSED_PARAMETER(context);
 
-            /* Send the command and data to publisher task over the queue */
-            xQueueSendFromISR(publisher_task_q, &publisher_q_data, &xHigherPriorityTaskWoken);
-            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-        }
+    if (!mqtt_client_is_connected())
+    {
+        return;
     }
 
-   /* CYBSP_USER_BTN1 (SW2) and CYBSP_USER_BTN2 (SW4) share the same port in
-    * the PSOC� Edge E84 evaluation kit and hence they share the same NVIC IRQ
-    * line. Since both the buttons are configured for falling edge interrupt in
-    * the BSP, pressing any button will trigger the execution of this ISR. Therefore,
-    * we must clear the interrupt flag of the user button (CYBSP_USER_BTN2) to avoid
-    * issues in case if user presses BTN2 by mistake.
-    */
-    #if defined(CYBSP_USER_BTN2_ENABLED)
-        Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN2_PORT, CYBSP_USER_BTN2_PIN);
-        NVIC_ClearPendingIRQ(CYBSP_USER_BTN2_IRQ);
-    #endif
+    if (!publisher_over_budget(PUBLISHER_LANE_BULK))
+    {
+        publisher_enqueue(PUBLISHER_LANE_BULK, (char *)jsonPayLoad);
+    }
+    else
+    {
+        publisher_count_drop(PUBLISHER_LANE_BULK);
+    }
 }
 
-/*******************************************************************************
-* Function Name: user_button_init
-********************************************************************************
-*
-* Summary:
-*  Initialize the button with Interrupt
-*
-* Parameters:
-*  None
-*
-* Return:
-*  None
-*
-*******************************************************************************/
-void user_button_init(void)
+static const sampling_sensor_t vitals_sensor =
 {
-    cy_en_sysint_status_t btn_interrupt_init_status ;
+    .name = "vitals",
+    .period_ms = VITALS_SAMPLE_PERIOD_MS,
+    .sample = publisher_sample_vitals,
+    .context = NULL
+};
 
-    /* CYBSP_USER_BTN1 (SW2) and CYBSP_USER_BTN2 (SW4) share the same port and
-    * hence they share the same NVIC IRQ line. Since both are configured in the BSP
-    * via the Device Configurator, the interrupt flags for both the buttons are set
-    * right after they get initialized through the call to cybsp_init(). The flags
-    * must be cleared otherwise the interrupt line will be constantly asserted.
-    */
-    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN1_PORT,CYBSP_USER_BTN1_PIN);
-    NVIC_ClearPendingIRQ(CYBSP_USER_BTN1_IRQ);
-    #if defined(CYBSP_USER_BTN2_ENABLED)
-        Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN2_PORT,CYBSP_USER_BTN2_PIN);
-        NVIC_ClearPendingIRQ(CYBSP_USER_BTN2_IRQ);
-    #endif
+/******************************************************************************
+ * Function Name: publisher_button_event
+ ******************************************************************************
+ * Summary:
+ *  Handler of the user button events, called by the GPIO event engine in the
+ *  timer service task. A long press raises an alarm on the urgent lane.
+ *  Every short press, including each press of a multi-press, queues a
+ *  telemetry sample on the bulk lane. For telemetry the button is a best-
+ *  effort producer: while the lane is over budget the sample is dropped.
+ *
+ * Parameters:
+ *  const gpio_event_t *event : Debounced button event
+ *  void *context : Unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_button_event(const gpio_event_t *event, void *context)
+{
+    CY_UNUSED_PARAMETER(context);
 
-    /* Initialize the interrupt and register interrupt callback */
-    btn_interrupt_init_status = Cy_SysInt_Init(&intrCfg, &button_interrupt_handler);
+    if (GPIO_EVENT_LONG_PRESS == event->type)
+    {
+        (void) publisher_enqueue(PUBLISHER_LANE_URGENT, (char *)button_alarm_payload);
+        return;
+    }
 
-    /* Button interrupt initialization failed. Stop program execution. */
-    if(CY_SYSINT_SUCCESS != btn_interrupt_init_status)
+    for (uint32_t i = 0U; i < event->count; i++)
     {
-        handle_app_error();
+        if (!publisher_over_budget(PUBLISHER_LANE_BULK))
+        {
+            (void) publisher_enqueue(PUBLISHER_LANE_BULK, (char *)jsonPayLoad);
+        }
+        else
+        {
+            publisher_count_drop(PUBLISHER_LANE_BULK);
+        }
     }
+}
 
-    /* Enable the interrupt in the NVIC */
-    NVIC_EnableIRQ(intrCfg.intrSrc);
+/******************************************************************************
+ * Function Name: publisher_buttons_init
+ ******************************************************************************
+ * Summary:
+ *  Registers the user buttons with the GPIO event engine on the first call
+ *  and enables their interrupts.
+ *
+ *  CYBSP_USER_BTN1 (SW2) and CYBSP_USER_BTN2 (SW4) share the same port and
+ *  hence the same NVIC IRQ line, and both are configured for interrupts by
+ *  the BSP. BTN2 is registered without a handler, so that its interrupt flag
+ *  is cleared when it fires rather than on every interrupt of the port.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_buttons_init(void)
+{
+    static bool buttons_registered = false;
+    const gpio_event_input_t button1 =
+    {
+        .name = "BTN1",
+        .port = CYBSP_USER_BTN1_PORT,
+        .pin = CYBSP_USER_BTN1_PIN,
+        .irq = CYBSP_USER_BTN1_IRQ,
+        .active_low = true,
+        .handler = publisher_button_event,
+        .context = NULL
+    };
+#if defined(CYBSP_USER_BTN2_ENABLED)
+    const gpio_event_input_t button2 =
+    {
+        .name = "BTN2",
+        .port = CYBSP_USER_BTN2_PORT,
+        .pin = CYBSP_USER_BTN2_PIN,
+        .irq = CYBSP_USER_BTN2_IRQ,
+        .active_low = true,
+        .handler = NULL,
+        .context = NULL
+    };
+#endif /* CYBSP_USER_BTN2_ENABLED */
+
+    if (!buttons_registered)
+    {
+        /* Button initialization failed. Stop program execution. */
+        if (gpio_events_register(&button1) < 0)
+        {
+            handle_app_error();
+        }
+#if defined(CYBSP_USER_BTN2_ENABLED)
+        if (gpio_events_register(&button2) < 0)
+        {
+            handle_app_error();
+        }
+#endif /* CYBSP_USER_BTN2_ENABLED */
+        buttons_registered = true;
+    }
+
+    gpio_events_enable(true);
 }
+
 /******************************************************************************
  * Function Name: publisher_init
  ******************************************************************************
@@ -253,10 +486,12 @@ void user_button_init(void)
 static void publisher_init(void)
 {
     /* Initialize the user button GPIO */
-    user_button_init();
+    publisher_buttons_init();
 
-    printf("\nPress the USER BTN1 to publish \"%s\"/\"%s\" on the topic '%s'...\n",
-           MQTT_DEVICE_ON_MESSAGE, MQTT_DEVICE_OFF_MESSAGE, publish_info.topic);
+    printf("\nPress the USER BTN1 to publish telemetry on the topic '%s'...\n",
+           publisher_lane_config[PUBLISHER_LANE_BULK].topic);
+    printf("Hold the USER BTN1 to raise an alarm on the topic '%s'...\n",
+           publisher_lane_config[PUBLISHER_LANE_URGENT].topic);
 }
 
 /******************************************************************************
@@ -274,7 +509,631 @@ static void publisher_init(void)
  ******************************************************************************/
 static void publisher_deinit(void)
 {
-    NVIC_DisableIRQ(intrCfg.intrSrc);
+    gpio_events_enable(false);
+}
+
+/******************************************************************************
+ * Function Name: publisher_register_sensors
+ ******************************************************************************
+ * Summary:
+ *  Registers the periodic telemetry sources of the publisher with the
+ *  sampling scheduler and applies the sampling period of the configuration
+ *  store. Must be called before the scheduler task is started.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publisher_register_sensors(void)
+{
+    if (!sampling_scheduler_register(&vitals_sensor))
+    {
+        printf("Publisher: Failed to register sensor '%s'!\n", vitals_sensor.name);
+        return;
+    }
+
+    (void) sampling_scheduler_set_period(vitals_sensor.name,
+                                         config_store_get_uint(CONFIG_KEY_SAMPLE_PERIOD,
+                                                               VITALS_SAMPLE_PERIOD_MS));
+}
+
+/******************************************************************************
+ * Function Name: publisher_send_command
+ ******************************************************************************
+ * Summary:
+ *  Sends a control command (init/deinit) to the publisher task and wakes it
+ *  up.
+ *
+ * Parameters:
+ *  publisher_cmd_t cmd : Command to be sent
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publisher_send_command(publisher_cmd_t cmd)
+{
+    publisher_data_t publisher_q_data =
+    {
+        .cmd = cmd,
+        .data = NULL,
+        .topic = NULL,
+        .enqueue_tick = xTaskGetTickCount()
+    };
+
+    xQueueSend(publisher_task_q, &publisher_q_data, portMAX_DELAY);
+    xTaskNotifyGive(publisher_task_handle);
+}
+
+/******************************************************************************
+ * Function Name: publisher_enqueue_on_topic
+ ******************************************************************************
+ * Summary:
+ *  Queues a message for publishing on the given lane without blocking. The
+ *  enqueue time is recorded for the end-to-end latency measurement.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane on which the message is published
+ *  const char *topic : Topic of the message, NULL for the topic of the lane;
+ *                      must stay valid until published
+ *  char *data : NUL-terminated payload; must stay valid until published
+ *
+ * Return:
+ *  BaseType_t : pdPASS if the message was queued, pdFAIL if the lane is full
+ *
+ ******************************************************************************/
+BaseType_t publisher_enqueue_on_topic(publisher_lane_t lane, const char *topic, char *data)
+{
+    BaseType_t result;
+    publisher_data_t publisher_q_data =
+    {
+        .cmd = PUBLISH_MQTT_MSG,
+        .data = data,
+        .topic = topic,
+        .enqueue_tick = xTaskGetTickCount()
+    };
+
+    result = xQueueSend(publisher_lane_q[lane], &publisher_q_data, 0);
+    if (pdPASS == result)
+    {
+        xTaskNotifyGive(publisher_task_handle);
+    }
+    else
+    {
+        publisher_count_drop(lane);
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: publisher_enqueue
+ ******************************************************************************
+ * Summary:
+ *  Queues a message for publishing on the topic of the given lane. See
+ *  publisher_enqueue_on_topic().
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane on which the message is published
+ *  char *data : NUL-terminated payload; must stay valid until published
+ *
+ * Return:
+ *  BaseType_t : pdPASS if the message was queued, pdFAIL if the lane is full
+ *
+ ******************************************************************************/
+BaseType_t publisher_enqueue(publisher_lane_t lane, char *data)
+{
+    return publisher_enqueue_on_topic(lane, NULL, data);
+}
+
+/******************************************************************************
+ * Function Name: publisher_enqueue_copy
+ ******************************************************************************
+ * Summary:
+ *  Queues a copy of a short message, for payloads formatted into a buffer
+ *  the caller reuses. The copy is held in a slot of its own until it has
+ *  been published.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane on which the message is published
+ *  const char *topic : Topic of the message, NULL for the topic of the lane;
+ *                      must stay valid until published
+ *  const char *data : NUL-terminated payload of less than
+ *                     PUBLISHER_COPY_PAYLOAD_SIZE bytes
+ *
+ * Return:
+ *  BaseType_t : pdPASS if the message was queued, pdFAIL if the payload is
+ *               too long or no slot or lane entry is free
+ *
+ ******************************************************************************/
+BaseType_t publisher_enqueue_copy(publisher_lane_t lane, const char *topic, const char *data)
+{
+    const publisher_lane_config_t *config = &publisher_lane_config[lane];
+    size_t length = strlen(data);
+    uint32_t slot = PUBLISHER_COPY_SLOT_COUNT;
+
+    if (length >= PUBLISHER_COPY_PAYLOAD_SIZE)
+    {
+        publisher_count_drop(lane);
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = config->copy_slot_base; i < (config->copy_slot_base + config->queue_length); i++)
+    {
+        if (!publisher_copy_slot_used[i])
+        {
+            publisher_copy_slot_used[i] = true;
+            slot = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (PUBLISHER_COPY_SLOT_COUNT == slot)
+    {
+        publisher_count_drop(lane);
+        return pdFAIL;
+    }
+
+    memcpy(publisher_copy_slots[slot], data, length + 1U);
+    if (pdPASS != publisher_enqueue_on_topic(lane, topic, publisher_copy_slots[slot]))
+    {
+        publisher_copy_slot_used[slot] = false;
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+
+/******************************************************************************
+ * Function Name: publisher_enqueue_from_isr
+ ******************************************************************************
+ * Summary:
+ *  Interrupt-safe variant of publisher_enqueue().
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane on which the message is published
+ *  char *data : NUL-terminated payload; must stay valid until published
+ *  BaseType_t *higher_priority_task_woken : Set to pdTRUE if a context switch
+ *                                           is required on ISR exit
+ *
+ * Return:
+ *  BaseType_t : pdPASS if the message was queued, pdFAIL if the lane is full
+ *
+ ******************************************************************************/
+BaseType_t publisher_enqueue_from_isr(publisher_lane_t lane, char *data,
+                                      BaseType_t *higher_priority_task_woken)
+{
+    BaseType_t result;
+    publisher_data_t publisher_q_data =
+    {
+        .cmd = PUBLISH_MQTT_MSG,
+        .data = data,
+        .topic = NULL,
+        .enqueue_tick = xTaskGetTickCountFromISR()
+    };
+
+    result = xQueueSendFromISR(publisher_lane_q[lane], &publisher_q_data,
+                               higher_priority_task_woken);
+    if (pdPASS == result)
+    {
+        vTaskNotifyGiveFromISR(publisher_task_handle, higher_priority_task_woken);
+    }
+    else
+    {
+        publisher_count_drop(lane);
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: publisher_over_budget
+ ******************************************************************************
+ * Summary:
+ *  Tells producers whether a lane is currently backed up, either because the
+ *  publish rate budget is spent or because its queue is full. Producers can
+ *  then batch or drop samples according to their own policy instead of
+ *  blocking. Safe to call from an ISR.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane to be checked
+ *
+ * Return:
+ *  bool : true if new messages on this lane will be delayed or rejected
+ *
+ ******************************************************************************/
+bool publisher_over_budget(publisher_lane_t lane)
+{
+    if (NULL == publisher_lane_q[lane])
+    {
+        return true;
+    }
+
+    if (0U == (publisher_lane_config[lane].queue_length -
+               uxQueueMessagesWaitingFromISR(publisher_lane_q[lane])))
+    {
+        return true;
+    }
+
+    /* Urgent messages are never rate limited. */
+    return (PUBLISHER_LANE_BULK == lane) && bulk_lane_throttled;
+}
+
+/******************************************************************************
+ * Function Name: publisher_message_size
+ ******************************************************************************
+ * Summary:
+ *  Returns the on-the-wire size of a queued message on the given lane.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane the message belongs to
+ *  const publisher_data_t *msg : Queued message
+ *
+ * Return:
+ *  size_t : Size of the PUBLISH packet in bytes
+ *
+ ******************************************************************************/
+static size_t publisher_message_size(publisher_lane_t lane, const publisher_data_t *msg)
+{
+    size_t topic_len = (NULL != msg->topic) ? strlen(msg->topic) : publisher_lane_config[lane].topic_len;
+
+    return mqtt_publish_wire_size(publisher_lane_config[lane].qos, topic_len, strlen(msg->data));
+}
+
+/******************************************************************************
+ * Function Name: publisher_release_payload
+ ******************************************************************************
+ * Summary:
+ *  Frees the buffer of a message that has been published or dropped: the
+ *  slot of a payload queued by publisher_enqueue_copy() or the metrics
+ *  report payload. Other payloads are left alone.
+ *
+ * Parameters:
+ *  const char *data : Payload of a message that is no longer queued
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_release_payload(const char *data)
+{
+    if (data == metrics_payload)
+    {
+        metrics_report_queued = false;
+        return;
+    }
+
+    for (uint32_t i = 0U; i < PUBLISHER_COPY_SLOT_COUNT; i++)
+    {
+        if (data == publisher_copy_slots[i])
+        {
+            publisher_copy_slot_used[i] = false;
+            return;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: publisher_publish
+ ******************************************************************************
+ * Summary:
+ *  Publishes one message on the topic of the given lane and updates the
+ *  latency statistics of that lane. A publish failure is reported to the
+ *  MQTT client task. If the client went offline after the message was taken
+ *  off its lane, the message is put back in front of the lane.
+ *
+ * Parameters:
+ *  publisher_lane_t lane : Lane the message was taken from
+ *  const publisher_data_t *msg : Message to be published
+ *
+ * Return:
+ *  bool : false if the client is offline and the message was not sent
+ *
+ ******************************************************************************/
+static bool publisher_publish(publisher_lane_t lane, const publisher_data_t *msg)
+{
+    const publisher_lane_config_t *config = &publisher_lane_config[lane];
+    publisher_lane_stats_t *stats = &publisher_lane_stats[lane];
+    mqtt_task_cmd_t mqtt_task_cmd;
+    TickType_t handoff_tick;
+    uint32_t queue_ms;
+    uint32_t ack_ms;
+    uint32_t latency_ms;
+    cy_rslt_t result;
+
+    if (NULL != msg->topic)
+    {
+        publish_info.topic = msg->topic;
+        publish_info.topic_len = (uint16_t)strlen(msg->topic);
+    }
+    else
+    {
+        publish_info.topic = config->topic;
+        publish_info.topic_len = config->topic_len;
+    }
+    publish_info.qos = config->qos;
+    publish_info.payload = msg->data;
+    publish_info.payload_len = strlen(msg->data);
+
+    if (tesaiot_debug_level >= TESAIOT_DEBUG_LEVEL_INFO)
+    {
+        printf("\nPublisher: Publishing '%s' on the topic '%s'\n",
+               (char *) publish_info.payload, publish_info.topic);
+    }
+
+    handoff_tick = xTaskGetTickCount();
+    if (!mqtt_client_publish(&publish_info, &result))
+    {
+        /* Held until the MQTT instance is connected again; dropped only if
+         * producers have filled the lane in the meantime.
+         */
+        if (pdPASS != xQueueSendToFront(publisher_lane_q[lane], msg, 0))
+        {
+            publisher_count_drop(lane);
+            publisher_release_payload(msg->data);
+        }
+        return false;
+    }
+
+    /* The radio is awake now; bulk messages may share the wake-up. */
+    tx_window_anchor(&publisher_tx_window, (uint32_t)(handoff_tick * portTICK_PERIOD_MS));
+
+    publisher_release_payload(msg->data);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("  Publisher: MQTT Publish failed with error 0x%0X.\n\n", (int)result);
+
+        /* Communicate the publish failure with the the MQTT client task.
+         * The publisher must not block on its short queue: if it is full,
+         * the MQTT task already has a disconnection or failure to handle.
+         */
+        mqtt_task_cmd = HANDLE_MQTT_PUBLISH_FAILURE;
+        (void) xQueueSend(mqtt_task_q, &mqtt_task_cmd, 0);
+        return true;
+    }
+
+    /* For QoS 1 cy_mqtt_publish() returns once the PUBACK is received, so
+     * this is the full enqueue-to-acknowledge latency.
+     */
+    queue_ms = (uint32_t)((handoff_tick - msg->enqueue_tick) * portTICK_PERIOD_MS);
+    ack_ms = (uint32_t)((xTaskGetTickCount() - handoff_tick) * portTICK_PERIOD_MS);
+    latency_ms = queue_ms + ack_ms;
+
+    publish_metrics_record(publish_info.topic, queue_ms, ack_ms);
+    if (CY_MQTT_QOS0 != publish_info.qos)
+    {
+        keepalive_tuner_record_puback(ack_ms);
+    }
+
+    stats->published++;
+    power_profiler_count_message();
+    if (latency_ms > stats->max_latency_ms)
+    {
+        stats->max_latency_ms = latency_ms;
+    }
+    if (latency_ms > config->latency_slo_ms)
+    {
+        stats->slo_misses++;
+    }
+
+    if (tesaiot_debug_level >= TESAIOT_DEBUG_LEVEL_INFO)
+    {
+        printf("Publisher: [%s] latency %lu ms (max %lu ms, SLO %lu ms missed %lu/%lu, dropped %lu)\n",
+               config->name, (unsigned long)latency_ms,
+               (unsigned long)stats->max_latency_ms, (unsigned long)config->latency_slo_ms,
+               (unsigned long)stats->slo_misses, (unsigned long)stats->published,
+               (unsigned long)stats->dropped);
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: publisher_drain_urgent
+ ******************************************************************************
+ * Summary:
+ *  Publishes every message waiting on the urgent lane while the MQTT client
+ *  is connected.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_drain_urgent(void)
+{
+    publisher_data_t msg;
+
+    while (mqtt_client_is_connected() &&
+           (pdTRUE == xQueueReceive(publisher_lane_q[PUBLISHER_LANE_URGENT], &msg, 0)))
+    {
+        rate_limiter_force_acquire(&publish_rate_limiter,
+                                   publisher_message_size(PUBLISHER_LANE_URGENT, &msg));
+        if (!publisher_publish(PUBLISHER_LANE_URGENT, &msg))
+        {
+            break;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: publisher_bulk_wait_ticks
+ ******************************************************************************
+ * Summary:
+ *  Determines how long the bulk lane may keep collecting messages before its
+ *  batch must be published: until the batch is full or the next transmit
+ *  window opens. Once the batch is due, the wait is extended until the rate
+ *  budget allows the oldest message to go out.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  TickType_t : 0 if the batch can be published now, portMAX_DELAY if the
+ *               bulk lane is empty or the MQTT client is offline, else the
+ *               ticks to wait
+ *
+ ******************************************************************************/
+static TickType_t publisher_bulk_wait_ticks(void)
+{
+    QueueHandle_t bulk_q = publisher_lane_q[PUBLISHER_LANE_BULK];
+    publisher_data_t oldest;
+    uint32_t window_wait_ms;
+    TickType_t budget_wait;
+
+    /* The batch is held while offline; PUBLISHER_INIT wakes the task up. */
+    if (!mqtt_client_is_connected())
+    {
+        return portMAX_DELAY;
+    }
+
+    if (pdTRUE != xQueuePeek(bulk_q, &oldest, 0))
+    {
+        bulk_lane_throttled = false;
+        return portMAX_DELAY;
+    }
+
+    window_wait_ms = tx_window_wait_ms(&publisher_tx_window,
+                                       (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+    if ((uxQueueMessagesWaiting(bulk_q) >= PUBLISHER_BULK_BATCH_SIZE) || (0U == window_wait_ms))
+    {
+        budget_wait = rate_limiter_wait_ticks(&publish_rate_limiter,
+                                              publisher_message_size(PUBLISHER_LANE_BULK, &oldest));
+        if ((0U != budget_wait) && !bulk_lane_throttled)
+        {
+            bulk_lane_throttled = true;
+            printf("Publisher: [bulk] over rate budget, deferring %lu ms "
+                   "(allowed %lu, forced %lu, throttled %lu)\n",
+                   (unsigned long)(budget_wait * portTICK_PERIOD_MS),
+                   (unsigned long)publish_rate_limiter.allowed,
+                   (unsigned long)publish_rate_limiter.forced,
+                   (unsigned long)publish_rate_limiter.throttled);
+        }
+        return budget_wait;
+    }
+
+    return pdMS_TO_TICKS(window_wait_ms);
+}
+
+/******************************************************************************
+ * Function Name: publisher_flush_bulk
+ ******************************************************************************
+ * Summary:
+ *  Publishes the queued bulk batch back-to-back, as far as the rate budget
+ *  allows. The urgent lane is checked before every bulk message so that an
+ *  alarm never waits for more than the message in progress.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_flush_bulk(void)
+{
+    publisher_data_t msg;
+
+    /* A larger backlog is worth keeping the radio awake for. */
+    wifi_powersave_report_backlog((uint32_t)(uxQueueMessagesWaiting(publisher_lane_q[PUBLISHER_LANE_BULK]) +
+                                             uxQueueMessagesWaiting(publisher_lane_q[PUBLISHER_LANE_URGENT])));
+
+    publisher_drain_urgent();
+    while (mqtt_client_is_connected() &&
+           (pdTRUE == xQueuePeek(publisher_lane_q[PUBLISHER_LANE_BULK], &msg, 0)))
+    {
+        /* Stop at the first message the rate budget cannot afford; the task
+         * resumes the batch once enough tokens have accumulated.
+         */
+        if (!rate_limiter_try_acquire(&publish_rate_limiter,
+                                      publisher_message_size(PUBLISHER_LANE_BULK, &msg)))
+        {
+            break;
+        }
+
+        bulk_lane_throttled = false;
+        xQueueReceive(publisher_lane_q[PUBLISHER_LANE_BULK], &msg, 0);
+        if (!publisher_publish(PUBLISHER_LANE_BULK, &msg))
+        {
+            break;
+        }
+        publisher_drain_urgent();
+    }
+}
+
+/******************************************************************************
+ * Function Name: publisher_report_wait_ticks
+ ******************************************************************************
+ * Summary:
+ *  Determines the time left until the next metrics report is due.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  TickType_t : Ticks until the next report, 0 if it is due now
+ *
+ ******************************************************************************/
+static TickType_t publisher_report_wait_ticks(void)
+{
+    TickType_t elapsed = xTaskGetTickCount() - metrics_report_tick;
+
+    if (elapsed >= pdMS_TO_TICKS(PUBLISH_METRICS_REPORT_INTERVAL_MS))
+    {
+        return 0U;
+    }
+
+    return pdMS_TO_TICKS(PUBLISH_METRICS_REPORT_INTERVAL_MS) - elapsed;
+}
+
+/******************************************************************************
+ * Function Name: publisher_report_metrics
+ ******************************************************************************
+ * Summary:
+ *  Prints the publish latency histograms on the debug UART and queues them
+ *  on the metrics topic via the bulk lane, so that the report is subject to
+ *  the same batching and rate budget as the telemetry. While the MQTT client
+ *  is offline the report is only printed.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publisher_report_metrics(void)
+{
+    metrics_report_tick = xTaskGetTickCount();
+
+    publish_metrics_print();
+
+    /* Skip this report if the previous one has not been published yet. */
+    if (metrics_report_queued || !mqtt_client_is_connected())
+    {
+        return;
+    }
+
+    if (0U == publish_metrics_format_json(metrics_payload, sizeof(metrics_payload)))
+    {
+        printf("Publisher: Metrics report does not fit in %u bytes!\n",
+               (unsigned int)sizeof(metrics_payload));
+        return;
+    }
+
+    if (pdPASS == publisher_enqueue_on_topic(PUBLISHER_LANE_BULK, MQTT_PUB_TOPIC_METRICS,
+                                             metrics_payload))
+    {
+        metrics_report_queued = true;
+    }
 }
 
 /******************************************************************************
@@ -282,9 +1141,10 @@ static void publisher_deinit(void)
  ******************************************************************************
  * Summary:
  *  Task that sets up the user button GPIO for the publisher and publishes
- *  MQTT messages to the broker. The user button init and deinit operations,
- *  and the MQTT publish operation is performed based on commands sent by other
- *  tasks and callbacks over a message queue.
+ *  MQTT messages to the broker. The user button init and deinit operations
+ *  are performed based on commands sent by other tasks over a message queue.
+ *  Messages are taken from the urgent lane as soon as they arrive, while the
+ *  bulk lane is published in batches.
  *
  * Parameters:
  *  void *pvParameters : Task parameter defined during task creation (unused)
@@ -295,27 +1155,56 @@ static void publisher_deinit(void)
  ******************************************************************************/
 void publisher_task(void *pvParameters)
 {
-    /* Status variable */
-    cy_rslt_t result;
-
     publisher_data_t publisher_q_data;
-
-    /* Command to the MQTT client task */
-    mqtt_task_cmd_t mqtt_task_cmd;
+    TickType_t wait_ticks;
+    TickType_t report_wait_ticks;
 
     /* To avoid compiler warnings */
     CY_UNUSED_PARAMETER(pvParameters);
 
+    /* Create the message queues before the button interrupt can post to them. */
+    publisher_task_q = xQueueCreate(PUBLISHER_TASK_QUEUE_LENGTH, sizeof(publisher_data_t));
+    for (uint32_t lane = 0; lane < PUBLISHER_LANE_COUNT; lane++)
+    {
+        publisher_lane_q[lane] = xQueueCreate(publisher_lane_config[lane].queue_length,
+                                              sizeof(publisher_data_t));
+    }
+
+    rate_limiter_init(&publish_rate_limiter,
+                      MQTT_PUBLISH_RATE_MSGS_PER_SEC, MQTT_PUBLISH_BURST_MSGS,
+                      MQTT_PUBLISH_RATE_BYTES_PER_SEC, MQTT_PUBLISH_BURST_BYTES);
+    tx_window_init(&publisher_tx_window, WIFI_AP_BEACON_INTERVAL_TU, WIFI_AP_DTIM_PERIOD,
+                   PUBLISHER_TX_WINDOW_INTERVAL_MS, WIFI_PM2_RETURN_TO_SLEEP_MS,
+                   (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+
     /* Initialize and set-up the user button GPIO. */
     publisher_init();
 
-    /* Create a message queue to communicate with other tasks and callbacks. */
-    publisher_task_q = xQueueCreate(PUBLISHER_TASK_QUEUE_LENGTH, sizeof(publisher_data_t));
+    metrics_report_tick = xTaskGetTickCount();
 
     while (true)
     {
-        /* Wait for commands from other tasks and callbacks. */
-        if (pdTRUE == xQueueReceive(publisher_task_q, &publisher_q_data, portMAX_DELAY))
+        /* Sleep until a command or message arrives, the bulk batch is due
+         * or a metrics report is due.
+         */
+        wait_ticks = publisher_bulk_wait_ticks();
+        report_wait_ticks = publisher_report_wait_ticks();
+        if (report_wait_ticks < wait_ticks)
+        {
+            wait_ticks = report_wait_ticks;
+        }
+        if (0U != wait_ticks)
+        {
+            ulTaskNotifyTake(pdTRUE, wait_ticks);
+        }
+
+        if (0U == publisher_report_wait_ticks())
+        {
+            publisher_report_metrics();
+        }
+
+        /* Handle commands from other tasks. */
+        while (pdTRUE == xQueueReceive(publisher_task_q, &publisher_q_data, 0))
         {
             switch(publisher_q_data.cmd)
             {
@@ -335,33 +1224,24 @@ void publisher_task(void *pvParameters)
 
                 case PUBLISH_MQTT_MSG:
                 {
-                    /* Publish the data received over the message queue. */
-                    publish_info.payload = jsonPayLoad; //publisher_q_data.data;
-                    publish_info.payload_len = strlen(jsonPayLoad);//strlen(publish_info.payload);
-
-                    printf("\nPublisher: Publishing '%s' on the topic '%s'\n",
-                           (char *) publish_info.payload, publish_info.topic);
-
-                    result = cy_mqtt_publish(mqtt_connection, &publish_info);
-
-                    if (result != CY_RSLT_SUCCESS)
-                    {
-                        printf("  Publisher: MQTT Publish failed with error 0x%0X.\n\n", (int)result);
-
-                        /* Communicate the publish failure with the the MQTT
-                         * client task.
-                         */
-                        mqtt_task_cmd = HANDLE_MQTT_PUBLISH_FAILURE;
-                        xQueueSend(mqtt_task_q, &mqtt_task_cmd, portMAX_DELAY);
-                    }
-
+                    /* Messages are expected on the lanes; publish any that
+                     * arrive here as bulk telemetry.
+                     */
+                    (void) publisher_publish(PUBLISHER_LANE_BULK, &publisher_q_data);
                     break;
                 }
             }
         }
+
+        /* Alarms first, then the bulk batch once it is full or a transmit
+         * window is open.
+         */
+        publisher_drain_urgent();
+        if (0U == publisher_bulk_wait_ticks())
+        {
+            publisher_flush_bulk();
+        }
     }
 }
 
-
-
 /* [] END OF FILE */
@@ -53,6 +53,11 @@
 #define PUBLISHER_TASK_PRIORITY               (2U)
 #define PUBLISHER_TASK_STACK_SIZE             (1024U *2U)
 
+/* Largest payload, including the terminating NUL, that
+ * publisher_enqueue_copy() can hold.
+ */
+#define PUBLISHER_COPY_PAYLOAD_SIZE           (160U)
+
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
@@ -64,10 +69,22 @@ typedef enum
     PUBLISH_MQTT_MSG
 } publisher_cmd_t;
 
+/* Publish lanes. The urgent lane (alarms) is always drained before the bulk
+ * lane (periodic telemetry), which is published in batches.
+ */
+typedef enum
+{
+    PUBLISHER_LANE_URGENT,
+    PUBLISHER_LANE_BULK,
+    PUBLISHER_LANE_COUNT
+} publisher_lane_t;
+
 /* Struct to be passed via the publisher task queue */
 typedef struct{
     publisher_cmd_t cmd;
     char *data;
+    const char *topic;          /* NULL to publish on the topic of the lane */
+    TickType_t enqueue_tick;
 } publisher_data_t;
 
 /*******************************************************************************
@@ -80,6 +97,14 @@ extern QueueHandle_t publisher_task_q;
 * Function Prototypes
 ********************************************************************************/
 void publisher_task(void *pvParameters);
+void publisher_register_sensors(void);
+void publisher_send_command(publisher_cmd_t cmd);
+BaseType_t publisher_enqueue(publisher_lane_t lane, char *data);
+BaseType_t publisher_enqueue_on_topic(publisher_lane_t lane, const char *topic, char *data);
+BaseType_t publisher_enqueue_copy(publisher_lane_t lane, const char *topic, const char *data);
+BaseType_t publisher_enqueue_from_isr(publisher_lane_t lane, char *data,
+                                      BaseType_t *higher_priority_task_woken);
+bool publisher_over_budget(publisher_lane_t lane);
 
 #endif /* PUBLISHER_TASK_H_ */
 
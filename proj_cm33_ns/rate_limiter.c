@@ -0,0 +1,324 @@
+/******************************************************************************
+* File Name:   rate_limiter.c
+*
+* Description: This file contains a token bucket rate limiter that bounds the
+*              number of messages and bytes published per second.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "rate_limiter.h"
+#include "task.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Token amounts are kept in thousandths of a token. */
+#define MILLI_TOKENS_PER_TOKEN          (1000U)
+
+#define MS_PER_SEC                      (1000U)
+
+/******************************************************************************
+ * Function Name: token_bucket_init
+ ******************************************************************************
+ * Summary:
+ *  Initializes a token bucket as full.
+ *
+ * Parameters:
+ *  token_bucket_t *bucket : Bucket to be initialized
+ *  uint32_t rate_per_sec : Refill rate in tokens per second
+ *  uint32_t burst : Bucket capacity in tokens
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void token_bucket_init(token_bucket_t *bucket, uint32_t rate_per_sec, uint32_t burst)
+{
+    bucket->rate_per_sec = rate_per_sec;
+    bucket->burst = burst;
+    bucket->milli_tokens = (int32_t)(burst * MILLI_TOKENS_PER_TOKEN);
+}
+
+/******************************************************************************
+ * Function Name: token_bucket_refill
+ ******************************************************************************
+ * Summary:
+ *  Adds the tokens accumulated over the elapsed time, capped at the bucket
+ *  capacity. At 'rate_per_sec' tokens per second, one millisecond is worth
+ *  'rate_per_sec' milli-tokens.
+ *
+ * Parameters:
+ *  token_bucket_t *bucket : Bucket to be refilled
+ *  uint32_t elapsed_ms : Time elapsed since the previous refill
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void token_bucket_refill(token_bucket_t *bucket, uint32_t elapsed_ms)
+{
+    int64_t level = (int64_t)bucket->milli_tokens +
+                    ((int64_t)elapsed_ms * bucket->rate_per_sec);
+    int64_t capacity = (int64_t)bucket->burst * MILLI_TOKENS_PER_TOKEN;
+
+    bucket->milli_tokens = (int32_t)((level > capacity) ? capacity : level);
+}
+
+/******************************************************************************
+ * Function Name: token_bucket_wait_ms
+ ******************************************************************************
+ * Summary:
+ *  Computes the time until the bucket holds the requested number of tokens.
+ *  A request larger than the capacity only waits for a full bucket, so that
+ *  it can never be blocked forever.
+ *
+ * Parameters:
+ *  const token_bucket_t *bucket : Bucket to be checked
+ *  uint32_t tokens : Number of tokens requested
+ *
+ * Return:
+ *  uint32_t : Wait time in milliseconds, 0 if the tokens are available
+ *
+ ******************************************************************************/
+static uint32_t token_bucket_wait_ms(const token_bucket_t *bucket, uint32_t tokens)
+{
+    int64_t needed;
+
+    if (0U == bucket->rate_per_sec)
+    {
+        /* A zero rate disables this bucket. */
+        return 0U;
+    }
+
+    if (tokens > bucket->burst)
+    {
+        tokens = bucket->burst;
+    }
+
+    needed = ((int64_t)tokens * MILLI_TOKENS_PER_TOKEN) - bucket->milli_tokens;
+    if (needed <= 0)
+    {
+        return 0U;
+    }
+
+    /* Round up so that the tokens are available when the wait ends. */
+    return (uint32_t)((needed + bucket->rate_per_sec - 1) / bucket->rate_per_sec);
+}
+
+/******************************************************************************
+ * Function Name: token_bucket_force_take
+ ******************************************************************************
+ * Summary:
+ *  Takes tokens regardless of the level. The debt is limited to one full
+ *  bucket, so that rate-limited messages resume at most two bucket refill
+ *  times after forced traffic stops, however long it lasted.
+ *
+ * Parameters:
+ *  token_bucket_t *bucket : Bucket
+ *  uint32_t tokens : Number of tokens taken
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void token_bucket_force_take(token_bucket_t *bucket, uint32_t tokens)
+{
+    int64_t floor = -((int64_t)bucket->burst * MILLI_TOKENS_PER_TOKEN);
+    int64_t level = (int64_t)bucket->milli_tokens - ((int64_t)tokens * MILLI_TOKENS_PER_TOKEN);
+
+    if (0U == bucket->rate_per_sec)
+    {
+        return;
+    }
+
+    bucket->milli_tokens = (int32_t)((level < floor) ? floor : level);
+}
+
+/******************************************************************************
+ * Function Name: rate_limiter_refill
+ ******************************************************************************
+ * Summary:
+ *  Refills both buckets for the time elapsed since the previous call.
+ *
+ * Parameters:
+ *  rate_limiter_t *limiter : Rate limiter to be refilled
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void rate_limiter_refill(rate_limiter_t *limiter)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t elapsed_ms = (uint32_t)((now - limiter->last_refill_tick) * portTICK_PERIOD_MS);
+
+    if (0U != elapsed_ms)
+    {
+        token_bucket_refill(&limiter->msgs, elapsed_ms);
+        token_bucket_refill(&limiter->bytes, elapsed_ms);
+        limiter->last_refill_tick = now;
+    }
+}
+
+/******************************************************************************
+ * Function Name: rate_limiter_init
+ ******************************************************************************
+ * Summary:
+ *  Initializes the rate limiter with both buckets full. A rate of 0 disables
+ *  the corresponding bucket.
+ *
+ * Parameters:
+ *  rate_limiter_t *limiter : Rate limiter to be initialized
+ *  uint32_t msgs_per_sec : Sustained message rate
+ *  uint32_t msg_burst : Number of messages that may be sent back-to-back
+ *  uint32_t bytes_per_sec : Sustained byte rate
+ *  uint32_t byte_burst : Number of bytes that may be sent back-to-back
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void rate_limiter_init(rate_limiter_t *limiter,
+                       uint32_t msgs_per_sec, uint32_t msg_burst,
+                       uint32_t bytes_per_sec, uint32_t byte_burst)
+{
+    token_bucket_init(&limiter->msgs, msgs_per_sec, msg_burst);
+    token_bucket_init(&limiter->bytes, bytes_per_sec, byte_burst);
+    limiter->last_refill_tick = xTaskGetTickCount();
+    limiter->allowed = 0U;
+    limiter->forced = 0U;
+    limiter->throttled = 0U;
+}
+
+/******************************************************************************
+ * Function Name: rate_limiter_try_acquire
+ ******************************************************************************
+ * Summary:
+ *  Takes the tokens for one message of the given size if both buckets can
+ *  afford it.
+ *
+ * Parameters:
+ *  rate_limiter_t *limiter : Rate limiter
+ *  size_t bytes : Size of the message
+ *
+ * Return:
+ *  bool : true if the message may be sent now, false if it is over budget
+ *
+ ******************************************************************************/
+bool rate_limiter_try_acquire(rate_limiter_t *limiter, size_t bytes)
+{
+    if (0U != rate_limiter_wait_ticks(limiter, bytes))
+    {
+        limiter->throttled++;
+        return false;
+    }
+
+    if (0U != limiter->msgs.rate_per_sec)
+    {
+        limiter->msgs.milli_tokens -= (int32_t)MILLI_TOKENS_PER_TOKEN;
+    }
+    if (0U != limiter->bytes.rate_per_sec)
+    {
+        limiter->bytes.milli_tokens -= (int32_t)(bytes * MILLI_TOKENS_PER_TOKEN);
+    }
+    limiter->allowed++;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: rate_limiter_force_acquire
+ ******************************************************************************
+ * Summary:
+ *  Takes the tokens for one message regardless of the budget. Used for
+ *  messages that must not be delayed; the buckets go into debt, which delays
+ *  subsequent rate-limited messages instead.
+ *
+ * Parameters:
+ *  rate_limiter_t *limiter : Rate limiter
+ *  size_t bytes : Size of the message
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void rate_limiter_force_acquire(rate_limiter_t *limiter, size_t bytes)
+{
+    rate_limiter_refill(limiter);
+
+    token_bucket_force_take(&limiter->msgs, 1U);
+    token_bucket_force_take(&limiter->bytes, (uint32_t)bytes);
+    limiter->forced++;
+}
+
+/******************************************************************************
+ * Function Name: rate_limiter_wait_ticks
+ ******************************************************************************
+ * Summary:
+ *  Computes how long a message of the given size has to wait until both
+ *  buckets can afford it.
+ *
+ * Parameters:
+ *  rate_limiter_t *limiter : Rate limiter
+ *  size_t bytes : Size of the message
+ *
+ * Return:
+ *  TickType_t : Wait time in ticks, 0 if the message may be sent now
+ *
+ ******************************************************************************/
+TickType_t rate_limiter_wait_ticks(rate_limiter_t *limiter, size_t bytes)
+{
+    uint32_t msgs_wait_ms;
+    uint32_t bytes_wait_ms;
+    uint32_t wait_ms;
+
+    rate_limiter_refill(limiter);
+
+    msgs_wait_ms = token_bucket_wait_ms(&limiter->msgs, 1U);
+    bytes_wait_ms = token_bucket_wait_ms(&limiter->bytes, (uint32_t)bytes);
+    wait_ms = (msgs_wait_ms > bytes_wait_ms) ? msgs_wait_ms : bytes_wait_ms;
+
+    if (0U == wait_ms)
+    {
+        return 0U;
+    }
+
+    /* Never return 0 for a pending wait, even below one tick. */
+    return (pdMS_TO_TICKS(wait_ms) > 0U) ? pdMS_TO_TICKS(wait_ms) : 1U;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name:   rate_limiter.h
+*
+* Description: This file is the public interface of rate_limiter.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RATE_LIMITER_H_
+#define RATE_LIMITER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Single token bucket. Tokens are kept in thousandths so that refill at low
+ * rates does not lose precision. The level may go negative when tokens are
+ * forcibly taken; the debt is then paid back by later refills.
+ */
+typedef struct
+{
+    uint32_t rate_per_sec;
+    uint32_t burst;
+    int32_t milli_tokens;
+} token_bucket_t;
+
+/* Rate limiter bounding both the message rate and the byte rate. */
+typedef struct
+{
+    token_bucket_t msgs;
+    token_bucket_t bytes;
+    TickType_t last_refill_tick;
+    uint32_t allowed;
+    uint32_t forced;
+    uint32_t throttled;
+} rate_limiter_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void rate_limiter_init(rate_limiter_t *limiter,
+                       uint32_t msgs_per_sec, uint32_t msg_burst,
+                       uint32_t bytes_per_sec, uint32_t byte_burst);
+bool rate_limiter_try_acquire(rate_limiter_t *limiter, size_t bytes);
+void rate_limiter_force_acquire(rate_limiter_t *limiter, size_t bytes);
+TickType_t rate_limiter_wait_ticks(rate_limiter_t *limiter, size_t bytes);
+
+#endif /* RATE_LIMITER_H_ */
+
+/* [] END OF FILE */
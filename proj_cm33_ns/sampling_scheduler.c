@@ -0,0 +1,365 @@
+/******************************************************************************
+* File Name:   sampling_scheduler.c
+*
+* Description: This file contains the deadline-driven sampling scheduler.
+*              Sensors are sampled on fixed periods using absolute deadlines
+*              (vTaskDelayUntil), with the deadlines of all sensors aligned
+*              so that they share wake-ups. Sampling jitter and missed
+*              deadlines are recorded per sensor and reported on the metrics
+*              topic.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sampling_scheduler.h"
+#include "publish_metrics.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* All periods are rounded up to a multiple of this value and all deadlines
+ * share the same epoch, so sensors with related periods fall due at the same
+ * instant and are sampled in one wake-up.
+ */
+#define SAMPLING_ALIGNMENT_MS               (1000U)
+
+/* A sensor that falls due within this time after a wake-up is sampled early
+ * in that wake-up instead of waking the device again.
+ */
+#define SAMPLING_COALESCE_MS                (50U)
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/* Scheduling state and statistics of a registered sensor. */
+typedef struct
+{
+    const sampling_sensor_t *sensor;
+    TickType_t period_ticks;
+    TickType_t next_deadline;
+    uint32_t samples;
+    uint32_t missed_deadlines;
+    uint32_t max_jitter_ms;
+    uint32_t total_jitter_ms;
+} sampling_entry_t;
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* FreeRTOS task handle for this task. */
+TaskHandle_t sampling_scheduler_task_handle;
+
+static sampling_entry_t sampling_entries[SAMPLING_MAX_SENSORS];
+static uint32_t sampling_entry_count = 0U;
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_register
+ ******************************************************************************
+ * Summary:
+ *  Adds a periodic sensor. Sensors must be registered before the scheduler
+ *  task is started.
+ *
+ * Parameters:
+ *  const sampling_sensor_t *sensor : Sensor description; must stay valid
+ *
+ * Return:
+ *  bool : true if the sensor was added, false if the table is full or the
+ *         period is 0
+ *
+ ******************************************************************************/
+bool sampling_scheduler_register(const sampling_sensor_t *sensor)
+{
+    uint32_t period_ms;
+
+    if ((SAMPLING_MAX_SENSORS <= sampling_entry_count) || (0U == sensor->period_ms))
+    {
+        return false;
+    }
+
+    /* Round the period up to the alignment grid. */
+    period_ms = ((sensor->period_ms + SAMPLING_ALIGNMENT_MS - 1U) / SAMPLING_ALIGNMENT_MS) *
+                SAMPLING_ALIGNMENT_MS;
+
+    sampling_entries[sampling_entry_count].sensor = sensor;
+    sampling_entries[sampling_entry_count].period_ticks = pdMS_TO_TICKS(period_ms);
+    sampling_entry_count++;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_set_period
+ ******************************************************************************
+ * Summary:
+ *  Changes the sampling period of a registered sensor at runtime. The new
+ *  period, rounded up like at registration, takes effect after the next
+ *  deadline of the sensor.
+ *
+ * Parameters:
+ *  const char *name : Name of the sensor
+ *  uint32_t period_ms : New sampling period
+ *
+ * Return:
+ *  bool : true if the period was changed, false if the sensor is unknown or
+ *         the period is 0
+ *
+ ******************************************************************************/
+bool sampling_scheduler_set_period(const char *name, uint32_t period_ms)
+{
+    if (0U == period_ms)
+    {
+        return false;
+    }
+
+    period_ms = ((period_ms + SAMPLING_ALIGNMENT_MS - 1U) / SAMPLING_ALIGNMENT_MS) *
+                SAMPLING_ALIGNMENT_MS;
+
+    for (uint32_t i = 0U; i < sampling_entry_count; i++)
+    {
+        if (0 == strcmp(sampling_entries[i].sensor->name, name))
+        {
+            sampling_entries[i].period_ticks = pdMS_TO_TICKS(period_ms);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_next_deadline
+ ******************************************************************************
+ * Summary:
+ *  Finds the earliest deadline of all registered sensors.
+ *
+ * Parameters:
+ *  TickType_t now : Current tick count, used as reference for wrap-around
+ *
+ * Return:
+ *  TickType_t : Earliest deadline
+ *
+ ******************************************************************************/
+static TickType_t sampling_scheduler_next_deadline(TickType_t now)
+{
+    TickType_t earliest = sampling_entries[0].next_deadline;
+
+    for (uint32_t i = 1U; i < sampling_entry_count; i++)
+    {
+        if ((TickType_t)(sampling_entries[i].next_deadline - now) < (TickType_t)(earliest - now))
+        {
+            earliest = sampling_entries[i].next_deadline;
+        }
+    }
+
+    return earliest;
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_run_due
+ ******************************************************************************
+ * Summary:
+ *  Samples every sensor that is due, or falls due within the coalescing
+ *  window, and advances its deadline by whole periods. Lateness is recorded
+ *  as jitter; periods that passed entirely are counted as missed deadlines.
+ *
+ * Parameters:
+ *  TickType_t now : Current tick count
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sampling_scheduler_run_due(TickType_t now)
+{
+    sampling_entry_t *entry;
+    TickType_t late_ticks;
+    uint32_t jitter_ms;
+    uint32_t missed;
+
+    for (uint32_t i = 0U; i < sampling_entry_count; i++)
+    {
+        entry = &sampling_entries[i];
+
+        /* Signed distance to the deadline; positive when it lies ahead. */
+        if ((int32_t)(entry->next_deadline - now) > (int32_t)pdMS_TO_TICKS(SAMPLING_COALESCE_MS))
+        {
+            continue;
+        }
+
+        late_ticks = ((int32_t)(now - entry->next_deadline) > 0) ? (now - entry->next_deadline) : 0U;
+        missed = late_ticks / entry->period_ticks;
+        jitter_ms = (uint32_t)((late_ticks % entry->period_ticks) * portTICK_PERIOD_MS);
+
+        entry->sensor->sample(entry->sensor->context);
+
+        entry->samples++;
+        entry->missed_deadlines += missed;
+        entry->total_jitter_ms += jitter_ms;
+        if (jitter_ms > entry->max_jitter_ms)
+        {
+            entry->max_jitter_ms = jitter_ms;
+        }
+
+        /* Keep the phase: skip the missed periods rather than drifting. */
+        entry->next_deadline += (missed + 1U) * entry->period_ticks;
+    }
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_format_json
+ ******************************************************************************
+ * Summary:
+ *  Formats the jitter statistics of every sensor for the metrics report.
+ *
+ * Parameters:
+ *  char *buffer : Output buffer
+ *  size_t buffer_len : Size of the output buffer
+ *  size_t *used : Number of characters already in the buffer; updated
+ *
+ * Return:
+ *  bool : true if the section fit into the buffer, else false
+ *
+ ******************************************************************************/
+static bool sampling_scheduler_format_json(char *buffer, size_t buffer_len, size_t *used)
+{
+    const sampling_entry_t *entry;
+    bool fits = publish_metrics_append(buffer, buffer_len, used, "[");
+
+    for (uint32_t i = 0U; fits && (i < sampling_entry_count); i++)
+    {
+        entry = &sampling_entries[i];
+        fits = publish_metrics_append(buffer, buffer_len, used,
+                                      "%s{\"name\":\"%s\",\"n\":%lu,\"missed\":%lu,\"jit_avg\":%lu,\"jit_max\":%lu}",
+                                      (0U == i) ? "" : ",", entry->sensor->name,
+                                      (unsigned long)entry->samples,
+                                      (unsigned long)entry->missed_deadlines,
+                                      (unsigned long)((0U == entry->samples) ? 0U : (entry->total_jitter_ms / entry->samples)),
+                                      (unsigned long)entry->max_jitter_ms);
+    }
+
+    return fits && publish_metrics_append(buffer, buffer_len, used, "]");
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_print
+ ******************************************************************************
+ * Summary:
+ *  Prints the jitter statistics of every sensor on the debug UART.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sampling_scheduler_print(void)
+{
+    const sampling_entry_t *entry;
+
+    printf("Sampling jitter (ms)          count missed    avg    max\n");
+    for (uint32_t i = 0U; i < sampling_entry_count; i++)
+    {
+        entry = &sampling_entries[i];
+        printf("  %-26s %7lu %6lu %6lu %6lu\n", entry->sensor->name,
+               (unsigned long)entry->samples,
+               (unsigned long)entry->missed_deadlines,
+               (unsigned long)((0U == entry->samples) ? 0U : (entry->total_jitter_ms / entry->samples)),
+               (unsigned long)entry->max_jitter_ms);
+    }
+}
+
+/******************************************************************************
+ * Function Name: sampling_scheduler_task
+ ******************************************************************************
+ * Summary:
+ *  Task that samples the registered sensors at their deadlines. The task
+ *  sleeps with vTaskDelayUntil() until the earliest deadline, so the sampling
+ *  instants do not drift with the execution time of the callbacks.
+ *
+ * Parameters:
+ *  void *pvParameters : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sampling_scheduler_task(void *pvParameters)
+{
+    TickType_t last_wake;
+    TickType_t next_deadline;
+
+    /* To avoid compiler warnings */
+    CY_UNUSED_PARAMETER(pvParameters);
+
+    if (0U == sampling_entry_count)
+    {
+        printf("\nSampling scheduler: No sensors registered.\n");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    publish_metrics_register_section("sampling", sampling_scheduler_format_json,
+                                     sampling_scheduler_print);
+
+    /* Common epoch: the first deadline of every sensor is one period after
+     * the scheduler start.
+     */
+    last_wake = xTaskGetTickCount();
+    for (uint32_t i = 0U; i < sampling_entry_count; i++)
+    {
+        sampling_entries[i].next_deadline = last_wake + sampling_entries[i].period_ticks;
+        printf("\nSampling scheduler: '%s' every %lu ms\n", sampling_entries[i].sensor->name,
+               (unsigned long)(sampling_entries[i].period_ticks * portTICK_PERIOD_MS));
+    }
+
+    while (true)
+    {
+        next_deadline = sampling_scheduler_next_deadline(last_wake);
+
+        /* Returns immediately if the deadline has already passed. */
+        vTaskDelayUntil(&last_wake, next_deadline - last_wake);
+
+        sampling_scheduler_run_due(xTaskGetTickCount());
+    }
+}
+
+/* [] END OF FILE */
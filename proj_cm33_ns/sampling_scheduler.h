@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   sampling_scheduler.h
+*
+* Description: This file is the public interface of sampling_scheduler.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLING_SCHEDULER_H_
+#define SAMPLING_SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Task parameters for the Sampling Scheduler Task. Runs above the publisher
+ * so that sampling deadlines are not delayed by a blocking publish.
+ */
+#define SAMPLING_SCHEDULER_TASK_PRIORITY    (3U)
+#define SAMPLING_SCHEDULER_TASK_STACK_SIZE  (1024U)
+
+/* Maximum number of periodic sensors. */
+#define SAMPLING_MAX_SENSORS                (4U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Called at every deadline of a sensor, in the context of the scheduler task.
+ * Must not block; results are handed over with publisher_enqueue().
+ */
+typedef void (*sampling_callback_t)(void *context);
+
+/* Periodic sensor description. */
+typedef struct
+{
+    const char *name;
+    uint32_t period_ms;
+    sampling_callback_t sample;
+    void *context;
+} sampling_sensor_t;
+
+/*******************************************************************************
+* Extern Variables
+********************************************************************************/
+extern TaskHandle_t sampling_scheduler_task_handle;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+bool sampling_scheduler_register(const sampling_sensor_t *sensor);
+bool sampling_scheduler_set_period(const char *name, uint32_t period_ms);
+void sampling_scheduler_task(void *pvParameters);
+
+#endif /* SAMPLING_SCHEDULER_H_ */
+
+/* [] END OF FILE */
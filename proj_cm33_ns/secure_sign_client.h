@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name:   secure_sign_client.h
+*
+* Description: This file is the public interface of secure_sign_client.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SECURE_SIGN_CLIENT_H_
+#define SECURE_SIGN_CLIENT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "secure_sign.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the PEM stand-in of the MQTT client key, including its NUL: a
+ * 121-byte SEC1 key in three base64 lines between the EC PRIVATE KEY lines.
+ */
+#define SECURE_SIGN_CLIENT_KEY_PEM_SIZE     (228U)
+
+/*******************************************************************************
+* Extern Variables
+********************************************************************************/
+/* PEM stand-in of the MQTT client key, written by secure_sign_client_init().
+ * It holds the public key of the secure key and a dummy private scalar; the
+ * TLS layer loads it in place of CLIENT_PRIVATE_KEY.
+ */
+extern char secure_sign_client_key_pem[SECURE_SIGN_CLIENT_KEY_PEM_SIZE];
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+bool secure_sign_client_init(void);
+uint32_t secure_sign_client_sign(const uint8_t *hash, uint8_t *signature, size_t size, size_t *length);
+uint32_t secure_sign_client_sign_batch(secure_sign_request_t *requests, uint32_t count);
+
+#endif /* SECURE_SIGN_CLIENT_H_ */
+
+/* [] END OF FILE */
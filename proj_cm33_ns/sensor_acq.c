@@ -0,0 +1,809 @@
+/******************************************************************************
+* File Name:   sensor_acq.c
+*
+* Description: This file contains the sensor acquisition layer. A DMA channel
+*              streams sensor frames from the SPI controller into a pool of
+*              block buffers, three by default; finished blocks are
+*              handed to the consumer task by pointer and summarised into
+*              telemetry. The DMA never writes to a block the consumer
+*              holds: when it falls behind, the oldest ready block is
+*              dropped instead.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "publisher_task.h"
+#include "sampling_scheduler.h"
+
+#include "sensor_acq.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#if (SENSOR_ACQ_BLOCK_COUNT < 2U)
+    #error "SENSOR_ACQ_BLOCK_COUNT must be at least two!"
+#endif
+
+/* The producer is the DMA interrupt; the consumer masks it while it moves
+ * a block between the lists.
+ */
+#define SENSOR_ACQ_LOCK()                   taskENTER_CRITICAL()
+#define SENSOR_ACQ_UNLOCK()                 taskEXIT_CRITICAL()
+
+/* A burst is started every block period: SENSOR_ACQ_FRAMES_PER_BLOCK frames
+ * at the 1 kHz output data rate of the sensor.
+ */
+#define SENSOR_ACQ_BLOCK_PERIOD_MS          (20U)
+
+/* Burst read of the FIFO data register of the sensor. The sensor ignores
+ * MOSI after the command, so the command byte is repeated to clock out the
+ * block.
+ */
+#define SENSOR_ACQ_SPI_FIFO_DATA_REGISTER   (0x26U)
+#define SENSOR_ACQ_SPI_READ_COMMAND         (0x80U | SENSOR_ACQ_SPI_FIFO_DATA_REGISTER)
+
+/* A DataWire descriptor moves at most 256 elements. */
+#define SENSOR_ACQ_DMA_MAX_COUNT            (256U)
+
+#if (SENSOR_ACQ_BUFFER_SIZE > SENSOR_ACQ_DMA_MAX_COUNT)
+    #error "SENSOR_ACQ_FRAMES_PER_BLOCK is too large for a single DMA descriptor!"
+#endif
+
+/* Priority of the DMA completion interrupt. */
+#define SENSOR_ACQ_DMA_INTERRUPT_PRIORITY   (7U)
+
+/* Period of the telemetry summary of the sensor. */
+#define SENSOR_ACQ_REPORT_PERIOD_MS         (10000U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* A block is free while the producer may fill it, ready once complete and
+ * lent while the consumer works on it.
+ */
+typedef enum
+{
+    SENSOR_ACQ_BLOCK_FREE,
+    SENSOR_ACQ_BLOCK_READY,
+    SENSOR_ACQ_BLOCK_LENT
+} sensor_acq_block_state_t;
+
+static uint8_t block_buffers[SENSOR_ACQ_BLOCK_COUNT][SENSOR_ACQ_BUFFER_SIZE];
+static sensor_acq_block_t blocks[SENSOR_ACQ_BLOCK_COUNT];
+static volatile sensor_acq_block_state_t block_states[SENSOR_ACQ_BLOCK_COUNT];
+
+/* Ready blocks in completion order. */
+static uint8_t ready_fifo[SENSOR_ACQ_BLOCK_COUNT];
+static volatile uint32_t ready_head;
+static volatile uint32_t ready_count;
+
+/* Buffer being filled by the producer. */
+static volatile uint32_t fill_index;
+
+static sensor_acq_stats_t acq_stats;
+
+TaskHandle_t sensor_acq_task_handle;
+
+/* Per-axis summary of the frames consumed since the last report. */
+typedef struct
+{
+    uint32_t frames;
+    int32_t min[SENSOR_ACQ_FRAME_AXES];
+    int32_t max[SENSOR_ACQ_FRAME_AXES];
+    int64_t sum[SENSOR_ACQ_FRAME_AXES];
+} sensor_acq_summary_t;
+
+static sensor_acq_summary_t acq_summary;
+
+/* Must stay valid until published; reused every report period. */
+static char report_payload[320];
+
+/******************************************************************************
+ * Function Name: sensor_acq_reset
+ ******************************************************************************
+ * Summary:
+ *  Frees all blocks, clears the statistics and makes buffer 0 the one the
+ *  producer fills first. Call while the producer is stopped.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sensor_acq_reset(void)
+{
+    for (uint32_t i = 0U; i < SENSOR_ACQ_BLOCK_COUNT; i++)
+    {
+        blocks[i].data = &block_buffers[i][SENSOR_ACQ_BLOCK_HEADER_SIZE];
+        blocks[i].size = SENSOR_ACQ_BLOCK_SIZE;
+        blocks[i].sequence = 0U;
+        blocks[i].time_ms = 0U;
+        block_states[i] = SENSOR_ACQ_BLOCK_FREE;
+    }
+
+    ready_head = 0U;
+    ready_count = 0U;
+    fill_index = 0U;
+    memset(&acq_stats, 0, sizeof(acq_stats));
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_buffer
+ ******************************************************************************
+ * Summary:
+ *  Returns a buffer of the pool, e.g. to point a DMA descriptor at it. The
+ *  buffer starts with SENSOR_ACQ_BLOCK_HEADER_SIZE bytes ahead of the block.
+ *
+ * Parameters:
+ *  uint32_t index : Buffer index, below SENSOR_ACQ_BLOCK_COUNT
+ *
+ * Return:
+ *  uint8_t * : SENSOR_ACQ_BUFFER_SIZE bytes
+ *
+ ******************************************************************************/
+uint8_t *sensor_acq_buffer(uint32_t index)
+{
+    return block_buffers[index % SENSOR_ACQ_BLOCK_COUNT];
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_block_done
+ ******************************************************************************
+ * Summary:
+ *  Called by the producer, e.g. the DMA interrupt, when the buffer being
+ *  filled is complete. The block is queued for the consumer and a free
+ *  buffer becomes the one being filled; the producer never waits for the
+ *  consumer. Without a free buffer, the oldest ready block is dropped as an
+ *  overrun and its buffer refilled. The block lent to the consumer is never
+ *  written to.
+ *
+ * Parameters:
+ *  uint32_t time_ms : Completion time
+ *
+ * Return:
+ *  uint8_t * : Buffer to fill next, see sensor_acq_buffer()
+ *
+ ******************************************************************************/
+uint8_t *sensor_acq_block_done(uint32_t time_ms)
+{
+    uint32_t index = fill_index;
+    uint32_t next;
+
+    blocks[index].sequence = acq_stats.produced;
+    blocks[index].time_ms = time_ms;
+    block_states[index] = SENSOR_ACQ_BLOCK_READY;
+    ready_fifo[(ready_head + ready_count) % SENSOR_ACQ_BLOCK_COUNT] = (uint8_t)index;
+    ready_count++;
+    acq_stats.produced++;
+
+    next = 0U;
+    while ((next < SENSOR_ACQ_BLOCK_COUNT) && (SENSOR_ACQ_BLOCK_FREE != block_states[next]))
+    {
+        next++;
+    }
+
+    if (SENSOR_ACQ_BLOCK_COUNT == next)
+    {
+        /* The consumer is behind: the oldest ready block is lost. With two
+         * buffers and one lent, that is the block just completed.
+         */
+        next = ready_fifo[ready_head];
+        ready_head = (ready_head + 1U) % SENSOR_ACQ_BLOCK_COUNT;
+        ready_count--;
+        block_states[next] = SENSOR_ACQ_BLOCK_FREE;
+        acq_stats.overruns++;
+    }
+
+    fill_index = next;
+
+    return block_buffers[next];
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_take
+ ******************************************************************************
+ * Summary:
+ *  Lends the oldest ready block to the consumer. The data is read in place
+ *  and the block must be returned with sensor_acq_release(). Called by a
+ *  single consumer, never from an ISR.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  const sensor_acq_block_t * : Block, NULL if none is ready
+ *
+ ******************************************************************************/
+const sensor_acq_block_t *sensor_acq_take(void)
+{
+    const sensor_acq_block_t *block = NULL;
+    uint32_t index;
+
+    SENSOR_ACQ_LOCK();
+    if (0U != ready_count)
+    {
+        index = ready_fifo[ready_head];
+        ready_head = (ready_head + 1U) % SENSOR_ACQ_BLOCK_COUNT;
+        ready_count--;
+        block_states[index] = SENSOR_ACQ_BLOCK_LENT;
+        block = &blocks[index];
+    }
+    SENSOR_ACQ_UNLOCK();
+
+    return block;
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_release
+ ******************************************************************************
+ * Summary:
+ *  Returns a block lent by sensor_acq_take() to the producer.
+ *
+ * Parameters:
+ *  const sensor_acq_block_t *block : Block to release
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sensor_acq_release(const sensor_acq_block_t *block)
+{
+    uint32_t index = (uint32_t)(block - blocks);
+
+    SENSOR_ACQ_LOCK();
+    acq_stats.delivered++;
+    block_states[index] = SENSOR_ACQ_BLOCK_FREE;
+    SENSOR_ACQ_UNLOCK();
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_get_stats
+ ******************************************************************************
+ * Summary:
+ *  Copies the block statistics since sensor_acq_reset().
+ *
+ * Parameters:
+ *  sensor_acq_stats_t *stats : Destination
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sensor_acq_get_stats(sensor_acq_stats_t *stats)
+{
+    SENSOR_ACQ_LOCK();
+    *stats = acq_stats;
+    SENSOR_ACQ_UNLOCK();
+}
+
+#if defined(CYBSP_DMA_RX_SPI_CONTROLLER_ENABLED)
+/******************************************************************************
+* SPI DMA stream
+******************************************************************************/
+static cy_stc_scb_spi_context_t spi_context;
+static TimerHandle_t burst_timer;
+
+/* One descriptor per buffer. Each disables the RX channel once its block
+ * is complete; the interrupt re-arms it on the buffer to fill next.
+ */
+static CY_ALIGN(8) cy_stc_dma_descriptor_t rx_descriptors[SENSOR_ACQ_BLOCK_COUNT];
+static uint8_t spi_read_command;
+
+/******************************************************************************
+ * Function Name: sensor_acq_dma_isr
+ ******************************************************************************
+ * Summary:
+ *  Completion interrupt of the RX DMA channel. The finished block is
+ *  queued, the channel re-armed on the buffer to fill next and the consumer
+ *  task woken. The next burst starts a block period later, long after the
+ *  channel is armed.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_dma_isr(void)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint8_t *next;
+
+    Cy_DMA_Channel_ClearInterrupt(CYBSP_DMA_RX_SPI_CONTROLLER_HW, CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL);
+
+    next = sensor_acq_block_done((uint32_t)(xTaskGetTickCountFromISR() * portTICK_PERIOD_MS));
+    Cy_DMA_Channel_SetDescriptor(CYBSP_DMA_RX_SPI_CONTROLLER_HW, CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL,
+                                 &rx_descriptors[(uint32_t)(next - block_buffers[0]) / SENSOR_ACQ_BUFFER_SIZE]);
+    Cy_DMA_Channel_Enable(CYBSP_DMA_RX_SPI_CONTROLLER_HW, CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL);
+
+    vTaskNotifyGiveFromISR(sensor_acq_task_handle, &higher_priority_task_woken);
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_burst_timer_callback
+ ******************************************************************************
+ * Summary:
+ *  Starts the burst read of one block. The TX channel disables itself once
+ *  the command and the clocking bytes are in the TX FIFO.
+ *
+ * Parameters:
+ *  TimerHandle_t xTimer : Unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_burst_timer_callback(TimerHandle_t xTimer)
+{
+    CY_UNUSED_PARAMETER(xTimer);
+
+    Cy_DMA_Channel_SetDescriptor(CYBSP_DMA_TX_SPI_CONTROLLER_HW, CYBSP_DMA_TX_SPI_CONTROLLER_CHANNEL,
+                                 &CYBSP_DMA_TX_SPI_CONTROLLER_Descriptor_0);
+    Cy_DMA_Channel_Enable(CYBSP_DMA_TX_SPI_CONTROLLER_HW, CYBSP_DMA_TX_SPI_CONTROLLER_CHANNEL);
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_spi_init
+ ******************************************************************************
+ * Summary:
+ *  Sets up the SPI controller and both DMA channels of the stream. The TX
+ *  channel of the BSP sends the read command and clocks out a block, the RX
+ *  channel writes every received byte straight into a block buffer.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+static bool sensor_acq_spi_init(void)
+{
+    cy_stc_scb_spi_config_t spi_config = CYBSP_SPI_CONTROLLER_config;
+    cy_stc_dma_descriptor_config_t tx_config = CYBSP_DMA_TX_SPI_CONTROLLER_Descriptor_0_config;
+    cy_stc_dma_descriptor_config_t rx_config = CYBSP_DMA_RX_SPI_CONTROLLER_Descriptor_0_config;
+    cy_stc_dma_channel_config_t channel_config;
+    cy_stc_sysint_t intr_cfg =
+    {
+        .intrSrc = CYBSP_DMA_RX_SPI_CONTROLLER_IRQ,
+        .intrPriority = SENSOR_ACQ_DMA_INTERRUPT_PRIORITY
+    };
+
+    /* A DMA request for every received byte. */
+    spi_config.rxFifoTriggerLevel = 0UL;
+    if (CY_SCB_SPI_SUCCESS != Cy_SCB_SPI_Init(CYBSP_SPI_CONTROLLER_HW, &spi_config, &spi_context))
+    {
+        return false;
+    }
+    Cy_SCB_SPI_SetActiveSlaveSelect(CYBSP_SPI_CONTROLLER_HW, CY_SCB_SPI_SLAVE_SELECT0);
+    Cy_SCB_SPI_Enable(CYBSP_SPI_CONTROLLER_HW);
+
+    spi_read_command = SENSOR_ACQ_SPI_READ_COMMAND;
+    tx_config.srcAddress = &spi_read_command;
+    tx_config.srcXincrement = 0;
+    tx_config.dstAddress = (void *)&CYBSP_SPI_CONTROLLER_HW->TX_FIFO_WR;
+    tx_config.dstXincrement = 0;
+    tx_config.xCount = SENSOR_ACQ_BUFFER_SIZE;
+    tx_config.channelState = CY_DMA_CHANNEL_DISABLED;
+    if (CY_DMA_SUCCESS != Cy_DMA_Descriptor_Init(&CYBSP_DMA_TX_SPI_CONTROLLER_Descriptor_0, &tx_config))
+    {
+        return false;
+    }
+
+    rx_config.interruptType = CY_DMA_DESCR;
+    rx_config.channelState = CY_DMA_CHANNEL_DISABLED;
+    rx_config.dataSize = CY_DMA_BYTE;
+    rx_config.srcTransferSize = CY_DMA_TRANSFER_SIZE_WORD;
+    rx_config.dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA;
+    rx_config.descriptorType = CY_DMA_1D_TRANSFER;
+    rx_config.srcAddress = (void *)&CYBSP_SPI_CONTROLLER_HW->RX_FIFO_RD;
+    rx_config.srcXincrement = 0;
+    rx_config.dstXincrement = 1;
+    rx_config.xCount = SENSOR_ACQ_BUFFER_SIZE;
+    for (uint32_t i = 0U; i < SENSOR_ACQ_BLOCK_COUNT; i++)
+    {
+        rx_config.dstAddress = sensor_acq_buffer(i);
+        rx_config.nextDescriptor = NULL;
+        if (CY_DMA_SUCCESS != Cy_DMA_Descriptor_Init(&rx_descriptors[i], &rx_config))
+        {
+            return false;
+        }
+    }
+
+    channel_config = CYBSP_DMA_TX_SPI_CONTROLLER_channelConfig;
+    if (CY_DMA_SUCCESS != Cy_DMA_Channel_Init(CYBSP_DMA_TX_SPI_CONTROLLER_HW,
+                                              CYBSP_DMA_TX_SPI_CONTROLLER_CHANNEL, &channel_config))
+    {
+        return false;
+    }
+
+    channel_config = CYBSP_DMA_RX_SPI_CONTROLLER_channelConfig;
+    channel_config.descriptor = &rx_descriptors[0];
+    if (CY_DMA_SUCCESS != Cy_DMA_Channel_Init(CYBSP_DMA_RX_SPI_CONTROLLER_HW,
+                                              CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL, &channel_config))
+    {
+        return false;
+    }
+    Cy_DMA_Channel_SetInterruptMask(CYBSP_DMA_RX_SPI_CONTROLLER_HW, CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL,
+                                    CY_DMA_INTR_MASK);
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&intr_cfg, sensor_acq_dma_isr))
+    {
+        return false;
+    }
+
+    burst_timer = xTimerCreate("Sensor acq", pdMS_TO_TICKS(SENSOR_ACQ_BLOCK_PERIOD_MS), pdTRUE,
+                               NULL, sensor_acq_burst_timer_callback);
+
+    return (NULL != burst_timer);
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_spi_start
+ ******************************************************************************
+ * Summary:
+ *  Arms the RX channel and starts the periodic burst reads.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_spi_start(void)
+{
+    Cy_DMA_Enable(CYBSP_DMA_RX_SPI_CONTROLLER_HW);
+    Cy_DMA_Enable(CYBSP_DMA_TX_SPI_CONTROLLER_HW);
+    Cy_DMA_Channel_Enable(CYBSP_DMA_RX_SPI_CONTROLLER_HW, CYBSP_DMA_RX_SPI_CONTROLLER_CHANNEL);
+
+    NVIC_ClearPendingIRQ(CYBSP_DMA_RX_SPI_CONTROLLER_IRQ);
+    NVIC_EnableIRQ(CYBSP_DMA_RX_SPI_CONTROLLER_IRQ);
+
+    (void) xTimerStart(burst_timer, 0U);
+}
+#else
+/******************************************************************************
+ * Function Name: sensor_acq_spi_init
+ ******************************************************************************
+ * Summary:
+ *  The BSP routes only the TX request of the SPI controller to a DMA
+ *  channel. Add a DW channel named CYBSP_DMA_RX_SPI_CONTROLLER, triggered
+ *  by the RX request of the SPI controller, in the Device Configurator to
+ *  enable the stream.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : false
+ *
+ ******************************************************************************/
+static bool sensor_acq_spi_init(void)
+{
+    printf("Sensor acquisition: No RX DMA channel for the SPI controller in the BSP\n");
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_spi_start
+ ******************************************************************************
+ * Summary:
+ *  No stream without the RX DMA channel.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_spi_start(void)
+{
+}
+#endif /* CYBSP_DMA_RX_SPI_CONTROLLER_ENABLED */
+
+/******************************************************************************
+* Consumer
+******************************************************************************/
+/******************************************************************************
+ * Function Name: sensor_acq_summary_clear
+ ******************************************************************************
+ * Summary:
+ *  Empties a summary.
+ *
+ * Parameters:
+ *  sensor_acq_summary_t *summary : Summary to clear
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_summary_clear(sensor_acq_summary_t *summary)
+{
+    summary->frames = 0U;
+    for (uint32_t axis = 0U; axis < SENSOR_ACQ_FRAME_AXES; axis++)
+    {
+        summary->min[axis] = INT16_MAX;
+        summary->max[axis] = INT16_MIN;
+        summary->sum[axis] = 0;
+    }
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_summarise
+ ******************************************************************************
+ * Summary:
+ *  Adds the frames of a block, read in place, to a summary.
+ *
+ * Parameters:
+ *  const sensor_acq_block_t *block : Lent block
+ *  sensor_acq_summary_t *summary : Summary to add to
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_summarise(const sensor_acq_block_t *block, sensor_acq_summary_t *summary)
+{
+    const uint8_t *frame = block->data;
+    int32_t value;
+
+    for (uint32_t offset = 0U; offset < block->size; offset += SENSOR_ACQ_FRAME_SIZE)
+    {
+        for (uint32_t axis = 0U; axis < SENSOR_ACQ_FRAME_AXES; axis++)
+        {
+            value = (int16_t)(((uint16_t)frame[offset + (2U * axis)] << 8) | frame[offset + (2U * axis) + 1U]);
+            summary->min[axis] = (value < summary->min[axis]) ? value : summary->min[axis];
+            summary->max[axis] = (value > summary->max[axis]) ? value : summary->max[axis];
+            summary->sum[axis] += value;
+        }
+        summary->frames++;
+    }
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_format_axes
+ ******************************************************************************
+ * Summary:
+ *  Appends a JSON member holding an array of per-axis values, followed by a
+ *  comma.
+ *
+ * Parameters:
+ *  char *buffer : Destination
+ *  size_t size : Size of the destination
+ *  size_t length : Length already used
+ *  const char *key : Key of the member
+ *  const int32_t *values : SENSOR_ACQ_FRAME_AXES values
+ *
+ * Return:
+ *  size_t : New length, at least 'size' if truncated
+ *
+ ******************************************************************************/
+static size_t sensor_acq_format_axes(char *buffer, size_t size, size_t length, const char *key,
+                                     const int32_t *values)
+{
+    if (length < size)
+    {
+        length += (size_t)snprintf(&buffer[length], size - length, "\"%s\":[", key);
+    }
+    for (uint32_t axis = 0U; (axis < SENSOR_ACQ_FRAME_AXES) && (length < size); axis++)
+    {
+        length += (size_t)snprintf(&buffer[length], size - length, "%ld%s", (long)values[axis],
+                                   ((SENSOR_ACQ_FRAME_AXES - 1U) == axis) ? "]," : ",");
+    }
+
+    return length;
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_report
+ ******************************************************************************
+ * Summary:
+ *  Sampling scheduler callback that queues the summary of the frames since
+ *  the last report, with the block and overrun counts, on the bulk lane.
+ *
+ * Parameters:
+ *  void *context : Unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sensor_acq_report(void *context)
+{
+    sensor_acq_summary_t summary;
+    sensor_acq_stats_t stats;
+    int32_t mean[SENSOR_ACQ_FRAME_AXES];
+    size_t length;
+
+    CY_UNUSED_PARAMETER(context);
+
+    taskENTER_CRITICAL();
+    summary = acq_summary;
+    sensor_acq_summary_clear(&acq_summary);
+    taskEXIT_CRITICAL();
+
+    if ((0U == summary.frames) || publisher_over_budget(PUBLISHER_LANE_BULK))
+    {
+        return;
+    }
+
+    sensor_acq_get_stats(&stats);
+    for (uint32_t axis = 0U; axis < SENSOR_ACQ_FRAME_AXES; axis++)
+    {
+        mean[axis] = (int32_t)(summary.sum[axis] / (int64_t)summary.frames);
+    }
+
+    length = (size_t)snprintf(report_payload, sizeof(report_payload), "{\"sensor\":\"imu\",\"frames\":%lu,",
+                              (unsigned long)summary.frames);
+    length = sensor_acq_format_axes(report_payload, sizeof(report_payload), length, "mean", mean);
+    length = sensor_acq_format_axes(report_payload, sizeof(report_payload), length, "min", summary.min);
+    length = sensor_acq_format_axes(report_payload, sizeof(report_payload), length, "max", summary.max);
+    if (length < sizeof(report_payload))
+    {
+        length += (size_t)snprintf(&report_payload[length], sizeof(report_payload) - length,
+                                   "\"blocks\":%lu,\"overruns\":%lu}",
+                                   (unsigned long)stats.produced, (unsigned long)stats.overruns);
+    }
+
+    /* A truncated report is not valid JSON. */
+    if (length < sizeof(report_payload))
+    {
+        (void) publisher_enqueue(PUBLISHER_LANE_BULK, report_payload);
+    }
+}
+
+static const sampling_sensor_t report_sensor =
+{
+    .name = "imu",
+    .period_ms = SENSOR_ACQ_REPORT_PERIOD_MS,
+    .sample = sensor_acq_report,
+    .context = NULL
+};
+
+/******************************************************************************
+ * Function Name: sensor_acq_init
+ ******************************************************************************
+ * Summary:
+ *  Sets up the SPI DMA stream, creates the Sensor Acquisition Task and
+ *  registers the summary report with the sampling scheduler. Must be called
+ *  before the scheduler task is started. Acquisition is optional: on
+ *  failure the application runs without it.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sensor_acq_init(void)
+{
+    if (NULL != sensor_acq_task_handle)
+    {
+        return;
+    }
+
+    sensor_acq_reset();
+    sensor_acq_summary_clear(&acq_summary);
+
+    if (!sensor_acq_spi_init())
+    {
+        printf("Sensor acquisition: Disabled\n");
+        return;
+    }
+
+    if (pdPASS != xTaskCreate(sensor_acq_task, "Sensor acquisition task", SENSOR_ACQ_TASK_STACK_SIZE,
+                              NULL, SENSOR_ACQ_TASK_PRIORITY, &sensor_acq_task_handle))
+    {
+        printf("Sensor acquisition: Failed to create the task!\n");
+        return;
+    }
+
+    if (!sampling_scheduler_register(&report_sensor))
+    {
+        printf("Sensor acquisition: Failed to register sensor '%s'!\n", report_sensor.name);
+    }
+}
+
+/******************************************************************************
+ * Function Name: sensor_acq_task
+ ******************************************************************************
+ * Summary:
+ *  Task that starts the stream and consumes the finished blocks. Each block
+ *  is summarised in place.
+ *
+ * Parameters:
+ *  void *pvParameters : Task parameter defined during task creation (unused)
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void sensor_acq_task(void *pvParameters)
+{
+    const sensor_acq_block_t *block;
+    sensor_acq_summary_t block_summary;
+
+    CY_UNUSED_PARAMETER(pvParameters);
+
+    sensor_acq_spi_start();
+
+    while (true)
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (NULL != (block = sensor_acq_take()))
+        {
+            sensor_acq_summary_clear(&block_summary);
+            sensor_acq_summarise(block, &block_summary);
+            sensor_acq_release(block);
+
+            taskENTER_CRITICAL();
+            for (uint32_t axis = 0U; axis < SENSOR_ACQ_FRAME_AXES; axis++)
+            {
+                if (block_summary.min[axis] < acq_summary.min[axis])
+                {
+                    acq_summary.min[axis] = block_summary.min[axis];
+                }
+                if (block_summary.max[axis] > acq_summary.max[axis])
+                {
+                    acq_summary.max[axis] = block_summary.max[axis];
+                }
+                acq_summary.sum[axis] += block_summary.sum[axis];
+            }
+            acq_summary.frames += block_summary.frames;
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,136 @@
+/******************************************************************************
+* File Name:   sensor_acq.h
+*
+* Description: This file contains the declarations of the sensor acquisition
+*              layer, which streams sensor frames by DMA into a pool of block
+*              buffers and hands finished blocks to a consumer without
+*              copying them.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SENSOR_ACQ_H_
+#define SENSOR_ACQ_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of block buffers. With three, the DMA fills one while the consumer
+ * works on another, and the third holds the newest complete block; a
+ * consumer that falls behind loses the older ready blocks, never the one it
+ * holds. With a ping-pong pair (2), every block completed while the
+ * consumer holds the other is lost.
+ */
+#ifndef SENSOR_ACQ_BLOCK_COUNT
+#define SENSOR_ACQ_BLOCK_COUNT              (3U)
+#endif
+
+/* A frame is one sample of the sensor: six big-endian 16-bit axes, the
+ * transfer length of the SPI controller TX DMA channel of the BSP.
+ */
+#define SENSOR_ACQ_FRAME_SIZE               (12U)
+#define SENSOR_ACQ_FRAME_AXES               (SENSOR_ACQ_FRAME_SIZE / 2U)
+
+/* Frames per block. A block is read from the sensor FIFO in one SPI burst,
+ * which a DataWire descriptor limits to 256 bytes including the command.
+ */
+#ifndef SENSOR_ACQ_FRAMES_PER_BLOCK
+#define SENSOR_ACQ_FRAMES_PER_BLOCK         (20U)
+#endif
+
+#define SENSOR_ACQ_BLOCK_SIZE               (SENSOR_ACQ_FRAME_SIZE * SENSOR_ACQ_FRAMES_PER_BLOCK)
+
+/* Bytes received while the read command is sent. They lead each buffer and
+ * are not part of the block.
+ */
+#define SENSOR_ACQ_BLOCK_HEADER_SIZE        (1U)
+#define SENSOR_ACQ_BUFFER_SIZE              (SENSOR_ACQ_BLOCK_HEADER_SIZE + SENSOR_ACQ_BLOCK_SIZE)
+
+/* Task parameters for the Sensor Acquisition Task. It only summarises the
+ * blocks and runs above the publisher, so that it releases them in time.
+ */
+#define SENSOR_ACQ_TASK_PRIORITY            (3U)
+#define SENSOR_ACQ_TASK_STACK_SIZE          (512U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Finished block, lent to the consumer by sensor_acq_take() until
+ * sensor_acq_release().
+ */
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t sequence;      /* Block number since sensor_acq_reset() */
+    uint32_t time_ms;       /* Completion time */
+} sensor_acq_block_t;
+
+typedef struct
+{
+    uint32_t produced;      /* Blocks completed by the producer */
+    uint32_t delivered;     /* Blocks released by the consumer */
+    uint32_t overruns;      /* Ready blocks dropped because the consumer was
+                             * behind */
+} sensor_acq_stats_t;
+
+/*******************************************************************************
+* Extern Variables
+********************************************************************************/
+extern TaskHandle_t sensor_acq_task_handle;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void sensor_acq_reset(void);
+uint8_t *sensor_acq_buffer(uint32_t index);
+uint8_t *sensor_acq_block_done(uint32_t time_ms);
+const sensor_acq_block_t *sensor_acq_take(void);
+void sensor_acq_release(const sensor_acq_block_t *block);
+void sensor_acq_get_stats(sensor_acq_stats_t *stats);
+
+void sensor_acq_init(void);
+void sensor_acq_task(void *pvParameters);
+
+#endif /* SENSOR_ACQ_H_ */
+
+/* [] END OF FILE */
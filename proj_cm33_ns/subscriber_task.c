@@ -2,7 +2,7 @@
 * File Name:   subscriber_task.c
 *
 * Description: This file contains the task that initializes the user LED GPIO,
-*              subscribes to the topic 'MQTT_SUB_TOPIC', and actuates the user LED
+*              subscribes to the topics 'MQTT_SUB_TOPICS', and actuates the user LED
 *              based on the notifications received from the MQTT subscriber
 *              callback.
 *
@@ -48,6 +48,9 @@
 /* Task header files */
 #include "subscriber_task.h"
 #include "mqtt_task.h"
+#include "ota_receiver.h"
+#include "config_command.h"
+#include "cert_pinning.h"
 
 /* Configuration file for MQTT client */
 #include "mqtt_client_config.h"
@@ -65,8 +68,13 @@
 /* Time interval in milliseconds between MQTT subscribe retries. */
 #define MQTT_SUBSCRIBE_RETRY_INTERVAL_MS        (1000U)
 
-/* The number of MQTT topics to be subscribed to. */
-#define SUBSCRIPTION_COUNT                      (1U)
+/* Maximum number of topics in the subscription registry: the longest topic
+ * list the device subscribes to.
+ */
+#define SUBSCRIPTION_MAX_COUNT                  (MQTT_SUB_TOPICS_INDIVIDUAL_COUNT)
+
+/* Number of topics in a comma-separated topic list. */
+#define SUBSCRIPTION_TOPIC_COUNT(...)           (sizeof((const char * const[]){ __VA_ARGS__ }) / sizeof(const char *))
 
 /* Queue length of a message queue that is used to communicate with the 
  * subscriber task.
@@ -87,35 +95,84 @@ QueueHandle_t subscriber_task_q;
  */
 uint32_t current_device_state = DEVICE_OFF_STATE;
 
-/* Configure the subscription information structure. */
-static cy_mqtt_subscribe_info_t subscribe_info =
-{
-    .qos = (cy_mqtt_qos_t) MQTT_MESSAGES_QOS,
-    .topic = MQTT_SUB_TOPIC,
-    .topic_len = (sizeof(MQTT_SUB_TOPIC) - 1)
-};
+/* Topics subscribed to by default. */
+static const char * const subscription_default_topics[] = { MQTT_SUB_TOPICS };
+
+_Static_assert(SUBSCRIPTION_TOPIC_COUNT(MQTT_SUB_TOPICS_INDIVIDUAL) == MQTT_SUB_TOPICS_INDIVIDUAL_COUNT,
+               "MQTT_SUB_TOPICS_INDIVIDUAL_COUNT does not match MQTT_SUB_TOPICS_INDIVIDUAL");
+_Static_assert((sizeof(subscription_default_topics) / sizeof(subscription_default_topics[0])) <= SUBSCRIPTION_MAX_COUNT,
+               "MQTT_SUB_TOPICS has more topics than the subscription registry holds");
+
+/* Subscription registry. 'allocated_qos' holds the QoS granted by the broker,
+ * CY_MQTT_QOS_INVALID while the topic is not subscribed.
+ */
+static cy_mqtt_subscribe_info_t subscriptions[SUBSCRIPTION_MAX_COUNT];
+static uint8_t subscription_count;
 
 /******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 
+/******************************************************************************
+ * Function Name: subscriber_register_topic
+ ******************************************************************************
+ * Summary:
+ *  Adds a topic to the subscription registry. Registered topics are
+ *  subscribed to together in one SUBSCRIBE packet, at the start of the
+ *  subscriber task and after every reconnection.
+ *
+ * Parameters:
+ *  const char *topic : Topic filter; must outlive the registry
+ *  cy_mqtt_qos_t qos : Requested QoS
+ *
+ * Return:
+ *  bool : true if the topic is registered, false if the registry is full
+ *
+ ******************************************************************************/
+bool subscriber_register_topic(const char *topic, cy_mqtt_qos_t qos)
+{
+    for (uint32_t i = 0U; i < subscription_count; i++)
+    {
+        if (0 == strcmp(subscriptions[i].topic, topic))
+        {
+            subscriptions[i].qos = qos;
+            return true;
+        }
+    }
+
+    if (subscription_count >= SUBSCRIPTION_MAX_COUNT)
+    {
+        return false;
+    }
+
+    subscriptions[subscription_count].topic = topic;
+    subscriptions[subscription_count].topic_len = (uint16_t)strlen(topic);
+    subscriptions[subscription_count].qos = qos;
+    subscriptions[subscription_count].allocated_qos = CY_MQTT_QOS_INVALID;
+    subscription_count++;
+
+    return true;
+}
+
 /******************************************************************************
  * Function Name: subscribe_to_topic
  ******************************************************************************
  * Summary:
- *  Function that subscribes to the MQTT topic specified by the macro
- *  'MQTT_SUB_TOPIC'. This operation is retried a maximum of
+ *  Function that subscribes to every topic of the registry in a single
+ *  SUBSCRIBE packet. The SUBACK is checked per topic: only the topics the
+ *  broker refused are sent again, in one batch, a maximum of
  *  'MAX_SUBSCRIBE_RETRIES' times with interval of
  *  'MQTT_SUBSCRIBE_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
- *  void
+ *  TickType_t disconnect_tick : Tick count of the disconnection that led to
+ *                               this subscribe, or 0
  *
  * Return:
  *  void
  *
  ******************************************************************************/
-static void subscribe_to_topic(void)
+static void subscribe_to_topic(TickType_t disconnect_tick)
 {
     /* Status variable */
     cy_rslt_t result = CY_RSLT_SUCCESS;
@@ -123,21 +180,91 @@ static void subscribe_to_topic(void)
     /* Command to the MQTT client task */
     mqtt_task_cmd_t mqtt_task_cmd;
 
-    /* Subscribe with the configured parameters. */
+    cy_mqtt_subscribe_info_t batch[SUBSCRIPTION_MAX_COUNT];
+    uint8_t batch_index[SUBSCRIPTION_MAX_COUNT];
+    uint8_t batch_count = 0U;
+    uint32_t granted = 0U;
+    cy_mqtt_subscribe_info_t *entry;
+
+    for (uint32_t i = 0U; i < subscription_count; i++)
+    {
+        subscriptions[i].allocated_qos = CY_MQTT_QOS_INVALID;
+    }
+
     for (uint32_t retry_count = 0; retry_count < MAX_SUBSCRIBE_RETRIES; retry_count++)
     {
-        result = cy_mqtt_subscribe(mqtt_connection, &subscribe_info, SUBSCRIPTION_COUNT);
-        if (result == CY_RSLT_SUCCESS)
+        /* Batch the topics that are not subscribed yet. */
+        batch_count = 0U;
+        for (uint8_t i = 0U; i < subscription_count; i++)
+        {
+            if (CY_MQTT_QOS_INVALID == subscriptions[i].allocated_qos)
+            {
+                batch[batch_count] = subscriptions[i];
+                batch_index[batch_count] = i;
+                batch_count++;
+            }
+        }
+
+        if (0U == batch_count)
         {
+            break;
+        }
+
+        result = cy_mqtt_subscribe(mqtt_connection, batch, batch_count);
+
+        /* On success every topic was granted. On failure, the topics with a
+         * valid 'allocated_qos' were granted and the others refused.
+         */
+        for (uint32_t i = 0U; i < batch_count; i++)
+        {
+            entry = &subscriptions[batch_index[i]];
+            if (CY_MQTT_QOS_INVALID != batch[i].allocated_qos)
+            {
+                entry->allocated_qos = batch[i].allocated_qos;
+            }
+            else if (CY_RSLT_SUCCESS == result)
+            {
+                entry->allocated_qos = entry->qos;
+            }
+            else
+            {
+                continue;
+            }
+
+            granted++;
             printf("\nMQTT client subscribed to the topic '%.*s' successfully.\n",
-                    subscribe_info.topic_len, subscribe_info.topic);
+                   entry->topic_len, entry->topic);
+            if (entry->allocated_qos < entry->qos)
+            {
+                printf("  Subscriber: QoS %d requested, broker granted QoS %d.\n",
+                       (int)entry->qos, (int)entry->allocated_qos);
+            }
+        }
+
+        if (granted == subscription_count)
+        {
             break;
         }
 
         vTaskDelay(pdMS_TO_TICKS(MQTT_SUBSCRIBE_RETRY_INTERVAL_MS));
     }
 
-    if (CY_RSLT_SUCCESS != result)
+    if ((0U != disconnect_tick) && (0U != granted))
+    {
+        printf("MQTT ready %lu ms after the disconnection.\n",
+               (unsigned long)((xTaskGetTickCount() - disconnect_tick) * portTICK_PERIOD_MS));
+    }
+
+    for (uint32_t i = 0U; i < subscription_count; i++)
+    {
+        if (CY_MQTT_QOS_INVALID == subscriptions[i].allocated_qos)
+        {
+            printf("\nMQTT Subscribe to '%.*s' failed after %d retries...\n",
+                   subscriptions[i].topic_len, subscriptions[i].topic, MAX_SUBSCRIBE_RETRIES);
+        }
+    }
+
+    if (0U == granted)
     {
         printf("\nMQTT Subscribe failed with error 0x%0X after %d retries...\n\n",
                (int)result, MAX_SUBSCRIBE_RETRIES);
@@ -152,8 +279,8 @@ static void subscribe_to_topic(void)
  * Function Name: unsubscribe_from_topic
  ******************************************************************************
  * Summary:
- *  Function that unsubscribes from the topic specified by the macro
- *  'MQTT_SUB_TOPIC'.
+ *  Function that unsubscribes from every subscribed topic of the registry in
+ *  a single UNSUBSCRIBE packet.
  *
  * Parameters:
  *  void
@@ -164,9 +291,25 @@ static void subscribe_to_topic(void)
  ******************************************************************************/
 static void unsubscribe_from_topic(void)
 {
-    cy_rslt_t result = cy_mqtt_unsubscribe(mqtt_connection,
-                                           (cy_mqtt_unsubscribe_info_t *) &subscribe_info,
-                                           SUBSCRIPTION_COUNT);
+    cy_mqtt_unsubscribe_info_t batch[SUBSCRIPTION_MAX_COUNT];
+    uint8_t batch_count = 0U;
+    cy_rslt_t result;
+
+    for (uint32_t i = 0U; i < subscription_count; i++)
+    {
+        if (CY_MQTT_QOS_INVALID != subscriptions[i].allocated_qos)
+        {
+            batch[batch_count++] = subscriptions[i];
+            subscriptions[i].allocated_qos = CY_MQTT_QOS_INVALID;
+        }
+    }
+
+    if (0U == batch_count)
+    {
+        return;
+    }
+
+    result = cy_mqtt_unsubscribe(mqtt_connection, batch, batch_count);
 
     if (CY_RSLT_SUCCESS != result)
     {
@@ -197,8 +340,15 @@ void subscriber_task(void *pvParameters)
     /* To avoid compiler warnings */
     (void) pvParameters;
 
-    /* Subscribe to the specified MQTT topic. */
-    subscribe_to_topic();
+    /* Register the default topics and subscribe to them. */
+    for (uint32_t i = 0U; i < (sizeof(subscription_default_topics) / sizeof(subscription_default_topics[0])); i++)
+    {
+        if (!subscriber_register_topic(subscription_default_topics[i], (cy_mqtt_qos_t) MQTT_MESSAGES_QOS))
+        {
+            printf("\nSubscriber: Registry full, '%s' not subscribed.\n", subscription_default_topics[i]);
+        }
+    }
+    subscribe_to_topic(0U);
 
     /* Create a message queue to communicate with other tasks and callbacks. */
     subscriber_task_q = xQueueCreate(SUBSCRIBER_TASK_QUEUE_LENGTH, sizeof(subscriber_data_t));
@@ -212,7 +362,7 @@ void subscriber_task(void *pvParameters)
             {
                 case SUBSCRIBE_TO_TOPIC:
                 {
-                    subscribe_to_topic();
+                    subscribe_to_topic(subscriber_q_data.disconnect_tick);
                     break;
                 }
 
@@ -264,6 +414,38 @@ void mqtt_subscription_callback(cy_mqtt_publish_info_t *received_msg_info)
     /* Data to be sent to the subscriber task queue. */
     subscriber_data_t subscriber_q_data;
 
+    /* Firmware fragments are binary and handled by the OTA receiver. */
+    if ((received_msg_info->topic_len == (sizeof(MQTT_SUB_TOPIC_COMMAND_FIRMWARE) - 1)) &&
+        (strncmp(MQTT_SUB_TOPIC_COMMAND_FIRMWARE, received_msg_info->topic,
+                 received_msg_info->topic_len) == 0))
+    {
+        ota_receiver_handle_fragment((const uint8_t *)received_msg_info->payload,
+                                     received_msg_info->payload_len);
+        return;
+    }
+
+    /* Runtime configuration updates are JSON objects. */
+    if ((received_msg_info->topic_len == (sizeof(MQTT_SUB_TOPIC_COMMAND_CONFIG) - 1)) &&
+        (strncmp(MQTT_SUB_TOPIC_COMMAND_CONFIG, received_msg_info->topic,
+                 received_msg_info->topic_len) == 0))
+    {
+        config_command_handle(received_msg_info->payload, received_msg_info->payload_len);
+        return;
+    }
+
+    /* Certificate provisioning may replace the trust anchors; the next
+     * handshake validates the server chain in full.
+     */
+    if (((received_msg_info->topic_len == (sizeof(MQTT_SUB_TOPIC_COMMAND_CERT) - 1)) &&
+         (strncmp(MQTT_SUB_TOPIC_COMMAND_CERT, received_msg_info->topic,
+                  received_msg_info->topic_len) == 0)) ||
+        ((received_msg_info->topic_len == (sizeof(MQTT_SUB_TOPIC_COMMAND_SYNC_CERT_RESPONSE) - 1)) &&
+         (strncmp(MQTT_SUB_TOPIC_COMMAND_SYNC_CERT_RESPONSE, received_msg_info->topic,
+                  received_msg_info->topic_len) == 0)))
+    {
+        cert_pin_clear();
+    }
+
     printf("  \nSubsciber: Incoming MQTT message received:\n"
            "    Publish topic name: %.*s\n"
            "    Publish QoS: %d\n"
@@ -73,6 +73,11 @@ typedef enum
 typedef struct{
     subscriber_cmd_t cmd;
     uint8_t data;
+
+    /* SUBSCRIBE_TO_TOPIC after a reconnection: tick count of the
+     * disconnection, to report the reconnect-to-ready time; else 0.
+     */
+    TickType_t disconnect_tick;
 } subscriber_data_t;
 
 /*******************************************************************************
@@ -86,6 +91,7 @@ extern uint32_t current_device_state;
 * Function Prototypes
 ********************************************************************************/
 void subscriber_task(void *pvParameters);
+bool subscriber_register_topic(const char *topic, cy_mqtt_qos_t qos);
 void mqtt_subscription_callback(cy_mqtt_publish_info_t *received_msg_info);
 
 #endif /* SUBSCRIBER_TASK_H_ */
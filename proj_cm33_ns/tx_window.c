@@ -0,0 +1,139 @@
+/******************************************************************************
+* File Name:   tx_window.c
+*
+* Description: This file contains the transmit window grid of the publisher.
+*              Non-urgent publishes are held for shared windows spaced in
+*              whole DTIM intervals, so that the radio wakes once per window
+*              instead of once per message.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "tx_window.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Length of an 802.11 time unit in microseconds. */
+#define TX_WINDOW_TU_US                     (1024U)
+
+/******************************************************************************
+ * Function Name: tx_window_init
+ ******************************************************************************
+ * Summary:
+ *  Sets up the window grid. The interval is rounded up to whole DTIM
+ *  intervals of the access point. The phase of the beacons is not visible
+ *  to the host, so the grid is anchored on the radio's own wake-ups: a
+ *  station in power save that was awake at the anchor is awake again at
+ *  every later window for the DTIM beacon.
+ *
+ * Parameters:
+ *  tx_window_t *window : Window grid to set up
+ *  uint32_t beacon_interval_tu : Beacon interval of the access point in TU
+ *  uint32_t dtim_period : DTIM period of the access point in beacons
+ *  uint32_t interval_ms : Requested spacing of the windows
+ *  uint32_t open_ms : Time a window stays open
+ *  uint32_t now_ms : Current time; the first window opens now
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void tx_window_init(tx_window_t *window, uint32_t beacon_interval_tu, uint32_t dtim_period,
+                    uint32_t interval_ms, uint32_t open_ms, uint32_t now_ms)
+{
+    uint32_t dtim_ms = ((beacon_interval_tu * dtim_period * TX_WINDOW_TU_US) + 999U) / 1000U;
+
+    if (0U == dtim_ms)
+    {
+        dtim_ms = 1U;
+    }
+
+    window->interval_ms = ((interval_ms + dtim_ms - 1U) / dtim_ms) * dtim_ms;
+    if (0U == window->interval_ms)
+    {
+        window->interval_ms = dtim_ms;
+    }
+    window->open_ms = (open_ms < window->interval_ms) ? open_ms : window->interval_ms;
+    window->anchor_ms = now_ms;
+}
+
+/******************************************************************************
+ * Function Name: tx_window_anchor
+ ******************************************************************************
+ * Summary:
+ *  Records a radio wake-up, e.g. an urgent publish, and restarts the grid at
+ *  it: a window is open right away, so pending messages can share the
+ *  wake-up.
+ *
+ * Parameters:
+ *  tx_window_t *window : Window grid
+ *  uint32_t now_ms : Time of the wake-up
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void tx_window_anchor(tx_window_t *window, uint32_t now_ms)
+{
+    window->anchor_ms = now_ms;
+}
+
+/******************************************************************************
+ * Function Name: tx_window_wait_ms
+ ******************************************************************************
+ * Summary:
+ *  Returns the time until the next window opens. Depends only on its
+ *  arguments; times may wrap around.
+ *
+ * Parameters:
+ *  const tx_window_t *window : Window grid
+ *  uint32_t now_ms : Current time
+ *
+ * Return:
+ *  uint32_t : 0 if a window is open, else the milliseconds to wait
+ *
+ ******************************************************************************/
+uint32_t tx_window_wait_ms(const tx_window_t *window, uint32_t now_ms)
+{
+    uint32_t phase = (now_ms - window->anchor_ms) % window->interval_ms;
+
+    return (phase < window->open_ms) ? 0U : (window->interval_ms - phase);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name:   tx_window.h
+*
+* Description: This file is the public interface of tx_window.c
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TX_WINDOW_H_
+#define TX_WINDOW_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Grid of shared transmit windows. A window opens every 'interval_ms',
+ * counted from the last radio wake-up, and stays open for 'open_ms', the
+ * time the radio stays awake after a transmission anyway.
+ */
+typedef struct
+{
+    uint32_t interval_ms;
+    uint32_t open_ms;
+    uint32_t anchor_ms;
+} tx_window_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void tx_window_init(tx_window_t *window, uint32_t beacon_interval_tu, uint32_t dtim_period,
+                    uint32_t interval_ms, uint32_t open_ms, uint32_t now_ms);
+void tx_window_anchor(tx_window_t *window, uint32_t now_ms);
+uint32_t tx_window_wait_ms(const tx_window_t *window, uint32_t now_ms);
+
+#endif /* TX_WINDOW_H_ */
+
+/* [] END OF FILE */
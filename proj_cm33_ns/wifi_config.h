@@ -65,4 +65,43 @@
 /* Wi-Fi re-connection time interval in milliseconds. */
 #define WIFI_CONN_RETRY_INTERVAL_MS       (5000)
 
+/* Additional Wi-Fi networks, tried after WIFI_SSID when it is weaker or
+ * unavailable. Each entry is { "SSID", "password", security }, e.g.
+ * { "Ward2_IoT", "password", CY_WCM_SECURITY_WPA2_AES_PSK },
+ */
+#define WIFI_EXTRA_PROFILES
+
+/* Maximum number of Wi-Fi network profiles, including WIFI_SSID. */
+#define WIFI_MAX_PROFILES                 (4u)
+
+/* When the RSSI of the associated access point falls below this threshold,
+ * the client scans for a stronger one and roams to it if it is at least
+ * WIFI_ROAM_HYSTERESIS_DB stronger. Checked every WIFI_ROAM_CHECK_INTERVAL_MS.
+ */
+#define WIFI_ROAM_RSSI_THRESHOLD_DBM      (-75)
+#define WIFI_ROAM_HYSTERESIS_DB           (8)
+#define WIFI_ROAM_CHECK_INTERVAL_MS       (30000u)
+
+/* Beacon interval (in 802.11 time units of 1.024 ms) and DTIM period of the
+ * access point, see its settings. Non-urgent publishes are sent in windows
+ * spaced in whole DTIM intervals.
+ */
+#define WIFI_AP_BEACON_INTERVAL_TU        (100u)
+#define WIFI_AP_DTIM_PERIOD               (1u)
+
+/* Time the radio stays awake after the last frame in power save mode 2
+ * (the WHD default). A transmit window stays open this long.
+ */
+#define WIFI_PM2_RETURN_TO_SLEEP_MS       (200u)
+
+/* Traffic-driven power save (see wifi_powersave.c). The radio uses power
+ * save mode 1 for sparse telemetry, mode 2 once this many messages are
+ * waiting and no power save at all for a larger backlog or a bulk transfer.
+ * A mode is only left after it has not been asked for during
+ * WIFI_POWERSAVE_HOLD_MS.
+ */
+#define WIFI_POWERSAVE_BALANCED_BACKLOG    (2u)
+#define WIFI_POWERSAVE_PERFORMANCE_BACKLOG (6u)
+#define WIFI_POWERSAVE_HOLD_MS             (5000u)
+
 #endif /* WIFI_CONFIG_H_ */
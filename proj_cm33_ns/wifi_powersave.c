@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name:   wifi_powersave.c
+*
+* Description: This file contains the traffic-driven Wi-Fi power save policy.
+*              Producers report their backlog and the traffic they expect,
+*              and the MQTT client task switches the power save mode of the
+*              radio to the lowest power mode that serves the demand, leaving
+*              a mode only after a hold time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "cybsp.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#include "wifi_powersave.h"
+#include "wifi_config.h"
+#include "mqtt_task.h"
+
+#include "cy_wcm.h"
+#include "whd_wifi_api.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define WIFI_POWERSAVE_HOLD_TICKS           pdMS_TO_TICKS(WIFI_POWERSAVE_HOLD_MS)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Power save modes of the radio, by increasing radio-on time. */
+typedef enum
+{
+    WIFI_POWERSAVE_MAXIMUM,     /* PM1: sleeps between DTIM beacons, PS-Poll per frame */
+    WIFI_POWERSAVE_BALANCED,    /* PM2: stays awake WIFI_PM2_RETURN_TO_SLEEP_MS after traffic */
+    WIFI_POWERSAVE_PERFORMANCE, /* PM0: always awake */
+    WIFI_POWERSAVE_MODE_COUNT
+} wifi_powersave_mode_t;
+
+static const char *const wifi_powersave_mode_names[WIFI_POWERSAVE_MODE_COUNT] =
+{
+    "PM1 (maximum power save)", "PM2 (balanced)", "PM0 (no power save)"
+};
+
+/* Time until which each mode has been asked for; WIFI_POWERSAVE_MAXIMUM is
+ * the fallback and never needs to be asked for.
+ */
+static bool demand_active[WIFI_POWERSAVE_MODE_COUNT];
+static TickType_t demand_until[WIFI_POWERSAVE_MODE_COUNT];
+
+/* Mode the radio is in; only changed by the MQTT client task. */
+static wifi_powersave_mode_t current_mode = WIFI_POWERSAVE_MAXIMUM;
+static bool current_mode_set = false;
+static uint32_t mode_switches;
+
+/* Set while a HANDLE_WIFI_POWERSAVE command waits in the MQTT task queue. */
+static volatile bool apply_pending = false;
+
+/* Re-evaluates the policy when the demand for the current mode expires. */
+static TimerHandle_t expiry_timer;
+
+/******************************************************************************
+* Function Name: wifi_powersave_target
+******************************************************************************
+* Summary:
+*  Determines the mode that serves the current demand, and when that demand
+*  expires.
+*
+* Parameters:
+*  TickType_t now : Current tick count
+*  TickType_t *expiry_ticks : Ticks until the target may drop; set unless
+*                             the target is WIFI_POWERSAVE_MAXIMUM
+*
+* Return:
+*  wifi_powersave_mode_t : Target mode
+*
+******************************************************************************/
+static wifi_powersave_mode_t wifi_powersave_target(TickType_t now, TickType_t *expiry_ticks)
+{
+    wifi_powersave_mode_t target = WIFI_POWERSAVE_MAXIMUM;
+
+    taskENTER_CRITICAL();
+    for (uint32_t mode = WIFI_POWERSAVE_MODE_COUNT - 1U; mode > WIFI_POWERSAVE_MAXIMUM; mode--)
+    {
+        if (demand_active[mode] && ((int32_t)(demand_until[mode] - now) > 0))
+        {
+            target = (wifi_powersave_mode_t)mode;
+            *expiry_ticks = demand_until[mode] - now;
+            break;
+        }
+        demand_active[mode] = false;
+    }
+    taskEXIT_CRITICAL();
+
+    return target;
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_request_apply
+******************************************************************************
+* Summary:
+*  Asks the MQTT client task, which owns the Wi-Fi link, to apply the policy
+*  if the target mode differs from the current one. Never blocks.
+*
+* Parameters:
+*  bool always : Apply even if the mode stays, to re-arm the expiry timer
+*
+* Return:
+*  void
+*
+******************************************************************************/
+static void wifi_powersave_request_apply(bool always)
+{
+    mqtt_task_cmd_t cmd = HANDLE_WIFI_POWERSAVE;
+    TickType_t expiry_ticks;
+
+    if (apply_pending || (NULL == mqtt_task_q) ||
+        (!always && current_mode_set &&
+         (wifi_powersave_target(xTaskGetTickCount(), &expiry_ticks) == current_mode)))
+    {
+        return;
+    }
+
+    apply_pending = true;
+    if (pdTRUE != xQueueSend(mqtt_task_q, &cmd, 0))
+    {
+        /* Retried on the next report or expiry. */
+        apply_pending = false;
+    }
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_demand
+******************************************************************************
+* Summary:
+*  Asks for a mode for the given time plus the hold time.
+*
+* Parameters:
+*  wifi_powersave_mode_t mode : Mode asked for
+*  uint32_t duration_ms : Time the traffic is expected to last
+*
+* Return:
+*  void
+*
+******************************************************************************/
+static void wifi_powersave_demand(wifi_powersave_mode_t mode, uint32_t duration_ms)
+{
+    TickType_t until = xTaskGetTickCount() + pdMS_TO_TICKS(duration_ms) + WIFI_POWERSAVE_HOLD_TICKS;
+
+    taskENTER_CRITICAL();
+    if (!demand_active[mode] || ((int32_t)(until - demand_until[mode]) > 0))
+    {
+        demand_active[mode] = true;
+        demand_until[mode] = until;
+    }
+    taskEXIT_CRITICAL();
+
+    wifi_powersave_request_apply(false);
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_expiry_callback
+******************************************************************************
+* Summary:
+*  Timer callback; the demand for the current mode may have expired.
+*
+* Parameters:
+*  TimerHandle_t timer : Expired timer (unused)
+*
+* Return:
+*  void
+*
+******************************************************************************/
+static void wifi_powersave_expiry_callback(TimerHandle_t timer)
+{
+    CY_UNUSED_PARAMETER(timer);
+
+    wifi_powersave_request_apply(true);
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_set_mode
+******************************************************************************
+* Summary:
+*  Sets the power save mode of the station interface.
+*
+* Parameters:
+*  wifi_powersave_mode_t mode : Mode to be set
+*
+* Return:
+*  cy_rslt_t : Result of the WHD call
+*
+******************************************************************************/
+static cy_rslt_t wifi_powersave_set_mode(wifi_powersave_mode_t mode)
+{
+    whd_interface_t ifp;
+    cy_rslt_t result = cy_wcm_get_whd_interface(CY_WCM_INTERFACE_TYPE_STA, &ifp);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    switch (mode)
+    {
+        case WIFI_POWERSAVE_PERFORMANCE:
+            result = whd_wifi_disable_powersave(ifp);
+            break;
+
+        case WIFI_POWERSAVE_BALANCED:
+            result = whd_wifi_enable_powersave_with_throughput(ifp, WIFI_PM2_RETURN_TO_SLEEP_MS);
+            break;
+
+        default:
+            result = whd_wifi_enable_powersave(ifp);
+            break;
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_init
+******************************************************************************
+* Summary:
+*  Creates the timer that lowers the power mode once the demand expires.
+*  Called after the MQTT task queue has been created.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void wifi_powersave_init(void)
+{
+    expiry_timer = xTimerCreate("Wi-Fi power save", WIFI_POWERSAVE_HOLD_TICKS, pdFALSE, NULL,
+                                wifi_powersave_expiry_callback);
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_expect
+******************************************************************************
+* Summary:
+*  Hint from a producer that the given traffic is about to start. A burst
+*  asks for power save mode 2 and a bulk transfer for no power save, for
+*  the given time plus WIFI_POWERSAVE_HOLD_MS. Repeat the hint to extend it.
+*
+* Parameters:
+*  wifi_traffic_t traffic : Expected traffic
+*  uint32_t duration_ms : Time the traffic is expected to last
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void wifi_powersave_expect(wifi_traffic_t traffic, uint32_t duration_ms)
+{
+    wifi_powersave_demand((WIFI_TRAFFIC_BULK == traffic) ? WIFI_POWERSAVE_PERFORMANCE :
+                                                           WIFI_POWERSAVE_BALANCED,
+                          duration_ms);
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_report_backlog
+******************************************************************************
+* Summary:
+*  Reports the number of messages waiting to be sent. A backlog of
+*  WIFI_POWERSAVE_BALANCED_BACKLOG messages or more asks for power save
+*  mode 2, of WIFI_POWERSAVE_PERFORMANCE_BACKLOG or more for no power save.
+*
+* Parameters:
+*  uint32_t queued : Messages waiting to be sent
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void wifi_powersave_report_backlog(uint32_t queued)
+{
+    if (queued >= WIFI_POWERSAVE_PERFORMANCE_BACKLOG)
+    {
+        wifi_powersave_demand(WIFI_POWERSAVE_PERFORMANCE, 0U);
+    }
+    else if (queued >= WIFI_POWERSAVE_BALANCED_BACKLOG)
+    {
+        wifi_powersave_demand(WIFI_POWERSAVE_BALANCED, 0U);
+    }
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_connected
+******************************************************************************
+* Summary:
+*  Sets the power save mode after a (re)connection to an access point.
+*  Called by the MQTT client task.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void wifi_powersave_connected(void)
+{
+    current_mode_set = false;
+    wifi_powersave_apply();
+}
+
+/******************************************************************************
+* Function Name: wifi_powersave_apply
+******************************************************************************
+* Summary:
+*  Switches the radio to the target mode of the policy and arms the timer
+*  that re-evaluates it when the demand expires. Raising the power mode
+*  takes effect at once; lowering it only happens once the higher mode has
+*  not been asked for during WIFI_POWERSAVE_HOLD_MS, so that bursts a few
+*  seconds apart do not toggle the mode. Called by the MQTT client task.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void wifi_powersave_apply(void)
+{
+    TickType_t expiry_ticks = 0U;
+    wifi_powersave_mode_t target;
+    cy_rslt_t result;
+
+    apply_pending = false;
+    target = wifi_powersave_target(xTaskGetTickCount(), &expiry_ticks);
+
+    if ((!current_mode_set || (target != current_mode)) && (0U != cy_wcm_is_connected_to_ap()))
+    {
+        result = wifi_powersave_set_mode(target);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            if (current_mode_set)
+            {
+                mode_switches++;
+                printf("Wi-Fi power save: %s -> %s (%lu switches)\n",
+                       wifi_powersave_mode_names[current_mode], wifi_powersave_mode_names[target],
+                       (unsigned long)mode_switches);
+            }
+            else
+            {
+                printf("Wi-Fi power save: %s\n", wifi_powersave_mode_names[target]);
+            }
+            current_mode = target;
+            current_mode_set = true;
+        }
+        else
+        {
+            printf("Wi-Fi power save: setting %s failed with error 0x%0X\n",
+                   wifi_powersave_mode_names[target], (int)result);
+        }
+    }
+
+    if ((NULL != expiry_timer) && (WIFI_POWERSAVE_MAXIMUM != target))
+    {
+        (void) xTimerChangePeriod(expiry_timer, expiry_ticks + 1U, 0U);
+    }
+}
+
+/* [] END OF FILE */
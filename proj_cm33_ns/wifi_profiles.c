@@ -0,0 +1,592 @@
+/******************************************************************************
+* File Name:   wifi_profiles.c
+*
+* Description: This file contains the Wi-Fi network selection. The
+*              configured network profiles are tried by their connection
+*              history, a scan ranks them by RSSI when none connects, and a
+*              weak link triggers roaming to a stronger access point.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "wifi_config.h"
+#include "config_store.h"
+
+#include "wifi_profiles.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Maximum time to wait for a scan to complete. */
+#define WIFI_SCAN_TIMEOUT_MS                (10000U)
+
+/* Ranking penalties: each consecutive failed connection costs as much as
+ * WIFI_PROFILE_FAILURE_PENALTY_DB of RSSI, and every
+ * WIFI_PROFILE_LATENCY_MS_PER_DB of average connect time costs 1 dB.
+ */
+#define WIFI_PROFILE_FAILURE_PENALTY_DB     (10)
+#define WIFI_PROFILE_LATENCY_MS_PER_DB      (500U)
+
+/* Typical duration of a failed join (authentication or association
+ * timeout), the cost of a failure in the expected time to join.
+ */
+#define WIFI_PROFILE_FAILED_JOIN_MS         (4000U)
+
+/******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Compile-time profile. */
+typedef struct
+{
+    const char *ssid;
+    const char *password;
+    cy_wcm_security_t security;
+} wifi_profile_config_t;
+
+/* Profiles after the primary one; the last entry terminates the list. */
+static const wifi_profile_config_t wifi_extra_profiles[] =
+{
+    WIFI_EXTRA_PROFILES
+    { NULL, NULL, CY_WCM_SECURITY_OPEN }
+};
+
+static wifi_profile_t wifi_profiles[WIFI_MAX_PROFILES];
+static uint32_t wifi_profile_count;
+static uint32_t wifi_last_good;
+static SemaphoreHandle_t wifi_scan_done;
+
+/******************************************************************************
+ * Function Name: wifi_profiles_set
+ ******************************************************************************
+ * Summary:
+ *  Sets the credentials of a profile. The history is cleared if the SSID
+ *  changes.
+ *
+ * Parameters:
+ *  wifi_profile_t *profile : Profile
+ *  const char *ssid : SSID
+ *  const char *password : Password
+ *  cy_wcm_security_t security : Security type
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void wifi_profiles_set(wifi_profile_t *profile, const char *ssid, const char *password,
+                              cy_wcm_security_t security)
+{
+    if (0 != strncmp(profile->ssid, ssid, sizeof(profile->ssid)))
+    {
+        memset(profile, 0, sizeof(*profile));
+        strncpy(profile->ssid, ssid, sizeof(profile->ssid) - 1U);
+    }
+    strncpy(profile->password, password, sizeof(profile->password) - 1U);
+    profile->password[sizeof(profile->password) - 1U] = '\0';
+    profile->security = security;
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_load_primary
+ ******************************************************************************
+ * Summary:
+ *  Refreshes the primary profile from the configuration store, which
+ *  defaults to WIFI_SSID and WIFI_PASSWORD.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void wifi_profiles_load_primary(void)
+{
+    char ssid[CY_WCM_MAX_SSID_LEN + 1];
+    char password[CY_WCM_MAX_PASSPHRASE_LEN + 1];
+
+    config_store_get_string(CONFIG_KEY_WIFI_SSID, ssid, sizeof(ssid), WIFI_SSID);
+    config_store_get_string(CONFIG_KEY_WIFI_PASSWORD, password, sizeof(password), WIFI_PASSWORD);
+    wifi_profiles_set(&wifi_profiles[0], ssid, password, WIFI_SECURITY);
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_init
+ ******************************************************************************
+ * Summary:
+ *  Builds the profile list: the primary network followed by
+ *  WIFI_EXTRA_PROFILES, up to WIFI_MAX_PROFILES.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void wifi_profiles_init(void)
+{
+    const wifi_profile_config_t *config;
+
+    if (NULL == wifi_scan_done)
+    {
+        wifi_scan_done = xSemaphoreCreateBinary();
+    }
+
+    memset(wifi_profiles, 0, sizeof(wifi_profiles));
+    wifi_profiles_load_primary();
+    wifi_profile_count = 1U;
+    wifi_last_good = 0U;
+
+    for (config = wifi_extra_profiles; (NULL != config->ssid) && (wifi_profile_count < WIFI_MAX_PROFILES);
+         config++)
+    {
+        wifi_profiles_set(&wifi_profiles[wifi_profile_count], config->ssid, config->password,
+                          config->security);
+        wifi_profile_count++;
+    }
+
+    printf("\nWi-Fi: %lu network profile(s) configured.\n", (unsigned long)wifi_profile_count);
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_score
+ ******************************************************************************
+ * Summary:
+ *  Scores a profile seen in the last scan: its RSSI, lowered by recent
+ *  failures and by slow connections.
+ *
+ * Parameters:
+ *  const wifi_profile_t *profile : Profile
+ *
+ * Return:
+ *  int32_t : Score in dB; higher is better
+ *
+ ******************************************************************************/
+static int32_t wifi_profiles_score(const wifi_profile_t *profile)
+{
+    return (int32_t)profile->rssi -
+           ((int32_t)profile->consecutive_failures * WIFI_PROFILE_FAILURE_PENALTY_DB) -
+           (int32_t)(profile->avg_connect_ms / WIFI_PROFILE_LATENCY_MS_PER_DB);
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_rank
+ ******************************************************************************
+ * Summary:
+ *  Orders the profiles for connection: profiles seen in the last scan by
+ *  descending score, then the others (e.g. hidden networks) in list order.
+ *  Depends only on its arguments, so it can be fed simulated scan results.
+ *
+ * Parameters:
+ *  const wifi_profile_t *profiles : Profiles
+ *  uint32_t count : Number of profiles
+ *  uint8_t *order : Indices of the profiles in connection order; set
+ *
+ * Return:
+ *  uint32_t : Number of entries written to 'order'
+ *
+ ******************************************************************************/
+uint32_t wifi_profiles_rank(const wifi_profile_t *profiles, uint32_t count, uint8_t *order)
+{
+    uint32_t seen_count = 0U;
+    uint32_t n = 0U;
+    uint32_t j;
+    uint8_t index;
+
+    /* Insertion sort of the seen profiles; the list is short. */
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (!profiles[i].seen)
+        {
+            continue;
+        }
+
+        for (j = seen_count; (j > 0U) &&
+             (wifi_profiles_score(&profiles[order[j - 1U]]) < wifi_profiles_score(&profiles[i])); j--)
+        {
+            order[j] = order[j - 1U];
+        }
+        order[j] = (uint8_t)i;
+        seen_count++;
+    }
+
+    n = seen_count;
+    for (index = 0U; index < count; index++)
+    {
+        if (!profiles[index].seen)
+        {
+            order[n++] = index;
+        }
+    }
+
+    return n;
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_scan_callback
+ ******************************************************************************
+ * Summary:
+ *  Scan result callback. Records the strongest access point of every
+ *  profile.
+ *
+ * Parameters:
+ *  cy_wcm_scan_result_t *result_ptr : Scan result
+ *  void *user_data : Unused
+ *  cy_wcm_scan_status_t status : Scan status
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void wifi_profiles_scan_callback(cy_wcm_scan_result_t *result_ptr, void *user_data,
+                                        cy_wcm_scan_status_t status)
+{
+    wifi_profile_t *profile;
+
+    CY_UNUSED_PARAMETER(user_data);
+
+    if (CY_WCM_SCAN_COMPLETE == status)
+    {
+        xSemaphoreGive(wifi_scan_done);
+        return;
+    }
+
+    for (uint32_t i = 0U; (NULL != result_ptr) && (i < wifi_profile_count); i++)
+    {
+        profile = &wifi_profiles[i];
+        if ((0 == strncmp(profile->ssid, (const char *)result_ptr->SSID, sizeof(profile->ssid))) &&
+            (!profile->seen || (result_ptr->signal_strength > profile->rssi)))
+        {
+            profile->seen = true;
+            profile->rssi = result_ptr->signal_strength;
+            memcpy(profile->bssid, result_ptr->BSSID, sizeof(profile->bssid));
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_scan
+ ******************************************************************************
+ * Summary:
+ *  Runs one scan of all channels and updates the RSSI of every profile.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if the scan completed
+ *
+ ******************************************************************************/
+static bool wifi_profiles_scan(void)
+{
+    for (uint32_t i = 0U; i < wifi_profile_count; i++)
+    {
+        wifi_profiles[i].seen = false;
+    }
+
+    (void) xSemaphoreTake(wifi_scan_done, 0U);
+    if (CY_RSLT_SUCCESS != cy_wcm_start_scan(wifi_profiles_scan_callback, NULL, NULL))
+    {
+        return false;
+    }
+
+    if (pdTRUE != xSemaphoreTake(wifi_scan_done, pdMS_TO_TICKS(WIFI_SCAN_TIMEOUT_MS)))
+    {
+        (void) cy_wcm_stop_scan();
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_join
+ ******************************************************************************
+ * Summary:
+ *  Connects to the network of a profile, to its strongest access point if
+ *  it was seen in the last scan, and updates the history of the profile.
+ *
+ * Parameters:
+ *  uint32_t index : Index of the profile
+ *  cy_wcm_ip_address_t *ip_address : Assigned IP address; set on success
+ *
+ * Return:
+ *  cy_rslt_t : Result of cy_wcm_connect_ap()
+ *
+ ******************************************************************************/
+static cy_rslt_t wifi_profiles_join(uint32_t index, cy_wcm_ip_address_t *ip_address)
+{
+    wifi_profile_t *profile = &wifi_profiles[index];
+    cy_wcm_connect_params_t connect_param;
+    TickType_t start;
+    uint32_t elapsed_ms;
+    cy_rslt_t result;
+
+    memset(&connect_param, 0, sizeof(connect_param));
+    memcpy(connect_param.ap_credentials.SSID, profile->ssid, sizeof(profile->ssid));
+    memcpy(connect_param.ap_credentials.password, profile->password,
+           sizeof(connect_param.ap_credentials.password));
+    connect_param.ap_credentials.security = profile->security;
+    if (profile->seen)
+    {
+        memcpy(connect_param.BSSID, profile->bssid, sizeof(connect_param.BSSID));
+        printf("\nWi-Fi Connecting to '%s' (RSSI %d dBm)\n", profile->ssid, (int)profile->rssi);
+    }
+    else
+    {
+        printf("\nWi-Fi Connecting to '%s' (not seen in scan)\n", profile->ssid);
+    }
+
+    start = xTaskGetTickCount();
+    result = cy_wcm_connect_ap(&connect_param, ip_address);
+    elapsed_ms = (uint32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        profile->avg_connect_ms = (0U == profile->successes) ? elapsed_ms :
+                                  (((3U * profile->avg_connect_ms) + elapsed_ms) / 4U);
+        profile->successes++;
+        profile->consecutive_failures = 0U;
+        wifi_last_good = index;
+        printf("Wi-Fi: Joined '%s' in %lu ms (%lu/%lu successful)\n", profile->ssid,
+               (unsigned long)elapsed_ms, (unsigned long)profile->successes,
+               (unsigned long)(profile->successes + profile->failures));
+    }
+    else
+    {
+        profile->failures++;
+        profile->consecutive_failures++;
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_expected_ms
+ ******************************************************************************
+ * Summary:
+ *  Expected time to join a profile that joined before: its average connect
+ *  time plus, per success, the failed attempts of its history.
+ *
+ * Parameters:
+ *  const wifi_profile_t *profile : Profile with at least one success
+ *
+ * Return:
+ *  uint32_t : Expected time to join in milliseconds
+ *
+ ******************************************************************************/
+static uint32_t wifi_profiles_expected_ms(const wifi_profile_t *profile)
+{
+    return profile->avg_connect_ms +
+           (uint32_t)(((uint64_t)profile->failures * WIFI_PROFILE_FAILED_JOIN_MS) / profile->successes);
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_rank_history
+ ******************************************************************************
+ * Summary:
+ *  Orders the profiles for a connection without a scan: those that joined
+ *  before by ascending expected time to join, the last joined one first on
+ *  a tie, then the others in list order. Without history this is list
+ *  order.
+ *
+ * Parameters:
+ *  uint8_t *order : Indices of the profiles in connection order; set
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void wifi_profiles_rank_history(uint8_t *order)
+{
+    uint32_t joined_count = 0U;
+    uint32_t n;
+    uint32_t j;
+    uint32_t expected_ms;
+    uint32_t other_ms;
+
+    /* Insertion sort of the profiles with history; the list is short. */
+    for (uint32_t i = 0U; i < wifi_profile_count; i++)
+    {
+        if (0U == wifi_profiles[i].successes)
+        {
+            continue;
+        }
+
+        expected_ms = wifi_profiles_expected_ms(&wifi_profiles[i]);
+        for (j = joined_count; j > 0U; j--)
+        {
+            other_ms = wifi_profiles_expected_ms(&wifi_profiles[order[j - 1U]]);
+            if ((expected_ms > other_ms) || ((expected_ms == other_ms) && (i != wifi_last_good)))
+            {
+                break;
+            }
+            order[j] = order[j - 1U];
+        }
+        order[j] = (uint8_t)i;
+        joined_count++;
+    }
+
+    n = joined_count;
+    for (uint32_t i = 0U; i < wifi_profile_count; i++)
+    {
+        if (0U == wifi_profiles[i].successes)
+        {
+            order[n++] = (uint8_t)i;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_connect
+ ******************************************************************************
+ * Summary:
+ *  Tries the profiles by their history, the best known network first and
+ *  without a scan, so that it is never slower than list order. If none
+ *  connects, scans once and retries the profiles seen, ranked by RSSI and
+ *  history, on their strongest access point.
+ *
+ * Parameters:
+ *  cy_wcm_ip_address_t *ip_address : Assigned IP address; set on success
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if a network was joined, else the error of
+ *              the last attempt
+ *
+ ******************************************************************************/
+cy_rslt_t wifi_profiles_connect(cy_wcm_ip_address_t *ip_address)
+{
+    uint8_t order[WIFI_MAX_PROFILES];
+    uint32_t count;
+    cy_rslt_t result = ~CY_RSLT_SUCCESS;
+
+    wifi_profiles_load_primary();
+
+    /* The last scan may be stale: join by SSID, not by BSSID. */
+    for (uint32_t i = 0U; i < wifi_profile_count; i++)
+    {
+        wifi_profiles[i].seen = false;
+    }
+
+    wifi_profiles_rank_history(order);
+    for (uint32_t i = 0U; (i < wifi_profile_count) && (CY_RSLT_SUCCESS != result); i++)
+    {
+        result = wifi_profiles_join(order[i], ip_address);
+    }
+
+    if ((CY_RSLT_SUCCESS == result) || !wifi_profiles_scan())
+    {
+        return result;
+    }
+
+    count = wifi_profiles_rank(wifi_profiles, wifi_profile_count, order);
+    for (uint32_t i = 0U; (i < count) && wifi_profiles[order[i]].seen && (CY_RSLT_SUCCESS != result); i++)
+    {
+        result = wifi_profiles_join(order[i], ip_address);
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: wifi_profiles_check_roam
+ ******************************************************************************
+ * Summary:
+ *  Checks the RSSI of the associated access point. Below
+ *  WIFI_ROAM_RSSI_THRESHOLD_DBM it scans and, if the best ranked access
+ *  point is at least WIFI_ROAM_HYSTERESIS_DB stronger, moves to it before
+ *  the link drops.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if the client left the access point
+ *
+ ******************************************************************************/
+bool wifi_profiles_check_roam(void)
+{
+    cy_wcm_associated_ap_info_t ap_info;
+    cy_wcm_ip_address_t ip_address;
+    uint8_t order[WIFI_MAX_PROFILES];
+    const wifi_profile_t *best;
+    uint32_t count;
+
+    if ((0U == cy_wcm_is_connected_to_ap()) ||
+        (CY_RSLT_SUCCESS != cy_wcm_get_associated_ap_info(&ap_info)) ||
+        (ap_info.signal_strength >= WIFI_ROAM_RSSI_THRESHOLD_DBM))
+    {
+        return false;
+    }
+
+    if (!wifi_profiles_scan())
+    {
+        return false;
+    }
+
+    count = wifi_profiles_rank(wifi_profiles, wifi_profile_count, order);
+    best = &wifi_profiles[order[0]];
+    if ((0U == count) || !best->seen ||
+        (best->rssi < (ap_info.signal_strength + WIFI_ROAM_HYSTERESIS_DB)) ||
+        (0 == memcmp(best->bssid, ap_info.BSSID, sizeof(best->bssid))))
+    {
+        printf("Wi-Fi: RSSI %d dBm, no stronger access point.\n", (int)ap_info.signal_strength);
+        return false;
+    }
+
+    printf("\nWi-Fi: Roaming from RSSI %d dBm to '%s' (RSSI %d dBm)\n",
+           (int)ap_info.signal_strength, best->ssid, (int)best->rssi);
+    (void) cy_wcm_disconnect_ap();
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (CY_RSLT_SUCCESS == wifi_profiles_join(order[i], &ip_address))
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
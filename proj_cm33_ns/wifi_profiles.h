@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   wifi_profiles.h
+*
+* Description: This file is the public interface of wifi_profiles.c, which
+*              selects the Wi-Fi network to join from a list of profiles and
+*              roams between access points.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WIFI_PROFILES_H_
+#define WIFI_PROFILES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_wcm.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Wi-Fi network profile with its connection history and last scan result. */
+typedef struct
+{
+    char ssid[CY_WCM_MAX_SSID_LEN + 1];
+    char password[CY_WCM_MAX_PASSPHRASE_LEN + 1];
+    cy_wcm_security_t security;
+
+    uint32_t successes;
+    uint32_t failures;
+    uint32_t consecutive_failures;
+    uint32_t avg_connect_ms;
+
+    bool seen;
+    int16_t rssi;
+    cy_wcm_mac_t bssid;
+} wifi_profile_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void wifi_profiles_init(void);
+uint32_t wifi_profiles_rank(const wifi_profile_t *profiles, uint32_t count, uint8_t *order);
+cy_rslt_t wifi_profiles_connect(cy_wcm_ip_address_t *ip_address);
+bool wifi_profiles_check_roam(void);
+
+#endif /* WIFI_PROFILES_H_ */
+
+/* [] END OF FILE */
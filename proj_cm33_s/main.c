@@ -45,6 +45,7 @@
 
 #include "cy_pdl.h"
 #include "cybsp.h"
+#include "secure_sign.h"
 
 /*****************************************************************************
 * Macros
@@ -88,6 +89,9 @@ int main(void)
     /* Enable global interrupts */
     __enable_irq();
 
+    /* Load the provisioned keys before the non-secure image can ask for them. */
+    secure_sign_init();
+
     ns_stack = (uint32_t)(*((uint32_t*)CM33_NS_APP_BOOT_ADDR));
     __TZ_set_MSP_NS(ns_stack);
     
@@ -0,0 +1,108 @@
+/******************************************************************************
+* File Name:   secure_sign.h
+*
+* Description: This file is the interface of the secure signing service
+*              shared by the secure and the non-secure CM33 projects. The
+*              service holds the client private key in the secure world and
+*              signs hashes for the non-secure world through NSC veneers.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SECURE_SIGN_H_
+#define SECURE_SIGN_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Identifiers of the keys provisioned in secure_sign_keys.h. */
+#define SECURE_SIGN_KEY_MQTT_CLIENT         (0U)
+#define SECURE_SIGN_KEY_COUNT               (1U)
+
+/* Handle value that never refers to an open key. */
+#define SECURE_SIGN_INVALID_HANDLE          (0U)
+
+/* Maximum number of signatures computed by one secure call. */
+#define SECURE_SIGN_MAX_BATCH               (4U)
+
+/* Sizes for ECDSA P-256 with SHA-256: the hash, the DER-encoded signature
+ * and the uncompressed public key.
+ */
+#define SECURE_SIGN_HASH_SIZE               (32U)
+#define SECURE_SIGN_SIGNATURE_MAX_SIZE      (72U)
+#define SECURE_SIGN_PUBLIC_KEY_SIZE         (65U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Results of the secure signing service. */
+typedef enum
+{
+    SECURE_SIGN_SUCCESS = 0,
+    SECURE_SIGN_ERR_BAD_ARGUMENT,
+    SECURE_SIGN_ERR_NOT_PROVISIONED,
+    SECURE_SIGN_ERR_BAD_HANDLE,
+    SECURE_SIGN_ERR_CRYPTO
+} secure_sign_status_t;
+
+/* One signing request of a batch. Buffers are inline so that the whole batch
+ * is validated and copied into the secure world in one piece.
+ */
+typedef struct
+{
+    uint32_t handle;
+    uint8_t hash[SECURE_SIGN_HASH_SIZE];
+    uint8_t signature[SECURE_SIGN_SIGNATURE_MAX_SIZE];
+    uint32_t signature_len;
+    uint32_t status;
+} secure_sign_request_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Secure world only. */
+void secure_sign_init(void);
+
+/* Non-secure callable; linked into the non-secure image from nsc_veneer.o. */
+uint32_t secure_sign_open(uint32_t key_id, uint32_t *handle);
+uint32_t secure_sign_public_key(uint32_t handle, uint8_t *public_key, uint32_t size, uint32_t *length);
+uint32_t secure_sign_batch(secure_sign_request_t *requests, uint32_t count);
+
+#endif /* SECURE_SIGN_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,343 @@
+/******************************************************************************
+* File Name:   secure_sign.c
+*
+* Description: This file contains the secure signing service. It parses the
+*              provisioned private keys once at boot, keeps them in secure
+*              memory and exposes open, public key and batched sign
+*              operations to the non-secure world as NSC veneers.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include <arm_cmse.h>
+
+#include "mbedtls/ecp.h"
+#include "mbedtls/hmac_drbg.h"
+#include "mbedtls/md.h"
+#include "mbedtls/memory_buffer_alloc.h"
+#include "mbedtls/pk.h"
+
+#include "secure_sign.h"
+#include "secure_sign_keys.h"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Static heap of mbedTLS. Parsing and signing with one P-256 key peak at
+ * about 3 KB with a window size of 2.
+ */
+#define SECURE_SIGN_HEAP_SIZE               (6U * 1024U)
+
+/* Access the non-secure caller must have to every buffer passed in. */
+#define SECURE_SIGN_NS_READWRITE            (CMSE_NONSECURE | CMSE_MPU_READWRITE)
+
+/* Entry points callable from the non-secure world. */
+#define SECURE_SIGN_NSC                     __attribute__((cmse_nonsecure_entry))
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Provisioned keys, indexed by SECURE_SIGN_KEY_*. */
+static const struct
+{
+    const char *pem;
+    size_t size;
+} secure_sign_key_source[SECURE_SIGN_KEY_COUNT] =
+{
+    { SECURE_SIGN_MQTT_CLIENT_PRIVATE_KEY, sizeof(SECURE_SIGN_MQTT_CLIENT_PRIVATE_KEY) }
+};
+
+/* Keys parsed at boot; a handle is the key index plus one. */
+static mbedtls_pk_context secure_sign_keys[SECURE_SIGN_KEY_COUNT];
+static bool secure_sign_key_loaded[SECURE_SIGN_KEY_COUNT];
+
+static uint8_t secure_sign_heap[SECURE_SIGN_HEAP_SIZE] __attribute__((aligned(8)));
+
+/* Mixed into the blinding seed so no two signatures share it. */
+static uint32_t secure_sign_counter;
+
+/******************************************************************************
+* Function Name: secure_sign_key_from_handle
+******************************************************************************
+* Summary:
+*  Looks up the parsed key of a handle returned by secure_sign_open().
+*
+* Parameters:
+*  uint32_t handle : Key handle
+*
+* Return:
+*  mbedtls_pk_context * : The key, or NULL if the handle is not open
+*
+******************************************************************************/
+static mbedtls_pk_context *secure_sign_key_from_handle(uint32_t handle)
+{
+    if ((SECURE_SIGN_INVALID_HANDLE == handle) || (handle > SECURE_SIGN_KEY_COUNT) ||
+        !secure_sign_key_loaded[handle - 1U])
+    {
+        return NULL;
+    }
+
+    return &secure_sign_keys[handle - 1U];
+}
+
+/******************************************************************************
+* Function Name: secure_sign_hash
+******************************************************************************
+* Summary:
+*  Signs one SHA-256 hash with ECDSA. The nonce is derived from the key and
+*  the hash (RFC 6979); the blinding of the scalar multiplication is seeded
+*  from the hash and a counter, as the secure world has no entropy source.
+*
+* Parameters:
+*  mbedtls_pk_context *key : Private key
+*  secure_sign_request_t *request : Request in secure memory; the signature,
+*                                   its length and the status are written
+*
+* Return:
+*  void
+*
+******************************************************************************/
+static void secure_sign_hash(mbedtls_pk_context *key, secure_sign_request_t *request)
+{
+    mbedtls_hmac_drbg_context blinding;
+    uint8_t seed[SECURE_SIGN_HASH_SIZE + sizeof(secure_sign_counter)];
+    size_t length = 0;
+    int ret;
+
+    memcpy(seed, request->hash, SECURE_SIGN_HASH_SIZE);
+    memcpy(&seed[SECURE_SIGN_HASH_SIZE], &secure_sign_counter, sizeof(secure_sign_counter));
+    secure_sign_counter++;
+
+    mbedtls_hmac_drbg_init(&blinding);
+    ret = mbedtls_hmac_drbg_seed_buf(&blinding, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                                     seed, sizeof(seed));
+    if (0 == ret)
+    {
+        ret = mbedtls_pk_sign(key, MBEDTLS_MD_SHA256, request->hash, SECURE_SIGN_HASH_SIZE,
+                              request->signature, sizeof(request->signature), &length,
+                              mbedtls_hmac_drbg_random, &blinding);
+    }
+    mbedtls_hmac_drbg_free(&blinding);
+
+    request->signature_len = (0 == ret) ? (uint32_t)length : 0U;
+    request->status = (0 == ret) ? SECURE_SIGN_SUCCESS : SECURE_SIGN_ERR_CRYPTO;
+}
+
+/******************************************************************************
+* Function Name: secure_sign_init
+******************************************************************************
+* Summary:
+*  Sets up the static mbedTLS heap and parses every provisioned key once.
+*  Keys that are empty, malformed or not EC P-256 stay unavailable. Must run
+*  before the non-secure image is started.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+******************************************************************************/
+void secure_sign_init(void)
+{
+    mbedtls_memory_buffer_alloc_init(secure_sign_heap, sizeof(secure_sign_heap));
+
+    for (uint32_t i = 0; i < SECURE_SIGN_KEY_COUNT; i++)
+    {
+        mbedtls_pk_init(&secure_sign_keys[i]);
+        secure_sign_key_loaded[i] = false;
+
+        /* An empty PEM string is just its terminating NUL. */
+        if (secure_sign_key_source[i].size <= 1U)
+        {
+            continue;
+        }
+
+        if ((0 == mbedtls_pk_parse_key(&secure_sign_keys[i],
+                                       (const unsigned char *)secure_sign_key_source[i].pem,
+                                       secure_sign_key_source[i].size, NULL, 0, NULL, NULL)) &&
+            mbedtls_pk_can_do(&secure_sign_keys[i], MBEDTLS_PK_ECDSA) &&
+            (256U == mbedtls_pk_get_bitlen(&secure_sign_keys[i])))
+        {
+            secure_sign_key_loaded[i] = true;
+        }
+        else
+        {
+            mbedtls_pk_free(&secure_sign_keys[i]);
+        }
+    }
+}
+
+/******************************************************************************
+* Function Name: secure_sign_open
+******************************************************************************
+* Summary:
+*  Non-secure callable. Returns the handle of a provisioned key. The key was
+*  parsed at boot, so this is a lookup; callers cache the handle.
+*
+* Parameters:
+*  uint32_t key_id : SECURE_SIGN_KEY_* identifier
+*  uint32_t *handle : Non-secure location receiving the handle
+*
+* Return:
+*  uint32_t : secure_sign_status_t
+*
+******************************************************************************/
+uint32_t SECURE_SIGN_NSC secure_sign_open(uint32_t key_id, uint32_t *handle)
+{
+    handle = cmse_check_address_range(handle, sizeof(*handle), SECURE_SIGN_NS_READWRITE);
+    if ((NULL == handle) || (key_id >= SECURE_SIGN_KEY_COUNT))
+    {
+        return SECURE_SIGN_ERR_BAD_ARGUMENT;
+    }
+
+    if (!secure_sign_key_loaded[key_id])
+    {
+        *handle = SECURE_SIGN_INVALID_HANDLE;
+        return SECURE_SIGN_ERR_NOT_PROVISIONED;
+    }
+
+    *handle = key_id + 1U;
+    return SECURE_SIGN_SUCCESS;
+}
+
+/******************************************************************************
+* Function Name: secure_sign_public_key
+******************************************************************************
+* Summary:
+*  Non-secure callable. Exports the public half of a key as an uncompressed
+*  EC point, e.g. to check it against the client certificate.
+*
+* Parameters:
+*  uint32_t handle : Key handle
+*  uint8_t *public_key : Non-secure output buffer
+*  uint32_t size : Size of the output buffer
+*  uint32_t *length : Non-secure location receiving the written length
+*
+* Return:
+*  uint32_t : secure_sign_status_t
+*
+******************************************************************************/
+uint32_t SECURE_SIGN_NSC secure_sign_public_key(uint32_t handle, uint8_t *public_key, uint32_t size,
+                                               uint32_t *length)
+{
+    uint8_t point[SECURE_SIGN_PUBLIC_KEY_SIZE];
+    mbedtls_pk_context *key = secure_sign_key_from_handle(handle);
+    size_t written = 0;
+
+    public_key = cmse_check_address_range(public_key, size, SECURE_SIGN_NS_READWRITE);
+    length = cmse_check_address_range(length, sizeof(*length), SECURE_SIGN_NS_READWRITE);
+    if ((NULL == public_key) || (NULL == length) || (size < sizeof(point)))
+    {
+        return SECURE_SIGN_ERR_BAD_ARGUMENT;
+    }
+    if (NULL == key)
+    {
+        return SECURE_SIGN_ERR_BAD_HANDLE;
+    }
+
+    if (0 != mbedtls_ecp_write_public_key(mbedtls_pk_ec(*key), MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                          &written, point, sizeof(point)))
+    {
+        return SECURE_SIGN_ERR_CRYPTO;
+    }
+
+    memcpy(public_key, point, written);
+    *length = (uint32_t)written;
+    return SECURE_SIGN_SUCCESS;
+}
+
+/******************************************************************************
+* Function Name: secure_sign_batch
+******************************************************************************
+* Summary:
+*  Non-secure callable. Signs up to SECURE_SIGN_MAX_BATCH hashes in one
+*  secure call. The batch is copied into secure memory before it is used, so
+*  the non-secure side cannot change a request while it is processed. Each
+*  request receives its own status.
+*
+* Parameters:
+*  secure_sign_request_t *requests : Non-secure array of requests
+*  uint32_t count : Number of requests
+*
+* Return:
+*  uint32_t : SECURE_SIGN_SUCCESS if every request was signed, else the
+*             status of the first failure
+*
+******************************************************************************/
+uint32_t SECURE_SIGN_NSC secure_sign_batch(secure_sign_request_t *requests, uint32_t count)
+{
+    secure_sign_request_t batch[SECURE_SIGN_MAX_BATCH];
+    mbedtls_pk_context *key;
+    uint32_t result = SECURE_SIGN_SUCCESS;
+
+    if ((0U == count) || (count > SECURE_SIGN_MAX_BATCH))
+    {
+        return SECURE_SIGN_ERR_BAD_ARGUMENT;
+    }
+    requests = cmse_check_address_range(requests, count * sizeof(*requests), SECURE_SIGN_NS_READWRITE);
+    if (NULL == requests)
+    {
+        return SECURE_SIGN_ERR_BAD_ARGUMENT;
+    }
+
+    memcpy(batch, requests, count * sizeof(*requests));
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        key = secure_sign_key_from_handle(batch[i].handle);
+        if (NULL == key)
+        {
+            batch[i].signature_len = 0U;
+            batch[i].status = SECURE_SIGN_ERR_BAD_HANDLE;
+        }
+        else
+        {
+            secure_sign_hash(key, &batch[i]);
+        }
+
+        if ((SECURE_SIGN_SUCCESS == result) && (SECURE_SIGN_SUCCESS != batch[i].status))
+        {
+            result = batch[i].status;
+        }
+    }
+
+    memcpy(requests, batch, count * sizeof(*requests));
+    return result;
+}
+
+/* [] END OF FILE */
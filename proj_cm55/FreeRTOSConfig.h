@@ -192,9 +192,12 @@ standard names - or at least those used in the unmodified vector table. */
  * The Low Power Assistant library provides additional portable configuration layer
  * for low-power features supported by the PSoC 6 devices:
  * https://github.com/Infineon/lpa
+ * cm55_residency_sleep() wraps it to account the time spent in each
+ * power mode for the CM33 power profiler.
  */
 extern void vApplicationSleep( uint32_t xExpectedIdleTime );
-#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) vApplicationSleep( xIdleTime )
+extern void cm55_residency_sleep( uint32_t expected_idle_ticks );
+#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) cm55_residency_sleep( xIdleTime )
 #define configUSE_TICKLESS_IDLE                 2
 
 #else
@@ -0,0 +1,203 @@
+/******************************************************************************
+* File Name:   cm55_residency.c
+*
+* Description: This file contains the power mode residency accounting of the
+*              CM55. It wraps the tickless idle hook and publishes the time
+*              spent in CPU sleep and deep sleep in shared memory for the
+*              CM33.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "cm55_residency.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Order of the SysPm callback; it only observes the transition. */
+#define CM55_RESIDENCY_SYSPM_ORDER          (255U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Record read by the CM33, in its own cache line so that cleaning it does not
+ * touch other data.
+ */
+CY_SECTION_SHAREDMEM static cm55_residency_t cm55_residency __attribute__((aligned(32)));
+
+/* Set by the SysPm callback when the CPU has been in deep sleep. */
+static volatile bool cm55_deepsleep_entered;
+
+/*******************************************************************************
+* Function Name: cm55_residency_syspm_callback
+********************************************************************************
+* Summary:
+*  Notes a wake-up from deep sleep, to tell it from a CPU sleep.
+*
+* Parameters:
+*  cy_stc_syspm_callback_params_t *params : Callback parameters (unused)
+*  cy_en_syspm_callback_mode_t mode : Callback mode
+*
+* Return:
+*  cy_en_syspm_status_t : CY_SYSPM_SUCCESS
+*
+*******************************************************************************/
+static cy_en_syspm_status_t cm55_residency_syspm_callback(cy_stc_syspm_callback_params_t *params,
+                                                          cy_en_syspm_callback_mode_t mode)
+{
+    CY_UNUSED_PARAMETER(params);
+
+    if (CY_SYSPM_AFTER_TRANSITION == mode)
+    {
+        cm55_deepsleep_entered = true;
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+static cy_stc_syspm_callback_params_t cm55_residency_syspm_params =
+{
+    .context            = NULL,
+    .base               = NULL
+};
+
+static cy_stc_syspm_callback_t cm55_residency_syspm_cb =
+{
+    .callback           = &cm55_residency_syspm_callback,
+    .skipMode           = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                          CY_SYSPM_SKIP_BEFORE_TRANSITION,
+    .type               = CY_SYSPM_DEEPSLEEP,
+    .callbackParams     = &cm55_residency_syspm_params,
+    .prevItm            = NULL,
+    .nextItm            = NULL,
+    .order              = CM55_RESIDENCY_SYSPM_ORDER
+};
+
+/*******************************************************************************
+* Function Name: cm55_residency_publish
+********************************************************************************
+* Summary:
+*  Writes the record back from the data cache, so that the CM33 sees it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void cm55_residency_publish(void)
+{
+    __DMB();
+    SCB_CleanDCache_by_Addr((void *)&cm55_residency, (int32_t)sizeof(cm55_residency));
+}
+
+/*******************************************************************************
+* Function Name: cm55_residency_init
+********************************************************************************
+* Summary:
+*  Clears the record and registers the deep sleep callback. Called before
+*  the scheduler starts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void cm55_residency_init(void)
+{
+    memset(&cm55_residency, 0, sizeof(cm55_residency));
+    cm55_residency.magic = CM55_RESIDENCY_MAGIC;
+    cm55_residency_publish();
+
+    Cy_SysPm_RegisterCallback(&cm55_residency_syspm_cb);
+}
+
+/*******************************************************************************
+* Function Name: cm55_residency_sleep
+********************************************************************************
+* Summary:
+*  Tickless idle hook (portSUPPRESS_TICKS_AND_SLEEP in FreeRTOSConfig.h).
+*  Sleeps through vApplicationSleep() of the RTOS abstraction library, which
+*  steps the tick count by the time slept, and charges that time to CPU
+*  sleep or deep sleep.
+*
+* Parameters:
+*  uint32_t expected_idle_ticks : Ticks until the next task is due
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void cm55_residency_sleep(uint32_t expected_idle_ticks)
+{
+    TickType_t start = xTaskGetTickCount();
+    uint32_t slept_ms;
+
+    cm55_deepsleep_entered = false;
+    vApplicationSleep(expected_idle_ticks);
+    slept_ms = (uint32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+
+    cm55_residency.sequence++;
+    cm55_residency_publish();
+
+    if (cm55_deepsleep_entered)
+    {
+        cm55_residency.deepsleep_ms += slept_ms;
+    }
+    else
+    {
+        cm55_residency.sleep_ms += slept_ms;
+    }
+    if (0U != slept_ms)
+    {
+        cm55_residency.wakeups++;
+    }
+    cm55_residency.uptime_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    __DMB();
+    cm55_residency.sequence++;
+    cm55_residency_publish();
+}
+
+/* [] END OF FILE */
@@ -43,6 +43,7 @@
 #include "cyabs_rtos.h"
 #include "cyabs_rtos_impl.h"
 #include "cy_time.h"
+#include "cm55_residency.h"
 /*****************************************************************************
  * Macros
  *****************************************************************************/
@@ -253,6 +254,9 @@ int main(void)
     /* Setup the LPTimer instance for CM55*/
     setup_tickless_idle_timer();
 
+    /* Start the power mode residency record read by the CM33 */
+    cm55_residency_init();
+
     /* Enable global interrupts */
     __enable_irq();
 
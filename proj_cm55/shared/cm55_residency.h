@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   cm55_residency.h
+*
+* Description: This file describes the power mode residency record that the
+*              CM55 keeps in its shared memory for the CM33 power profiler.
+*              It is shared by the CM55 and CM33 projects.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CM55_RESIDENCY_H_
+#define CM55_RESIDENCY_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Marks a record written by the running CM55 image. */
+#define CM55_RESIDENCY_MAGIC                (0x35354D43UL)   /* "CM55" */
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Residency record. It is the only object in the shared memory section of
+ * the CM55 (.cy_sharedmem), so it is placed at the start of the
+ * m55_allocatable_shared region, where the CM33 reads it. 'sequence' is odd
+ * while the CM55 updates the record; a reader retries until it reads the
+ * same even value before and after the other fields.
+ */
+typedef struct
+{
+    uint32_t magic;
+    volatile uint32_t sequence;
+    uint32_t uptime_ms;
+    uint32_t sleep_ms;
+    uint32_t deepsleep_ms;
+    uint32_t wakeups;
+} cm55_residency_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+void cm55_residency_init(void);
+void cm55_residency_sleep(uint32_t expected_idle_ticks);
+
+#endif /* CM55_RESIDENCY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Summarises the "power" section of the device metrics reports.
+
+The device publishes cumulative counters on <telemetry base>/metrics every
+PUBLISH_METRICS_REPORT_INTERVAL_MS. This script takes the differences between
+consecutive reports and prints, per interval and for the whole capture, the
+residency of each CPU per power mode, the wake-up causes, the energy per
+message and the share of the active time taken by each task.
+
+Usage:
+    mosquitto_sub -h <broker> -t '<telemetry base>/metrics' | python3 scripts/power_profile.py
+    python3 scripts/power_profile.py capture.txt
+
+Each input line is either a metrics JSON document or "<topic> <document>"
+as printed by mosquitto_sub -v. The energy is an estimate from the currents
+in power_profiler.c and excludes the Wi-Fi radio.
+"""
+
+import json
+import sys
+
+COUNTER_MODULO = 1 << 32
+
+RESIDENCY_KEYS = ("act", "slp", "ds")
+RESIDENCY_NAMES = {"act": "active", "slp": "sleep", "ds": "deep sleep"}
+
+
+def parse_power(line):
+    """Returns the power section of a report line, or None."""
+    start = line.find("{")
+    if start < 0:
+        return None
+    try:
+        report = json.loads(line[start:])
+    except ValueError:
+        return None
+    return report.get("power")
+
+
+def delta(new, old):
+    """Difference of two 32-bit counters, across a wrap-around."""
+    return (new - old) % COUNTER_MODULO
+
+
+def diff(new, old):
+    """Differences of two power sections, as a section of the same shape."""
+    result = {"up": delta(new["up"], old["up"])}
+    for key in RESIDENCY_KEYS + ("msgs", "uJ"):
+        result[key] = delta(new[key], old[key])
+    result["wake"] = {cause: delta(count, old["wake"].get(cause, 0))
+                      for cause, count in new["wake"].items()}
+    if "m55" in new and "m55" in old:
+        result["m55"] = {key: delta(new["m55"][key], old["m55"][key]) for key in RESIDENCY_KEYS}
+    result["tasks"] = {name: delta(ms, old["tasks"].get(name, 0))
+                       for name, ms in new["tasks"].items()}
+    return result
+
+
+def accumulate(total, interval):
+    """Adds an interval to the running total."""
+    if total is None:
+        return json.loads(json.dumps(interval))
+    for key in ("up",) + RESIDENCY_KEYS + ("msgs", "uJ"):
+        total[key] += interval[key]
+    for group in ("wake", "m55", "tasks"):
+        if group in interval:
+            target = total.setdefault(group, {})
+            for key, value in interval[group].items():
+                target[key] = target.get(key, 0) + value
+    return total
+
+
+def residency(section, up_ms):
+    """Formats the share of each power mode."""
+    return ", ".join("%s %5.1f%%" % (RESIDENCY_NAMES[key], 100.0 * section[key] / up_ms)
+                     for key in RESIDENCY_KEYS)
+
+
+def report(title, interval):
+    """Prints one interval."""
+    up_ms = interval["up"]
+    if 0 == up_ms:
+        return
+    print("%s (%.1f s)" % (title, up_ms / 1000.0))
+    print("  CM33: %s" % residency(interval, up_ms))
+    if "m55" in interval:
+        print("  CM55: %s" % residency(interval["m55"], up_ms))
+    print("  Wake-ups: %s" % ", ".join("%s %d" % item for item in sorted(interval["wake"].items())))
+    if interval["msgs"]:
+        print("  Energy: %d uJ for %d messages, %.0f uJ per message"
+              % (interval["uJ"], interval["msgs"], interval["uJ"] / float(interval["msgs"])))
+    else:
+        print("  Energy: %d uJ, no messages" % interval["uJ"])
+
+    # The idle task is charged with the time slept, so it is left out.
+    busy = {name: ms for name, ms in interval["tasks"].items() if name != "IDLE" and ms}
+    busy_ms = sum(busy.values())
+    if busy_ms:
+        shares = sorted(busy.items(), key=lambda item: item[1], reverse=True)
+        print("  Tasks: %s" % ", ".join("%s %.1f%%" % (name, 100.0 * ms / busy_ms)
+                                         for name, ms in shares))
+
+
+def main():
+    source = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    previous = None
+    total = None
+    count = 0
+
+    for line in source:
+        power = parse_power(line)
+        if power is None:
+            continue
+        # A smaller uptime than before means the device restarted.
+        if previous is not None and power["up"] >= previous["up"]:
+            interval = diff(power, previous)
+            count += 1
+            report("Interval %d" % count, interval)
+            total = accumulate(total, interval)
+        previous = power
+
+    if total is not None and count > 1:
+        report("Total over %d intervals" % count, total)
+
+
+if __name__ == "__main__":
+    main()
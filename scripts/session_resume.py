@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Measures the MQTT reconnect-to-ready time of the device's two reconnection
+paths against a broker, usually a local one.
+
+With MQTT_PERSISTENT_SESSION set to 0 (the default) the device reconnects
+with a clean session and is ready when the SUBACK of its subscriptions
+arrives. With MQTT_PERSISTENT_SESSION set to 1 it resumes the session and is
+ready when the CONNACK arrives. This script runs both sequences from the
+host with the device's individual command topics. For each path it prints
+the time from the start of the TCP connect to ready.
+
+On the resumed path it also checks what the device assumes when it skips
+the subscribe: the CONNACK reports a present session, and a QoS 1 command
+published while the client was offline is delivered without a new subscribe.
+
+Usage:
+    mosquitto -p 1883 &
+    python3 scripts/session_resume.py --host localhost --runs 200
+    python3 scripts/session_resume.py --host <broker> --port 8883 --tls --cafile ca.pem
+
+Only the MQTT 3.1.1 packets the device uses are implemented, so no
+third-party package is needed.
+"""
+
+import argparse
+import socket
+import ssl
+import statistics
+import sys
+import time
+
+DEVICE_ID = "session-resume-test"
+COMMAND_TOPIC_BASE = "device/" + DEVICE_ID + "/commands"
+
+# MQTT_SUB_TOPICS_INDIVIDUAL of mqtt_client_config.h.
+TOPICS = (
+    COMMAND_TOPIC_BASE,
+    COMMAND_TOPIC_BASE + "/config",
+    COMMAND_TOPIC_BASE + "/certificate",
+    COMMAND_TOPIC_BASE + "/firmware",
+    COMMAND_TOPIC_BASE + "/protected_update",
+    COMMAND_TOPIC_BASE + "/check_certificate_response",
+    COMMAND_TOPIC_BASE + "/upload_certificate_response",
+    COMMAND_TOPIC_BASE + "/sync_certificate_response",
+)
+
+CONNECT, CONNACK, PUBLISH, PUBACK, SUBSCRIBE, SUBACK, DISCONNECT = 1, 2, 3, 4, 8, 9, 14
+KEEP_ALIVE_SECONDS = 60
+
+
+def encode_string(text):
+    """UTF-8 string with its 16-bit length."""
+    data = text.encode()
+    return len(data).to_bytes(2, "big") + data
+
+
+def packet(packet_type, flags, body):
+    """Fixed header with the remaining length, followed by the body."""
+    header = bytes([(packet_type << 4) | flags])
+    length = len(body)
+    while True:
+        byte = length % 128
+        length //= 128
+        header += bytes([byte | (0x80 if length else 0)])
+        if not length:
+            return header + body
+
+
+class Client:
+    """Blocking MQTT 3.1.1 client with just enough of the protocol."""
+
+    def __init__(self, args):
+        self.args = args
+        self.sock = None
+        self.buffer = b""
+
+    def open(self):
+        sock = socket.create_connection((self.args.host, self.args.port), timeout=10)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        if self.args.tls:
+            context = ssl.create_default_context(cafile=self.args.cafile)
+            if self.args.insecure:
+                context.check_hostname = False
+                context.verify_mode = ssl.CERT_NONE
+            sock = context.wrap_socket(sock, server_hostname=self.args.host)
+        self.sock = sock
+        self.buffer = b""
+
+    def close(self):
+        if self.sock is not None:
+            self.sock.close()
+            self.sock = None
+
+    def send(self, data):
+        self.sock.sendall(data)
+
+    def read_exact(self, count):
+        while len(self.buffer) < count:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("connection closed by the broker")
+            self.buffer += chunk
+        data, self.buffer = self.buffer[:count], self.buffer[count:]
+        return data
+
+    def receive(self):
+        """Returns the type, flags and body of the next packet."""
+        first = self.read_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            byte = self.read_exact(1)[0]
+            length |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        return first >> 4, first & 0x0F, self.read_exact(length)
+
+    def expect(self, packet_type):
+        """Skips to the next packet of a type, acknowledging QoS 1 publishes."""
+        while True:
+            received, flags, body = self.receive()
+            if received == packet_type:
+                return flags, body
+            if received == PUBLISH and (flags >> 1) & 0x03:
+                topic_length = int.from_bytes(body[:2], "big")
+                self.send(packet(PUBACK, 0, body[2 + topic_length:4 + topic_length]))
+
+    def connect(self, client_id, clean):
+        """Connects and returns the session present flag of the CONNACK."""
+        self.open()
+        body = (encode_string("MQTT") + bytes([4, 0x02 if clean else 0x00]) +
+                KEEP_ALIVE_SECONDS.to_bytes(2, "big") + encode_string(client_id))
+        self.send(packet(CONNECT, 0, body))
+        _, connack = self.expect(CONNACK)
+        if connack[1] != 0:
+            raise ConnectionError("CONNACK return code %d" % connack[1])
+        return bool(connack[0] & 0x01)
+
+    def subscribe(self, packet_id):
+        body = packet_id.to_bytes(2, "big")
+        for topic in TOPICS:
+            body += encode_string(topic) + bytes([1])
+        self.send(packet(SUBSCRIBE, 0x02, body))
+        _, suback = self.expect(SUBACK)
+        if any(code & 0x80 for code in suback[2:]):
+            raise ConnectionError("subscription refused")
+
+    def publish_qos1(self, topic, payload, packet_id):
+        body = encode_string(topic) + packet_id.to_bytes(2, "big") + payload
+        self.send(packet(PUBLISH, 0x02, body))
+        self.expect(PUBACK)
+
+    def receive_publish(self):
+        """Waits for a publish and returns its topic."""
+        flags, body = self.expect(PUBLISH)
+        topic_length = int.from_bytes(body[:2], "big")
+        topic = body[2:2 + topic_length].decode()
+        if (flags >> 1) & 0x03:
+            self.send(packet(PUBACK, 0, body[2 + topic_length:4 + topic_length]))
+        return topic
+
+    def disconnect(self):
+        self.send(packet(DISCONNECT, 0, b""))
+        self.close()
+
+
+def clean_reconnect(args, run):
+    """Reconnection with a clean session: CONNECT, CONNACK, SUBSCRIBE, SUBACK."""
+    client = Client(args)
+    start = time.perf_counter()
+    client.connect(DEVICE_ID + "-clean", clean=True)
+    client.subscribe(run % 0xFFFF + 1)
+    ready = time.perf_counter() - start
+    client.disconnect()
+    return ready
+
+
+def resumed_reconnect(args, run, commander):
+    """Reconnection of a persistent session: CONNECT, CONNACK. A command is
+    queued while the client is offline and must arrive after the resume."""
+    topic = COMMAND_TOPIC_BASE + "/config"
+    commander.publish_qos1(topic, b'{"run":%d}' % run, run % 0xFFFF + 1)
+
+    client = Client(args)
+    start = time.perf_counter()
+    present = client.connect(DEVICE_ID + "-session", clean=False)
+    ready = time.perf_counter() - start
+    if not present:
+        raise RuntimeError("the broker did not keep the session")
+    client.sock.settimeout(args.delivery_timeout)
+    try:
+        delivered = client.receive_publish() == topic
+    except socket.timeout:
+        delivered = False
+    client.disconnect()
+    return ready, delivered
+
+
+def summary(name, samples):
+    samples = sorted(samples)
+    p95 = samples[min(len(samples) - 1, (len(samples) * 95) // 100)]
+    print("%-22s %8.2f %8.2f %8.2f %8.2f" % (name, statistics.mean(samples) * 1000,
+                                             statistics.median(samples) * 1000, p95 * 1000,
+                                             samples[-1] * 1000))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--runs", type=int, default=100)
+    parser.add_argument("--tls", action="store_true")
+    parser.add_argument("--cafile")
+    parser.add_argument("--insecure", action="store_true", help="skip the server certificate check")
+    parser.add_argument("--delivery-timeout", type=float, default=2.0,
+                        help="seconds to wait for the queued command after a resume")
+    args = parser.parse_args()
+
+    # Create the persistent session once, as the first connection does.
+    client = Client(args)
+    client.connect(DEVICE_ID + "-session", clean=True)
+    client.disconnect()
+    client.connect(DEVICE_ID + "-session", clean=False)
+    client.subscribe(1)
+    client.disconnect()
+
+    commander = Client(args)
+    commander.connect(DEVICE_ID + "-commander", clean=True)
+
+    clean, resumed = [], []
+    lost = 0
+    for run in range(args.runs):
+        clean.append(clean_reconnect(args, run))
+        ready, delivered = resumed_reconnect(args, run, commander)
+        resumed.append(ready)
+        lost += 0 if delivered else 1
+    commander.disconnect()
+
+    print("%d runs against %s:%d%s" % (args.runs, args.host, args.port, " (TLS)" if args.tls else ""))
+    print("%-22s %8s %8s %8s %8s" % ("reconnect-to-ready ms", "mean", "median", "p95", "max"))
+    summary("clean + subscribe", clean)
+    summary("resumed session", resumed)
+    print("queued commands lost on resume: %d" % lost)
+    return 1 if lost else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
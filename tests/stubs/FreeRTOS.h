@@ -0,0 +1,74 @@
+/******************************************************************************
+* File Name:   FreeRTOS.h
+*
+* Description: Host declarations of the FreeRTOS kernel types and macros used
+*              by the modules under test.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FREERTOS_H_
+#define FREERTOS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE                          (1)
+#define pdFALSE                         (0)
+#define pdPASS                          (pdTRUE)
+#define pdFAIL                          (pdFALSE)
+
+/* One tick per millisecond, as configured in FreeRTOSConfig.h. */
+#define configTICK_RATE_HZ              (1000U)
+#define portTICK_PERIOD_MS              (1U)
+#define pdMS_TO_TICKS(ms)               ((TickType_t)(ms))
+#define portMAX_DELAY                   ((TickType_t)0xFFFFFFFFU)
+
+/* The tests run on one thread. */
+#define configASSERT(x)
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskENTER_CRITICAL_FROM_ISR()   (0U)
+#define taskEXIT_CRITICAL_FROM_ISR(x)   ((void)(x))
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+#endif /* FREERTOS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,223 @@
+/******************************************************************************
+* File Name:   cy_pdl.c
+*
+* Description: Host stand-ins for the PDL drivers declared in cybsp.h. The
+*              tests do not drive the hardware, so reaching a stand-in fails
+*              the test. A test that models a driver defines it itself, which
+*              replaces the weak stand-in.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cybsp.h"
+#include "cycfg_qspi_memslot.h"
+
+#define CY_PDL_STUB                         __attribute__((weak))
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+CY_PDL_STUB const cy_stc_smif_config_t CYBSP_SMIF_CORE_0_XSPI_FLASH_config;
+CY_PDL_STUB cy_stc_smif_mem_config_t *smifMemConfigs[1];
+CY_PDL_STUB uint32_t SystemCoreClock;
+CY_PDL_STUB CoreDebug_Type Cy_Host_CoreDebug;
+
+/******************************************************************************
+ * Function Name: cy_pdl_not_reached
+ ******************************************************************************
+ * Summary:
+ *  Reports a call into a driver that the test does not model and exits.
+ *
+ * Parameters:
+ *  const char *function : Name of the driver function
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void cy_pdl_not_reached(const char *function)
+{
+    printf("Host: %s() is not available on the host\n", function);
+    exit(EXIT_FAILURE);
+}
+
+/******************************************************************************
+* SysLib
+******************************************************************************/
+CY_PDL_STUB uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0U;
+}
+
+CY_PDL_STUB void Cy_SysLib_ExitCriticalSection(uint32_t saved_intr_status)
+{
+    (void) saved_intr_status;
+}
+
+CY_PDL_STUB void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    (void) microseconds;
+}
+
+/******************************************************************************
+* Core
+******************************************************************************/
+CY_PDL_STUB DWT_Type *Cy_Host_Dwt(void)
+{
+    cy_pdl_not_reached(__func__);
+    return NULL;
+}
+
+CY_PDL_STUB void NVIC_EnableIRQ(IRQn_Type irqn)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+CY_PDL_STUB void NVIC_DisableIRQ(IRQn_Type irqn)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+CY_PDL_STUB void NVIC_ClearPendingIRQ(IRQn_Type irqn)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+/******************************************************************************
+* SysInt
+******************************************************************************/
+CY_PDL_STUB cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress user_isr)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SYSINT_BAD_PARAM;
+}
+
+/******************************************************************************
+* GPIO
+******************************************************************************/
+CY_PDL_STUB uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pin_num)
+{
+    cy_pdl_not_reached(__func__);
+    return 0U;
+}
+
+CY_PDL_STUB uint32_t Cy_GPIO_GetInterruptStatus(GPIO_PRT_Type *base, uint32_t pin_num)
+{
+    cy_pdl_not_reached(__func__);
+    return 0U;
+}
+
+CY_PDL_STUB void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pin_num)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+CY_PDL_STUB void Cy_GPIO_SetInterruptEdge(GPIO_PRT_Type *base, uint32_t pin_num, uint32_t value)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+/******************************************************************************
+* RRAM
+******************************************************************************/
+CY_PDL_STUB cy_en_rram_status_t Cy_RRAM_NvmWriteByteArray(RRAMC_Type *base, uint32_t address,
+                                                          const uint8_t *data, uint32_t size)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_RRAM_BAD_PARAM;
+}
+
+/******************************************************************************
+* SMIF
+******************************************************************************/
+CY_PDL_STUB cy_en_smif_status_t Cy_SMIF_Init(SMIF_CORE_Type *base, const cy_stc_smif_config_t *config,
+                                             uint32_t timeout, cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SMIF_BAD_PARAM;
+}
+
+CY_PDL_STUB void Cy_SMIF_SetMode(SMIF_CORE_Type *base, cy_en_smif_mode_t mode)
+{
+    cy_pdl_not_reached(__func__);
+}
+
+CY_PDL_STUB cy_en_smif_status_t Cy_SMIF_TransmitCommand(SMIF_CORE_Type *base, uint8_t cmd,
+                                                        cy_en_smif_txfr_width_t cmd_width,
+                                                        const uint8_t *cmd_param, uint32_t param_size,
+                                                        cy_en_smif_txfr_width_t param_width,
+                                                        cy_en_smif_slave_select_t slave_select,
+                                                        uint32_t complete_tx,
+                                                        cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SMIF_BAD_PARAM;
+}
+
+CY_PDL_STUB bool Cy_SMIF_MemIsBusy(SMIF_CORE_Type *base, const cy_stc_smif_mem_config_t *mem_config,
+                                   const cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return false;
+}
+
+CY_PDL_STUB cy_en_smif_status_t Cy_SMIF_MemCmdWriteEnable(SMIF_CORE_Type *base,
+                                                          const cy_stc_smif_mem_config_t *mem_config,
+                                                          const cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SMIF_BAD_PARAM;
+}
+
+CY_PDL_STUB cy_en_smif_status_t Cy_SMIF_MemCmdSectorErase(SMIF_CORE_Type *base,
+                                                          const cy_stc_smif_mem_config_t *mem_config,
+                                                          const uint8_t *sector_addr,
+                                                          const cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SMIF_BAD_PARAM;
+}
+
+CY_PDL_STUB cy_en_smif_status_t Cy_SMIF_MemWrite(SMIF_CORE_Type *base,
+                                                 const cy_stc_smif_mem_config_t *mem_config,
+                                                 uint32_t address, const uint8_t *tx_buffer,
+                                                 uint32_t length, const cy_stc_smif_context_t *context)
+{
+    cy_pdl_not_reached(__func__);
+    return CY_SMIF_BAD_PARAM;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   cy_wcm.h
+*
+* Description: Host declarations of the Wi-Fi Connection Manager API used by
+*              the modules under test. Each test defines the functions it
+*              calls.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_WCM_H_
+#define CY_WCM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_result.h"
+
+#define CY_WCM_MAX_SSID_LEN                 (32)
+#define CY_WCM_MAX_PASSPHRASE_LEN           (63)
+
+typedef uint8_t cy_wcm_mac_t[6];
+
+typedef enum
+{
+    CY_WCM_SECURITY_OPEN,
+    CY_WCM_SECURITY_WPA2_AES_PSK,
+    CY_WCM_SECURITY_WPA3_SAE
+} cy_wcm_security_t;
+
+typedef enum
+{
+    CY_WCM_IP_VER_V4,
+    CY_WCM_IP_VER_V6
+} cy_wcm_ip_version_t;
+
+typedef struct
+{
+    cy_wcm_ip_version_t version;
+    union
+    {
+        uint32_t v4;
+        uint32_t v6[4];
+    } ip;
+} cy_wcm_ip_address_t;
+
+typedef enum
+{
+    CY_WCM_SCAN_INCOMPLETE,
+    CY_WCM_SCAN_COMPLETE,
+    CY_WCM_SCAN_ABORTED
+} cy_wcm_scan_status_t;
+
+typedef struct
+{
+    uint8_t SSID[CY_WCM_MAX_SSID_LEN + 1];
+    cy_wcm_mac_t BSSID;
+    int16_t signal_strength;
+    cy_wcm_security_t security;
+} cy_wcm_scan_result_t;
+
+typedef struct
+{
+    uint32_t mode;
+} cy_wcm_scan_filter_t;
+
+typedef struct
+{
+    uint8_t SSID[CY_WCM_MAX_SSID_LEN + 1];
+    uint8_t password[CY_WCM_MAX_PASSPHRASE_LEN + 1];
+    cy_wcm_security_t security;
+} cy_wcm_ap_credentials_t;
+
+typedef struct
+{
+    cy_wcm_ap_credentials_t ap_credentials;
+    cy_wcm_mac_t BSSID;
+} cy_wcm_connect_params_t;
+
+typedef struct
+{
+    uint8_t SSID[CY_WCM_MAX_SSID_LEN + 1];
+    cy_wcm_mac_t BSSID;
+    int16_t signal_strength;
+} cy_wcm_associated_ap_info_t;
+
+typedef void (*cy_wcm_scan_result_callback_t)(cy_wcm_scan_result_t *result_ptr, void *user_data,
+                                              cy_wcm_scan_status_t status);
+
+cy_rslt_t cy_wcm_start_scan(cy_wcm_scan_result_callback_t scan_callback, void *user_data,
+                            cy_wcm_scan_filter_t *scan_filter);
+cy_rslt_t cy_wcm_stop_scan(void);
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *connect_params, cy_wcm_ip_address_t *ip_addr);
+cy_rslt_t cy_wcm_disconnect_ap(void);
+uint8_t cy_wcm_is_connected_to_ap(void);
+cy_rslt_t cy_wcm_get_associated_ap_info(cy_wcm_associated_ap_info_t *ap_info);
+
+#endif /* CY_WCM_H_ */
+
+/* [] END OF FILE */
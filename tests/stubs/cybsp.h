@@ -0,0 +1,240 @@
+/******************************************************************************
+* File Name:   cybsp.h
+*
+* Description: Host declarations of the BSP, memory map and PDL drivers used by
+*              the modules under test. The drivers are defined in cy_pdl.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYBSP_H_
+#define CYBSP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Compiler
+********************************************************************************/
+#define CY_RAMFUNC_BEGIN
+#define CY_RAMFUNC_END
+#define CY_NOINLINE                         __attribute__((noinline))
+#define CY_UNUSED_PARAMETER(x)              ((void)(x))
+
+/*******************************************************************************
+* Memory map
+********************************************************************************/
+#define CYMEM_CM33_0_user_nvm_START                 (0x2205B000UL)
+#define CYMEM_CM33_0_user_nvm_SIZE                  (0x00008000UL)
+
+/* Secondary slot of the CM33 NS image, laid out like the primary slot. */
+#define CYMEM_CM33_0_m33_nvm_secondary_OFFSET       (0x00540000UL)
+#define CYMEM_CM33_0_m33_nvm_secondary_SIZE         (0x00200000UL)
+#define CYMEM_CM33_0_m33_trailer_secondary_OFFSET   (0x00740000UL)
+#define CYMEM_CM33_0_m33_trailer_secondary_SIZE     (0x00040000UL)
+
+/*******************************************************************************
+* SysLib
+********************************************************************************/
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t saved_intr_status);
+void Cy_SysLib_DelayUs(uint16_t microseconds);
+
+/*******************************************************************************
+* Core
+********************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef int IRQn_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk              (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk          (1UL << 24)
+
+/* The cycle counter is read through a function so that a test can advance
+ * it from its own clock on every read.
+ */
+#define DWT                                 (Cy_Host_Dwt())
+#define CoreDebug                           (&Cy_Host_CoreDebug)
+
+extern uint32_t SystemCoreClock;
+extern CoreDebug_Type Cy_Host_CoreDebug;
+
+DWT_Type *Cy_Host_Dwt(void);
+
+#define __DMB()                             __sync_synchronize()
+
+void NVIC_EnableIRQ(IRQn_Type irqn);
+void NVIC_DisableIRQ(IRQn_Type irqn);
+void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+
+/*******************************************************************************
+* SysInt
+********************************************************************************/
+typedef void (*cy_israddress)(void);
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS,
+    CY_SYSINT_BAD_PARAM
+} cy_en_sysint_status_t;
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress user_isr);
+
+/*******************************************************************************
+* GPIO
+********************************************************************************/
+typedef struct GPIO_PRT_Type GPIO_PRT_Type;
+
+#define CY_GPIO_INTR_BOTH                   (0x3UL)
+
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pin_num);
+uint32_t Cy_GPIO_GetInterruptStatus(GPIO_PRT_Type *base, uint32_t pin_num);
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pin_num);
+void Cy_GPIO_SetInterruptEdge(GPIO_PRT_Type *base, uint32_t pin_num, uint32_t value);
+
+/*******************************************************************************
+* RRAM
+********************************************************************************/
+typedef struct RRAMC_Type RRAMC_Type;
+
+typedef enum
+{
+    CY_RRAM_SUCCESS,
+    CY_RRAM_BAD_PARAM
+} cy_en_rram_status_t;
+
+#define RRAMC0                              ((RRAMC_Type *)NULL)
+
+cy_en_rram_status_t Cy_RRAM_NvmWriteByteArray(RRAMC_Type *base, uint32_t address,
+                                              const uint8_t *data, uint32_t size);
+
+/*******************************************************************************
+* SMIF
+********************************************************************************/
+typedef struct SMIF_CORE_Type SMIF_CORE_Type;
+
+typedef enum
+{
+    CY_SMIF_SUCCESS,
+    CY_SMIF_BAD_PARAM,
+    CY_SMIF_BUSY
+} cy_en_smif_status_t;
+
+typedef enum
+{
+    CY_SMIF_NORMAL,
+    CY_SMIF_MEMORY
+} cy_en_smif_mode_t;
+
+typedef enum
+{
+    CY_SMIF_WIDTH_SINGLE
+} cy_en_smif_txfr_width_t;
+
+typedef enum
+{
+    CY_SMIF_SLAVE_SELECT_0
+} cy_en_smif_slave_select_t;
+
+typedef struct
+{
+    uint32_t mode;
+} cy_stc_smif_config_t;
+
+typedef struct
+{
+    uint32_t numOfAddrBytes;
+    uint32_t eraseSize;
+    uint32_t programSize;
+    uint32_t eraseTime;
+} cy_stc_smif_mem_device_cfg_t;
+
+typedef struct
+{
+    cy_en_smif_slave_select_t slaveSelect;
+    cy_stc_smif_mem_device_cfg_t *deviceCfg;
+} cy_stc_smif_mem_config_t;
+
+typedef struct
+{
+    uint32_t timeout;
+} cy_stc_smif_context_t;
+
+#define CY_SMIF_CMD_WITHOUT_PARAM           (0U)
+#define CY_SMIF_TX_LAST_BYTE                (1U)
+#define CY_SMIF_FOUR_BYTES_ADDR             (4U)
+
+#define CYBSP_SMIF_CORE_0_XSPI_FLASH_HW     ((SMIF_CORE_Type *)NULL)
+extern const cy_stc_smif_config_t CYBSP_SMIF_CORE_0_XSPI_FLASH_config;
+
+cy_en_smif_status_t Cy_SMIF_Init(SMIF_CORE_Type *base, const cy_stc_smif_config_t *config,
+                                 uint32_t timeout, cy_stc_smif_context_t *context);
+void Cy_SMIF_SetMode(SMIF_CORE_Type *base, cy_en_smif_mode_t mode);
+cy_en_smif_status_t Cy_SMIF_TransmitCommand(SMIF_CORE_Type *base, uint8_t cmd,
+                                            cy_en_smif_txfr_width_t cmd_width,
+                                            const uint8_t *cmd_param, uint32_t param_size,
+                                            cy_en_smif_txfr_width_t param_width,
+                                            cy_en_smif_slave_select_t slave_select,
+                                            uint32_t complete_tx, cy_stc_smif_context_t *context);
+bool Cy_SMIF_MemIsBusy(SMIF_CORE_Type *base, const cy_stc_smif_mem_config_t *mem_config,
+                       const cy_stc_smif_context_t *context);
+cy_en_smif_status_t Cy_SMIF_MemCmdWriteEnable(SMIF_CORE_Type *base,
+                                              const cy_stc_smif_mem_config_t *mem_config,
+                                              const cy_stc_smif_context_t *context);
+cy_en_smif_status_t Cy_SMIF_MemCmdSectorErase(SMIF_CORE_Type *base,
+                                              const cy_stc_smif_mem_config_t *mem_config,
+                                              const uint8_t *sector_addr,
+                                              const cy_stc_smif_context_t *context);
+cy_en_smif_status_t Cy_SMIF_MemWrite(SMIF_CORE_Type *base, const cy_stc_smif_mem_config_t *mem_config,
+                                     uint32_t address, const uint8_t *tx_buffer, uint32_t length,
+                                     const cy_stc_smif_context_t *context);
+
+#endif /* CYBSP_H_ */
+
+/* [] END OF FILE */
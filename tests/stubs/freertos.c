@@ -0,0 +1,237 @@
+/******************************************************************************
+* File Name:   freertos.c
+*
+* Description: Host stand-ins for the FreeRTOS API declared in task.h, queue.h,
+*              semphr.h and timers.h. The tests run on one thread without the
+*              scheduler, so reaching a stand-in fails the test. A test that
+*              models a kernel function defines it itself, which replaces the
+*              weak stand-in.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+#define FREERTOS_STUB                       __attribute__((weak))
+
+/******************************************************************************
+ * Function Name: freertos_not_reached
+ ******************************************************************************
+ * Summary:
+ *  Reports a call into a kernel function that the test does not model and
+ *  exits.
+ *
+ * Parameters:
+ *  const char *function : Name of the kernel function
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void freertos_not_reached(const char *function)
+{
+    printf("Host: %s() is not available on the host\n", function);
+    exit(EXIT_FAILURE);
+}
+
+/******************************************************************************
+* Tasks
+******************************************************************************/
+FREERTOS_STUB BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                                     void *parameters, UBaseType_t priority, TaskHandle_t *handle)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB void vTaskDelete(TaskHandle_t task)
+{
+    freertos_not_reached(__func__);
+}
+
+FREERTOS_STUB void vTaskDelay(TickType_t ticks)
+{
+    freertos_not_reached(__func__);
+}
+
+FREERTOS_STUB TickType_t xTaskGetTickCount(void)
+{
+    freertos_not_reached(__func__);
+    return 0U;
+}
+
+FREERTOS_STUB TickType_t xTaskGetTickCountFromISR(void)
+{
+    freertos_not_reached(__func__);
+    return 0U;
+}
+
+FREERTOS_STUB uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return 0U;
+}
+
+FREERTOS_STUB BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    freertos_not_reached(__func__);
+}
+
+/* A test runs in one thread, so there is no other task to hold off. */
+FREERTOS_STUB void vTaskSuspendAll(void)
+{
+}
+
+FREERTOS_STUB BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+/******************************************************************************
+* Queues
+******************************************************************************/
+FREERTOS_STUB QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    freertos_not_reached(__func__);
+    return NULL;
+}
+
+FREERTOS_STUB BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item,
+                                           TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+                                           BaseType_t *higher_priority_task_woken)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    freertos_not_reached(__func__);
+    return 0U;
+}
+
+FREERTOS_STUB UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    freertos_not_reached(__func__);
+    return 0U;
+}
+
+/******************************************************************************
+* Semaphores
+******************************************************************************/
+FREERTOS_STUB SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    freertos_not_reached(__func__);
+    return NULL;
+}
+
+FREERTOS_STUB SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    freertos_not_reached(__func__);
+    return NULL;
+}
+
+FREERTOS_STUB SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count,
+                                                         UBaseType_t initial_count)
+{
+    freertos_not_reached(__func__);
+    return NULL;
+}
+
+FREERTOS_STUB BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+/******************************************************************************
+* Timers
+******************************************************************************/
+FREERTOS_STUB TimerHandle_t xTimerCreate(const char *name, TickType_t period, BaseType_t auto_reload,
+                                         void *timer_id, TimerCallbackFunction_t callback)
+{
+    freertos_not_reached(__func__);
+    return NULL;
+}
+
+FREERTOS_STUB BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks_to_wait)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+FREERTOS_STUB BaseType_t xTimerChangePeriodFromISR(TimerHandle_t timer, TickType_t period,
+                                                   BaseType_t *higher_priority_task_woken)
+{
+    freertos_not_reached(__func__);
+    return pdFAIL;
+}
+
+/* [] END OF FILE */
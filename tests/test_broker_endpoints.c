@@ -0,0 +1,356 @@
+/******************************************************************************
+* File Name:   test_broker_endpoints.c
+*
+* Description: Host test of the broker endpoints. Probes two broker stand-ins,
+*              one of which slows down, and checks the endpoint the client
+*              connects to or moves to.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mqtt_client_config.h"
+
+/* Endpoints of the test: "broker-a", the primary one, and "broker-b". */
+#undef MQTT_BROKER_ADDRESS
+#undef MQTT_PORT
+#undef MQTT_BROKER_FALLBACK_ENDPOINTS
+#undef MQTT_BROKER_MAX_ENDPOINTS
+#undef MQTT_SECURE_CONNECTION
+#undef MQTT_BROKER_PROBE_TIMEOUT_MS
+#undef MQTT_BROKER_REPROBE_INTERVAL_MS
+#undef MQTT_BROKER_REPROBE_BUDGET_MS
+#undef MQTT_BROKER_SWITCH_HYSTERESIS_MS
+#define MQTT_BROKER_ADDRESS                 "broker-a"
+#define MQTT_PORT                           (8883U)
+#define MQTT_BROKER_FALLBACK_ENDPOINTS      { "broker-b", 8883U },
+#define MQTT_BROKER_MAX_ENDPOINTS           (4U)
+#define MQTT_SECURE_CONNECTION              (1)
+#define MQTT_BROKER_PROBE_TIMEOUT_MS        (5000U)
+#define MQTT_BROKER_REPROBE_INTERVAL_MS     (300000U)
+#define MQTT_BROKER_REPROBE_BUDGET_MS       (1000U)
+#define MQTT_BROKER_SWITCH_HYSTERESIS_MS    (200U)
+
+/* The endpoints log every probe, which the test silences while it probes. */
+static bool host_quiet;
+#define printf(...)                         (host_quiet ? 0 : printf(__VA_ARGS__))
+
+#include "broker_endpoints.c"
+
+static uint32_t host_now_ms;
+
+/* Broker stand-in. */
+typedef struct
+{
+    const char *hostname;
+    uint32_t rtt_ms;        /* Network round trip time */
+    bool up;
+} host_broker_t;
+
+static host_broker_t host_brokers[] =
+{
+    { "broker-a", 40U, true },
+    { "broker-b", 120U, true },
+};
+
+/* Timeout set on the socket being probed. */
+static uint32_t host_socket_timeout_ms;
+
+/******************************************************************************
+ * Function Name: xTaskGetTickCount
+ ******************************************************************************
+ * Summary:
+ *  Returns the simulated time, one tick per millisecond.
+ *
+ ******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)host_now_ms;
+}
+
+/******************************************************************************
+ * Function Name: config_store_get_string
+ ******************************************************************************
+ * Summary:
+ *  Emulated configuration store with no stored value.
+ *
+ ******************************************************************************/
+void config_store_get_string(const char *key, char *buffer, size_t size, const char *default_value)
+{
+    (void) key;
+    (void) snprintf(buffer, size, "%s", default_value);
+}
+
+uint32_t config_store_get_uint(const char *key, uint32_t default_value)
+{
+    (void) key;
+    return default_value;
+}
+
+/******************************************************************************
+ * Function Name: cy_socket_gethostbyname
+ ******************************************************************************
+ * Summary:
+ *  Emulated name resolution: the address is the index of the stand-in plus
+ *  one.
+ *
+ ******************************************************************************/
+cy_rslt_t cy_socket_gethostbyname(const char *hostname, cy_socket_ip_version_t version,
+                                  cy_socket_ip_address_t *address)
+{
+    (void) version;
+
+    for (uint32_t i = 0U; i < (sizeof(host_brokers) / sizeof(host_brokers[0])); i++)
+    {
+        if (0 == strcmp(host_brokers[i].hostname, hostname))
+        {
+            address->version = CY_SOCKET_IP_VER_V4;
+            address->ip.v4 = i + 1U;
+            return CY_RSLT_SUCCESS;
+        }
+    }
+
+    return ~CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_create(int domain, int type, int protocol, cy_socket_t *handle)
+{
+    (void) domain;
+    (void) type;
+    (void) protocol;
+    *handle = &host_socket_timeout_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_setsockopt(cy_socket_t handle, int level, int option, const void *value,
+                               uint32_t length)
+{
+    (void) handle;
+    (void) length;
+    if ((CY_SOCKET_SOL_SOCKET == level) && (CY_SOCKET_SO_SNDTIMEO == option))
+    {
+        host_socket_timeout_ms = *(const uint32_t *)value;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: cy_socket_connect
+ ******************************************************************************
+ * Summary:
+ *  Emulated connect: advances the clock by one round trip, or by the socket
+ *  timeout if the stand-in is down or slower than the timeout.
+ *
+ ******************************************************************************/
+cy_rslt_t cy_socket_connect(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t length)
+{
+    const host_broker_t *broker = &host_brokers[address->ip_address.ip.v4 - 1U];
+
+    (void) handle;
+    (void) length;
+
+    if (!broker->up || (broker->rtt_ms > host_socket_timeout_ms))
+    {
+        host_now_ms += host_socket_timeout_ms;
+        return ~CY_RSLT_SUCCESS;
+    }
+
+    host_now_ms += broker->rtt_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_disconnect(cy_socket_t handle, uint32_t timeout_ms)
+{
+    (void) handle;
+    (void) timeout_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_delete(cy_socket_t handle)
+{
+    (void) handle;
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: host_reprobe
+ ******************************************************************************
+ * Summary:
+ *  Lets the re-probe interval elapse and re-probes, returning how long the
+ *  calling task was blocked.
+ *
+ ******************************************************************************/
+static bool host_reprobe(uint32_t current, uint32_t *blocked_ms)
+{
+    uint32_t start;
+    bool reconnect;
+
+    host_now_ms += MQTT_BROKER_REPROBE_INTERVAL_MS;
+    start = host_now_ms;
+    reconnect = broker_endpoints_reprobe(current);
+    *blocked_ms = host_now_ms - start;
+    return reconnect;
+}
+
+/******************************************************************************
+ * Function Name: host_report
+ ******************************************************************************
+ * Summary:
+ *  Prints the result of a check.
+ *
+ ******************************************************************************/
+static int host_report(const char *name, bool pass, uint32_t blocked_ms)
+{
+    printf("%-48s %6lu ms  %s\n", name, (unsigned long)blocked_ms, pass ? "pass" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Probes two broker stand-ins, slows one of them down and checks which
+ *  endpoint the client connects to or moves to, and for how long each probe
+ *  blocks the calling task.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed checks
+ *
+ ******************************************************************************/
+int main(void)
+{
+    broker_endpoint_t endpoints[3];
+    uint8_t order[MQTT_BROKER_MAX_ENDPOINTS];
+    uint32_t start;
+    uint32_t blocked_ms;
+    bool reconnect;
+    bool pass;
+    int failures = 0;
+
+    /* Ranking of fixed probe results. */
+    memset(endpoints, 0, sizeof(endpoints));
+    endpoints[0].latency_ms = 300U;
+    endpoints[1].reachable = true;
+    endpoints[1].latency_ms = 500U;
+    endpoints[2].reachable = true;
+    endpoints[2].latency_ms = 200U;
+    pass = (3U == broker_endpoints_rank(endpoints, 3U, order)) &&
+           (2U == order[0]) && (1U == order[1]) && (0U == order[2]);
+    failures += host_report("Rank reachable by latency, then unreachable", pass, 0U);
+
+    endpoints[2].consecutive_failures = 1U;
+    pass = (3U == broker_endpoints_rank(endpoints, 3U, order)) && (1U == order[0]) && (2U == order[1]);
+    failures += host_report("Rank with failure penalty", pass, 0U);
+
+    /* Start-up probe. */
+    host_quiet = true;
+    broker_endpoints_init();
+    start = host_now_ms;
+    pass = (2U == broker_endpoints_probe()) && (2U == broker_endpoints_order(order)) && (0U == order[0]);
+    blocked_ms = host_now_ms - start;
+    host_quiet = false;
+    failures += host_report("Start-up probe, broker-a fastest", pass, blocked_ms);
+
+    /* Within the interval nothing is probed. */
+    host_now_ms += MQTT_BROKER_REPROBE_INTERVAL_MS / 2U;
+    start = host_now_ms;
+    pass = !broker_endpoints_reprobe(0U) && (host_now_ms == start);
+    failures += host_report("Re-probe before the interval", pass, host_now_ms - start);
+
+    /* Unchanged network: stay. */
+    host_quiet = true;
+    reconnect = host_reprobe(0U, &blocked_ms);
+    host_quiet = false;
+    failures += host_report("Re-probe, unchanged", !reconnect && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS),
+                            blocked_ms);
+
+    /* broker-a slows down: move to broker-b. */
+    host_brokers[0].rtt_ms = 400U;
+    host_quiet = true;
+    reconnect = host_reprobe(0U, &blocked_ms);
+    (void) broker_endpoints_order(order);
+    host_quiet = false;
+    failures += host_report("Re-probe, broker-a slowed to 400 ms",
+                            reconnect && (1U == order[0]) && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS),
+                            blocked_ms);
+
+    /* broker-a recovers to within the hysteresis of broker-b: stay. */
+    host_brokers[0].rtt_ms = 100U;
+    host_quiet = true;
+    reconnect = host_reprobe(1U, &blocked_ms);
+    host_quiet = false;
+    failures += host_report("Re-probe, broker-a back within hysteresis",
+                            !reconnect && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS), blocked_ms);
+
+    /* broker-b fails: move back to broker-a. */
+    host_brokers[1].up = false;
+    host_quiet = true;
+    reconnect = host_reprobe(1U, &blocked_ms);
+    (void) broker_endpoints_order(order);
+    host_quiet = false;
+    failures += host_report("Re-probe, broker-b down",
+                            reconnect && (0U == order[0]) && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS),
+                            blocked_ms);
+
+    /* broker-a slower than its share of the budget: move to broker-b. */
+    host_brokers[0].rtt_ms = 600U;
+    host_brokers[1].up = true;
+    host_quiet = true;
+    reconnect = host_reprobe(0U, &blocked_ms);
+    (void) broker_endpoints_order(order);
+    host_quiet = false;
+    failures += host_report("Re-probe, broker-a beyond its budget share",
+                            reconnect && (1U == order[0]) && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS),
+                            blocked_ms);
+
+    /* Every endpoint down: stay, within the budget. */
+    host_brokers[0].up = false;
+    host_brokers[1].up = false;
+    host_quiet = true;
+    reconnect = host_reprobe(1U, &blocked_ms);
+    host_quiet = false;
+    failures += host_report("Re-probe, all brokers down",
+                            !reconnect && (blocked_ms <= MQTT_BROKER_REPROBE_BUDGET_MS), blocked_ms);
+
+    return failures;
+}
+
+/* [] END OF FILE */
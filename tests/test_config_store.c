@@ -0,0 +1,364 @@
+/******************************************************************************
+* File Name:   test_config_store.c
+*
+* Description: Host test of the configuration store. Cuts the power of an
+*              emulated region at every byte of a commit and checks that the
+*              store recovers either the previous or the new values.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The store logs every initialization, which the test silences while it
+ * sweeps.
+ */
+static bool host_quiet;
+#define printf(...)                         (host_quiet ? 0 : printf(__VA_ARGS__))
+
+#include "config_store.c"
+
+/* Mutex of the store; the test is single threaded. */
+static uint8_t host_mutex;
+
+/* Emulated region, the size of user_nvm. */
+#define HOST_NVM_SIZE                       (0x00008000UL)
+
+/* Settings of the committed and of the interrupted transaction. */
+typedef struct
+{
+    const char *ssid;
+    uint32_t port;
+    uint32_t sample_period_ms;
+    const char *username;   /* NULL if not set */
+} host_settings_t;
+
+/* Outcome of a power cut sweep. */
+typedef struct
+{
+    uint32_t cuts;
+    uint32_t old_values;    /* Recovered with the previous values */
+    uint32_t new_values;    /* Recovered with the interrupted transaction */
+    uint32_t violations;    /* Mixed, lost or unwritable afterwards */
+} host_sweep_t;
+
+static uint8_t host_nvm[HOST_NVM_SIZE];
+static uint8_t host_snapshot[HOST_NVM_SIZE];
+
+/* Bytes the emulated region can still write before the power fails. */
+static uint32_t host_power_budget = UINT32_MAX;
+static bool host_power_lost;
+static uint32_t host_bytes_written;
+
+/******************************************************************************
+ * Function Name: xSemaphoreCreateMutex, xSemaphoreTake, xSemaphoreGive
+ ******************************************************************************
+ * Summary:
+ *  Mutex of the store. The test is single threaded, so it is always free.
+ *
+ ******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return &host_mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return pdTRUE;
+}
+
+/******************************************************************************
+ * Function Name: host_nvm_write
+ ******************************************************************************
+ * Summary:
+ *  Emulated write. Once the power budget is spent the power fails: the byte
+ *  being written is left corrupted and every later access fails.
+ *
+ ******************************************************************************/
+static bool host_nvm_write(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        if (host_power_lost)
+        {
+            return false;
+        }
+        if (0U == host_power_budget)
+        {
+            host_nvm[offset + i] = (uint8_t)(data[i] ^ 0xA5U);
+            host_power_lost = true;
+            return false;
+        }
+        host_power_budget--;
+        host_bytes_written++;
+        host_nvm[offset + i] = data[i];
+    }
+
+    return !host_power_lost;
+}
+
+/******************************************************************************
+ * Function Name: host_nvm_erase
+ ******************************************************************************
+ * Summary:
+ *  Emulated erase, cut like host_nvm_write().
+ *
+ ******************************************************************************/
+static bool host_nvm_erase(uint32_t offset, uint32_t length)
+{
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        if (host_power_lost)
+        {
+            return false;
+        }
+        if (0U == host_power_budget)
+        {
+            host_nvm[offset + i] = 0x5AU;
+            host_power_lost = true;
+            return false;
+        }
+        host_power_budget--;
+        host_bytes_written++;
+        host_nvm[offset + i] = CONFIG_RECORD_ERASED;
+    }
+
+    return !host_power_lost;
+}
+
+static const config_store_nvm_t host_nvm_backend =
+{
+    .base = host_nvm,
+    .size = HOST_NVM_SIZE,
+    .write = host_nvm_write,
+    .erase = host_nvm_erase
+};
+
+/******************************************************************************
+ * Function Name: host_commit
+ ******************************************************************************
+ * Summary:
+ *  Stores settings in one transaction.
+ *
+ ******************************************************************************/
+static bool host_commit(const host_settings_t *settings)
+{
+    uint8_t port[4] = { (uint8_t)settings->port, (uint8_t)(settings->port >> 8), 0U, 0U };
+    uint8_t period[4] =
+    {
+        (uint8_t)settings->sample_period_ms, (uint8_t)(settings->sample_period_ms >> 8),
+        (uint8_t)(settings->sample_period_ms >> 16), (uint8_t)(settings->sample_period_ms >> 24)
+    };
+    bool staged;
+
+    if (!config_store_begin())
+    {
+        return false;
+    }
+
+    staged = config_store_set(CONFIG_KEY_WIFI_SSID, settings->ssid, (uint16_t)strlen(settings->ssid)) &&
+             config_store_set(CONFIG_KEY_MQTT_PORT, port, sizeof(port)) &&
+             config_store_set(CONFIG_KEY_SAMPLE_PERIOD, period, sizeof(period)) &&
+             ((NULL == settings->username) ||
+              config_store_set(CONFIG_KEY_MQTT_USERNAME, settings->username,
+                               (uint16_t)strlen(settings->username)));
+    if (!staged)
+    {
+        config_store_abort();
+        return false;
+    }
+
+    return config_store_commit();
+}
+
+/******************************************************************************
+ * Function Name: host_matches
+ ******************************************************************************
+ * Summary:
+ *  Checks if the store holds exactly the given settings.
+ *
+ ******************************************************************************/
+static bool host_matches(const host_settings_t *settings)
+{
+    char ssid[CONFIG_STORE_MAX_VALUE_LEN + 1U];
+    char username[CONFIG_STORE_MAX_VALUE_LEN + 1U];
+
+    config_store_get_string(CONFIG_KEY_WIFI_SSID, ssid, sizeof(ssid), "");
+    config_store_get_string(CONFIG_KEY_MQTT_USERNAME, username, sizeof(username), "");
+
+    return (0 == strcmp(ssid, settings->ssid)) &&
+           (settings->port == config_store_get_uint(CONFIG_KEY_MQTT_PORT, 0U)) &&
+           (settings->sample_period_ms == config_store_get_uint(CONFIG_KEY_SAMPLE_PERIOD, 0U)) &&
+           (0 == strcmp(username, (NULL != settings->username) ? settings->username : ""));
+}
+
+/******************************************************************************
+ * Function Name: host_sweep
+ ******************************************************************************
+ * Summary:
+ *  Cuts the power after every byte written by a commit of 'next' over the
+ *  current content of the region, including any compaction it triggers.
+ *  After each cut the store is restarted with the power back; it must hold
+ *  either 'previous' or 'next' in full and accept a further commit.
+ *
+ * Parameters:
+ *  const host_settings_t *previous : Settings committed before
+ *  const host_settings_t *next : Settings of the interrupted commit
+ *  host_sweep_t *sweep : Outcome
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_sweep(const host_settings_t *previous, const host_settings_t *next,
+                       host_sweep_t *sweep)
+{
+    static const host_settings_t after = { "after-recovery", 8884U, 42U, "device-43" };
+    uint32_t total;
+
+    memset(sweep, 0, sizeof(*sweep));
+    memcpy(host_snapshot, host_nvm, HOST_NVM_SIZE);
+    host_quiet = true;
+
+    /* Dry run to count the bytes the commit writes. */
+    host_bytes_written = 0U;
+    (void) config_store_init(&host_nvm_backend);
+    (void) host_commit(next);
+    total = host_bytes_written;
+
+    for (uint32_t cut = 0U; cut <= total; cut++)
+    {
+        memcpy(host_nvm, host_snapshot, HOST_NVM_SIZE);
+        (void) config_store_init(&host_nvm_backend);
+
+        host_power_budget = cut;
+        (void) host_commit(next);
+        host_power_budget = UINT32_MAX;
+        host_power_lost = false;
+
+        sweep->cuts++;
+        if (!config_store_init(&host_nvm_backend))
+        {
+            sweep->violations++;
+        }
+        else if (host_matches(previous))
+        {
+            sweep->old_values++;
+        }
+        else if (host_matches(next))
+        {
+            sweep->new_values++;
+        }
+        else
+        {
+            sweep->violations++;
+            continue;
+        }
+
+        if (!host_commit(&after) || !config_store_init(&host_nvm_backend) || !host_matches(&after))
+        {
+            sweep->violations++;
+        }
+    }
+
+    memcpy(host_nvm, host_snapshot, HOST_NVM_SIZE);
+    host_quiet = false;
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *    ./config_store
+ *  Sweeps a power cut over every byte of a commit into a fresh store, and
+ *  of a commit that compacts a full bank first.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed sweeps
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static const host_settings_t previous = { "home-network", 8883U, 1000U, NULL };
+    static const host_settings_t next = { "office-network", 1883U, 5000U, "device-42" };
+    host_settings_t filler = previous;
+    host_sweep_t sweep;
+    uint32_t commits = 0U;
+    int failures = 0;
+
+    memset(host_nvm, 0, sizeof(host_nvm));
+
+    /* Fresh store with one committed transaction. */
+    host_quiet = true;
+    (void) config_store_init(&host_nvm_backend);
+    (void) host_commit(&previous);
+    host_sweep(&previous, &next, &sweep);
+    failures += (0U == sweep.violations) ? 0 : 1;
+    printf("Commit:                 %5lu cuts, %5lu old, %5lu new, %lu violations - %s\n",
+           (unsigned long)sweep.cuts, (unsigned long)sweep.old_values,
+           (unsigned long)sweep.new_values, (unsigned long)sweep.violations,
+           (0U == sweep.violations) ? "pass" : "FAIL");
+
+    /* Fill the bank until the next commit has to compact it first. */
+    host_quiet = true;
+    (void) config_store_init(&host_nvm_backend);
+    while ((config_write_offset + 128U) < config_store_bank_size())
+    {
+        filler.sample_period_ms = 1000U + commits++;
+        (void) host_commit(&filler);
+    }
+    host_quiet = false;
+    host_sweep(&filler, &next, &sweep);
+    failures += (0U == sweep.violations) ? 0 : 1;
+    printf("Commit with compaction: %5lu cuts, %5lu old, %5lu new, %lu violations - %s\n",
+           (unsigned long)sweep.cuts, (unsigned long)sweep.old_values,
+           (unsigned long)sweep.new_values, (unsigned long)sweep.violations,
+           (0U == sweep.violations) ? "pass" : "FAIL");
+    printf("(bank filled with %lu commits)\n", (unsigned long)commits);
+
+    return failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,136 @@
+/******************************************************************************
+* File Name:   test_crypto_benchmark.c
+*
+* Description: Host run of the crypto benchmark against the software mbedTLS
+*              implementation. The DWT cycle counter is driven by the host
+*              monotonic clock at a modelled 1 GHz core clock, so one cycle
+*              is one nanosecond.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DISABLE_MBEDTLS_ACCELERATION
+
+#include "crypto_benchmark.c"
+#include "cert_pinning.c"
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* One cycle per nanosecond of the host clock. */
+uint32_t SystemCoreClock = 1000000000UL;
+
+static DWT_Type host_dwt;
+
+/******************************************************************************
+* Function Name: Cy_Host_Dwt
+******************************************************************************
+* Summary:
+*  Returns the cycle counter, advanced to the host monotonic clock.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  DWT_Type * : Cycle counter
+*
+******************************************************************************/
+DWT_Type *Cy_Host_Dwt(void)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    host_dwt.CYCCNT = (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec);
+
+    return &host_dwt;
+}
+
+/******************************************************************************
+* Function Name: main
+******************************************************************************
+* Summary:
+*  Host entry point, built and run by 'make' in this directory. The
+*  root CA chain and server name can be given on the command line:
+*    _build/test_crypto_benchmark [root_ca.pem [server_name]]
+*  Pass MBEDTLS_CFLAGS and MBEDTLS_LIBS of an mbedTLS built with
+*  MBEDTLS_USER_CONFIG_FILE set to this project's mbedtls_user_config.h to
+*  compare the TLS_PROFILE choices on the host.
+*
+* Parameters:
+*  int argc : Argument count
+*  char *argv[] : Optional path of the PEM root CA chain and server name
+*
+* Return:
+*  int : 0 if every primitive ran, else 1
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+    unsigned char *pem = NULL;
+    size_t pem_len = 0;
+    long file_len;
+    FILE *file;
+    int ret;
+
+    if (argc > 1)
+    {
+        file = fopen(argv[1], "rb");
+        if ((NULL == file) || (0 != fseek(file, 0, SEEK_END)) || ((file_len = ftell(file)) < 0))
+        {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 1;
+        }
+        rewind(file);
+        pem = calloc((size_t)file_len + 1U, 1U);
+        if ((NULL == pem) || (fread(pem, 1U, (size_t)file_len, file) != (size_t)file_len))
+        {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            fclose(file);
+            free(pem);
+            return 1;
+        }
+        fclose(file);
+        pem_len = (size_t)file_len + 1U;
+    }
+
+    ret = crypto_benchmark_run(pem, pem_len, (argc > 2) ? argv[2] : "localhost");
+    free(pem);
+
+    return (0 == ret) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,316 @@
+/******************************************************************************
+* File Name:   test_dedup_cache.c
+*
+* Description: Host test of the duplicate command cache. Replays a command
+*              stream with broker redeliveries and checks that every command
+*              is applied exactly once.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The cache logs every dropped duplicate, which the test silences while it
+ * replays.
+ */
+static bool host_quiet;
+#define printf(...)                         (host_quiet ? 0 : printf(__VA_ARGS__))
+
+#include "dedup_cache.c"
+
+/* Commands per replay, and the largest number of QoS 1 messages the broker
+ * keeps in flight (unacknowledged) per client.
+ */
+#define HOST_COMMANDS                       (5000U)
+#define HOST_MAX_INFLIGHT                   (128U)
+
+/* Replay configuration. */
+typedef struct
+{
+    const char *name;
+    uint32_t inflight;          /* Messages the broker may redeliver at once */
+    uint32_t id_cycle;          /* Packet identifiers used, 0 for all 65535 */
+    bool expect_exactly_once;
+} host_replay_t;
+
+/* Outcome of a replay. */
+typedef struct
+{
+    uint32_t deliveries;
+    uint32_t redeliveries;
+    uint32_t dropped;
+    uint32_t applied_twice;     /* Duplicates that got through */
+    uint32_t never_applied;     /* Commands wrongly dropped */
+    uint32_t ambiguous;         /* Lost messages identical to the last one
+                                 * delivered with their identifier */
+} host_result_t;
+
+/* Command of the stream. */
+typedef struct
+{
+    uint16_t packet_id;
+    uint8_t topic;
+    uint32_t value;             /* 0 for a "toggle" without arguments */
+} host_command_t;
+
+static const char *const host_topics[] =
+{
+    "device/test/commands",
+    "device/test/commands/config",
+    "device/test/commands/firmware",
+    "device/test/commands/certificate",
+};
+
+static host_command_t host_commands[HOST_COMMANDS];
+static uint8_t host_applied[HOST_COMMANDS];
+static uint32_t host_last_delivery[65536];     /* Command index + 1, by packet identifier */
+static uint32_t host_seed;
+
+bool publish_metrics_register_section(const char *name, publish_metrics_format_t format,
+                                      publish_metrics_print_t print)
+{
+    (void) name;
+    (void) format;
+    (void) print;
+    return true;
+}
+
+bool publish_metrics_append(char *buffer, size_t buffer_len, size_t *used, const char *format, ...)
+{
+    (void) buffer;
+    (void) buffer_len;
+    (void) used;
+    (void) format;
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_random
+ ******************************************************************************
+ * Summary:
+ *  Deterministic pseudo-random number, so that every run gives the same
+ *  table.
+ *
+ ******************************************************************************/
+static uint32_t host_random(uint32_t range)
+{
+    host_seed = (host_seed * 1103515245U) + 12345U;
+    return (host_seed >> 16) % range;
+}
+
+/******************************************************************************
+ * Function Name: host_deliver
+ ******************************************************************************
+ * Summary:
+ *  Delivers a command to the client as the MQTT event callback does, and
+ *  applies it unless the cache drops it.
+ *
+ ******************************************************************************/
+static void host_deliver(uint32_t index, bool dup, host_result_t *result)
+{
+    const host_command_t *command = &host_commands[index];
+    char payload[32];
+    int length;
+
+    if (0U == command->value)
+    {
+        length = snprintf(payload, sizeof(payload), "{\"led\":\"toggle\"}");
+    }
+    else
+    {
+        length = snprintf(payload, sizeof(payload), "{\"value\":%lu}", (unsigned long)command->value);
+    }
+
+    result->deliveries++;
+    host_last_delivery[command->packet_id] = index + 1U;
+    if (dedup_cache_check(command->packet_id, dup, host_topics[command->topic],
+                          strlen(host_topics[command->topic]), payload, (size_t)length))
+    {
+        result->dropped++;
+        return;
+    }
+    host_applied[index]++;
+}
+
+/******************************************************************************
+ * Function Name: host_replay
+ ******************************************************************************
+ * Summary:
+ *  Replays HOST_COMMANDS commands. A quarter of them are identical toggles,
+ *  so that identifier and content repeat across genuinely new messages.
+ *  After 1 in 25 messages the connection drops: the last message reaches the
+ *  client or not, the acknowledgements of the last messages in flight are
+ *  lost, and the broker redelivers those messages with DUP set after the
+ *  reconnection.
+ *
+ ******************************************************************************/
+static void host_replay(const host_replay_t *replay, host_result_t *result)
+{
+    uint32_t inflight[HOST_MAX_INFLIGHT];
+    uint32_t inflight_count = 0U;
+    uint32_t unacked;
+    uint32_t previous;
+    uint32_t id_cycle = (0U == replay->id_cycle) ? 65535U : replay->id_cycle;
+    bool lost;
+
+    memset(result, 0, sizeof(*result));
+    memset(host_applied, 0, sizeof(host_applied));
+    memset(dedup_slots, 0, sizeof(dedup_slots));
+    memset(host_last_delivery, 0, sizeof(host_last_delivery));
+    dedup_stamp = 0U;
+    host_seed = 1U;
+
+    for (uint32_t n = 0U; n < HOST_COMMANDS; n++)
+    {
+        host_commands[n].packet_id = (uint16_t)((n % id_cycle) + 1U);
+        host_commands[n].topic = (uint8_t)host_random(sizeof(host_topics) / sizeof(host_topics[0]));
+        host_commands[n].value = (0U == host_random(4U)) ? 0U : (n + 1U);
+
+        /* A message leaves the window once acknowledged; the oldest ones
+         * are acknowledged first.
+         */
+        if (inflight_count == replay->inflight)
+        {
+            memmove(inflight, &inflight[1], (inflight_count - 1U) * sizeof(inflight[0]));
+            inflight_count--;
+        }
+        inflight[inflight_count++] = n;
+
+        if (0U != host_random(25U))
+        {
+            host_deliver(n, false, result);
+            continue;
+        }
+
+        /* Connection lost, possibly with the last message. A message that
+         * never reached the client and is identical to the last one with
+         * its identifier cannot be told apart from a redelivery of that one.
+         */
+        lost = (0U != host_random(2U));
+        if (lost)
+        {
+            previous = host_last_delivery[host_commands[n].packet_id];
+            if ((0U != previous) && (host_commands[previous - 1U].topic == host_commands[n].topic) &&
+                (host_commands[previous - 1U].value == host_commands[n].value))
+            {
+                result->ambiguous++;
+            }
+        }
+        else
+        {
+            host_deliver(n, false, result);
+        }
+
+        unacked = 1U + host_random(inflight_count);
+        for (uint32_t i = inflight_count - unacked; i < inflight_count; i++)
+        {
+            host_deliver(inflight[i], true, result);
+            result->redeliveries++;
+        }
+        inflight_count = 0U;
+    }
+
+    for (uint32_t n = 0U; n < HOST_COMMANDS; n++)
+    {
+        if (host_applied[n] > 1U)
+        {
+            result->applied_twice += host_applied[n] - 1U;
+        }
+        else if (0U == host_applied[n])
+        {
+            result->never_applied++;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Replays 5000 commands with redeliveries and checks that every command is
+ *  applied exactly once while the broker keeps no more messages in flight
+ *  than a cache set can remember.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed replays
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static const host_replay_t replays[] =
+    {
+        { "1 in flight, ids 1..65535",    1U, 0U, true },
+        { "20 in flight, ids 1..65535",  20U, 0U, true },
+        { "64 in flight, ids 1..65535",  64U, 0U, true },
+        { "128 in flight, ids 1..65535", 128U, 0U, false },
+        { "4 in flight, ids 1..8",        4U, 8U, true },
+        { "2 in flight, ids 1..2",        2U, 2U, true },
+    };
+    host_result_t result;
+    bool pass;
+    int failures = 0;
+
+    printf("%-28s %10s %12s %8s %12s %13s %9s\n", "Replay of 5000 commands", "deliveries", "redeliveries",
+           "dropped", "applied > 1", "never applied", "ambiguous");
+    for (uint32_t i = 0U; i < (sizeof(replays) / sizeof(replays[0])); i++)
+    {
+        host_quiet = true;
+        host_replay(&replays[i], &result);
+        host_quiet = false;
+
+        /* Only an ambiguous message may be dropped wrongly, and duplicates
+         * may only get through where the broker keeps more messages in
+         * flight than the cache has slots.
+         */
+        pass = (result.never_applied <= result.ambiguous) &&
+               (!replays[i].expect_exactly_once || (0U == result.applied_twice)) &&
+               ((result.dropped + result.applied_twice + HOST_COMMANDS) ==
+                (result.deliveries + result.never_applied));
+        failures += pass ? 0 : 1;
+        printf("%-28s %10lu %12lu %8lu %12lu %13lu %9lu  %s\n", replays[i].name,
+               (unsigned long)result.deliveries, (unsigned long)result.redeliveries,
+               (unsigned long)result.dropped, (unsigned long)result.applied_twice,
+               (unsigned long)result.never_applied, (unsigned long)result.ambiguous, pass ? "pass" : "FAIL");
+    }
+
+    return failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,354 @@
+/******************************************************************************
+* File Name:   test_gpio_events.c
+*
+* Description: Host test of the GPIO event debouncer. Drives it with
+*              synthetic bounce patterns, with a prompt and a late debouncer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "gpio_events.c"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define HOST_MAX_EDGES                      (160U)
+#define HOST_MAX_EVENTS                     (8U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Synthetic input pattern and the events it must produce. */
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t input;
+    bool level;
+} host_edge_t;
+
+typedef struct
+{
+    uint8_t input;
+    gpio_event_type_t type;
+    uint8_t count;
+} host_event_t;
+
+typedef struct
+{
+    host_edge_t edges[HOST_MAX_EDGES];
+    uint32_t edge_count;
+    host_event_t expected[HOST_MAX_EVENTS];
+    uint32_t expected_count;
+} host_case_t;
+
+static const char *const host_event_names[] =
+{
+    "press", "multi-press", "long press"
+};
+
+static host_event_t host_events[HOST_MAX_EVENTS];
+static uint32_t host_event_count;
+
+/******************************************************************************
+ * Function Name: host_record_event
+ ******************************************************************************
+ * Summary:
+ *  Input handler of the test; records the event.
+ *
+ * Parameters:
+ *  const gpio_event_t *event : Event
+ *  void *context : Unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_record_event(const gpio_event_t *event, void *context)
+{
+    (void)context;
+
+    if (host_event_count < HOST_MAX_EVENTS)
+    {
+        host_events[host_event_count].input = event->input;
+        host_events[host_event_count].type = event->type;
+        host_events[host_event_count].count = event->count;
+    }
+    host_event_count++;
+}
+
+/******************************************************************************
+ * Function Name: host_add_press
+ ******************************************************************************
+ * Summary:
+ *  Adds a press to a pattern. Both the press and the release bounce the
+ *  given number of times, one edge per 'bounce_ms', before settling.
+ *
+ * Parameters:
+ *  host_case_t *test : Pattern
+ *  uint8_t input : Input index
+ *  uint32_t start_ms : Time of the first edge of the press
+ *  uint32_t duration_ms : Time from the first press edge to the first release edge
+ *  uint32_t bounces : Number of extra edge pairs on each transition
+ *  uint32_t bounce_ms : Time between bounce edges; 0 stacks them at one time
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_add_press(host_case_t *test, uint8_t input, uint32_t start_ms, uint32_t duration_ms,
+                           uint32_t bounces, uint32_t bounce_ms)
+{
+    uint32_t start[2] = { start_ms, start_ms + duration_ms };
+
+    for (uint32_t transition = 0U; transition < 2U; transition++)
+    {
+        for (uint32_t k = 0U; (k <= (2U * bounces)) && (test->edge_count < HOST_MAX_EDGES); k++)
+        {
+            test->edges[test->edge_count].time_ms = start[transition] + (k * bounce_ms);
+            test->edges[test->edge_count].input = input;
+            test->edges[test->edge_count].level = ((0U == (k & 1U)) == (0U == transition));
+            test->edge_count++;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: host_expect
+ ******************************************************************************
+ * Summary:
+ *  Adds an expected event to a pattern.
+ *
+ * Parameters:
+ *  host_case_t *test : Pattern
+ *  uint8_t input : Input index
+ *  gpio_event_type_t type : Event type
+ *  uint8_t count : Number of presses
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_expect(host_case_t *test, uint8_t input, gpio_event_type_t type, uint8_t count)
+{
+    test->expected[test->expected_count].input = input;
+    test->expected[test->expected_count].type = type;
+    test->expected[test->expected_count].count = count;
+    test->expected_count++;
+}
+
+/******************************************************************************
+ * Function Name: host_run
+ ******************************************************************************
+ * Summary:
+ *  Plays a pattern through the engine the way the target does: an edge
+ *  makes the debouncer run GPIO_EVENTS_DEBOUNCE_MS later unless it is due
+ *  by then, and every run re-arms it as requested. Each run is delayed by 'latency_ms' to model a
+ *  busy timer service task. Edges are pushed in pattern order, so a
+ *  pattern lists them by time.
+ *
+ * Parameters:
+ *  const char *name : Name of the pattern
+ *  const host_case_t *test : Pattern
+ *  uint32_t latency_ms : Extra delay of every debouncer run
+ *
+ * Return:
+ *  bool : true if the events matched the expected ones
+ *
+ ******************************************************************************/
+static bool host_run(const char *name, const host_case_t *test, uint32_t latency_ms)
+{
+    gpio_event_input_t config = { .name = "host", .active_low = false, .handler = host_record_event };
+    bool levels[GPIO_EVENTS_MAX_INPUTS] = { false };
+    uint32_t overflows_seen = 0U;
+    uint32_t edge = 0U;
+    uint32_t due_ms = 0U;
+    bool armed = false;
+    uint32_t next;
+    bool passed;
+
+    memset(inputs, 0, sizeof(inputs));
+    input_count = 0U;
+    ring_head = 0U;
+    ring_tail = 0U;
+    ring_overflows = 0U;
+    host_event_count = 0U;
+    for (uint32_t i = 0U; i < GPIO_EVENTS_MAX_INPUTS; i++)
+    {
+        (void) gpio_events_add_input(&config);
+    }
+
+    for (uint32_t now_ms = 0U; (edge < test->edge_count) || armed; now_ms++)
+    {
+        while ((edge < test->edge_count) && (test->edges[edge].time_ms == now_ms))
+        {
+            levels[test->edges[edge].input] = test->edges[edge].level;
+            (void) gpio_events_push_edge(test->edges[edge].input, test->edges[edge].level, now_ms);
+            if (!armed || ((int32_t)(due_ms - now_ms) > (int32_t)(GPIO_EVENTS_DEBOUNCE_MS + latency_ms)))
+            {
+                armed = true;
+                due_ms = now_ms + GPIO_EVENTS_DEBOUNCE_MS + latency_ms;
+            }
+            edge++;
+        }
+
+        if (!armed || (now_ms < due_ms))
+        {
+            continue;
+        }
+
+        if (gpio_events_overflows() != overflows_seen)
+        {
+            overflows_seen = gpio_events_overflows();
+            (void) gpio_events_process(now_ms);
+            for (uint32_t i = 0U; i < GPIO_EVENTS_MAX_INPUTS; i++)
+            {
+                gpio_events_resync((uint8_t)i, levels[i], now_ms);
+            }
+        }
+
+        next = gpio_events_process(now_ms);
+        armed = (GPIO_EVENTS_IDLE != next) || (ring_tail != ring_head);
+        due_ms = now_ms + ((GPIO_EVENTS_IDLE != next) ? ((0U == next) ? 1U : next) : GPIO_EVENTS_DEBOUNCE_MS) +
+                 latency_ms;
+    }
+
+    passed = (host_event_count == test->expected_count);
+    for (uint32_t i = 0U; passed && (i < host_event_count); i++)
+    {
+        passed = (host_events[i].input == test->expected[i].input) &&
+                 (host_events[i].type == test->expected[i].type) &&
+                 (host_events[i].count == test->expected[i].count);
+    }
+
+    printf("%s %s (latency %lu ms, %lu edges, %lu dropped):", passed ? "PASS" : "FAIL", name,
+           (unsigned long)latency_ms, (unsigned long)test->edge_count, (unsigned long)gpio_events_overflows());
+    for (uint32_t i = 0U; (i < host_event_count) && (i < HOST_MAX_EVENTS); i++)
+    {
+        printf(" %u:%s x%u", (unsigned int)host_events[i].input, host_event_names[host_events[i].type],
+               (unsigned int)host_events[i].count);
+    }
+    printf("\n");
+
+    return passed;
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Runs every bounce pattern with a prompt and a late debouncer.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed patterns
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static host_case_t tests[10];
+    static const char *const names[10] =
+    {
+        "clean press", "bouncy press", "glitch", "double press", "triple press",
+        "long press", "separate presses", "two inputs", "press then long press", "ring overflow"
+    };
+    const uint32_t latencies[] = { 0U, 150U };
+    int failures = 0;
+
+    host_add_press(&tests[0], 0U, 10U, 100U, 0U, 1U);
+    host_expect(&tests[0], 0U, GPIO_EVENT_PRESS, 1U);
+
+    host_add_press(&tests[1], 0U, 10U, 120U, 4U, 1U);
+    host_expect(&tests[1], 0U, GPIO_EVENT_PRESS, 1U);
+
+    /* A spike shorter than the debounce time, bouncing on both sides. */
+    host_add_press(&tests[2], 0U, 10U, 6U, 1U, 2U);
+
+    host_add_press(&tests[3], 0U, 10U, 80U, 3U, 2U);
+    host_add_press(&tests[3], 0U, 250U, 80U, 3U, 2U);
+    host_expect(&tests[3], 0U, GPIO_EVENT_MULTI_PRESS, 2U);
+
+    host_add_press(&tests[4], 0U, 10U, 60U, 2U, 1U);
+    host_add_press(&tests[4], 0U, 200U, 60U, 2U, 1U);
+    host_add_press(&tests[4], 0U, 400U, 60U, 2U, 1U);
+    host_expect(&tests[4], 0U, GPIO_EVENT_MULTI_PRESS, 3U);
+
+    host_add_press(&tests[5], 0U, 10U, 1500U, 5U, 1U);
+    host_expect(&tests[5], 0U, GPIO_EVENT_LONG_PRESS, 1U);
+
+    host_add_press(&tests[6], 0U, 10U, 80U, 2U, 1U);
+    host_add_press(&tests[6], 0U, 800U, 80U, 2U, 1U);
+    host_expect(&tests[6], 0U, GPIO_EVENT_PRESS, 1U);
+    host_expect(&tests[6], 0U, GPIO_EVENT_PRESS, 1U);
+
+    /* Interleaved presses on two inputs; the edges are listed by time. */
+    host_add_press(&tests[7], 0U, 10U, 100U, 0U, 1U);
+    host_add_press(&tests[7], 1U, 40U, 100U, 0U, 1U);
+    {
+        host_edge_t swap = tests[7].edges[1];
+        tests[7].edges[1] = tests[7].edges[2];
+        tests[7].edges[2] = swap;
+    }
+    host_expect(&tests[7], 0U, GPIO_EVENT_PRESS, 1U);
+    host_expect(&tests[7], 1U, GPIO_EVENT_PRESS, 1U);
+
+    host_add_press(&tests[8], 0U, 10U, 80U, 2U, 1U);
+    host_add_press(&tests[8], 0U, 200U, 1300U, 2U, 1U);
+    host_expect(&tests[8], 0U, GPIO_EVENT_PRESS, 1U);
+    host_expect(&tests[8], 0U, GPIO_EVENT_LONG_PRESS, 1U);
+
+    /* More bounce edges in one millisecond than the ring holds. */
+    host_add_press(&tests[9], 0U, 10U, 200U, GPIO_EVENTS_RING_SIZE, 0U);
+    host_expect(&tests[9], 0U, GPIO_EVENT_PRESS, 1U);
+
+    for (uint32_t latency = 0U; latency < (sizeof(latencies) / sizeof(latencies[0])); latency++)
+    {
+        for (uint32_t i = 0U; i < (sizeof(tests) / sizeof(tests[0])); i++)
+        {
+            failures += host_run(names[i], &tests[i], latencies[latency]) ? 0 : 1;
+        }
+    }
+
+    printf("%d of %u patterns failed\n", failures,
+           (unsigned int)(2U * (sizeof(tests) / sizeof(tests[0]))));
+
+    return failures;
+}
+
+/* [] END OF FILE */
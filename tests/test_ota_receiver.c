@@ -0,0 +1,556 @@
+/******************************************************************************
+* File Name:   test_ota_receiver.c
+*
+* Description: Host test of the OTA receiver. Streams images through the
+*              receiver and the writer into a timed flash emulator and checks
+*              the throughput and the handling of faulty updates.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ota_receiver.c"
+
+/* Image streamed in each scenario and payload of a fragment. */
+#define HOST_IMAGE_SIZE                     (0x00100000UL)
+#define HOST_FRAGMENT_DATA_SIZE             (1024U)
+
+/* Flash timing of a scenario. */
+typedef struct
+{
+    const char *name;
+    uint32_t erase_us;      /* Per OTA_FLASH_ERASE_SIZE sector */
+    uint32_t program_us;    /* Per OTA_FLASH_PROGRAM_SIZE page */
+} host_flash_timing_t;
+
+/* Fault injected into the fragment stream of an update. */
+typedef enum
+{
+    HOST_FAULT_NONE,
+    HOST_FAULT_DUPLICATE,   /* A fragment is delivered again */
+    HOST_FAULT_MISSING,     /* A fragment is lost */
+    HOST_FAULT_SHA256,      /* The manifest has a wrong hash */
+    HOST_FAULT_OVERSIZED    /* The image does not fit the slot */
+} host_fault_t;
+
+/* Writer command with the receiver time it was sent at. */
+typedef struct
+{
+    ota_writer_msg_t msg;
+    uint64_t time_us;
+} host_msg_t;
+
+static uint8_t host_flash[OTA_SECONDARY_SLOT_SIZE];
+static uint8_t host_image[HOST_IMAGE_SIZE];
+static const host_flash_timing_t *host_timing;
+static uint32_t host_program_errors;
+
+/* The receiver and the writer each have a clock of their own; the tick
+ * count is the one of the side that is running.
+ */
+static uint64_t host_rx_us;
+static uint64_t host_writer_us;
+static uint64_t *host_clock_us;
+static host_msg_t host_queue[OTA_WRITER_QUEUE_LENGTH];
+static uint32_t host_queue_head;
+static uint32_t host_queue_count;
+static uint64_t host_free_us[OTA_BUFFER_COUNT];
+static uint32_t host_free_head;
+static uint32_t host_free_count = OTA_BUFFER_COUNT;
+
+/******************************************************************************
+ * Function Name: host_flash_erase
+ ******************************************************************************
+ * Summary:
+ *  Emulated erase of the secondary slot; takes erase_us of writer time per
+ *  sector.
+ *
+ ******************************************************************************/
+static bool host_flash_erase(uint32_t offset, uint32_t length)
+{
+    offset -= OTA_SECONDARY_SLOT_OFFSET;
+    if ((0U != (offset % OTA_FLASH_ERASE_SIZE)) || (0U != (length % OTA_FLASH_ERASE_SIZE)) ||
+        ((offset + length) > OTA_SECONDARY_SLOT_SIZE))
+    {
+        return false;
+    }
+
+    memset(&host_flash[offset], 0xFF, length);
+    host_writer_us += (uint64_t)(length / OTA_FLASH_ERASE_SIZE) * host_timing->erase_us;
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_flash_program
+ ******************************************************************************
+ * Summary:
+ *  Emulated page program; takes program_us of writer time per page touched.
+ *  Like the real flash it can only clear bits, and counts any byte that was
+ *  not erased before.
+ *
+ ******************************************************************************/
+static bool host_flash_program(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    uint32_t pages;
+
+    offset -= OTA_SECONDARY_SLOT_OFFSET;
+    if ((offset + length) > OTA_SECONDARY_SLOT_SIZE)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        if ((host_flash[offset + i] & data[i]) != data[i])
+        {
+            host_program_errors++;
+        }
+        host_flash[offset + i] &= data[i];
+    }
+
+    pages = ((offset + length + OTA_FLASH_PROGRAM_SIZE - 1U) / OTA_FLASH_PROGRAM_SIZE) -
+            (offset / OTA_FLASH_PROGRAM_SIZE);
+    host_writer_us += (uint64_t)pages * host_timing->program_us;
+
+    return true;
+}
+
+static const ota_flash_ops_t host_flash_ops =
+{
+    .erase = host_flash_erase,
+    .program = host_flash_program
+};
+
+/******************************************************************************
+ * Function Name: host_writer_step
+ ******************************************************************************
+ * Summary:
+ *  Runs one iteration of the writer task loop on the writer clock: the next
+ *  command sent by then, else an erase-ahead, else an idle wait for the
+ *  next command. Nothing is started after 'until_us', the time up to which
+ *  the receiver has sent its commands.
+ *
+ * Parameters:
+ *  uint64_t until_us : Receiver time
+ *
+ * Return:
+ *  bool : false if the writer has nothing to do until then
+ *
+ ******************************************************************************/
+static bool host_writer_step(uint64_t until_us)
+{
+    host_msg_t *next = &host_queue[host_queue_head];
+    ota_writer_msg_t msg;
+
+    host_clock_us = &host_writer_us;
+
+    if ((host_queue_count > 0U) && (next->time_us <= host_writer_us))
+    {
+        msg = next->msg;
+        host_queue_head = (host_queue_head + 1U) % OTA_WRITER_QUEUE_LENGTH;
+        host_queue_count--;
+        ota_writer_handle(&msg);
+        return true;
+    }
+
+    if (host_writer_us >= until_us)
+    {
+        return false;
+    }
+
+    if (ota_writer_erase_pending())
+    {
+        ota_writer_erase_next();
+        return true;
+    }
+
+    if ((host_queue_count > 0U) && (next->time_us <= until_us))
+    {
+        host_writer_us = next->time_us;
+        return true;
+    }
+
+    if (until_us != UINT64_MAX)
+    {
+        host_writer_us = until_us;
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: xTaskGetTickCount
+ ******************************************************************************
+ * Summary:
+ *  Returns the clock of the side that is running, in milliseconds.
+ *
+ ******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(*host_clock_us / 1000U);
+}
+
+/******************************************************************************
+ * Function Name: xQueueSend
+ ******************************************************************************
+ * Summary:
+ *  Writer queue, called by the receiver. Each command is stamped with the
+ *  receiver time it was sent at.
+ *
+ ******************************************************************************/
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    host_msg_t *slot;
+
+    if (OTA_WRITER_QUEUE_LENGTH == host_queue_count)
+    {
+        printf("Host: writer queue overflow\n");
+        exit(EXIT_FAILURE);
+    }
+
+    slot = &host_queue[(host_queue_head + host_queue_count) % OTA_WRITER_QUEUE_LENGTH];
+    memcpy(&slot->msg, item, sizeof(slot->msg));
+    slot->time_us = host_rx_us;
+    host_queue_count++;
+
+    return pdPASS;
+}
+
+/******************************************************************************
+ * Function Name: xSemaphoreTake
+ ******************************************************************************
+ * Summary:
+ *  Free buffers, taken by the receiver. While no buffer is free the
+ *  receiver is blocked and the writer runs; the receiver resumes when the
+ *  writer frees a buffer.
+ *
+ ******************************************************************************/
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    uint64_t free_us;
+
+    while ((0U == host_free_count) && host_writer_step(UINT64_MAX))
+    {
+    }
+    host_clock_us = &host_rx_us;
+
+    if (0U == host_free_count)
+    {
+        return pdFALSE;
+    }
+
+    free_us = host_free_us[host_free_head];
+    host_free_head = (host_free_head + 1U) % OTA_BUFFER_COUNT;
+    host_free_count--;
+    if (free_us > host_rx_us)
+    {
+        host_rx_us = free_us;
+    }
+
+    return pdTRUE;
+}
+
+/******************************************************************************
+ * Function Name: xSemaphoreGive
+ ******************************************************************************
+ * Summary:
+ *  Free buffers, given back by the writer.
+ *
+ ******************************************************************************/
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    host_free_us[(host_free_head + host_free_count) % OTA_BUFFER_COUNT] = host_writer_us;
+    host_free_count++;
+
+    return pdTRUE;
+}
+
+/******************************************************************************
+ * Function Name: publisher_enqueue_copy
+ ******************************************************************************
+ * Summary:
+ *  Publisher; the status is already printed by the receiver.
+ *
+ ******************************************************************************/
+BaseType_t publisher_enqueue_copy(publisher_lane_t lane, const char *topic, const char *data)
+{
+    return pdPASS;
+}
+
+/******************************************************************************
+ * Function Name: wifi_powersave_expect
+ ******************************************************************************
+ * Summary:
+ *  Radio power save; there is no radio on the host.
+ *
+ ******************************************************************************/
+void wifi_powersave_expect(wifi_traffic_t traffic, uint32_t duration_ms)
+{
+}
+
+/******************************************************************************
+ * Function Name: host_fragment
+ ******************************************************************************
+ * Summary:
+ *  Delivers a fragment to the receiver at the current receiver time, after
+ *  the writer has caught up with it.
+ *
+ ******************************************************************************/
+static void host_fragment(uint32_t sequence, const uint8_t *data, uint32_t length)
+{
+    static uint8_t fragment[OTA_FRAGMENT_HEADER_SIZE + OTA_MANIFEST_SIZE + HOST_FRAGMENT_DATA_SIZE];
+
+    while (host_writer_step(host_rx_us))
+    {
+    }
+    host_clock_us = &host_rx_us;
+
+    fragment[0] = (uint8_t)sequence;
+    fragment[1] = (uint8_t)(sequence >> 8);
+    fragment[2] = (uint8_t)(sequence >> 16);
+    fragment[3] = (uint8_t)(sequence >> 24);
+    memcpy(&fragment[OTA_FRAGMENT_HEADER_SIZE], data, length);
+
+    ota_receiver_handle_fragment(fragment, OTA_FRAGMENT_HEADER_SIZE + length);
+}
+
+/******************************************************************************
+ * Function Name: host_update
+ ******************************************************************************
+ * Summary:
+ *  Streams the test image over a link of 'link_kbps' KB/s into a slot full
+ *  of stale data, then lets the writer finish. Each fragment is sent once
+ *  the previous one has been handled, like a QoS 1 sender that waits for
+ *  the PUBACK.
+ *
+ * Parameters:
+ *  uint32_t link_kbps : Throughput of the link
+ *  host_fault_t fault : Fault injected into the stream
+ *  uint64_t *duration_us : Time from the manifest to the end of the writer
+ *
+ * Return:
+ *  ota_state_t : Final state of the update
+ *
+ ******************************************************************************/
+static ota_state_t host_update(uint32_t link_kbps, host_fault_t fault, uint64_t *duration_us)
+{
+    uint8_t manifest[OTA_MANIFEST_SIZE];
+    mbedtls_sha256_context sha256;
+    uint32_t image_size = (HOST_FAULT_OVERSIZED == fault) ? OTA_SECONDARY_SLOT_SIZE : HOST_IMAGE_SIZE;
+    uint32_t fragments = (HOST_IMAGE_SIZE + HOST_FRAGMENT_DATA_SIZE - 1U) / HOST_FRAGMENT_DATA_SIZE;
+    uint64_t fragment_us = ((uint64_t)HOST_FRAGMENT_DATA_SIZE * 1000000U) / ((uint64_t)link_kbps * 1024U);
+    uint64_t start_us;
+    uint32_t offset;
+    uint32_t length;
+
+    for (uint32_t i = 0U; i < OTA_SECONDARY_SLOT_SIZE; i++)
+    {
+        host_flash[i] = (uint8_t)(i * 7U);
+    }
+    host_program_errors = 0U;
+
+    mbedtls_sha256_init(&sha256);
+    mbedtls_sha256_starts(&sha256, 0);
+    mbedtls_sha256_update(&sha256, host_image, HOST_IMAGE_SIZE);
+    mbedtls_sha256_finish(&sha256, &manifest[4]);
+    mbedtls_sha256_free(&sha256);
+    manifest[0] = (uint8_t)image_size;
+    manifest[1] = (uint8_t)(image_size >> 8);
+    manifest[2] = (uint8_t)(image_size >> 16);
+    manifest[3] = (uint8_t)(image_size >> 24);
+    if (HOST_FAULT_SHA256 == fault)
+    {
+        manifest[4] ^= 0x01U;
+    }
+
+    if (host_writer_us > host_rx_us)
+    {
+        host_rx_us = host_writer_us;
+    }
+    start_us = host_rx_us;
+
+    host_fragment(0U, manifest, OTA_MANIFEST_SIZE);
+    for (uint32_t sequence = 1U; sequence <= fragments; sequence++)
+    {
+        if ((HOST_FAULT_MISSING == fault) && (sequence == (fragments / 2U)))
+        {
+            continue;
+        }
+
+        offset = (sequence - 1U) * HOST_FRAGMENT_DATA_SIZE;
+        length = HOST_IMAGE_SIZE - offset;
+        if (length > HOST_FRAGMENT_DATA_SIZE)
+        {
+            length = HOST_FRAGMENT_DATA_SIZE;
+        }
+
+        host_rx_us += fragment_us;
+        host_fragment(sequence, &host_image[offset], length);
+
+        if ((HOST_FAULT_DUPLICATE == fault) && (0U == (sequence % 100U)))
+        {
+            host_rx_us += fragment_us;
+            host_fragment(sequence - 1U, &host_image[offset - HOST_FRAGMENT_DATA_SIZE],
+                          HOST_FRAGMENT_DATA_SIZE);
+        }
+    }
+
+    while (host_writer_step(UINT64_MAX))
+    {
+    }
+    *duration_us = host_writer_us - start_us;
+
+    return ota_receiver_get_state();
+}
+
+/******************************************************************************
+ * Function Name: host_boot_requested
+ ******************************************************************************
+ * Summary:
+ *  Checks if the boot magic is at the end of the emulated slot.
+ *
+ ******************************************************************************/
+static bool host_boot_requested(void)
+{
+    return (0 == memcmp(&host_flash[OTA_SECONDARY_SLOT_SIZE - OTA_BOOT_MAGIC_SIZE],
+                        ota_boot_magic, OTA_BOOT_MAGIC_SIZE));
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Streams a 1 MB image through the receiver and the writer into the flash
+ *  emulator for several link and flash speeds and reports the throughput,
+ *  then checks that duplicated, missing, corrupted and oversized updates
+ *  are handled. Typical timing is an assumption for the S25FS128S; the
+ *  worst case is the eraseTime and programTime of its memory configuration.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed checks
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static const host_flash_timing_t typical = { "typical",    275000U,  450U };
+    static const host_flash_timing_t worst   = { "worst case", 725000U, 2000U };
+    static const struct
+    {
+        const host_flash_timing_t *timing;
+        uint32_t link_kbps;
+    } runs[] =
+    {
+        { &typical,  100U },
+        { &typical,  400U },
+        { &typical, 2000U },
+        { &worst,    400U }
+    };
+    static const struct
+    {
+        const char *name;
+        host_fault_t fault;
+        ota_state_t state;
+    } faults[] =
+    {
+        { "duplicated fragments", HOST_FAULT_DUPLICATE, OTA_STATE_VERIFIED },
+        { "missing fragment",     HOST_FAULT_MISSING,   OTA_STATE_FAILED   },
+        { "SHA-256 mismatch",     HOST_FAULT_SHA256,    OTA_STATE_FAILED   },
+        { "oversized image",      HOST_FAULT_OVERSIZED, OTA_STATE_FAILED   }
+    };
+    uint64_t duration_us;
+    uint64_t flash_us;
+    ota_state_t state;
+    bool intact;
+    bool passed;
+    int failures = 0;
+
+    for (uint32_t i = 0U; i < HOST_IMAGE_SIZE; i++)
+    {
+        host_image[i] = (uint8_t)((i * 2654435761UL) >> 13);
+    }
+
+    ota_writer_q = (QueueHandle_t)host_queue;
+    ota_free_buffers = (SemaphoreHandle_t)host_free_us;
+    host_clock_us = &host_rx_us;
+    ota_receiver_set_flash_ops(&host_flash_ops);
+
+    printf("OTA receiver: %lu byte image, %u byte fragments, %u x %u byte buffers\n\n",
+           (unsigned long)HOST_IMAGE_SIZE, (unsigned int)HOST_FRAGMENT_DATA_SIZE,
+           (unsigned int)OTA_BUFFER_COUNT, (unsigned int)OTA_BUFFER_SIZE);
+
+    for (uint32_t i = 0U; i < (sizeof(runs) / sizeof(runs[0])); i++)
+    {
+        host_timing = runs[i].timing;
+        state = host_update(runs[i].link_kbps, HOST_FAULT_NONE, &duration_us);
+
+        /* Time the flash alone needs for the image, without overlap. */
+        flash_us = ((uint64_t)OTA_ROUND_UP(HOST_IMAGE_SIZE, OTA_FLASH_ERASE_SIZE) / OTA_FLASH_ERASE_SIZE) *
+                   host_timing->erase_us +
+                   ((uint64_t)HOST_IMAGE_SIZE / OTA_FLASH_PROGRAM_SIZE) * host_timing->program_us;
+
+        intact = (0 == memcmp(host_flash, host_image, HOST_IMAGE_SIZE)) && (0U == host_program_errors);
+        passed = (OTA_STATE_VERIFIED == state) && intact && host_boot_requested();
+        failures += passed ? 0 : 1;
+
+        printf("%s flash, %u KB/s link: %.1f KB/s end to end (flash alone %.1f KB/s) - %s\n\n",
+               host_timing->name, (unsigned int)runs[i].link_kbps,
+               ((double)HOST_IMAGE_SIZE * 1000000.0) / ((double)duration_us * 1024.0),
+               ((double)HOST_IMAGE_SIZE * 1000000.0) / ((double)flash_us * 1024.0),
+               passed ? "pass" : "FAIL");
+    }
+
+    host_timing = &typical;
+    for (uint32_t i = 0U; i < (sizeof(faults) / sizeof(faults[0])); i++)
+    {
+        state = host_update(2000U, faults[i].fault, &duration_us);
+
+        intact = (0 == memcmp(host_flash, host_image, HOST_IMAGE_SIZE)) && (0U == host_program_errors);
+        passed = (faults[i].state == state) &&
+                 ((OTA_STATE_VERIFIED == state) ? (intact && host_boot_requested()) : !host_boot_requested());
+        failures += passed ? 0 : 1;
+
+        printf("%s: %s\n\n", faults[i].name, passed ? "pass" : "FAIL");
+    }
+
+    return failures;
+}
+
+/* [] END OF FILE */
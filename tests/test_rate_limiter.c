@@ -0,0 +1,428 @@
+/******************************************************************************
+* File Name:   test_rate_limiter.c
+*
+* Description: Host simulation of the publisher lanes over the rate limiter.
+*              Measures the alarm latency under saturating bulk load and the
+*              recovery of bulk traffic after urgent floods.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rate_limiter.c"
+
+/* Simulated time base. */
+static TickType_t sim_now_ms;
+
+/******************************************************************************
+ * Function Name: xTaskGetTickCount
+ ******************************************************************************
+ * Summary:
+ *  Returns the simulated time, one tick per millisecond.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  TickType_t : Simulated tick count
+ *
+ ******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    return sim_now_ms;
+}
+
+/******************************************************************************
+* Host simulation
+******************************************************************************/
+/* Defaults of mqtt_client_config.h and publisher_task.c, which need the
+ * target SDK; override them with -D to model another setup.
+ */
+#ifndef MQTT_PUBLISH_RATE_MSGS_PER_SEC
+#define MQTT_PUBLISH_RATE_MSGS_PER_SEC      (5U)
+#endif
+#ifndef MQTT_PUBLISH_BURST_MSGS
+#define MQTT_PUBLISH_BURST_MSGS             (10U)
+#endif
+#ifndef MQTT_PUBLISH_RATE_BYTES_PER_SEC
+#define MQTT_PUBLISH_RATE_BYTES_PER_SEC     (4096U)
+#endif
+#ifndef MQTT_PUBLISH_BURST_BYTES
+#define MQTT_PUBLISH_BURST_BYTES            (8192U)
+#endif
+#ifndef PUBLISHER_URGENT_QUEUE_LENGTH
+#define PUBLISHER_URGENT_QUEUE_LENGTH       (4U)
+#endif
+#ifndef PUBLISHER_URGENT_SLO_MS
+#define PUBLISHER_URGENT_SLO_MS             (500U)
+#endif
+
+/* Depth of the single publisher queue before the lanes were added. */
+#define SIM_LEGACY_QUEUE_LENGTH             (3U)
+
+/* Simulated time, message sizes on the wire and the time from the hand-off
+ * to cy_mqtt_publish() until the PUBACK, drawn uniformly.
+ */
+#define SIM_DURATION_MS                     (3600000U)
+#define SIM_BULK_BYTES                      (230U)
+#define SIM_ALARM_BYTES                     (80U)
+#define SIM_PUBLISH_MIN_MS                  (20U)
+#define SIM_PUBLISH_MAX_MS                  (120U)
+
+/* Alarms arrive at random, one every SIM_ALARM_MEAN_GAP_MS on average. */
+#define SIM_ALARM_MEAN_GAP_MS               (3000U)
+#define SIM_MAX_ALARMS                      (4096U)
+
+/* Urgent flood above the message rate, e.g. a stuck alarm source. */
+#define SIM_FLOOD_RATE_PER_SEC              (20U)
+#define SIM_SEED                            (12345U)
+
+/* Publisher designs compared by the simulation. */
+typedef enum
+{
+    SIM_POLICY_SINGLE_FIFO,     /* One queue, alarms wait behind telemetry */
+    SIM_POLICY_LANES,           /* Urgent lane drained before every bulk message */
+    SIM_POLICY_COUNT
+} sim_policy_t;
+
+static const char *const sim_policy_names[SIM_POLICY_COUNT] =
+{
+    "single FIFO", "lanes"
+};
+
+typedef struct
+{
+    uint32_t alarms;
+    uint32_t dropped;
+    uint32_t bulk;
+    uint32_t latency_count;
+    uint32_t latency_ms[SIM_MAX_ALARMS];
+} sim_result_t;
+
+static uint32_t sim_random_state;
+
+/******************************************************************************
+ * Function Name: sim_random
+ ******************************************************************************
+ * Summary:
+ *  Deterministic pseudo-random generator of the simulation.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t : Next pseudo-random number
+ *
+ ******************************************************************************/
+static uint32_t sim_random(void)
+{
+    sim_random_state = (sim_random_state * 1103515245U) + 12345U;
+
+    return sim_random_state >> 8;
+}
+
+/******************************************************************************
+ * Function Name: sim_compare
+ ******************************************************************************
+ * Summary:
+ *  qsort() comparator of latencies.
+ *
+ * Parameters:
+ *  const void *a : First latency
+ *  const void *b : Second latency
+ *
+ * Return:
+ *  int : Negative, zero or positive as a is below, equal to or above b
+ *
+ ******************************************************************************/
+static int sim_compare(const void *a, const void *b)
+{
+    uint32_t left = *(const uint32_t *)a;
+    uint32_t right = *(const uint32_t *)b;
+
+    return (left > right) - (left < right);
+}
+
+/******************************************************************************
+ * Function Name: sim_run
+ ******************************************************************************
+ * Summary:
+ *  Simulates the publisher for SIM_DURATION_MS with a bulk producer that
+ *  keeps its queue full and alarms at random times, and records the latency
+ *  of every alarm from its creation to its PUBACK. Single FIFO models the
+ *  former publisher: one queue, no rate limit, and an alarm producer that
+ *  blocks while the queue is full.
+ *
+ * Parameters:
+ *  sim_policy_t policy : Publisher design
+ *  sim_result_t *result : Result
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sim_run(sim_policy_t policy, sim_result_t *result)
+{
+    rate_limiter_t limiter;
+    uint32_t fifo_alarm_ms[SIM_LEGACY_QUEUE_LENGTH + SIM_MAX_ALARMS];
+    bool fifo_is_alarm[SIM_LEGACY_QUEUE_LENGTH];
+    uint32_t fifo_count = 0U;
+    uint32_t blocked_ms[SIM_MAX_ALARMS];
+    uint32_t blocked_count = 0U;
+    uint32_t urgent_ms[PUBLISHER_URGENT_QUEUE_LENGTH];
+    uint32_t urgent_count = 0U;
+    bool busy = false;
+    bool busy_alarm = false;
+    uint32_t busy_since_ms = 0U;
+    uint32_t busy_until_ms = 0U;
+
+    memset(result, 0, sizeof(*result));
+    sim_random_state = SIM_SEED;
+    sim_now_ms = 0U;
+    rate_limiter_init(&limiter, MQTT_PUBLISH_RATE_MSGS_PER_SEC, MQTT_PUBLISH_BURST_MSGS,
+                      MQTT_PUBLISH_RATE_BYTES_PER_SEC, MQTT_PUBLISH_BURST_BYTES);
+
+    for (sim_now_ms = 0U; sim_now_ms < SIM_DURATION_MS; sim_now_ms++)
+    {
+        if (((sim_random() % SIM_ALARM_MEAN_GAP_MS) == 0U) && (result->alarms < SIM_MAX_ALARMS))
+        {
+            result->alarms++;
+            if (SIM_POLICY_LANES == policy)
+            {
+                /* publisher_enqueue() never blocks; a full lane drops. */
+                if (urgent_count < PUBLISHER_URGENT_QUEUE_LENGTH)
+                {
+                    urgent_ms[urgent_count++] = sim_now_ms;
+                }
+                else
+                {
+                    result->dropped++;
+                }
+            }
+            else
+            {
+                blocked_ms[blocked_count++] = sim_now_ms;
+            }
+        }
+
+        if (SIM_POLICY_SINGLE_FIFO == policy)
+        {
+            /* Blocked alarms get the free slots first, then the telemetry
+             * fills the queue up again.
+             */
+            while ((0U != blocked_count) && (fifo_count < SIM_LEGACY_QUEUE_LENGTH))
+            {
+                fifo_alarm_ms[fifo_count] = blocked_ms[0];
+                fifo_is_alarm[fifo_count++] = true;
+                memmove(&blocked_ms[0], &blocked_ms[1], (--blocked_count) * sizeof(blocked_ms[0]));
+            }
+            while (fifo_count < SIM_LEGACY_QUEUE_LENGTH)
+            {
+                fifo_is_alarm[fifo_count++] = false;
+            }
+        }
+
+        if (busy && (sim_now_ms >= busy_until_ms))
+        {
+            busy = false;
+            if (busy_alarm)
+            {
+                result->latency_ms[result->latency_count++] = sim_now_ms - busy_since_ms;
+            }
+            else
+            {
+                result->bulk++;
+            }
+        }
+        if (busy)
+        {
+            continue;
+        }
+
+        if (SIM_POLICY_LANES == policy)
+        {
+            if (0U != urgent_count)
+            {
+                rate_limiter_force_acquire(&limiter, SIM_ALARM_BYTES);
+                busy = true;
+                busy_alarm = true;
+                busy_since_ms = urgent_ms[0];
+                memmove(&urgent_ms[0], &urgent_ms[1], (--urgent_count) * sizeof(urgent_ms[0]));
+            }
+            else if (rate_limiter_try_acquire(&limiter, SIM_BULK_BYTES))
+            {
+                /* The bulk lane is always full. */
+                busy = true;
+                busy_alarm = false;
+            }
+        }
+        else
+        {
+            busy = true;
+            busy_alarm = fifo_is_alarm[0];
+            busy_since_ms = fifo_alarm_ms[0];
+            fifo_count--;
+            memmove(&fifo_is_alarm[0], &fifo_is_alarm[1], fifo_count * sizeof(fifo_is_alarm[0]));
+            memmove(&fifo_alarm_ms[0], &fifo_alarm_ms[1], fifo_count * sizeof(fifo_alarm_ms[0]));
+        }
+
+        if (busy)
+        {
+            busy_until_ms = sim_now_ms + SIM_PUBLISH_MIN_MS +
+                            (sim_random() % (SIM_PUBLISH_MAX_MS - SIM_PUBLISH_MIN_MS + 1U));
+        }
+    }
+
+    qsort(result->latency_ms, result->latency_count, sizeof(result->latency_ms[0]), sim_compare);
+}
+
+/******************************************************************************
+ * Function Name: sim_flood_recovery_ms
+ ******************************************************************************
+ * Summary:
+ *  Forces urgent messages through the limiter at SIM_FLOOD_RATE_PER_SEC for
+ *  'flood_ms', then returns how long a bulk message waits afterwards.
+ *
+ * Parameters:
+ *  uint32_t flood_ms : Duration of the urgent flood
+ *
+ * Return:
+ *  uint32_t : Time from the end of the flood until a bulk message passes
+ *
+ ******************************************************************************/
+static uint32_t sim_flood_recovery_ms(uint32_t flood_ms)
+{
+    rate_limiter_t limiter;
+    uint32_t end_ms;
+
+    sim_now_ms = 0U;
+    rate_limiter_init(&limiter, MQTT_PUBLISH_RATE_MSGS_PER_SEC, MQTT_PUBLISH_BURST_MSGS,
+                      MQTT_PUBLISH_RATE_BYTES_PER_SEC, MQTT_PUBLISH_BURST_BYTES);
+
+    for (sim_now_ms = 0U; sim_now_ms < flood_ms; sim_now_ms += (1000U / SIM_FLOOD_RATE_PER_SEC))
+    {
+        rate_limiter_force_acquire(&limiter, SIM_ALARM_BYTES);
+    }
+
+    end_ms = sim_now_ms;
+    while (!rate_limiter_try_acquire(&limiter, SIM_BULK_BYTES))
+    {
+        sim_now_ms++;
+    }
+
+    return sim_now_ms - end_ms;
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Prints the end-to-end alarm latency of each publisher design under
+ *  saturating bulk load and checks the lanes against the urgent SLO, then
+ *  checks that bulk messages recover from urgent floods of any length.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed checks
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static sim_result_t result;
+    static const uint32_t flood_ms[] = { 10000U, 60000U, 600000U };
+    uint32_t count;
+    uint32_t recovery_ms;
+    uint32_t bound_ms;
+    int failures = 0;
+
+    printf("Alarm latency under saturating bulk load: %u ms simulated, publish %u-%u ms, "
+           "alarm every %u ms on average\n",
+           (unsigned int)SIM_DURATION_MS, (unsigned int)SIM_PUBLISH_MIN_MS,
+           (unsigned int)SIM_PUBLISH_MAX_MS, (unsigned int)SIM_ALARM_MEAN_GAP_MS);
+    printf("  %-12s %7s %8s %7s %7s %7s %7s %9s\n", "Design", "Alarms", "Dropped", "p50 ms", "p99 ms",
+           "Max ms", "Bulk/s", "Result");
+
+    for (uint32_t policy = 0U; policy < SIM_POLICY_COUNT; policy++)
+    {
+        bool passed = true;
+
+        sim_run((sim_policy_t)policy, &result);
+        count = result.latency_count;
+
+        if (SIM_POLICY_LANES == policy)
+        {
+            passed = (0U != count) && (0U == result.dropped) &&
+                     (result.latency_ms[count - 1U] <= PUBLISHER_URGENT_SLO_MS);
+            failures += passed ? 0 : 1;
+        }
+
+        printf("  %-12s %7lu %8lu %7lu %7lu %7lu %7.2f %9s\n", sim_policy_names[policy],
+               (unsigned long)result.alarms, (unsigned long)result.dropped,
+               (unsigned long)((0U != count) ? result.latency_ms[count / 2U] : 0U),
+               (unsigned long)((0U != count) ? result.latency_ms[(count * 99U) / 100U] : 0U),
+               (unsigned long)((0U != count) ? result.latency_ms[count - 1U] : 0U),
+               ((double)result.bulk * 1000.0) / SIM_DURATION_MS,
+               (SIM_POLICY_LANES == policy) ? (passed ? "pass" : "FAIL") : "baseline");
+    }
+
+    /* The debt of both buckets is capped at one bucket, so bulk resumes
+     * within two refills of the fuller bucket, however long the flood.
+     */
+    bound_ms = ((2U * MQTT_PUBLISH_BURST_MSGS * 1000U) / MQTT_PUBLISH_RATE_MSGS_PER_SEC) + 1U;
+    if (((2U * MQTT_PUBLISH_BURST_BYTES * 1000U) / MQTT_PUBLISH_RATE_BYTES_PER_SEC) >= bound_ms)
+    {
+        bound_ms = ((2U * MQTT_PUBLISH_BURST_BYTES * 1000U) / MQTT_PUBLISH_RATE_BYTES_PER_SEC) + 1U;
+    }
+    printf("Bulk recovery after an urgent flood of %u msgs/s (bound %lu ms):\n",
+           (unsigned int)SIM_FLOOD_RATE_PER_SEC, (unsigned long)bound_ms);
+    for (uint32_t i = 0U; i < (sizeof(flood_ms) / sizeof(flood_ms[0])); i++)
+    {
+        recovery_ms = sim_flood_recovery_ms(flood_ms[i]);
+        failures += (recovery_ms <= bound_ms) ? 0 : 1;
+        printf("  flood %7lu ms: bulk waits %5lu ms %9s\n", (unsigned long)flood_ms[i],
+               (unsigned long)recovery_ms, (recovery_ms <= bound_ms) ? "pass" : "FAIL");
+    }
+
+    return failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,394 @@
+/******************************************************************************
+* File Name:   test_sensor_acq.c
+*
+* Description: Host test of the sensor acquisition block pool. Drives it
+*              with a synthetic producer and consumers of several speeds for
+*              throughput and overrun testing.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sensor_acq.c"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Blocks produced per scenario. */
+#define HOST_BLOCKS                         (20000U)
+
+/* Blocks of the handoff benchmark. */
+#define HOST_BENCH_BLOCKS                   (2000000U)
+
+/* Block period of the target, 20 frames at 1 kHz. */
+#define HOST_DEFAULT_PERIOD_US              (20000U)
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+/* Consumer scenario, in multiples of the producer block period. The consumer
+ * takes 'consume_pct' percent of a period per block, plus a stall of
+ * 'stall_pct' percent every 'stall_every' blocks.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t consume_pct;
+    uint32_t stall_every;
+    uint32_t stall_pct;
+    bool lossless;          /* Must not overrun */
+} host_case_t;
+
+typedef struct
+{
+    sensor_acq_stats_t stats;
+    uint32_t intact;        /* Blocks released with the data of their sequence */
+    uint32_t torn;          /* Blocks changed while ready or lent */
+    uint64_t duration_us;
+} host_result_t;
+
+/******************************************************************************
+ * Function Name: host_fill
+ ******************************************************************************
+ * Summary:
+ *  Synthetic producer: writes the pattern of a block into a buffer, as the
+ *  DMA would with a frame stream.
+ *
+ * Parameters:
+ *  uint8_t *buffer : Buffer of the pool
+ *  uint32_t sequence : Sequence number of the block
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_fill(uint8_t *buffer, uint32_t sequence)
+{
+    for (uint32_t i = 0U; i < SENSOR_ACQ_BUFFER_SIZE; i++)
+    {
+        buffer[i] = (uint8_t)((sequence * 131U) + i);
+    }
+}
+
+/******************************************************************************
+ * Function Name: host_intact
+ ******************************************************************************
+ * Summary:
+ *  Checks that a block still holds the pattern of its sequence number.
+ *
+ * Parameters:
+ *  const sensor_acq_block_t *block : Lent block
+ *
+ * Return:
+ *  bool : true if intact
+ *
+ ******************************************************************************/
+static bool host_intact(const sensor_acq_block_t *block)
+{
+    for (uint32_t i = 0U; i < block->size; i++)
+    {
+        if (block->data[i] != (uint8_t)((block->sequence * 131U) + SENSOR_ACQ_BLOCK_HEADER_SIZE + i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_consume
+ ******************************************************************************
+ * Summary:
+ *  Checks that a lent block still holds its data and releases it.
+ *
+ * Parameters:
+ *  const sensor_acq_block_t *block : Lent block
+ *  host_result_t *result : Result to update
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_consume(const sensor_acq_block_t *block, host_result_t *result)
+{
+    if (host_intact(block))
+    {
+        result->intact++;
+    }
+    else
+    {
+        result->torn++;
+    }
+    sensor_acq_release(block);
+}
+
+/******************************************************************************
+ * Function Name: host_run
+ ******************************************************************************
+ * Summary:
+ *  Event simulation of a scenario: a producer completing a block every
+ *  period like the chained DMA, and a consumer that takes the oldest ready
+ *  block whenever it is idle.
+ *
+ * Parameters:
+ *  const host_case_t *test : Scenario
+ *  uint32_t period_us : Block period of the producer
+ *  host_result_t *result : Result
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void host_run(const host_case_t *test, uint32_t period_us, host_result_t *result)
+{
+    const sensor_acq_block_t *lent = NULL;
+    uint8_t *fill;
+    uint64_t now_us = 0U;
+    uint64_t done_us = period_us;
+    uint64_t busy_until_us = 0U;
+    uint32_t produced = 0U;
+
+    memset(result, 0, sizeof(*result));
+    sensor_acq_reset();
+    fill = sensor_acq_buffer(0U);
+
+    while ((produced < HOST_BLOCKS) || (NULL != lent))
+    {
+        if ((NULL != lent) && ((busy_until_us <= done_us) || (produced >= HOST_BLOCKS)))
+        {
+            now_us = busy_until_us;
+            host_consume(lent, result);
+            lent = NULL;
+        }
+        else
+        {
+            now_us = done_us;
+            host_fill(fill, produced);
+            fill = sensor_acq_block_done((uint32_t)(now_us / 1000U));
+            produced++;
+            done_us += period_us;
+        }
+
+        if ((NULL == lent) && (NULL != (lent = sensor_acq_take())))
+        {
+            /* A ready block is never written to. */
+            result->torn += host_intact(lent) ? 0U : 1U;
+            busy_until_us = now_us + (((uint64_t)period_us * test->consume_pct) / 100U);
+            if ((0U != test->stall_every) && (0U == (lent->sequence % test->stall_every)))
+            {
+                busy_until_us += ((uint64_t)period_us * test->stall_pct) / 100U;
+            }
+        }
+    }
+
+    sensor_acq_get_stats(&result->stats);
+    result->duration_us = now_us;
+}
+
+/******************************************************************************
+ * Function Name: host_now_ns
+ ******************************************************************************
+ * Summary:
+ *  Monotonic wall clock of the host.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint64_t : Nanoseconds
+ *
+ ******************************************************************************/
+static uint64_t host_now_ns(void)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/******************************************************************************
+ * Function Name: host_benchmark
+ ******************************************************************************
+ * Summary:
+ *  Runs the pool as fast as the host allows, first the handoff alone, then
+ *  with a producer writing every block and a consumer reading it in place.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true if no block was lost
+ *
+ ******************************************************************************/
+static bool host_benchmark(void)
+{
+    const sensor_acq_block_t *block;
+    sensor_acq_stats_t stats;
+    volatile uint32_t sink = 0U;
+    uint64_t start_ns;
+    uint64_t handoff_ns;
+    uint64_t stream_ns;
+    uint8_t *fill;
+    uint32_t sum;
+
+    sensor_acq_reset();
+    start_ns = host_now_ns();
+    for (uint32_t i = 0U; i < HOST_BENCH_BLOCKS; i++)
+    {
+        (void) sensor_acq_block_done(i);
+        block = sensor_acq_take();
+        sensor_acq_release(block);
+    }
+    handoff_ns = host_now_ns() - start_ns;
+
+    sensor_acq_reset();
+    fill = sensor_acq_buffer(0U);
+    start_ns = host_now_ns();
+    for (uint32_t i = 0U; i < HOST_BENCH_BLOCKS; i++)
+    {
+        memset(fill, (int)i, SENSOR_ACQ_BUFFER_SIZE);
+        fill = sensor_acq_block_done(i);
+        block = sensor_acq_take();
+        sum = 0U;
+        for (uint32_t j = 0U; j < block->size; j++)
+        {
+            sum += block->data[j];
+        }
+        sink += sum;
+        sensor_acq_release(block);
+    }
+    stream_ns = host_now_ns() - start_ns;
+    sensor_acq_get_stats(&stats);
+
+    printf("Handoff: %.1f ns per block; with fill and in-place read: %.0f MB/s (%u-byte blocks)\n",
+           (double)handoff_ns / HOST_BENCH_BLOCKS,
+           ((double)HOST_BENCH_BLOCKS * SENSOR_ACQ_BLOCK_SIZE * 1000.0) / (double)stream_ns,
+           (unsigned int)SENSOR_ACQ_BLOCK_SIZE);
+
+    return (0U == stats.overruns) && (HOST_BENCH_BLOCKS == stats.delivered);
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory. The block
+ *  period can be given on the command line:
+ *    _build/test_sensor_acq [block_period_us]
+ *  Runs each consumer scenario against the synthetic producer and checks
+ *  the block accounting, that no block changes once complete, that the
+ *  consumer is never starved below the blocks it has time for, and that
+ *  only the overload overruns. Build with
+ *  make CC="cc -DSENSOR_ACQ_BLOCK_COUNT=n" to compare other pool sizes. The
+ *  ping-pong pair fails the periodic stall and overload scenarios: every
+ *  block completed while the consumer holds the other is dropped.
+ *
+ * Parameters:
+ *  int argc : Argument count
+ *  char *argv[] : Optional block period of the producer
+ *
+ * Return:
+ *  int : Number of failed scenarios
+ *
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const host_case_t tests[] =
+    {
+        { "light load",     25U,   0U,   0U, true  },
+        { "heavy load",     95U,   0U,   0U, true  },
+        { "periodic stall", 25U, 100U, 150U, true  },
+        { "overload",      125U,   0U,   0U, false }
+    };
+    uint32_t period_us = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : HOST_DEFAULT_PERIOD_US;
+    host_result_t result;
+    uint64_t capacity;
+    uint32_t pending;
+    bool passed;
+    int failures = 0;
+
+    if (0U == period_us)
+    {
+        period_us = HOST_DEFAULT_PERIOD_US;
+    }
+
+    printf("Sensor acquisition: %u blocks of %u bytes, one every %u us, %u blocks per scenario\n",
+           (unsigned int)SENSOR_ACQ_BLOCK_COUNT, (unsigned int)SENSOR_ACQ_BLOCK_SIZE,
+           (unsigned int)period_us, (unsigned int)HOST_BLOCKS);
+    printf("  %-16s %9s %9s %9s %9s %9s %10s\n", "Scenario", "Intact", "Bound", "Overruns", "Torn", "kB/s",
+           "Result");
+
+    for (uint32_t i = 0U; i < (sizeof(tests) / sizeof(tests[0])); i++)
+    {
+        host_run(&tests[i], period_us, &result);
+
+        /* Blocks the consumer can process in the time the producer takes,
+         * less those the pool holds at the end.
+         */
+        capacity = ((uint64_t)HOST_BLOCKS * 100U) / tests[i].consume_pct;
+        if (0U != tests[i].stall_every)
+        {
+            capacity = ((uint64_t)HOST_BLOCKS * 100U * tests[i].stall_every) /
+                       (((uint64_t)tests[i].consume_pct * tests[i].stall_every) + tests[i].stall_pct);
+        }
+        capacity = ((capacity < HOST_BLOCKS) ? capacity : HOST_BLOCKS) - SENSOR_ACQ_BLOCK_COUNT;
+
+        /* Every block is either delivered, dropped as an overrun or still
+         * ready, and none is written to once complete.
+         */
+        pending = result.stats.produced - result.stats.delivered - result.stats.overruns;
+        passed = (HOST_BLOCKS == result.stats.produced) && (pending < SENSOR_ACQ_BLOCK_COUNT) &&
+                 (0U == result.torn) && (result.intact == result.stats.delivered) &&
+                 (result.intact >= capacity) &&
+                 (!tests[i].lossless || (0U == result.stats.overruns));
+        failures += passed ? 0 : 1;
+
+        printf("  %-16s %9lu %9lu %9lu %9lu %9.1f %10s\n", tests[i].name, (unsigned long)result.intact,
+               (unsigned long)capacity, (unsigned long)result.stats.overruns, (unsigned long)result.torn,
+               ((double)result.intact * SENSOR_ACQ_BLOCK_SIZE * 1000.0) / (double)result.duration_us,
+               passed ? "pass" : "FAIL");
+    }
+
+    failures += host_benchmark() ? 0 : 1;
+
+    return failures;
+}
+
+/* [] END OF FILE */
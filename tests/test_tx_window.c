@@ -0,0 +1,310 @@
+/******************************************************************************
+* File Name:   test_tx_window.c
+*
+* Description: Host simulation of the transmit window grid. Prints the
+*              radio-on time per hour of each scheduling policy for the
+*              traffic of the application.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mqtt_client_config.h"
+#include "wifi_config.h"
+
+#include "tx_window.c"
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+/* Settings private to publisher_task.c; override them with -D to model
+ * another setup.
+ */
+#ifndef PUBLISHER_TX_WINDOW_INTERVAL_MS
+#define PUBLISHER_TX_WINDOW_INTERVAL_MS     (5000U)
+#endif
+#ifndef PUBLISHER_BULK_BATCH_SIZE
+#define PUBLISHER_BULK_BATCH_SIZE           (4U)
+#endif
+
+/* Simulated time and radio cost model: air time of one publish with its
+ * acknowledgements, and the wake-up for one DTIM beacon.
+ */
+#define SIM_DURATION_MS                     (3600000U)
+#define SIM_MESSAGE_AIRTIME_MS              (4U)
+#define SIM_BEACON_RX_MS                    (2U)
+
+/* Traffic of the application: vitals and metrics reports every minute at
+ * different phases, button presses (bulk) and command acknowledgements
+ * (urgent) at random times.
+ */
+#define SIM_VITALS_PERIOD_MS                (60000U)
+#define SIM_METRICS_PERIOD_MS               (60000U)
+#define SIM_METRICS_PHASE_MS                (17000U)
+#define SIM_BUTTON_PER_HOUR                 (12U)
+#define SIM_URGENT_PER_HOUR                 (6U)
+#define SIM_SEED                            (12345U)
+
+/* Age at which the former publisher flushed a bulk batch. */
+#define SIM_LEGACY_BATCH_WINDOW_MS          (2000U)
+
+/* Scheduling policies compared by the simulation. */
+typedef enum
+{
+    SIM_POLICY_IMMEDIATE,       /* Every message on its own */
+    SIM_POLICY_BATCH,           /* Former bulk batching by age */
+    SIM_POLICY_TX_WINDOW,       /* Shared transmit windows */
+    SIM_POLICY_COUNT
+} sim_policy_t;
+
+/* Radio state and results of one simulation run. */
+typedef struct
+{
+    uint32_t awake_until_ms;
+    uint32_t last_tx_ms;
+    uint32_t radio_on_ms;
+    uint32_t wakeups;
+    uint32_t messages;
+    uint32_t pings;
+    uint32_t max_bulk_delay_ms;
+} sim_result_t;
+
+static const char *const sim_policy_names[SIM_POLICY_COUNT] =
+{
+    "immediate", "batch by age", "tx windows"
+};
+
+static uint32_t sim_random_state;
+
+/******************************************************************************
+ * Function Name: sim_chance
+ ******************************************************************************
+ * Summary:
+ *  Draws whether an event with the given hourly rate happens in one
+ *  millisecond, from a fixed-seed generator so that every policy sees the
+ *  same traffic.
+ *
+ * Parameters:
+ *  uint32_t per_hour : Mean number of events per hour
+ *
+ * Return:
+ *  bool : true if the event happens
+ *
+ ******************************************************************************/
+static bool sim_chance(uint32_t per_hour)
+{
+    sim_random_state = (sim_random_state * 1664525U) + 1013904223U;
+
+    return ((sim_random_state >> 8) % SIM_DURATION_MS) < per_hour;
+}
+
+/******************************************************************************
+ * Function Name: sim_transmit
+ ******************************************************************************
+ * Summary:
+ *  Charges the radio for a burst of messages: the radio wakes up unless it
+ *  is still awake, sends the burst and stays awake for the return-to-sleep
+ *  time of power save mode 2.
+ *
+ * Parameters:
+ *  sim_result_t *result : Radio state; updated
+ *  uint32_t now_ms : Time of the burst
+ *  uint32_t count : Number of messages
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sim_transmit(sim_result_t *result, uint32_t now_ms, uint32_t count)
+{
+    uint32_t end_ms = now_ms + (count * SIM_MESSAGE_AIRTIME_MS) + WIFI_PM2_RETURN_TO_SLEEP_MS;
+
+    if (now_ms >= result->awake_until_ms)
+    {
+        result->wakeups++;
+        result->radio_on_ms += end_ms - now_ms;
+        result->awake_until_ms = end_ms;
+    }
+    else if (end_ms > result->awake_until_ms)
+    {
+        result->radio_on_ms += end_ms - result->awake_until_ms;
+        result->awake_until_ms = end_ms;
+    }
+
+    result->last_tx_ms = now_ms;
+}
+
+/******************************************************************************
+ * Function Name: sim_run
+ ******************************************************************************
+ * Summary:
+ *  Simulates one hour of the publisher with one scheduling policy, in steps
+ *  of one millisecond. Keep-alive PINGREQs are sent after
+ *  MQTT_KEEP_ALIVE_SECONDS without a transmission.
+ *
+ * Parameters:
+ *  sim_policy_t policy : Scheduling policy
+ *  uint32_t sensor_period_ms : Period of an additional bulk sensor, 0 for none
+ *  sim_result_t *result : Results; set
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sim_run(sim_policy_t policy, uint32_t sensor_period_ms, sim_result_t *result)
+{
+    tx_window_t window;
+    uint32_t bulk_pending = 0U;
+    uint32_t bulk_oldest_ms = 0U;
+    uint32_t urgent_pending;
+    bool bulk_due;
+
+    memset(result, 0, sizeof(*result));
+    sim_random_state = SIM_SEED;
+    tx_window_init(&window, WIFI_AP_BEACON_INTERVAL_TU, WIFI_AP_DTIM_PERIOD,
+                   PUBLISHER_TX_WINDOW_INTERVAL_MS, WIFI_PM2_RETURN_TO_SLEEP_MS, 0U);
+
+    for (uint32_t now_ms = 0U; now_ms < SIM_DURATION_MS; now_ms++)
+    {
+        uint32_t arrivals = 0U;
+
+        arrivals += ((now_ms % SIM_VITALS_PERIOD_MS) == 0U) ? 1U : 0U;
+        arrivals += ((now_ms % SIM_METRICS_PERIOD_MS) == SIM_METRICS_PHASE_MS) ? 1U : 0U;
+        arrivals += ((0U != sensor_period_ms) && ((now_ms % sensor_period_ms) == 0U)) ? 1U : 0U;
+        arrivals += sim_chance(SIM_BUTTON_PER_HOUR) ? 1U : 0U;
+        urgent_pending = sim_chance(SIM_URGENT_PER_HOUR) ? 1U : 0U;
+
+        if ((0U == bulk_pending) && (0U != arrivals))
+        {
+            bulk_oldest_ms = now_ms;
+        }
+        bulk_pending += arrivals;
+
+        if ((now_ms - result->last_tx_ms) >= (MQTT_KEEP_ALIVE_SECONDS * 1000U))
+        {
+            sim_transmit(result, now_ms, 1U);
+            tx_window_anchor(&window, now_ms);
+            result->pings++;
+        }
+
+        if (0U != urgent_pending)
+        {
+            sim_transmit(result, now_ms, urgent_pending);
+            tx_window_anchor(&window, now_ms);
+            result->messages += urgent_pending;
+        }
+
+        switch (policy)
+        {
+            case SIM_POLICY_IMMEDIATE:
+                bulk_due = (0U != bulk_pending);
+                break;
+
+            case SIM_POLICY_BATCH:
+                bulk_due = (bulk_pending >= PUBLISHER_BULK_BATCH_SIZE) ||
+                           ((0U != bulk_pending) && ((now_ms - bulk_oldest_ms) >= SIM_LEGACY_BATCH_WINDOW_MS));
+                break;
+
+            default:
+                bulk_due = (bulk_pending >= PUBLISHER_BULK_BATCH_SIZE) ||
+                           ((0U != bulk_pending) && (0U == tx_window_wait_ms(&window, now_ms)));
+                break;
+        }
+
+        if (bulk_due)
+        {
+            if ((now_ms - bulk_oldest_ms) > result->max_bulk_delay_ms)
+            {
+                result->max_bulk_delay_ms = now_ms - bulk_oldest_ms;
+            }
+            sim_transmit(result, now_ms, bulk_pending);
+            tx_window_anchor(&window, now_ms);
+            result->messages += bulk_pending;
+            bulk_pending = 0U;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory. The period
+ *  of the extra sensor can be given on the command line:
+ *    _build/test_tx_window [sensor_period_ms]
+ *  Prints the radio-on time per hour of each scheduling policy for the
+ *  traffic of the application, plus an optional bulk sensor.
+ *
+ * Parameters:
+ *  int argc : Argument count
+ *  char *argv[] : Optional period of an additional bulk sensor
+ *
+ * Return:
+ *  int : 0
+ *
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t sensor_period_ms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 10000U;
+    uint32_t dtim_ms = ((WIFI_AP_BEACON_INTERVAL_TU * WIFI_AP_DTIM_PERIOD * TX_WINDOW_TU_US) + 999U) / 1000U;
+    uint32_t beacon_ms = (SIM_DURATION_MS / dtim_ms) * SIM_BEACON_RX_MS;
+    sim_result_t result;
+
+    printf("Radio-on time per hour: beacon %u TU, DTIM %u, PM2 return-to-sleep %u ms, "
+           "window %u ms, extra sensor every %u ms\n",
+           (unsigned int)WIFI_AP_BEACON_INTERVAL_TU, (unsigned int)WIFI_AP_DTIM_PERIOD,
+           (unsigned int)WIFI_PM2_RETURN_TO_SLEEP_MS, (unsigned int)PUBLISHER_TX_WINDOW_INTERVAL_MS,
+           (unsigned int)sensor_period_ms);
+    printf("  %-14s %9s %6s %9s %12s %15s\n", "Policy", "Messages", "Pings", "Wake-ups", "Radio-on s",
+           "Max delay ms");
+
+    for (uint32_t policy = 0U; policy < SIM_POLICY_COUNT; policy++)
+    {
+        sim_run((sim_policy_t)policy, sensor_period_ms, &result);
+        printf("  %-14s %9lu %6lu %9lu %8lu.%03lu %15lu\n", sim_policy_names[policy],
+               (unsigned long)result.messages, (unsigned long)result.pings, (unsigned long)result.wakeups,
+               (unsigned long)((result.radio_on_ms + beacon_ms) / 1000U),
+               (unsigned long)((result.radio_on_ms + beacon_ms) % 1000U),
+               (unsigned long)result.max_bulk_delay_ms);
+    }
+    printf("  Radio-on includes %lu.%03lu s of DTIM beacon reception.\n",
+           (unsigned long)(beacon_ms / 1000U), (unsigned long)(beacon_ms % 1000U));
+
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,507 @@
+/******************************************************************************
+* File Name:   test_wifi_profiles.c
+*
+* Description: Host test of the Wi-Fi profiles. Feeds simulated scans and
+*              joins to the profile selection, checks the ranking and compares
+*              the time to connect with list order.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wifi_config.h"
+
+/* Networks of the test: "home", the primary one, "backup" and the hidden
+ * "lab".
+ */
+#undef WIFI_SSID
+#undef WIFI_PASSWORD
+#undef WIFI_SECURITY
+#undef WIFI_EXTRA_PROFILES
+#define WIFI_SSID                           "home"
+#define WIFI_PASSWORD                       "password"
+#define WIFI_SECURITY                       CY_WCM_SECURITY_WPA2_AES_PSK
+#define WIFI_EXTRA_PROFILES                 { "backup", "password", CY_WCM_SECURITY_WPA2_AES_PSK }, \
+                                            { "lab", "password", CY_WCM_SECURITY_WPA2_AES_PSK },
+
+/* The profiles log every scan and join, which the test silences while it
+ * measures.
+ */
+static bool host_quiet;
+#define printf(...)                         (host_quiet ? 0 : printf(__VA_ARGS__))
+
+#include "wifi_profiles.c"
+
+static uint32_t host_now_ms;
+static bool host_scan_done;
+
+/* Duration of a full scan, and of a join that fails (authentication or
+ * association timeout, or no access point in range).
+ */
+#define HOST_SCAN_MS                        (2500U)
+#define HOST_JOIN_FAILURE_MS                (4000U)
+
+/* Connections per scenario, and access points per environment. */
+#define HOST_CONNECTS                       (1000U)
+#define HOST_MAX_APS                        (4U)
+
+/* Simulated access point. */
+typedef struct
+{
+    const char *ssid;       /* NULL terminates the environment */
+    uint8_t bssid_tail;     /* Last byte of the BSSID */
+    int16_t rssi;           /* Mean RSSI; scans add up to +/-3 dB */
+    uint32_t success_pct;   /* Probability that a join succeeds */
+    uint32_t join_ms;       /* Duration of a successful join */
+    bool hidden;            /* Not reported by scans */
+} host_ap_t;
+
+/* Time-to-connect scenario. */
+typedef struct
+{
+    const char *name;
+    bool ranking_helps;     /* false if list order is already right */
+    host_ap_t aps[HOST_MAX_APS];
+} host_scenario_t;
+
+static const host_ap_t *host_aps;
+static const host_ap_t *host_joined;
+static uint32_t host_seed = 1U;
+static uint32_t host_connect_ms[HOST_CONNECTS];
+
+/******************************************************************************
+ * Function Name: host_random
+ ******************************************************************************
+ * Summary:
+ *  Deterministic pseudo-random number, so that every run gives the same
+ *  table.
+ *
+ ******************************************************************************/
+static uint32_t host_random(uint32_t range)
+{
+    host_seed = (host_seed * 1103515245U) + 12345U;
+    return (host_seed >> 16) % range;
+}
+
+/******************************************************************************
+ * Function Name: xTaskGetTickCount
+ ******************************************************************************
+ * Summary:
+ *  Returns the simulated time, one tick per millisecond.
+ *
+ ******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)host_now_ms;
+}
+
+/******************************************************************************
+ * Function Name: xSemaphoreCreateBinary, xSemaphoreGive, xSemaphoreTake
+ ******************************************************************************
+ * Summary:
+ *  Scan semaphore. The emulated scan completes synchronously, so the
+ *  semaphore is either given already or never.
+ *
+ ******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return &host_scan_done;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    host_scan_done = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    bool done = host_scan_done;
+
+    host_scan_done = false;
+    return done ? pdTRUE : pdFALSE;
+}
+
+/******************************************************************************
+ * Function Name: config_store_get_string
+ ******************************************************************************
+ * Summary:
+ *  Emulated configuration store with no stored value.
+ *
+ ******************************************************************************/
+void config_store_get_string(const char *key, char *buffer, size_t size, const char *default_value)
+{
+    (void) key;
+    (void) snprintf(buffer, size, "%s", default_value);
+}
+
+/******************************************************************************
+ * Function Name: cy_wcm_start_scan
+ ******************************************************************************
+ * Summary:
+ *  Emulated scan: reports every visible access point of the environment
+ *  with some RSSI noise, then completes.
+ *
+ ******************************************************************************/
+cy_rslt_t cy_wcm_start_scan(cy_wcm_scan_result_callback_t callback, void *user_data,
+                            cy_wcm_scan_filter_t *filter)
+{
+    cy_wcm_scan_result_t result;
+
+    (void) filter;
+    host_now_ms += HOST_SCAN_MS;
+
+    for (const host_ap_t *ap = host_aps; NULL != ap->ssid; ap++)
+    {
+        if (ap->hidden)
+        {
+            continue;
+        }
+        memset(&result, 0, sizeof(result));
+        (void) snprintf((char *)result.SSID, sizeof(result.SSID), "%s", ap->ssid);
+        result.BSSID[5] = ap->bssid_tail;
+        result.signal_strength = (int16_t)(ap->rssi + (int16_t)host_random(7U) - 3);
+        callback(&result, user_data, CY_WCM_SCAN_INCOMPLETE);
+    }
+
+    callback(NULL, user_data, CY_WCM_SCAN_COMPLETE);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_stop_scan(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: cy_wcm_connect_ap
+ ******************************************************************************
+ * Summary:
+ *  Emulated join: to the given BSSID, or without one to the strongest
+ *  access point of the SSID, hidden ones included. Advances the clock by
+ *  the duration of the join.
+ *
+ ******************************************************************************/
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *params, cy_wcm_ip_address_t *ip_address)
+{
+    static const cy_wcm_mac_t any_bssid;
+    const host_ap_t *target = NULL;
+
+    for (const host_ap_t *ap = host_aps; NULL != ap->ssid; ap++)
+    {
+        if (0 != strcmp(ap->ssid, (const char *)params->ap_credentials.SSID))
+        {
+            continue;
+        }
+        if (0 == memcmp(params->BSSID, any_bssid, sizeof(any_bssid)))
+        {
+            if ((NULL == target) || (ap->rssi > target->rssi))
+            {
+                target = ap;
+            }
+        }
+        else if (params->BSSID[5] == ap->bssid_tail)
+        {
+            target = ap;
+        }
+    }
+
+    if ((NULL == target) || (host_random(100U) >= target->success_pct))
+    {
+        host_now_ms += HOST_JOIN_FAILURE_MS;
+        return ~CY_RSLT_SUCCESS;
+    }
+
+    host_now_ms += target->join_ms;
+    host_joined = target;
+    ip_address->version = CY_WCM_IP_VER_V4;
+    ip_address->ip.v4 = 0x0A000002U;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_disconnect_ap(void)
+{
+    host_joined = NULL;
+    return CY_RSLT_SUCCESS;
+}
+
+uint8_t cy_wcm_is_connected_to_ap(void)
+{
+    return (NULL != host_joined) ? 1U : 0U;
+}
+
+cy_rslt_t cy_wcm_get_associated_ap_info(cy_wcm_associated_ap_info_t *ap_info)
+{
+    memset(ap_info, 0, sizeof(*ap_info));
+    ap_info->signal_strength = host_joined->rssi;
+    ap_info->BSSID[5] = host_joined->bssid_tail;
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: host_connect_list_order
+ ******************************************************************************
+ * Summary:
+ *  Reference without scan and ranking: tries the profiles in list order.
+ *
+ ******************************************************************************/
+static cy_rslt_t host_connect_list_order(cy_wcm_ip_address_t *ip_address)
+{
+    cy_rslt_t result = ~CY_RSLT_SUCCESS;
+
+    for (uint32_t i = 0U; (i < wifi_profile_count) && (CY_RSLT_SUCCESS != result); i++)
+    {
+        result = wifi_profiles_join(i, ip_address);
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: host_compare_ms
+ ******************************************************************************
+ * Summary:
+ *  qsort() comparison of connection times.
+ *
+ ******************************************************************************/
+static int host_compare_ms(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/******************************************************************************
+ * Function Name: host_measure
+ ******************************************************************************
+ * Summary:
+ *  Connects HOST_CONNECTS times with the given strategy, keeping the
+ *  history of the profiles between connections as the device does across
+ *  reconnects, and returns the mean, 95th percentile and maximum time to
+ *  connect. With retries in fewer than 5% of the connections, the mean can
+ *  exceed the 95th percentile; the maximum shows that tail.
+ *
+ ******************************************************************************/
+static void host_measure(const host_scenario_t *scenario, cy_rslt_t (*connect)(cy_wcm_ip_address_t *),
+                         uint32_t *mean_ms, uint32_t *p95_ms, uint32_t *max_ms)
+{
+    cy_wcm_ip_address_t ip_address;
+    uint64_t total_ms = 0U;
+    uint32_t start;
+    cy_rslt_t result;
+
+    host_quiet = true;
+    host_aps = scenario->aps;
+    host_seed = 1U;
+    wifi_profiles_init();
+
+    for (uint32_t i = 0U; i < HOST_CONNECTS; i++)
+    {
+        start = host_now_ms;
+        do
+        {
+            result = connect(&ip_address);
+        } while (CY_RSLT_SUCCESS != result);
+        host_connect_ms[i] = host_now_ms - start;
+        total_ms += host_connect_ms[i];
+        (void) cy_wcm_disconnect_ap();
+    }
+
+    qsort(host_connect_ms, HOST_CONNECTS, sizeof(host_connect_ms[0]), host_compare_ms);
+    *mean_ms = (uint32_t)(total_ms / HOST_CONNECTS);
+    /* Nearest rank: the smallest time that 95% of the connections meet. */
+    *p95_ms = host_connect_ms[(((HOST_CONNECTS * 95U) + 99U) / 100U) - 1U];
+    *max_ms = host_connect_ms[HOST_CONNECTS - 1U];
+    host_quiet = false;
+}
+
+/******************************************************************************
+ * Function Name: host_check_rank
+ ******************************************************************************
+ * Summary:
+ *  Ranks a fixed set of profiles and compares the order with the expected
+ *  one.
+ *
+ ******************************************************************************/
+static int host_check_rank(const char *name, const wifi_profile_t *profiles, uint32_t count,
+                           const uint8_t *expected)
+{
+    uint8_t order[WIFI_MAX_PROFILES];
+    bool pass = (count == wifi_profiles_rank(profiles, count, order)) &&
+                (0 == memcmp(order, expected, count));
+
+    printf("Rank %-34s %s\n", name, pass ? "pass" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+/******************************************************************************
+ * Function Name: main
+ ******************************************************************************
+ * Summary:
+ *  Host entry point, built and run by 'make' in this directory.
+ *  Checks the ranking on fixed profiles and on a simulated scan feed, then
+ *  compares the time to connect of the ranked profiles with list order.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  int : Number of failed checks
+ *
+ ******************************************************************************/
+int main(void)
+{
+    static const host_scenario_t scenarios[] =
+    {
+        /* Primary network in range and reliable: the scan is pure overhead. */
+        { "primary good", false, {
+            { "home",   0x01U, -55, 98U, 1200U, false },
+            { "backup", 0x02U, -65, 95U, 1500U, false },
+            { NULL, 0U, 0, 0U, 0U, false } } },
+        /* Primary network at the edge of coverage, backup close by. */
+        { "primary weak", true, {
+            { "home",   0x01U, -84, 35U, 2500U, false },
+            { "backup", 0x02U, -58, 95U, 1500U, false },
+            { NULL, 0U, 0, 0U, 0U, false } } },
+        /* Primary network out of range. */
+        { "primary absent", true, {
+            { "backup", 0x02U, -62, 95U, 1500U, false },
+            { NULL, 0U, 0, 0U, 0U, false } } },
+        /* Only the hidden network in range: unseen profiles keep list order. */
+        { "hidden only", false, {
+            { "lab",    0x03U, -60, 95U, 1500U, true },
+            { NULL, 0U, 0, 0U, 0U, false } } },
+    };
+    static const host_ap_t two_home_aps[] =
+    {
+        { "home",   0x11U, -80, 90U, 1500U, false },
+        { "home",   0x12U, -52, 90U, 1200U, false },
+        { "backup", 0x02U, -70, 90U, 1500U, false },
+        { NULL, 0U, 0, 0U, 0U, false }
+    };
+    static const host_ap_t roam_aps[] =
+    {
+        { "home",   0x11U, -80, 100U, 1500U, false },
+        { "home",   0x12U, -60, 100U, 1200U, false },
+        { NULL, 0U, 0, 0U, 0U, false }
+    };
+    static const uint8_t by_score[] = { 1U, 2U, 0U };
+    static const uint8_t seen_first[] = { 2U, 0U, 1U };
+    static const uint8_t penalised[] = { 1U, 0U, 2U };
+    static const uint8_t slow_last[] = { 1U, 0U, 2U };
+    wifi_profile_t profiles[3];
+    cy_wcm_ip_address_t ip_address;
+    uint8_t order[WIFI_MAX_PROFILES];
+    uint32_t ranked_mean;
+    uint32_t ranked_p95;
+    uint32_t list_mean;
+    uint32_t list_p95;
+    uint32_t ranked_max;
+    uint32_t list_max;
+    bool pass;
+    int failures = 0;
+
+    /* Ranking of fixed profiles. */
+    memset(profiles, 0, sizeof(profiles));
+    profiles[0].seen = true;
+    profiles[0].rssi = -70;
+    profiles[1].seen = true;
+    profiles[1].rssi = -50;
+    profiles[2].seen = true;
+    profiles[2].rssi = -60;
+    failures += host_check_rank("by RSSI", profiles, 3U, by_score);
+
+    profiles[0].seen = false;
+    profiles[1].seen = false;
+    failures += host_check_rank("seen before unseen", profiles, 3U, seen_first);
+
+    profiles[0].seen = true;
+    profiles[1].seen = true;
+    profiles[2].consecutive_failures = 2U;
+    failures += host_check_rank("with failure penalty", profiles, 3U, penalised);
+
+    profiles[2].consecutive_failures = 0U;
+    profiles[2].avg_connect_ms = 6000U;
+    failures += host_check_rank("with connect time penalty", profiles, 3U, slow_last);
+
+    /* Simulated scan feed: the strongest access point of a network. */
+    host_quiet = true;
+    host_aps = two_home_aps;
+    wifi_profiles_init();
+    pass = (CY_RSLT_SUCCESS == wifi_profiles_connect(&ip_address)) &&
+           (0x12U == host_joined->bssid_tail) && wifi_profiles_scan() &&
+           (3U == wifi_profiles_rank(wifi_profiles, wifi_profile_count, order)) &&
+           (0U == order[0]) && (1U == order[1]) && (2U == order[2]);
+    host_quiet = false;
+    failures += pass ? 0 : 1;
+    printf("Scan strongest access point of 'home'   %s\n", pass ? "pass" : "FAIL");
+
+    /* Roaming: below the threshold to an access point beyond the hysteresis. */
+    host_quiet = true;
+    host_aps = roam_aps;
+    wifi_profiles_init();
+    host_joined = &roam_aps[0];
+    pass = wifi_profiles_check_roam() && (0x12U == host_joined->bssid_tail) &&
+           !wifi_profiles_check_roam();
+    host_quiet = false;
+    failures += pass ? 0 : 1;
+    printf("Roam to the stronger access point       %s\n", pass ? "pass" : "FAIL");
+
+    /* Time to connect, scan and ranking against list order. */
+    printf("\n%-16s %24s %24s\n", "Scenario", "ranked mean/p95/max ms", "list mean/p95/max ms");
+    for (uint32_t i = 0U; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+    {
+        host_measure(&scenarios[i], wifi_profiles_connect, &ranked_mean, &ranked_p95, &ranked_max);
+        host_measure(&scenarios[i], host_connect_list_order, &list_mean, &list_p95, &list_max);
+
+        /* The last-good profile goes first, so the ranking is never slower
+         * than list order, and faster where list order starts wrong.
+         */
+        pass = (ranked_mean <= list_mean) && (ranked_p95 <= list_p95) &&
+               (!scenarios[i].ranking_helps || (ranked_mean < list_mean));
+        failures += pass ? 0 : 1;
+        printf("%-16s %8lu / %5lu / %5lu %8lu / %5lu / %5lu  %s\n", scenarios[i].name,
+               (unsigned long)ranked_mean, (unsigned long)ranked_p95, (unsigned long)ranked_max,
+               (unsigned long)list_mean, (unsigned long)list_p95, (unsigned long)list_max,
+               pass ? "pass" : "FAIL");
+    }
+
+    return failures;
+}
+
+/* [] END OF FILE */